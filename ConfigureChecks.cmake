@@ -103,6 +103,56 @@ check_cxx_source_compiles("
   }
 " HAVE_ISO_STRDUP)
 
+# Determine whether your system supports memory mapped files.
+check_cxx_source_compiles("
+  #include <sys/mman.h>
+  int main() {
+    mmap(0, 0, PROT_READ, MAP_PRIVATE, -1, 0);
+    return 0;
+  }
+" HAVE_MMAP)
+
+check_cxx_source_compiles("
+  #include <fcntl.h>
+  int main() {
+    fallocate(-1, FALLOC_FL_INSERT_RANGE, 0, 0);
+    fallocate(-1, FALLOC_FL_COLLAPSE_RANGE, 0, 0);
+    return 0;
+  }
+" HAVE_FALLOCATE_RANGE)
+
+check_cxx_source_compiles("
+  #include <unistd.h>
+  int main() {
+    copy_file_range(-1, 0, -1, 0, 0, 0);
+    return 0;
+  }
+" HAVE_COPY_FILE_RANGE)
+
+# Determine whether the kernel headers support reading through io_uring.
+check_cxx_source_compiles("
+  #include <linux/io_uring.h>
+  #include <sys/eventfd.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+  int main() {
+    io_uring_params params {};
+    io_uring_sqe sqe {};
+    sqe.opcode = IORING_OP_READ;
+    return static_cast<int>(syscall(__NR_io_uring_setup, 1, &params)) +
+      IORING_FEAT_SINGLE_MMAP + IORING_REGISTER_EVENTFD + eventfd(0, EFD_CLOEXEC);
+  }
+" HAVE_IO_URING)
+
+# Determine whether stat() returns the modification time in nanoseconds.
+check_cxx_source_compiles("
+  #include <sys/stat.h>
+  int main() {
+    struct stat st;
+    return static_cast<int>(st.st_mtim.tv_nsec);
+  }
+" HAVE_STAT_MTIM)
+
 # Detect WinRT mode
 if(CMAKE_SYSTEM_NAME STREQUAL "WindowsStore")
   set(PLATFORM_WINRT 1)
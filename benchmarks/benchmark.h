@@ -0,0 +1,160 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#ifndef TAGLIB_BENCHMARK_H
+#define TAGLIB_BENCHMARK_H
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+#include "tfile.h"
+#include "tiostream.h"
+
+using namespace TagLib;
+
+//! IOStream decorator which counts the calls and bytes going to a stream
+class CountingStream : public IOStream
+{
+public:
+  explicit CountingStream(IOStream *stream) : stream(stream) { }
+
+  FileName name() const override { return stream->name(); }
+
+  ByteVector readBlock(size_t length) override
+  {
+    ByteVector data = stream->readBlock(length);
+    ++reads;
+    bytesRead += data.size();
+    return data;
+  }
+
+  ByteVector readBlockAt(offset_t offset, size_t length) override
+  {
+    ByteVector data = stream->readBlockAt(offset, length);
+    ++positionalReads;
+    bytesRead += data.size();
+    return data;
+  }
+
+  ByteVectorList readBlocks(const List<Region> &regions) override
+  {
+    ByteVectorList blocks = stream->readBlocks(regions);
+    ++batchReads;
+    for(const auto &block : blocks)
+      bytesRead += block.size();
+    return blocks;
+  }
+
+  void writeBlock(const ByteVector &data) override
+  {
+    ++writes;
+    bytesWritten += data.size();
+    stream->writeBlock(data);
+  }
+
+  void insert(const ByteVector &data, offset_t start, size_t replace) override
+  {
+    stream->insert(data, start, replace);
+  }
+
+  void removeBlock(offset_t start, size_t length) override
+  {
+    stream->removeBlock(start, length);
+  }
+
+  bool readOnly() const override { return stream->readOnly(); }
+  bool isOpen() const override { return stream->isOpen(); }
+
+  void seek(offset_t offset, Position p) override
+  {
+    ++seeks;
+    stream->seek(offset, p);
+  }
+
+  void clear() override { stream->clear(); }
+  offset_t tell() const override { return stream->tell(); }
+  offset_t length() override { return stream->length(); }
+  void truncate(offset_t length) override { stream->truncate(length); }
+
+  void reset()
+  {
+    reads = positionalReads = batchReads = writes = seeks = 0;
+    bytesRead = bytesWritten = 0;
+  }
+
+  IOStream *const stream;
+  unsigned long long reads = 0;
+  unsigned long long positionalReads = 0;
+  unsigned long long batchReads = 0;
+  unsigned long long writes = 0;
+  unsigned long long seeks = 0;
+  unsigned long long bytesRead = 0;
+  unsigned long long bytesWritten = 0;
+};
+
+//! File subclass that gives benchmarks access to the search and I/O methods
+class PlainFile : public File
+{
+public:
+  explicit PlainFile(IOStream *stream) : File(stream) { }
+  Tag *tag() const override { return nullptr; }
+  AudioProperties *audioProperties() const override { return nullptr; }
+  bool save() override { return false; }
+};
+
+//! Measures the wall clock time since construction
+class Timer
+{
+public:
+  double milliseconds() const
+  {
+    return std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - start).count();
+  }
+
+private:
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+};
+
+//! Temporary file which is removed when going out of scope
+class ScopedTempFile
+{
+public:
+  explicit ScopedTempFile(const std::string &name) :
+    path((std::filesystem::temp_directory_path() / ("taglib-benchmark-" + name)).string())
+  {
+  }
+
+  ~ScopedTempFile()
+  {
+    std::remove(path.c_str());
+  }
+
+  const std::string path;
+};
+
+#endif
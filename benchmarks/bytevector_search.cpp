@@ -0,0 +1,132 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+// Compares the throughput of ByteVector::find() and ByteVector::rfind() with
+// the scalar and the vectorized search kernels supported by this CPU.
+//
+// Usage: bytevector_search [size in MiB]
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+#include "tbytevector.h"
+#include "tbytevectorsearch.h"
+#include "benchmark.h"
+
+namespace
+{
+  using ByteVectorSearch::Kernel;
+
+  const char *kernelName(Kernel kernel)
+  {
+    switch(kernel) {
+    case Kernel::Scalar:
+      return "scalar";
+    case Kernel::SSE2:
+      return "SSE2";
+    case Kernel::AVX2:
+      return "AVX2";
+    case Kernel::NEON:
+      return "NEON";
+    }
+    return "";
+  }
+
+  struct Search
+  {
+    const char *description;
+    ByteVector pattern;
+    int byteAlign;
+  };
+}
+
+int main(int argc, char *argv[])
+{
+  const unsigned long mebibytes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 16;
+
+  // Lower case letters only, none of the patterns is found, so that every
+  // search goes through all of the data.
+
+  ByteVector data(static_cast<unsigned int>(mebibytes << 20), 0);
+  unsigned int seed = 1;
+  for(auto &c : data) {
+    seed = seed * 1103515245U + 12345U;
+    c = static_cast<char>('a' + (seed >> 16) % 26);
+  }
+
+  const Search searches[] = {
+    { "1 byte", "X", 1 },
+    { "4 bytes", "abcX", 1 },
+    { "16 bytes", "abcdefghijklmnoX", 1 },
+    { "2 bytes, aligned to 2", ByteVector("a\0", 2), 2 },
+    { "4 bytes, aligned to 4", ByteVector("a\0\0\0", 4), 4 },
+    { "2 bytes, aligned to 3", ByteVector("a\0", 2), 3 }
+  };
+
+  const Kernel defaultKernel = ByteVectorSearch::kernel();
+
+  std::cout << "Data size: " << data.size() << " bytes, default kernel: "
+            << kernelName(defaultKernel) << std::endl << std::endl
+            << std::left << std::setw(24) << "pattern"
+            << std::setw(8) << "kernel" << std::right
+            << std::setw(14) << "find MB/s"
+            << std::setw(14) << "rfind MB/s" << std::endl;
+
+  constexpr int repetitions = 5;
+
+  for(const auto &search : searches) {
+    for(Kernel kernel : { Kernel::Scalar, Kernel::SSE2, Kernel::AVX2, Kernel::NEON }) {
+      if(!ByteVectorSearch::setKernel(kernel))
+        continue;
+
+      int result = 0;
+
+      const Timer findTimer;
+      for(int i = 0; i < repetitions; ++i)
+        result += data.find(search.pattern, 0, search.byteAlign);
+      const double findMs = findTimer.milliseconds();
+
+      const Timer rfindTimer;
+      for(int i = 0; i < repetitions; ++i)
+        result += data.rfind(search.pattern, 0, search.byteAlign);
+      const double rfindMs = rfindTimer.milliseconds();
+
+      const double megabytes = static_cast<double>(data.size()) * repetitions / 1e6;
+
+      std::cout << std::left << std::setw(24) << search.description
+                << std::setw(8) << kernelName(kernel) << std::right
+                << std::fixed << std::setprecision(0)
+                << std::setw(14) << megabytes / findMs * 1000
+                << std::setw(14) << megabytes / rfindMs * 1000
+                << (result == -2 * repetitions ? "" : "  unexpected match")
+                << std::endl;
+    }
+  }
+
+  ByteVectorSearch::setKernel(defaultKernel);
+
+  return 0;
+}
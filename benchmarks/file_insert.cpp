@@ -0,0 +1,163 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+// Measures FileStream::insert() and removeBlock() near the start of a large
+// file, which shifts almost all of it, and reports the throughput of the
+// shift in MiB/s.  The same is done with the former algorithm, which copied
+// the tail in buffers of 1 KiB through seek(), readBlock() and writeBlock(),
+// for reference.
+//
+// Usage: file_insert [size in MiB]
+
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#include "tfilestream.h"
+#include "benchmark.h"
+
+namespace
+{
+  constexpr unsigned int legacyBufferSize = 1024;
+
+  void legacyInsert(IOStream &stream, const ByteVector &data, offset_t start)
+  {
+    unsigned int bufferLength = legacyBufferSize;
+    while(data.size() > bufferLength)
+      bufferLength += legacyBufferSize;
+
+    offset_t readPosition = start;
+    offset_t writePosition = start;
+    ByteVector buffer = data;
+
+    while(true) {
+      stream.seek(readPosition);
+      const ByteVector aboutToOverwrite = stream.readBlock(bufferLength);
+      readPosition += bufferLength;
+
+      if(aboutToOverwrite.size() < bufferLength)
+        stream.clear();
+
+      stream.seek(writePosition);
+      stream.writeBlock(buffer);
+
+      if(aboutToOverwrite.isEmpty())
+        break;
+
+      writePosition += buffer.size();
+      buffer = aboutToOverwrite;
+    }
+  }
+
+  void legacyRemove(IOStream &stream, offset_t start, size_t length)
+  {
+    offset_t readPosition = start + length;
+    offset_t writePosition = start;
+
+    while(true) {
+      stream.seek(readPosition);
+      const ByteVector buffer = stream.readBlock(legacyBufferSize);
+      if(buffer.size() < legacyBufferSize)
+        stream.clear();
+
+      stream.seek(writePosition);
+      stream.writeBlock(buffer);
+
+      if(buffer.isEmpty())
+        break;
+
+      readPosition += buffer.size();
+      writePosition += buffer.size();
+    }
+
+    stream.truncate(writePosition);
+  }
+
+  void report(const char *description, unsigned int size, offset_t shifted, double ms)
+  {
+    std::cout << std::left << std::setw(22) << description << std::right
+              << std::setw(12) << size
+              << std::setw(12) << std::fixed << std::setprecision(2) << ms
+              << std::setw(12) << std::setprecision(1)
+              << (static_cast<double>(shifted) / (1 << 20)) / (ms / 1000)
+              << std::endl;
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  const unsigned long mebibytes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 256;
+  const offset_t fileSize = static_cast<offset_t>(mebibytes) << 20;
+
+  ScopedTempFile temp("file_insert.bin");
+  {
+    std::ofstream out(temp.path, std::ios::binary);
+    ByteVector chunk(1 << 20, '\0');
+    for(unsigned int i = 0; i < chunk.size(); ++i)
+      chunk[i] = static_cast<char>(i * 7);
+    for(unsigned long i = 0; i < mebibytes; ++i)
+      out.write(chunk.data(), chunk.size());
+  }
+
+  FileStream stream(temp.path.c_str());
+
+  std::cout << "File size: " << fileSize << " bytes" << std::endl << std::endl
+            << std::left << std::setw(22) << "operation" << std::right
+            << std::setw(12) << "bytes"
+            << std::setw(12) << "ms"
+            << std::setw(12) << "MiB/s" << std::endl;
+
+  // The block sized changes may be done by shifting the extents of the file
+  // on file systems which support that.
+
+  const offset_t start = 1000;
+  const unsigned int sizes[] = { 10, 1000, 4096, 65536, 1 << 20 };
+
+  for(unsigned int size : sizes) {
+    const ByteVector data(size, 'x');
+
+    const Timer insertTimer;
+    stream.insert(data, start, 0);
+    report("insert", size, fileSize - start, insertTimer.milliseconds());
+
+    const Timer removeTimer;
+    stream.removeBlock(start, size);
+    report("removeBlock", size, fileSize - start, removeTimer.milliseconds());
+  }
+
+  for(unsigned int size : sizes) {
+    const ByteVector data(size, 'x');
+
+    const Timer insertTimer;
+    legacyInsert(stream, data, start);
+    report("legacy insert", size, fileSize - start, insertTimer.milliseconds());
+
+    const Timer removeTimer;
+    legacyRemove(stream, start, size);
+    report("legacy removeBlock", size, fileSize - start, removeTimer.milliseconds());
+  }
+
+  return stream.length() == fileSize ? 0 : 1;
+}
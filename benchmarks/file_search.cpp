@@ -0,0 +1,118 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+// Measures File::find() and File::rfind() on a large file, reporting how
+// many read calls were issued and how many bytes were actually read.
+//
+// Usage: file_search [size in MiB]
+
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#include "tfilestream.h"
+#include "benchmark.h"
+
+namespace
+{
+  const ByteVector marker("TAGLIB-MARKER");
+
+  struct BlockSizes
+  {
+    const char *name;
+    unsigned int initial;
+    unsigned int maximum;
+  };
+
+  void run(const char *description, CountingStream &stream, const BlockSizes &blockSizes,
+           offset_t (*search)(File &))
+  {
+    PlainFile file(&stream);
+    file.setSearchBlockSize(blockSizes.initial, blockSizes.maximum);
+
+    stream.reset();
+    const Timer timer;
+    const offset_t result = search(file);
+    const double ms = timer.milliseconds();
+
+    std::cout << std::left << std::setw(26) << description
+              << std::setw(14) << blockSizes.name << std::right
+              << std::setw(12) << result
+              << std::setw(10) << stream.reads + stream.positionalReads
+              << std::setw(14) << stream.bytesRead
+              << std::setw(10) << std::fixed << std::setprecision(2) << ms
+              << std::endl;
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  const unsigned long mebibytes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 64;
+  const offset_t fileSize = static_cast<offset_t>(mebibytes) << 20;
+
+  ScopedTempFile temp("file_search.bin");
+  {
+    std::ofstream out(temp.path, std::ios::binary);
+    const ByteVector chunk(1 << 20, '\0');
+    for(unsigned long i = 0; i < mebibytes; ++i)
+      out.write(chunk.data(), chunk.size());
+    out.seekp(1000);
+    out.write(marker.data(), marker.size());
+    out.seekp(fileSize - 1000);
+    out.write(marker.data(), marker.size());
+  }
+
+  FileStream fileStream(temp.path.c_str(), true);
+  CountingStream stream(&fileStream);
+
+  std::cout << "File size: " << fileSize << " bytes" << std::endl << std::endl
+            << std::left << std::setw(26) << "search"
+            << std::setw(14) << "blocks" << std::right
+            << std::setw(12) << "result"
+            << std::setw(10) << "reads"
+            << std::setw(14) << "bytes read"
+            << std::setw(10) << "ms" << std::endl;
+
+  const BlockSizes configurations[] = {
+    { "fixed 1 KiB", 1024, 1024 },
+    { "default", 1024, 64 * 1024 },
+    { "1 KiB..1 MiB", 1024, 1024 * 1024 }
+  };
+
+  for(const auto &blockSizes : configurations) {
+    run("find, marker at end", stream, blockSizes, [](File &file) {
+      return file.find(marker, 2000);
+    });
+    run("rfind, marker at start", stream, blockSizes, [](File &file) {
+      return file.rfind(marker, file.length() - 2000);
+    });
+    run("rfind, no match", stream, blockSizes, [](File &file) {
+      return file.rfind("NOT-IN-THE-FILE");
+    });
+  }
+
+  return 0;
+}
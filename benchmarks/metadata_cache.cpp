@@ -0,0 +1,130 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+// Reads the metadata of all files in a directory, e.g. tests/data, with
+// FileRef::readMany(), once without a MetadataCache, once filling an empty
+// cache and then several times with the filled cache after reopening it.
+// Also measures how long it takes to validate the cache.
+//
+// Usage: metadata_cache directory [passes]
+
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "fileref.h"
+#include "metadatacache.h"
+#include "benchmark.h"
+
+namespace
+{
+  void report(const std::string &description, size_t files, unsigned int read, double ms)
+  {
+    std::cout << std::left << std::setw(24) << description << std::right
+              << std::setw(10) << files
+              << std::setw(10) << read
+              << std::setw(12) << std::fixed << std::setprecision(1) << ms
+              << std::setw(14) << std::setprecision(0) << files * 1000.0 / ms
+              << std::endl;
+  }
+
+  unsigned int readMany(const List<FileName> &fileNames, MetadataCache *cache)
+  {
+    unsigned int read = 0;
+    FileRef::readMany(fileNames, [&read](const FileRef::BatchResult &result) {
+      if(result.status == FileRef::BatchResult::Read)
+        ++read;
+    }, 0, true, AudioProperties::Average, cache);
+    return read;
+  }
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+  if(argc < 2) {
+    std::cerr << "Usage: metadata_cache directory [passes]" << std::endl;
+    return 1;
+  }
+
+  const int passes = argc > 2 ? std::max(std::atoi(argv[2]), 1) : 10;
+
+  std::vector<std::string> paths;
+  for(const auto &entry : std::filesystem::recursive_directory_iterator(argv[1])) {
+    if(entry.is_regular_file())
+      paths.push_back(entry.path().string());
+  }
+
+  List<FileName> fileNames;
+  for(const auto &path : paths)
+    fileNames.append(path.c_str());
+
+  const ScopedTempFile cacheFile("metadata-cache");
+  std::remove(cacheFile.path.c_str());
+
+  std::cout << std::left << std::setw(24) << "method" << std::right
+            << std::setw(10) << "files"
+            << std::setw(10) << "read"
+            << std::setw(12) << "ms"
+            << std::setw(14) << "files/s" << std::endl;
+
+  {
+    const Timer timer;
+    const unsigned int read = readMany(fileNames, nullptr);
+    report("no cache", fileNames.size(), read, timer.milliseconds());
+  }
+  {
+    const Timer timer;
+    MetadataCache cache(cacheFile.path.c_str());
+    const unsigned int read = readMany(fileNames, &cache);
+    cache.flush();
+    report("empty cache", fileNames.size(), read, timer.milliseconds());
+  }
+  {
+    const Timer timer;
+    const MetadataCache cache(cacheFile.path.c_str());
+    report("open cache", cache.size(), cache.size(), timer.milliseconds());
+  }
+
+  MetadataCache cache(cacheFile.path.c_str());
+  {
+    unsigned int read = 0;
+    const Timer timer;
+    for(int pass = 0; pass < passes; ++pass)
+      read += readMany(fileNames, &cache);
+    report("filled cache", fileNames.size() * passes, read, timer.milliseconds());
+  }
+  {
+    unsigned int changed = 0;
+    const Timer timer;
+    for(int pass = 0; pass < passes; ++pass)
+      changed += cache.validate(fileNames).size();
+    report("validate", fileNames.size() * passes, changed, timer.milliseconds());
+  }
+
+  return 0;
+}
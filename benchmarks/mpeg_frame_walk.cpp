@@ -0,0 +1,121 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+// Measures reading the audio properties of a large VBR MP3 without a Xing
+// header with each read style.  The accurate read style walks all frames,
+// on one thread and on one thread per core, its throughput is reported in
+// GB/s.
+//
+// Usage: mpeg_frame_walk [size in MiB]
+
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#include "tfilestream.h"
+#include "fileref.h"
+#include "benchmark.h"
+
+namespace
+{
+  // The length of an MPEG-1 Layer 3 frame at 44.1 kHz without padding.
+  unsigned int frameLength(unsigned int bitrateIndex)
+  {
+    static constexpr unsigned int bitrates[] = {
+      0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320
+    };
+    return 1152 * bitrates[bitrateIndex] * 125 / 44100;
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  const unsigned long mebibytes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 64;
+  const unsigned long long fileSize = static_cast<unsigned long long>(mebibytes) << 20;
+
+  // Frames with bitrates from 128 to 320 kb/s and silent payloads.
+
+  ScopedTempFile temp("mpeg_frame_walk.mp3");
+  unsigned long long frames = 0;
+  {
+    std::ofstream out(temp.path, std::ios::binary);
+    unsigned long long written = 0;
+    while(written < fileSize) {
+      const unsigned int bitrateIndex = 9 + frames % 6;
+      ByteVector frame(frameLength(bitrateIndex), '\0');
+      frame[0] = '\xFF';
+      frame[1] = '\xFB';
+      frame[2] = static_cast<char>(bitrateIndex << 4);
+      out.write(frame.data(), frame.size());
+      written += frame.size();
+      ++frames;
+    }
+  }
+
+  std::cout << "File size: " << mebibytes << " MiB, " << frames << " frames, "
+            << "exact length: " << frames * 1152 * 1000 / 44100 << " ms"
+            << std::endl << std::endl
+            << std::left << std::setw(20) << "read style" << std::right
+            << std::setw(12) << "length ms"
+            << std::setw(10) << "kb/s"
+            << std::setw(12) << "time ms"
+            << std::setw(10) << "GB/s" << std::endl;
+
+  // Frames are only counted on several threads if the stream supports
+  // concurrent reads, which a FileStream does if it is opened read only.
+
+  struct Run
+  {
+    const char *name;
+    AudioProperties::ReadStyle style;
+    bool readOnly;
+  };
+
+  const Run runs[] = {
+    { "fast", AudioProperties::Fast, true },
+    { "average", AudioProperties::Average, true },
+    { "accurate, 1 thread", AudioProperties::Accurate, false },
+    { "accurate", AudioProperties::Accurate, true }
+  };
+
+  for(const auto &run : runs) {
+    FileStream stream(temp.path.c_str(), run.readOnly);
+
+    const Timer timer;
+    const FileRef f(&stream, true, run.style);
+    const double ms = timer.milliseconds();
+
+    const AudioProperties *properties = f.audioProperties();
+    std::cout << std::left << std::setw(20) << run.name << std::right
+              << std::setw(12) << (properties ? properties->lengthInMilliseconds() : 0)
+              << std::setw(10) << (properties ? properties->bitrate() : 0)
+              << std::setw(12) << std::fixed << std::setprecision(2) << ms
+              << std::setw(10) << static_cast<double>(fileSize) / ms / 1e6
+              << std::endl;
+  }
+
+  return 0;
+}
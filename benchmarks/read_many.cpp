@@ -0,0 +1,116 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+// Reads the metadata of all files in a directory, e.g. tests/data, several
+// times, once with a FileRef per file and once with FileRef::readMany() for
+// 1, 2, 4, ... threads up to the number of cores or the given maximum.
+//
+// Usage: read_many directory [passes] [maximum threads]
+
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "fileref.h"
+#include "benchmark.h"
+
+namespace
+{
+  void report(const std::string &description, size_t files, unsigned int read, double ms)
+  {
+    std::cout << std::left << std::setw(24) << description << std::right
+              << std::setw(10) << files
+              << std::setw(10) << read
+              << std::setw(12) << std::fixed << std::setprecision(1) << ms
+              << std::setw(14) << std::setprecision(0) << files * 1000.0 / ms
+              << std::endl;
+  }
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+  if(argc < 2) {
+    std::cerr << "Usage: read_many directory [passes] [maximum threads]" << std::endl;
+    return 1;
+  }
+
+  const int passes = argc > 2 ? std::max(std::atoi(argv[2]), 1) : 10;
+
+  std::vector<std::string> paths;
+  for(const auto &entry : std::filesystem::recursive_directory_iterator(argv[1])) {
+    if(entry.is_regular_file())
+      paths.push_back(entry.path().string());
+  }
+
+  List<FileName> fileNames;
+  for(int pass = 0; pass < passes; ++pass) {
+    for(const auto &path : paths)
+      fileNames.append(path.c_str());
+  }
+
+  std::cout << std::left << std::setw(24) << "method" << std::right
+            << std::setw(10) << "files"
+            << std::setw(10) << "read"
+            << std::setw(12) << "ms"
+            << std::setw(14) << "files/s" << std::endl;
+
+  {
+    unsigned int read = 0;
+    const Timer timer;
+    for(const auto &fileName : fileNames) {
+      const FileRef f(fileName);
+      if(!f.isNull()) {
+        f.properties();
+        f.complexPropertyKeys();
+        ++read;
+      }
+    }
+    report("FileRef", fileNames.size(), read, timer.milliseconds());
+  }
+
+  const unsigned int maximumThreads = argc > 3
+    ? std::max(std::atoi(argv[3]), 1) : std::max(std::thread::hardware_concurrency(), 1U);
+  for(unsigned int threads = 1; ; threads *= 2) {
+    threads = std::min(threads, maximumThreads);
+
+    unsigned int read = 0;
+    const Timer timer;
+    FileRef::readMany(fileNames, [&read](const FileRef::BatchResult &result) {
+      if(result.status == FileRef::BatchResult::Read)
+        ++read;
+    }, threads);
+    report("readMany, " + std::to_string(threads) + " threads",
+           fileNames.size(), read, timer.milliseconds());
+
+    if(threads == maximumThreads)
+      break;
+  }
+
+  return 0;
+}
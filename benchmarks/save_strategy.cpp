@@ -0,0 +1,90 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+// Measures saving a tag which grows by different sizes to a large MP3 file,
+// changing the file in place and rewriting it to a temporary file.
+//
+// Usage: save_strategy [size in MiB]
+
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "fileref.h"
+#include "tag.h"
+#include "benchmark.h"
+
+namespace
+{
+  // MPEG-1 Layer III, 128 kbit/s, 44.1 kHz, 417 bytes per frame
+  const ByteVector frameHeader("\xFF\xFB\x90\x64", 4);
+  constexpr unsigned int frameLength = 417;
+
+  double save(const std::string &path, File::SaveStrategy strategy, unsigned int size)
+  {
+    FileRef f(path.c_str());
+    f.file()->setSaveStrategy(strategy);
+    f.tag()->setComment(String(std::string(size, 'x')));
+
+    const Timer timer;
+    if(!f.save())
+      std::cerr << "Saving " << path << " failed" << std::endl;
+    return timer.milliseconds();
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  const unsigned long mebibytes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 256;
+
+  ScopedTempFile temp("save_strategy.mp3");
+  {
+    ByteVector frame = frameHeader;
+    frame.resize(frameLength, '\0');
+
+    std::ofstream out(temp.path, std::ios::binary);
+    for(unsigned long i = 0; i < (mebibytes << 20) / frameLength; ++i)
+      out.write(frame.data(), frame.size());
+  }
+
+  std::cout << "File size: " << (mebibytes << 20) << " bytes" << std::endl << std::endl
+            << std::setw(12) << "tag bytes"
+            << std::setw(14) << "in place ms"
+            << std::setw(14) << "rewrite ms" << std::endl;
+
+  // The tag grows with each save, so that the audio data has to be moved.
+
+  for(unsigned int size = 1000; size <= 1000000; size *= 10) {
+    const double inPlace = save(temp.path, File::InPlace, size);
+    const double rewrite = save(temp.path, File::Rewrite, size * 2);
+
+    std::cout << std::setw(12) << size
+              << std::setw(14) << std::fixed << std::setprecision(2) << inPlace
+              << std::setw(14) << rewrite << std::endl;
+  }
+
+  return 0;
+}
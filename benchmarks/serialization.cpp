@@ -0,0 +1,155 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+// Measures the throughput of serializing and deserializing a typical
+// PropertyMap and the complex properties of a picture, compared with
+// writing the same data as JSON using the output operator of Variant.
+//
+// Usage: serialization [iterations]
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "tpropertymap.h"
+#include "tvariant.h"
+#include "tbytevectorlist.h"
+#include "benchmark.h"
+
+namespace
+{
+  void report(const std::string &description, int iterations, size_t bytes, double ms)
+  {
+    std::cout << std::left << std::setw(32) << description << std::right
+              << std::setw(10) << bytes
+              << std::setw(12) << std::fixed << std::setprecision(1) << ms
+              << std::setw(14) << std::setprecision(0) << iterations * 1000.0 / ms
+              << std::setw(12) << std::setprecision(1)
+              << iterations * static_cast<double>(bytes) / 1000.0 / ms << std::endl;
+  }
+
+  PropertyMap properties()
+  {
+    PropertyMap map;
+    map["TITLE"] = String("A Title of Average Length");
+    map["ARTIST"] = StringList {"First Artist", "Second Artist"};
+    map["ALBUM"] = String("Album");
+    map["ALBUMARTIST"] = String("Album Artist");
+    map["DATE"] = String("2026");
+    map["TRACKNUMBER"] = String("7/12");
+    map["GENRE"] = String("Genre");
+    map["COMMENT"] = String("A longer comment, which spans a few words");
+    map["MUSICBRAINZ_TRACKID"] = String("3a1a8a6d-bc7f-45e0-a2c4-d45bcf5d9c0a");
+    map["REPLAYGAIN_TRACK_GAIN"] = String("-6.54 dB");
+    return map;
+  }
+
+  Variant picture()
+  {
+    return VariantList {
+      VariantMap {
+        {"data", ByteVector(64 * 1024, 'x')},
+        {"mimeType", "image/jpeg"},
+        {"description", "Front Cover"},
+        {"pictureType", "Front Cover"},
+        {"width", 500},
+        {"height", 500}
+      }
+    };
+  }
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+  const int iterations = argc > 1 ? std::max(std::atoi(argv[1]), 1) : 100000;
+
+  std::cout << std::left << std::setw(32) << "method" << std::right
+            << std::setw(10) << "bytes"
+            << std::setw(12) << "ms"
+            << std::setw(14) << "ops/s"
+            << std::setw(12) << "MB/s" << std::endl;
+
+  const PropertyMap map = properties();
+  VariantMap mapVariant;
+  for(const auto &[key, values] : map)
+    mapVariant.insert(key, values);
+
+  const ByteVector mapData = map.serialize();
+  {
+    size_t bytes = 0;
+    const Timer timer;
+    for(int i = 0; i < iterations; ++i) {
+      std::ostringstream s;
+      s << Variant(mapVariant);
+      bytes = s.str().size();
+    }
+    report("PropertyMap as JSON", iterations, bytes, timer.milliseconds());
+  }
+  {
+    const Timer timer;
+    for(int i = 0; i < iterations; ++i)
+      map.serialize();
+    report("PropertyMap::serialize()", iterations, mapData.size(), timer.milliseconds());
+  }
+  {
+    const Timer timer;
+    for(int i = 0; i < iterations; ++i)
+      PropertyMap::deserialize(mapData);
+    report("PropertyMap::deserialize()", iterations, mapData.size(), timer.milliseconds());
+  }
+
+  // Pictures are larger, so fewer iterations are needed.
+
+  const int pictureIterations = std::max(iterations / 100, 1);
+  const Variant pictures = picture();
+  const ByteVector pictureData = pictures.serialize();
+  {
+    size_t bytes = 0;
+    const Timer timer;
+    for(int i = 0; i < pictureIterations; ++i) {
+      std::ostringstream s;
+      s << pictures;
+      bytes = s.str().size();
+    }
+    report("picture as JSON", pictureIterations, bytes, timer.milliseconds());
+  }
+  {
+    const Timer timer;
+    for(int i = 0; i < pictureIterations; ++i)
+      pictures.serialize();
+    report("Variant::serialize()", pictureIterations, pictureData.size(), timer.milliseconds());
+  }
+  {
+    const Timer timer;
+    for(int i = 0; i < pictureIterations; ++i)
+      Variant::deserialize(pictureData);
+    report("Variant::deserialize()", pictureIterations, pictureData.size(),
+           timer.milliseconds());
+  }
+
+  return 0;
+}
@@ -0,0 +1,106 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+// Counts the stream calls which are needed to read the tags and the audio
+// properties of the given files.  Each call to a FileStream is at least one
+// system call.  Each file is read a second time through a CachedIOStream,
+// which shows the calls that still reach the file, a third time with
+// deferred payloads, which leaves large pictures in the file, and a fourth
+// time through a PrefetchIOStream, which fetches the head and the tail of
+// the file in one batch.  The requests column adds up all calls which would
+// be round trips to remote storage.
+//
+// Usage: stream_calls file...
+
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "tfilestream.h"
+#include "tcachediostream.h"
+#include "tprefetchiostream.h"
+#include "fileref.h"
+#include "benchmark.h"
+
+namespace
+{
+  enum Mode { Direct, Cached, Prefetched };
+
+  void run(const std::string &description, IOStream *fileStream, Mode mode,
+           File::PayloadStyle payloadStyle = File::ReadPayloads)
+  {
+    CountingStream stream(fileStream);
+
+    const Timer timer;
+    std::unique_ptr<IOStream> wrapper;
+    if(mode == Cached)
+      wrapper = std::make_unique<CachedIOStream>(&stream);
+    else if(mode == Prefetched)
+      wrapper = std::make_unique<PrefetchIOStream>(&stream);
+    const FileRef file(wrapper ? wrapper.get() : &stream,
+                       true, AudioProperties::Average, payloadStyle);
+    const double ms = timer.milliseconds();
+
+    std::cout << std::left << std::setw(40) << description << std::right
+              << std::setw(8) << stream.seeks
+              << std::setw(8) << stream.reads
+              << std::setw(12) << stream.positionalReads
+              << std::setw(10) << stream.batchReads
+              << std::setw(10) << stream.reads + stream.positionalReads + stream.batchReads
+              << std::setw(12) << stream.bytesRead
+              << std::setw(10) << std::fixed << std::setprecision(3) << ms
+              << (file.isNull() ? "  (not supported)" : "")
+              << std::endl;
+  }
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+  std::cout << std::left << std::setw(40) << "file" << std::right
+            << std::setw(8) << "seeks"
+            << std::setw(8) << "reads"
+            << std::setw(12) << "pos. reads"
+            << std::setw(10) << "batches"
+            << std::setw(10) << "requests"
+            << std::setw(12) << "bytes read"
+            << std::setw(10) << "ms" << std::endl;
+
+  for(int i = 1; i < argc; ++i) {
+    FileStream fileStream(argv[i], true);
+    if(!fileStream.isOpen())
+      continue;
+
+    run(argv[i], &fileStream, Direct);
+    fileStream.seek(0);
+    run(std::string(argv[i]) + " (cached)", &fileStream, Cached);
+    fileStream.seek(0);
+    run(std::string(argv[i]) + " (deferred)", &fileStream, Direct, File::DeferPayloads);
+    fileStream.seek(0);
+    run(std::string(argv[i]) + " (prefetched)", &fileStream, Prefetched);
+  }
+
+  return 0;
+}
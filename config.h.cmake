@@ -13,6 +13,21 @@
 /* Defined if your compiler supports ISO _strdup */
 #cmakedefine   HAVE_ISO_STRDUP 1
 
+/* Defined if your system supports mmap() */
+#cmakedefine   HAVE_MMAP 1
+
+/* Defined if your system supports inserting and collapsing file ranges */
+#cmakedefine   HAVE_FALLOCATE_RANGE 1
+
+/* Defined if your system supports copy_file_range() */
+#cmakedefine   HAVE_COPY_FILE_RANGE 1
+
+/* Defined if your system supports reading through io_uring */
+#cmakedefine   HAVE_IO_URING 1
+
+/* Defined if stat() returns the modification time in nanoseconds */
+#cmakedefine   HAVE_STAT_MTIM 1
+
 /* Defined if zlib is installed */
 #cmakedefine   HAVE_ZLIB 1
 
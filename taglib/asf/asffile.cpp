@@ -25,6 +25,7 @@
 
 #include "asffile.h"
 
+#include <functional>
 #include <utility>
 
 #include "tdebug.h"
@@ -62,6 +63,7 @@ public:
   FilePrivate &operator=(const FilePrivate &) = delete;
 
   unsigned long long headerSize { 0 };
+  Properties::ReadStyle readStyle { Properties::Average };
 
   std::unique_ptr<ASF::Tag> tag;
   std::unique_ptr<ASF::Properties> properties;
@@ -104,9 +106,12 @@ public:
 class ASF::File::FilePrivate::UnknownObject : public ASF::File::FilePrivate::BaseObject
 {
   ByteVector myGuid;
+  std::function<ByteVector()> readData;
 public:
   UnknownObject(const ByteVector &guid);
   ByteVector guid() const override;
+  void parse(ASF::File *file, long long size) override;
+  ByteVector render(ASF::File *file) override;
 };
 
 class ASF::File::FilePrivate::FilePropertiesObject : public ASF::File::FilePrivate::BaseObject
@@ -206,6 +211,30 @@ ByteVector ASF::File::FilePrivate::UnknownObject::guid() const
   return myGuid;
 }
 
+void ASF::File::FilePrivate::UnknownObject::parse(ASF::File *file, long long size)
+{
+  // With the Fast read style, the data of objects which are not used, e.g.
+  // padding or index parameters, is only read when the file is saved.
+
+  if(file->d->readStyle == Properties::Fast && size > 24 && size <= file->length()) {
+    data.clear();
+    readData = file->deferredReadBlock(file->tell(), static_cast<size_t>(size - 24));
+    file->seek(size - 24, File::Current);
+    return;
+  }
+
+  BaseObject::parse(file, size);
+}
+
+ByteVector ASF::File::FilePrivate::UnknownObject::render(ASF::File *file)
+{
+  if(readData) {
+    data = readData();
+    readData = nullptr;
+  }
+  return BaseObject::render(file);
+}
+
 ByteVector ASF::File::FilePrivate::FilePropertiesObject::guid() const
 {
   return filePropertiesGuid;
@@ -480,18 +509,20 @@ bool ASF::File::isSupported(IOStream *stream)
 // public members
 ////////////////////////////////////////////////////////////////////////////////
 
-ASF::File::File(FileName file, bool, Properties::ReadStyle) :
+ASF::File::File(FileName file, bool, Properties::ReadStyle propertiesStyle) :
   TagLib::File(file),
   d(std::make_unique<FilePrivate>())
 {
+  d->readStyle = propertiesStyle;
   if(isOpen())
     read();
 }
 
-ASF::File::File(IOStream *stream, bool, Properties::ReadStyle) :
+ASF::File::File(IOStream *stream, bool, Properties::ReadStyle propertiesStyle) :
   TagLib::File(stream),
   d(std::make_unique<FilePrivate>())
 {
+  d->readStyle = propertiesStyle;
   if(isOpen())
     read();
 }
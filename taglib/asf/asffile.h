@@ -50,9 +50,12 @@ namespace TagLib {
       /*!
        * Constructs an ASF file from \a file.
        *
-       * \note In the current implementation, both \a readProperties and
-       * \a propertiesStyle are ignored.  The audio properties are always
-       * read.
+       * With the Fast \a propertiesStyle, the header objects which are not
+       * used for the tag or the audio properties are only read when the file
+       * is saved.
+       *
+       * \note In the current implementation, \a readProperties is ignored.
+       * The audio properties are always read.
        */
       File(FileName file, bool readProperties = true,
            Properties::ReadStyle propertiesStyle = Properties::Average);
@@ -60,9 +63,12 @@ namespace TagLib {
       /*!
        * Constructs an ASF file from \a stream.
        *
-       * \note In the current implementation, both \a readProperties and
-       * \a propertiesStyle are ignored.  The audio properties are always
-       * read.
+       * With the Fast \a propertiesStyle, the header objects which are not
+       * used for the tag or the audio properties are only read when the file
+       * is saved.
+       *
+       * \note In the current implementation, \a readProperties is ignored.
+       * The audio properties are always read.
        *
        * \note TagLib will *not* take ownership of the stream, the caller is
        * responsible for deleting it after the File object.
@@ -341,12 +341,13 @@ void ASF::Tag::removeUnsupportedProperties(const StringList &props)
 
 PropertyMap ASF::Tag::setProperties(const PropertyMap &props)
 {
-  static Map<String, String> reverseKeyMap;
-  if(reverseKeyMap.isEmpty()) {
+  static const Map<String, String> reverseKeyMap = [] {
+    Map<String, String> m;
     for(const auto &[k, t] : keyTranslation) {
-      reverseKeyMap[t] = k;
+      m[t] = k;
     }
-  }
+    return m;
+  }();
 
   const PropertyMap origProps = properties();
   for(const auto &[prop, _] : origProps) {
@@ -364,7 +365,7 @@ PropertyMap ASF::Tag::setProperties(const PropertyMap &props)
         d->copyright.clear();
       }
       else {
-        d->attributeListMap.erase(reverseKeyMap[prop]);
+        d->attributeListMap.erase(reverseKeyMap.value(prop));
       }
     }
   }
@@ -372,7 +373,7 @@ PropertyMap ASF::Tag::setProperties(const PropertyMap &props)
   PropertyMap ignoredProps;
   for(const auto &[prop, attributes] : props) {
     if(reverseKeyMap.contains(prop)) {
-      String name = reverseKeyMap[prop];
+      String name = reverseKeyMap.value(prop);
       removeItem(name);
       for(const auto &attr : attributes) {
         addAttribute(name, attr);
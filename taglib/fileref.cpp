@@ -29,15 +29,33 @@
 
 #include "fileref.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
 #include <utility>
+#include <vector>
+
+#ifdef _WIN32
+# include <io.h>
+#else
+# include <unistd.h>
+#endif
 
 #include "taglib_config.h"
+#include "metadatacache.h"
 #include "tfilestream.h"
 #include "tpropertymap.h"
 #include "tstringlist.h"
 #include "tvariant.h"
 #include "tdebug.h"
+#include "filetypes.h"
 #include "mpegfile.h"
 #ifdef TAGLIB_WITH_RIFF
 #include "aifffile.h"
@@ -90,11 +108,94 @@ class FileRef::StreamTypeResolver::StreamTypeResolverPrivate
 
 namespace
 {
-  List<const FileRef::FileTypeResolver *> fileTypeResolvers;
+  // A resolver with its filters, which are queried once when it is added.
 
-  // Detect the file type by user-defined resolvers.
+  struct RegisteredResolver
+  {
+    const FileRef::FileTypeResolver *resolver;
+    // The resolver if it is also a stream resolver, else nullptr
+    const FileRef::StreamTypeResolver *streamResolver;
+    // The extensions in ASCII lowercase, empty for all files
+    std::vector<std::string> extensions;
+    List<FileRef::ResolverFilter::Signature> signatures;
+  };
+
+  List<RegisteredResolver> fileTypeResolvers;
+  std::mutex fileTypeResolversMutex;
 
-  File *detectByResolvers(FileName fileName, bool readAudioProperties,
+  // Returns the resolvers.  The list is implicitly shared, so the copy is not
+  // affected if resolvers are added or removed in another thread.
+
+  List<RegisteredResolver> currentFileTypeResolvers()
+  {
+    std::lock_guard<std::mutex> lock(fileTypeResolversMutex);
+    return fileTypeResolvers;
+  }
+
+  using Candidates = std::vector<const RegisteredResolver *>;
+
+  // Returns the resolvers whose extensions accept a file with the extension
+  // \a key, only the stream resolvers if \a streamResolvers is true.
+
+  Candidates candidates(const List<RegisteredResolver> &resolvers,
+                        const std::string &key, bool streamResolvers)
+  {
+    Candidates result;
+    for(const auto &resolver : resolvers) {
+      if(streamResolvers && !resolver.streamResolver)
+        continue;
+      if(!resolver.extensions.empty() &&
+         std::find(resolver.extensions.begin(), resolver.extensions.end(), key) ==
+           resolver.extensions.end())
+        continue;
+      result.push_back(&resolver);
+    }
+    return result;
+  }
+
+  // The beginning of a stream, which is read once and shared by the
+  // signatures of the resolvers and the detection by content.
+
+  class StreamHeader
+  {
+  public:
+    const ByteVector &data(IOStream *stream)
+    {
+      if(!read) {
+        if(stream->isOpen()) {
+          const offset_t position = stream->tell();
+          header = stream->readBlockAt(0, FileTypes::HeaderLength);
+          stream->seek(position);
+        }
+        read = true;
+      }
+      return header;
+    }
+
+  private:
+    ByteVector header;
+    bool read { false };
+  };
+
+  bool matchesSignatures(const RegisteredResolver &resolver,
+                         const std::function<const ByteVector &()> &header)
+  {
+    if(resolver.signatures.isEmpty())
+      return true;
+
+    const ByteVector &data = header();
+    return std::any_of(resolver.signatures.begin(), resolver.signatures.end(),
+                       [&data](const FileRef::ResolverFilter::Signature &signature) {
+      return data.containsAt(signature.pattern, signature.offset);
+    });
+  }
+
+  // Detect the file type by user-defined resolvers.  Resolvers with
+  // signatures are only called if one of them is found in the header.
+
+  File *detectByResolvers(FileName fileName, const Candidates &resolvers,
+                          const std::function<const ByteVector &()> &header,
+                          bool readAudioProperties,
                           AudioProperties::ReadStyle audioPropertiesStyle)
   {
 #ifdef _WIN32
@@ -104,8 +205,11 @@ namespace
     if(::strlen(fileName) == 0)
       return nullptr;
 #endif
-    for(const auto &resolver : std::as_const(fileTypeResolvers)) {
-      File *file = resolver->createFile(fileName, readAudioProperties, audioPropertiesStyle);
+    for(const auto resolver : resolvers) {
+      if(!matchesSignatures(*resolver, header))
+        continue;
+      File *file = resolver->resolver->createFile(fileName, readAudioProperties,
+                                                  audioPropertiesStyle);
       if(file)
         return file;
     }
@@ -113,113 +217,229 @@ namespace
     return nullptr;
   }
 
-  File *detectByResolvers(IOStream* stream, bool readAudioProperties,
+  File *detectByResolvers(IOStream* stream, const Candidates &resolvers,
+                          const std::function<const ByteVector &()> &header,
+                          bool readAudioProperties,
                           AudioProperties::ReadStyle audioPropertiesStyle)
   {
-    for(const auto &resolver : std::as_const(fileTypeResolvers)) {
-      if(auto streamResolver = dynamic_cast<const FileRef::StreamTypeResolver *>(resolver)) {
-        if(File *file = streamResolver->createFileFromStream(
-             stream, readAudioProperties, audioPropertiesStyle))
-          return file;
-      }
+    for(const auto resolver : resolvers) {
+      if(!matchesSignatures(*resolver, header))
+        continue;
+      if(File *file = resolver->streamResolver->createFileFromStream(
+           stream, readAudioProperties, audioPropertiesStyle))
+        return file;
     }
 
     return nullptr;
   }
 
-  // Detect the file type based on the file extension.
-
-  File* detectByExtension(IOStream *stream, bool readAudioProperties,
-                          AudioProperties::ReadStyle audioPropertiesStyle)
-  {
-#ifdef _WIN32
-    const String s = stream->name().toString();
-#else
-    const String s(stream->name());
-#endif
-
-    String ext;
-    if(const int pos = s.rfind("."); pos != -1)
-      ext = s.substr(pos + 1).upper();
+  // The default file types by extension.  defaultFileExtensions() returns
+  // the extensions in this order.
 
-    // If this list is updated, the method defaultFileExtensions() should also be
-    // updated.  However at some point that list should be created at the same time
-    // that a default file type resolver is created.
+  using Factory = File *(*)(IOStream *stream, bool readAudioProperties,
+                            AudioProperties::ReadStyle audioPropertiesStyle,
+                            File::PayloadStyle payloadStyle);
 
-    if(ext.isEmpty())
-      return nullptr;
+  template <typename T>
+  File *create(IOStream *stream, bool readAudioProperties,
+               AudioProperties::ReadStyle audioPropertiesStyle, File::PayloadStyle)
+  {
+    return new T(stream, readAudioProperties, audioPropertiesStyle);
+  }
 
-    // .oga can be any audio in the Ogg container. So leave it to content-based detection.
+  // Files which can defer their payloads.
 
-    File *file = nullptr;
+  template <typename T>
+  File *createWithPayloadStyle(IOStream *stream, bool readAudioProperties,
+                               AudioProperties::ReadStyle audioPropertiesStyle,
+                               File::PayloadStyle payloadStyle)
+  {
+    return new T(stream, readAudioProperties, audioPropertiesStyle, nullptr, payloadStyle);
+  }
 
-    if(ext == "MP3" || ext == "MP2" || ext == "AAC")
-      file = new MPEG::File(stream, readAudioProperties, audioPropertiesStyle);
 #ifdef TAGLIB_WITH_VORBIS
-    else if(ext == "OGG")
+  // .oga can be any audio in the Ogg container.  First try FLAC, then Vorbis.
+
+  File *createOggAudio(IOStream *stream, bool readAudioProperties,
+                       AudioProperties::ReadStyle audioPropertiesStyle, File::PayloadStyle)
+  {
+    File *file = new Ogg::FLAC::File(stream, readAudioProperties, audioPropertiesStyle);
+    if(!file->isValid()) {
+      delete file;
       file = new Ogg::Vorbis::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(ext == "OGA") {
-      /* .oga can be any audio in the Ogg container. First try FLAC, then Vorbis. */
-      file = new Ogg::FLAC::File(stream, readAudioProperties, audioPropertiesStyle);
-      if(!file->isValid()) {
-        delete file;
-        file = new Ogg::Vorbis::File(stream, readAudioProperties, audioPropertiesStyle);
-      }
     }
-    else if(ext == "FLAC")
-      file = new FLAC::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(ext == "SPX")
-      file = new Ogg::Speex::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(ext == "OPUS")
-      file = new Ogg::Opus::File(stream, readAudioProperties, audioPropertiesStyle);
+    return file;
+  }
+#endif
+
+  struct Extension
+  {
+    const char *name;
+    Factory factory;
+  };
+
+  constexpr Extension extensions[] = {
+    { "mp3", createWithPayloadStyle<MPEG::File> },
+    { "mp2", createWithPayloadStyle<MPEG::File> },
+    { "aac", createWithPayloadStyle<MPEG::File> },
+#ifdef TAGLIB_WITH_VORBIS
+    { "ogg", create<Ogg::Vorbis::File> },
+    { "flac", createWithPayloadStyle<FLAC::File> },
+    { "oga", createOggAudio },
+    { "opus", create<Ogg::Opus::File> },
+    { "spx", create<Ogg::Speex::File> },
 #endif
 #ifdef TAGLIB_WITH_APE
-    else if(ext == "MPC")
-      file = new MPC::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(ext == "WV")
-      file = new WavPack::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(ext == "APE")
-      file = new APE::File(stream, readAudioProperties, audioPropertiesStyle);
+    { "mpc", create<MPC::File> },
+    { "wv", create<WavPack::File> },
+    { "ape", create<APE::File> },
 #endif
 #ifdef TAGLIB_WITH_TRUEAUDIO
-    else if(ext == "TTA")
-      file = new TrueAudio::File(stream, readAudioProperties, audioPropertiesStyle);
+    { "tta", create<TrueAudio::File> },
 #endif
 #ifdef TAGLIB_WITH_MP4
-    else if(ext == "M4A" || ext == "M4R" || ext == "M4B" || ext == "M4P" || ext == "MP4" || ext == "3G2" || ext == "M4V")
-      file = new MP4::File(stream, readAudioProperties, audioPropertiesStyle);
+    { "m4a", create<MP4::File> },
+    { "m4r", create<MP4::File> },
+    { "m4b", create<MP4::File> },
+    { "m4p", create<MP4::File> },
+    { "3g2", create<MP4::File> },
+    { "mp4", create<MP4::File> },
+    { "m4v", create<MP4::File> },
 #endif
 #ifdef TAGLIB_WITH_ASF
-    else if(ext == "WMA" || ext == "ASF")
-      file = new ASF::File(stream, readAudioProperties, audioPropertiesStyle);
+    { "wma", create<ASF::File> },
+    { "asf", create<ASF::File> },
 #endif
 #ifdef TAGLIB_WITH_RIFF
-    else if(ext == "AIF" || ext == "AIFF" || ext == "AFC" || ext == "AIFC")
-      file = new RIFF::AIFF::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(ext == "WAV")
-      file = new RIFF::WAV::File(stream, readAudioProperties, audioPropertiesStyle);
+    { "aif", create<RIFF::AIFF::File> },
+    { "aiff", create<RIFF::AIFF::File> },
+    { "afc", create<RIFF::AIFF::File> },
+    { "aifc", create<RIFF::AIFF::File> },
+    { "wav", create<RIFF::WAV::File> },
 #endif
 #ifdef TAGLIB_WITH_MOD
+    { "mod", create<Mod::File> },
     // module, nst and wow are possible but uncommon extensions
-    else if(ext == "MOD" || ext == "MODULE" || ext == "NST" || ext == "WOW")
-      file = new Mod::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(ext == "S3M")
-      file = new S3M::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(ext == "IT")
-      file = new IT::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(ext == "XM")
-      file = new XM::File(stream, readAudioProperties, audioPropertiesStyle);
+    { "module", create<Mod::File> },
+    { "nst", create<Mod::File> },
+    { "wow", create<Mod::File> },
+    { "s3m", create<S3M::File> },
+    { "it", create<IT::File> },
+    { "xm", create<XM::File> },
 #endif
 #ifdef TAGLIB_WITH_DSF
-    else if(ext == "DSF")
-      file = new DSF::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(ext == "DFF" || ext == "DSDIFF")
-      file = new DSDIFF::File(stream, readAudioProperties, audioPropertiesStyle);
+    { "dsf", create<DSF::File> },
+    { "dff", create<DSDIFF::File> },
+    { "dsdiff", create<DSDIFF::File> }, // alias for "dff"
 #endif
 #ifdef TAGLIB_WITH_SHORTEN
-    else if(ext == "SHN")
-      file = new Shorten::File(stream, readAudioProperties, audioPropertiesStyle);
+    { "shn", create<Shorten::File> },
 #endif
+  };
+
+  const std::unordered_map<std::string, Factory> &defaultFactories()
+  {
+    static const std::unordered_map<std::string, Factory> factories = [] {
+      std::unordered_map<std::string, Factory> result;
+      for(const auto &extension : extensions)
+        result.emplace(extension.name, extension.factory);
+      return result;
+    }();
+    return factories;
+  }
+
+  // The extensions added with FileRef::addFileExtension().  The flag saves
+  // taking the lock as long as there are none.
+
+  std::unordered_map<std::string, FileRef::FileFactory> customFactories;
+  std::atomic<bool> hasCustomFactories(false);
+
+  // Returns the extension of a file name in ASCII lowercase, or an empty
+  // string if it has none or it is not ASCII.
+
+  template <typename Char>
+  std::string extensionKey(const Char *name, size_t length)
+  {
+    size_t pos = length;
+    while(pos > 0 && name[pos - 1] != '.') {
+      if(name[pos - 1] == '/' || name[pos - 1] == '\\')
+        return std::string();
+      --pos;
+    }
+    if(pos == 0)
+      return std::string();
+
+    std::string key;
+    key.reserve(length - pos);
+    for(size_t i = pos; i < length; ++i) {
+      const auto c = static_cast<std::make_unsigned_t<Char>>(name[i]);
+      if(c == 0 || c > 0x7F)
+        return std::string();
+      key += static_cast<char>(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+    }
+    return key;
+  }
+
+  std::string extensionKey(FileName fileName)
+  {
+#ifdef _WIN32
+    const std::wstring &name = fileName.wstr();
+    return extensionKey(name.c_str(), name.size());
+#else
+    if(!fileName)
+      return std::string();
+    return extensionKey(fileName, ::strlen(fileName));
+#endif
+  }
+
+  std::string extensionKey(const String &extension)
+  {
+    const std::wstring name = L"." + extension.toWString();
+    return extensionKey(name.c_str(), name.size());
+  }
+
+  bool isKnownExtension(const std::string &key)
+  {
+    if(key.empty())
+      return false;
+
+    if(defaultFactories().count(key) != 0)
+      return true;
+
+    if(hasCustomFactories) {
+      std::lock_guard<std::mutex> lock(fileTypeResolversMutex);
+      return customFactories.count(key) != 0;
+    }
+    return false;
+  }
+
+  // Detect the file type based on the file extension.
+
+  File* detectByExtension(IOStream *stream, bool readAudioProperties,
+                          AudioProperties::ReadStyle audioPropertiesStyle,
+                          File::PayloadStyle payloadStyle)
+  {
+    const std::string key = extensionKey(stream->name());
+    if(key.empty())
+      return nullptr;
+
+    File *file = nullptr;
+
+    FileRef::FileFactory customFactory;
+    if(hasCustomFactories) {
+      std::lock_guard<std::mutex> lock(fileTypeResolversMutex);
+      if(const auto it = customFactories.find(key); it != customFactories.end())
+        customFactory = it->second;
+    }
+
+    if(customFactory) {
+      file = customFactory(stream, readAudioProperties, audioPropertiesStyle);
+    }
+    else {
+      const auto &factories = defaultFactories();
+      if(const auto it = factories.find(key); it != factories.end())
+        file = it->second(stream, readAudioProperties, audioPropertiesStyle, payloadStyle);
+    }
 
     // if file is not valid, leave it to content-based detection.
 
@@ -234,73 +454,176 @@ namespace
 
   // Detect the file type based on the actual content of the stream.
 
-  File *detectByContent(IOStream *stream, bool readAudioProperties,
-                        AudioProperties::ReadStyle audioPropertiesStyle)
-  {
-    File *file = nullptr;
+  // Creates a file of the given type.
 
-    if(MPEG::File::isSupported(stream))
-      file = new MPEG::File(stream, readAudioProperties, audioPropertiesStyle);
+  File *createFile(FileTypes::Type type, IOStream *stream, bool readAudioProperties,
+                   AudioProperties::ReadStyle audioPropertiesStyle,
+                   File::PayloadStyle payloadStyle)
+  {
+    switch(type) {
+    case FileTypes::Type::MPEG:
+      return new MPEG::File(stream, readAudioProperties, audioPropertiesStyle,
+                            nullptr, payloadStyle);
 #ifdef TAGLIB_WITH_VORBIS
-    else if(Ogg::Vorbis::File::isSupported(stream))
-      file = new Ogg::Vorbis::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(Ogg::FLAC::File::isSupported(stream))
-      file = new Ogg::FLAC::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(FLAC::File::isSupported(stream))
-      file = new FLAC::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(Ogg::Speex::File::isSupported(stream))
-      file = new Ogg::Speex::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(Ogg::Opus::File::isSupported(stream))
-      file = new Ogg::Opus::File(stream, readAudioProperties, audioPropertiesStyle);
+    case FileTypes::Type::OggVorbis:
+      return new Ogg::Vorbis::File(stream, readAudioProperties, audioPropertiesStyle);
+    case FileTypes::Type::OggFLAC:
+      return new Ogg::FLAC::File(stream, readAudioProperties, audioPropertiesStyle);
+    case FileTypes::Type::FLAC:
+      return new FLAC::File(stream, readAudioProperties, audioPropertiesStyle,
+                            nullptr, payloadStyle);
+    case FileTypes::Type::Speex:
+      return new Ogg::Speex::File(stream, readAudioProperties, audioPropertiesStyle);
+    case FileTypes::Type::Opus:
+      return new Ogg::Opus::File(stream, readAudioProperties, audioPropertiesStyle);
 #endif
 #ifdef TAGLIB_WITH_APE
-    else if(MPC::File::isSupported(stream))
-      file = new MPC::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(WavPack::File::isSupported(stream))
-      file = new WavPack::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(APE::File::isSupported(stream))
-      file = new APE::File(stream, readAudioProperties, audioPropertiesStyle);
+    case FileTypes::Type::MPC:
+      return new MPC::File(stream, readAudioProperties, audioPropertiesStyle);
+    case FileTypes::Type::WavPack:
+      return new WavPack::File(stream, readAudioProperties, audioPropertiesStyle);
+    case FileTypes::Type::APE:
+      return new APE::File(stream, readAudioProperties, audioPropertiesStyle);
 #endif
 #ifdef TAGLIB_WITH_TRUEAUDIO
-    else if(TrueAudio::File::isSupported(stream))
-      file = new TrueAudio::File(stream, readAudioProperties, audioPropertiesStyle);
+    case FileTypes::Type::TrueAudio:
+      return new TrueAudio::File(stream, readAudioProperties, audioPropertiesStyle);
 #endif
 #ifdef TAGLIB_WITH_MP4
-    else if(MP4::File::isSupported(stream))
-      file = new MP4::File(stream, readAudioProperties, audioPropertiesStyle);
+    case FileTypes::Type::MP4:
+      return new MP4::File(stream, readAudioProperties, audioPropertiesStyle);
 #endif
 #ifdef TAGLIB_WITH_ASF
-    else if(ASF::File::isSupported(stream))
-      file = new ASF::File(stream, readAudioProperties, audioPropertiesStyle);
+    case FileTypes::Type::ASF:
+      return new ASF::File(stream, readAudioProperties, audioPropertiesStyle);
 #endif
 #ifdef TAGLIB_WITH_RIFF
-    else if(RIFF::AIFF::File::isSupported(stream))
-      file = new RIFF::AIFF::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(RIFF::WAV::File::isSupported(stream))
-      file = new RIFF::WAV::File(stream, readAudioProperties, audioPropertiesStyle);
+    case FileTypes::Type::AIFF:
+      return new RIFF::AIFF::File(stream, readAudioProperties, audioPropertiesStyle);
+    case FileTypes::Type::WAV:
+      return new RIFF::WAV::File(stream, readAudioProperties, audioPropertiesStyle);
 #endif
 #ifdef TAGLIB_WITH_DSF
-    else if(DSF::File::isSupported(stream))
-      file = new DSF::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(DSDIFF::File::isSupported(stream))
-      file = new DSDIFF::File(stream, readAudioProperties, audioPropertiesStyle);
+    case FileTypes::Type::DSF:
+      return new DSF::File(stream, readAudioProperties, audioPropertiesStyle);
+    case FileTypes::Type::DSDIFF:
+      return new DSDIFF::File(stream, readAudioProperties, audioPropertiesStyle);
 #endif
 #ifdef TAGLIB_WITH_SHORTEN
-    else if(Shorten::File::isSupported(stream))
-      file = new Shorten::File(stream, readAudioProperties, audioPropertiesStyle);
+    case FileTypes::Type::Shorten:
+      return new Shorten::File(stream, readAudioProperties, audioPropertiesStyle);
 #endif
+    default:
+      return nullptr;
+    }
+  }
 
-    // isSupported() only does a quick check, so double check the file here.
-
-    if(file) {
-      if(file->isValid())
-        return file;
-      delete file;
+  File *detectByContent(IOStream *stream, const ByteVector &header,
+                        bool readAudioProperties,
+                        AudioProperties::ReadStyle audioPropertiesStyle,
+                        File::PayloadStyle payloadStyle)
+  {
+    // The signatures are matched in a single read of the beginning of the
+    // stream.  This only does a quick check, so the files are tried in the
+    // order of the matches until one of them is valid.
+
+    for(const auto type : FileTypes::detect(stream, header)) {
+      if(File *file = createFile(type, stream, readAudioProperties,
+                                      audioPropertiesStyle, payloadStyle)) {
+        if(file->isValid())
+          return file;
+        delete file;
+      }
     }
 
     return nullptr;
   }
 
+  bool isReadable(FileName fileName)
+  {
+#ifdef _WIN32
+    return ::_waccess(fileName, 4) == 0;
+#else
+    return ::access(fileName, R_OK) == 0;
+#endif
+  }
+
+  // Copies the metadata of a file into a batch result.  If the file could not
+  // be read, its extension decides whether it is a file of an unknown type or
+  // an invalid file of a supported type.
+
+  FileRef::BatchResult batchResult(unsigned int index, const FileRef &ref,
+                                   FileName fileName)
+  {
+    FileRef::BatchResult result;
+    result.index = index;
+
+    if(ref.isNull()) {
+      result.status = isKnownExtension(extensionKey(fileName))
+        ? FileRef::BatchResult::InvalidFile : FileRef::BatchResult::UnknownType;
+      return result;
+    }
+
+    result.status = FileRef::BatchResult::Read;
+    result.properties = ref.file()->properties();
+    result.complexPropertyKeys = ref.file()->complexPropertyKeys();
+
+    if(const AudioProperties *properties = ref.file()->audioProperties()) {
+      result.lengthInMilliseconds = properties->lengthInMilliseconds();
+      result.bitrate = properties->bitrate();
+      result.sampleRate = properties->sampleRate();
+      result.channels = properties->channels();
+    }
+
+    return result;
+  }
+
+  // Calls read() for the indices 0 to count - 1 with threadCount threads and
+  // passes the results to the handler.  The tasks are independent, so a shared
+  // counter from which the threads take the next index when they become idle
+  // balances the load like a work-stealing queue.  The calling thread is one
+  // of the workers.
+
+  void readBatch(unsigned int count, unsigned int threadCount,
+                 const std::function<FileRef::BatchResult(unsigned int)> &read,
+                 const FileRef::BatchHandler &handler)
+  {
+    if(threadCount == 0)
+      threadCount = std::max(std::thread::hardware_concurrency(), 1U);
+    threadCount = std::min(threadCount, count);
+
+    std::atomic<unsigned int> next(0);
+    std::mutex handlerMutex;
+
+    const auto work = [&] {
+      for(unsigned int i = next++; i < count; i = next++) {
+        const FileRef::BatchResult result = read(i);
+
+        std::lock_guard<std::mutex> lock(handlerMutex);
+        handler(result);
+      }
+    };
+
+    // If a thread can not be started, the ones which are running and this
+    // thread take over its share.
+
+    std::vector<std::thread> threads;
+    for(unsigned int i = 1; i < threadCount; ++i) {
+      try {
+        threads.emplace_back(work);
+      }
+      catch(const std::system_error &) {
+        debug("FileRef::readMany() -- Could not start a thread.");
+        break;
+      }
+    }
+
+    work();
+
+    for(auto &thread : threads)
+      thread.join();
+  }
+
 }  // namespace
 
 class FileRef::FileRefPrivate
@@ -334,6 +657,35 @@ public:
   IOStream *stream { nullptr };
 };
 
+// The resolvers for a batch of files, with the candidates for each extension
+// found so far.  In a directory of files with a single extension, the
+// resolvers are only filtered once.
+
+class FileRef::ResolverMemo
+{
+public:
+  ResolverMemo() :
+    resolvers(currentFileTypeResolvers())
+  {
+  }
+
+  Candidates find(const std::string &key, bool streamResolvers)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto &memo = memos[streamResolvers ? 1 : 0];
+    auto it = memo.find(key);
+    if(it == memo.end())
+      it = memo.emplace(key, candidates(resolvers, key, streamResolvers)).first;
+    return it->second;
+  }
+
+private:
+  const List<RegisteredResolver> resolvers;
+  std::mutex mutex;
+  std::unordered_map<std::string, Candidates> memos[2];
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // public members
 ////////////////////////////////////////////////////////////////////////////////
@@ -345,15 +697,28 @@ FileRef::FileRef() :
 
 FileRef::FileRef(FileName fileName, bool readAudioProperties,
                  AudioProperties::ReadStyle audioPropertiesStyle) :
-  d(std::make_shared<FileRefPrivate>())
+  FileRef(fileName, readAudioProperties, audioPropertiesStyle, File::ReadPayloads, nullptr)
 {
-  parse(fileName, readAudioProperties, audioPropertiesStyle);
 }
 
-FileRef::FileRef(IOStream *stream, bool readAudioProperties, AudioProperties::ReadStyle audioPropertiesStyle) :
-  d(std::make_shared<FileRefPrivate>())
+FileRef::FileRef(FileName fileName, bool readAudioProperties,
+                 AudioProperties::ReadStyle audioPropertiesStyle,
+                 File::PayloadStyle payloadStyle) :
+  FileRef(fileName, readAudioProperties, audioPropertiesStyle, payloadStyle, nullptr)
+{
+}
+
+FileRef::FileRef(IOStream *stream, bool readAudioProperties,
+                 AudioProperties::ReadStyle audioPropertiesStyle) :
+  FileRef(stream, readAudioProperties, audioPropertiesStyle, File::ReadPayloads, nullptr)
+{
+}
+
+FileRef::FileRef(IOStream *stream, bool readAudioProperties,
+                 AudioProperties::ReadStyle audioPropertiesStyle,
+                 File::PayloadStyle payloadStyle) :
+  FileRef(stream, readAudioProperties, audioPropertiesStyle, payloadStyle, nullptr)
 {
-  parse(stream, readAudioProperties, audioPropertiesStyle);
 }
 
 FileRef::FileRef(File *file) :
@@ -443,76 +808,103 @@ bool FileRef::save()
   return d->file->save();
 }
 
+void FileRef::readMany(const List<FileName> &fileNames, const BatchHandler &handler,
+                       unsigned int threadCount, bool readAudioProperties,
+                       AudioProperties::ReadStyle audioPropertiesStyle,
+                       MetadataCache *cache) // static
+{
+  const std::vector<FileName> names(fileNames.begin(), fileNames.end());
+  ResolverMemo memo;
+
+  readBatch(static_cast<unsigned int>(names.size()), threadCount, [&](unsigned int i) {
+    BatchResult result;
+    result.index = i;
+    if(cache && cache->find(names[i], result, readAudioProperties))
+      return result;
+
+    if(!isReadable(names[i])) {
+      result.status = BatchResult::OpenError;
+      return result;
+    }
+    result = batchResult(i, FileRef(names[i], readAudioProperties, audioPropertiesStyle,
+                                    File::DeferPayloads, &memo),
+                         names[i]);
+    if(cache)
+      cache->insert(names[i], result, readAudioProperties);
+    return result;
+  }, handler);
+}
+
+void FileRef::readMany(const List<IOStream *> &streams, const BatchHandler &handler,
+                       unsigned int threadCount, bool readAudioProperties,
+                       AudioProperties::ReadStyle audioPropertiesStyle) // static
+{
+  const std::vector<IOStream *> s(streams.begin(), streams.end());
+  ResolverMemo memo;
+
+  readBatch(static_cast<unsigned int>(s.size()), threadCount, [&](unsigned int i) {
+    if(!s[i] || !s[i]->isOpen()) {
+      BatchResult result;
+      result.index = i;
+      result.status = BatchResult::OpenError;
+      return result;
+    }
+    return batchResult(i, FileRef(s[i], readAudioProperties, audioPropertiesStyle,
+                               File::DeferPayloads, &memo),
+                       s[i]->name());
+  }, handler);
+}
+
 const FileRef::FileTypeResolver *FileRef::addFileTypeResolver(const FileRef::FileTypeResolver *resolver) // static
 {
-  fileTypeResolvers.prepend(resolver);
+  RegisteredResolver registered;
+  registered.resolver = resolver;
+  registered.streamResolver = dynamic_cast<const StreamTypeResolver *>(resolver);
+  if(const auto filter = dynamic_cast<const ResolverFilter *>(resolver)) {
+    for(const auto &extension : filter->fileExtensions()) {
+      if(std::string key = extensionKey(extension); !key.empty())
+        registered.extensions.push_back(std::move(key));
+    }
+    registered.signatures = filter->signatures();
+  }
+
+  std::lock_guard<std::mutex> lock(fileTypeResolversMutex);
+  fileTypeResolvers.prepend(registered);
   return resolver;
 }
 
 void FileRef::clearFileTypeResolvers() // static
 {
+  std::lock_guard<std::mutex> lock(fileTypeResolversMutex);
   fileTypeResolvers.clear();
 }
 
+void FileRef::addFileExtension(const String &extension, const FileFactory &factory) // static
+{
+  const std::string key = extensionKey(extension);
+  if(key.empty()) {
+    debug("FileRef::addFileExtension() -- Invalid extension.");
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(fileTypeResolversMutex);
+  customFactories[key] = factory;
+  hasCustomFactories = true;
+}
+
+void FileRef::clearFileExtensions() // static
+{
+  std::lock_guard<std::mutex> lock(fileTypeResolversMutex);
+  customFactories.clear();
+  hasCustomFactories = false;
+}
+
 StringList FileRef::defaultFileExtensions()
 {
   StringList l;
 
-  l.append("mp3");
-  l.append("mp2");
-  l.append("aac");
-#ifdef TAGLIB_WITH_VORBIS
-  l.append("ogg");
-  l.append("flac");
-  l.append("oga");
-  l.append("opus");
-  l.append("spx");
-#endif
-#ifdef TAGLIB_WITH_APE
-  l.append("mpc");
-  l.append("wv");
-  l.append("ape");
-#endif
-#ifdef TAGLIB_WITH_TRUEAUDIO
-  l.append("tta");
-#endif
-#ifdef TAGLIB_WITH_MP4
-  l.append("m4a");
-  l.append("m4r");
-  l.append("m4b");
-  l.append("m4p");
-  l.append("3g2");
-  l.append("mp4");
-  l.append("m4v");
-#endif
-#ifdef TAGLIB_WITH_ASF
-  l.append("wma");
-  l.append("asf");
-#endif
-#ifdef TAGLIB_WITH_RIFF
-  l.append("aif");
-  l.append("aiff");
-  l.append("afc");
-  l.append("aifc");
-  l.append("wav");
-#endif
-#ifdef TAGLIB_WITH_MOD
-  l.append("mod");
-  l.append("module"); // alias for "mod"
-  l.append("nst"); // alias for "mod"
-  l.append("wow"); // alias for "mod"
-  l.append("s3m");
-  l.append("it");
-  l.append("xm");
-#endif
-#ifdef TAGLIB_WITH_DSF
-  l.append("dsf");
-  l.append("dff");
-  l.append("dsdiff"); // alias for "dff"
-#endif
-#ifdef TAGLIB_WITH_SHORTEN
-  l.append("shn");
-#endif
+  for(const auto &extension : extensions)
+    l.append(extension.name);
 
   return l;
 }
@@ -545,25 +937,63 @@ bool FileRef::operator!=(const FileRef &ref) const
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
+FileRef::FileRef(FileName fileName, bool readAudioProperties,
+                 AudioProperties::ReadStyle audioPropertiesStyle,
+                 File::PayloadStyle payloadStyle, ResolverMemo *memo) :
+  d(std::make_shared<FileRefPrivate>())
+{
+  parse(fileName, readAudioProperties, audioPropertiesStyle, payloadStyle, memo);
+}
+
+FileRef::FileRef(IOStream *stream, bool readAudioProperties,
+                 AudioProperties::ReadStyle audioPropertiesStyle,
+                 File::PayloadStyle payloadStyle, ResolverMemo *memo) :
+  d(std::make_shared<FileRefPrivate>())
+{
+  parse(stream, readAudioProperties, audioPropertiesStyle, payloadStyle, memo);
+}
+
 void FileRef::parse(FileName fileName, bool readAudioProperties,
-                    AudioProperties::ReadStyle audioPropertiesStyle)
+                    AudioProperties::ReadStyle audioPropertiesStyle,
+                    File::PayloadStyle payloadStyle, ResolverMemo *memo)
 {
+  // The stream is only opened before trying the resolvers if one of them has
+  // to check its signatures.
+
+  StreamHeader header;
+  const auto streamHeader = [&]() -> const ByteVector & {
+    if(!d->stream)
+      d->stream = new FileStream(fileName);
+    return header.data(d->stream);
+  };
+
   // Try user-defined resolvers.
 
-  d->file = detectByResolvers(fileName, readAudioProperties, audioPropertiesStyle);
-  if(d->file)
+  const std::string key = extensionKey(fileName);
+  const List<RegisteredResolver> resolvers = memo ? List<RegisteredResolver>()
+                                                  : currentFileTypeResolvers();
+  d->file = detectByResolvers(fileName,
+                              memo ? memo->find(key, false) : candidates(resolvers, key, false),
+                              streamHeader, readAudioProperties, audioPropertiesStyle);
+  if(d->file) {
+    delete d->stream;
+    d->stream = nullptr;
     return;
+  }
 
   // Try to resolve file types based on the file extension.
 
-  d->stream = new FileStream(fileName);
-  d->file = detectByExtension(d->stream, readAudioProperties, audioPropertiesStyle);
+  if(!d->stream)
+    d->stream = new FileStream(fileName);
+  d->file = detectByExtension(d->stream, readAudioProperties, audioPropertiesStyle,
+                              payloadStyle);
   if(d->file)
     return;
 
   // At last, try to resolve file types based on the actual content.
 
-  d->file = detectByContent(d->stream, readAudioProperties, audioPropertiesStyle);
+  d->file = detectByContent(d->stream, streamHeader(), readAudioProperties,
+                            audioPropertiesStyle, payloadStyle);
   if(d->file)
     return;
 
@@ -574,29 +1004,45 @@ void FileRef::parse(FileName fileName, bool readAudioProperties,
 }
 
 void FileRef::parse(IOStream *stream, bool readAudioProperties,
-                    AudioProperties::ReadStyle audioPropertiesStyle)
+                    AudioProperties::ReadStyle audioPropertiesStyle,
+                    File::PayloadStyle payloadStyle, ResolverMemo *memo)
 {
+  StreamHeader header;
+  const auto streamHeader = [&]() -> const ByteVector & {
+    return header.data(stream);
+  };
+
+  const std::string key = extensionKey(stream->name());
+  const List<RegisteredResolver> resolvers = memo ? List<RegisteredResolver>()
+                                                  : currentFileTypeResolvers();
+
   // Try user-defined stream resolvers.
 
-  d->file = detectByResolvers(stream, readAudioProperties, audioPropertiesStyle);
+  d->file = detectByResolvers(stream,
+                              memo ? memo->find(key, true) : candidates(resolvers, key, true),
+                              streamHeader, readAudioProperties, audioPropertiesStyle);
   if(d->file)
     return;
 
   // Try user-defined resolvers.
 
-  d->file = detectByResolvers(stream->name(), readAudioProperties, audioPropertiesStyle);
+  d->file = detectByResolvers(stream->name(),
+                              memo ? memo->find(key, false) : candidates(resolvers, key, false),
+                              streamHeader, readAudioProperties, audioPropertiesStyle);
   if(d->file)
     return;
 
   // Try to resolve file types based on the file extension.
 
-  d->file = detectByExtension(stream, readAudioProperties, audioPropertiesStyle);
+  d->file = detectByExtension(stream, readAudioProperties, audioPropertiesStyle,
+                              payloadStyle);
   if(d->file)
     return;
 
   // At last, try to resolve file types based on the actual content of the file.
 
-  d->file = detectByContent(stream, readAudioProperties, audioPropertiesStyle);
+  d->file = detectByContent(stream, streamHeader(), readAudioProperties,
+                            audioPropertiesStyle, payloadStyle);
 }
 
 FileRef::FileTypeResolver::FileTypeResolver() = default;
@@ -604,3 +1050,16 @@ FileRef::FileTypeResolver::~FileTypeResolver() = default;
 
 FileRef::StreamTypeResolver::StreamTypeResolver() = default;
 FileRef::StreamTypeResolver::~StreamTypeResolver() = default;
+
+FileRef::ResolverFilter::ResolverFilter() = default;
+FileRef::ResolverFilter::~ResolverFilter() = default;
+
+StringList FileRef::ResolverFilter::fileExtensions() const
+{
+  return StringList();
+}
+
+List<FileRef::ResolverFilter::Signature> FileRef::ResolverFilter::signatures() const
+{
+  return List<Signature>();
+}
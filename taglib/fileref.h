@@ -26,8 +26,11 @@
 #ifndef TAGLIB_FILEREF_H
 #define TAGLIB_FILEREF_H
 
+#include <functional>
+
 #include "tfile.h"
 #include "tstringlist.h"
+#include "tpropertymap.h"
 
 #include "taglib_export.h"
 #include "audioproperties.h"
@@ -35,6 +38,7 @@
 namespace TagLib {
 
   class Tag;
+  class MetadataCache;
 
   //! This class provides a simple abstraction for creating and handling files
 
@@ -169,6 +173,124 @@ namespace TagLib {
       std::unique_ptr<StreamTypeResolverPrivate> d;
     };
 
+    //! An interface to restrict the files passed to a resolver.
+
+    /*!
+     * A FileTypeResolver or StreamTypeResolver which also implements this
+     * interface is only called for the files matching its filters:
+     *
+     * \code
+     *
+     * class MyFlacResolver : public StreamTypeResolver, public ResolverFilter
+     * {
+     *   // createFile() and createFileFromStream() as above
+     *
+     *   StringList fileExtensions() const override
+     *   {
+     *     return StringList("flac");
+     *   }
+     *
+     *   List<Signature> signatures() const override
+     *   {
+     *     return List<Signature>({ { 0, "fLaC" } });
+     *   }
+     * }
+     *
+     * \endcode
+     *
+     * \note The filters are queried once when the resolver is added with
+     * addFileTypeResolver().
+     */
+
+    class TAGLIB_EXPORT ResolverFilter
+    {
+    public:
+      /*!
+       * A pattern at a fixed offset at the beginning of a file.
+       */
+      struct Signature
+      {
+        unsigned int offset;
+        ByteVector pattern;
+      };
+
+      ResolverFilter();
+      /*!
+       * Destroys this ResolverFilter instance.
+       */
+      virtual ~ResolverFilter();
+
+      ResolverFilter(const ResolverFilter &) = delete;
+      ResolverFilter &operator=(const ResolverFilter &) = delete;
+
+      /*!
+       * Returns the extensions of the files which the resolver can create,
+       * which are compared case-insensitively.  The resolver is not called
+       * for files with other extensions.  The default implementation returns
+       * an empty list, then the resolver is called for all files.
+       */
+      virtual StringList fileExtensions() const;
+
+      /*!
+       * Returns the signatures of the files which the resolver can create.
+       * The resolver is only called if one of them is found in the first
+       * 16 KiB of the file, which are read once for all resolvers and
+       * also used for the detection by content.  The default implementation
+       * returns an empty list, then the resolver is called for all files.
+       */
+      virtual List<Signature> signatures() const;
+    };
+
+    //! The metadata of a file read by readMany().
+
+    struct BatchResult
+    {
+      /*!
+       * The outcome of reading a file.
+       */
+      enum Status {
+        //! The metadata was read.
+        Read,
+        //! The file could not be opened.
+        OpenError,
+        //! The type of the file could not be detected.
+        UnknownType,
+        //! The file has the extension of a supported type, but it is not valid.
+        InvalidFile
+      };
+
+      /*!
+       * The position of the file in the list passed to readMany().
+       */
+      unsigned int index { 0 };
+
+      Status status { OpenError };
+
+      /*!
+       * The properties of the file, see FileRef::properties().
+       */
+      PropertyMap properties;
+
+      /*!
+       * The keys of the complex properties, see FileRef::complexPropertyKeys().
+       * The complex properties themselves are not read, as they can be large.
+       */
+      StringList complexPropertyKeys;
+
+      /*!
+       * The audio properties, which are 0 if they were not read.
+       */
+      int lengthInMilliseconds { 0 };
+      int bitrate { 0 };
+      int sampleRate { 0 };
+      int channels { 0 };
+    };
+
+    /*!
+     * Function which is called by readMany() with the result for each file.
+     */
+    using BatchHandler = std::function<void(const BatchResult &)>;
+
     /*!
      * Creates a null FileRef.
      */
@@ -188,6 +310,16 @@ namespace TagLib {
                      AudioProperties::ReadStyle
                      audioPropertiesStyle = AudioProperties::Average);
 
+    /*!
+     * Same as the constructor above, but \a payloadStyle specifies when
+     * pictures and other large binary payloads are read, see
+     * File::payloadStyle().
+     */
+    explicit FileRef(FileName fileName,
+                     bool readAudioProperties,
+                     AudioProperties::ReadStyle audioPropertiesStyle,
+                     File::PayloadStyle payloadStyle);
+
     /*!
      * Construct a FileRef from an opened \a IOStream.  If \a readAudioProperties
      * is \c true then the audio properties will be read using \a audioPropertiesStyle.
@@ -205,6 +337,16 @@ namespace TagLib {
                      AudioProperties::ReadStyle
                      audioPropertiesStyle = AudioProperties::Average);
 
+    /*!
+     * Same as the constructor above, but \a payloadStyle specifies when
+     * pictures and other large binary payloads are read, see
+     * File::payloadStyle().
+     */
+    explicit FileRef(IOStream* stream,
+                     bool readAudioProperties,
+                     AudioProperties::ReadStyle audioPropertiesStyle,
+                     File::PayloadStyle payloadStyle);
+
     /*!
      * Construct a FileRef using \a file.  The FileRef now takes ownership of the
      * pointer and will delete the File when it passes out of scope.
@@ -340,6 +482,53 @@ namespace TagLib {
      */
     bool save();
 
+    /*!
+     * Reads the metadata of all files in \a fileNames using \a threadCount
+     * threads, 0 meaning one per processor core.  The files are read with the
+     * same type detection as the FileRef constructors and are closed again
+     * before the next file is read.
+     *
+     * \a handler is called once for each file as soon as it has been read, so
+     * the results are not in the order of \a fileNames, see
+     * BatchResult::index.  The calls come from the worker threads, but they
+     * are never concurrent.  readMany() returns when all files have been
+     * handled.
+     *
+     * Files are assigned to the threads one by one as the threads become idle,
+     * so that a few large files do not keep the other threads waiting.  Large
+     * pictures and other binary payloads are not read, see
+     * File::DeferPayloads.
+     *
+     * If \a cache is not null, the files which are unchanged since their
+     * result was stored in \a cache are not opened, and the results of the
+     * other files are stored in it.
+     *
+     * The resolvers whose filters accept an extension are found once per
+     * batch, see ResolverFilter::fileExtensions().  Resolvers added while
+     * the batch is read are not used for it.
+     *
+     * \note Resolvers added with addFileTypeResolver() are called from several
+     * threads at once and have to be thread-safe.
+     */
+    static void readMany(const List<FileName> &fileNames,
+                         const BatchHandler &handler,
+                         unsigned int threadCount = 0,
+                         bool readAudioProperties = true,
+                         AudioProperties::ReadStyle
+                         audioPropertiesStyle = AudioProperties::Average,
+                         MetadataCache *cache = nullptr);
+
+    /*!
+     * Reads the metadata of all \a streams, see above.  Each stream is only
+     * used by one thread at a time.
+     */
+    static void readMany(const List<IOStream *> &streams,
+                         const BatchHandler &handler,
+                         unsigned int threadCount = 0,
+                         bool readAudioProperties = true,
+                         AudioProperties::ReadStyle
+                         audioPropertiesStyle = AudioProperties::Average);
+
     /*!
      * Adds a FileTypeResolver to the list of those used by TagLib.  Each
      * additional FileTypeResolver is added to the front of a list of resolvers
@@ -350,6 +539,8 @@ namespace TagLib {
      * this is mostly so that static initializers have something to use for
      * assignment).
      *
+     * \note This may be called while files are read in other threads.
+     *
      * \see FileTypeResolver
      */
     static const FileTypeResolver *addFileTypeResolver(const FileTypeResolver *resolver);
@@ -359,6 +550,40 @@ namespace TagLib {
      */
     static void clearFileTypeResolvers();
 
+    /*!
+     * Creates a file from a stream for an extension added with
+     * addFileExtension().  Returns nullptr if the stream does not hold such
+     * a file.
+     *
+     * \note The created file is then owned by the FileRef and should not be
+     * deleted.
+     */
+    using FileFactory = std::function<File *(IOStream *stream, bool readAudioProperties,
+                                             AudioProperties::ReadStyle audioPropertiesStyle)>;
+
+    /*!
+     * Adds \a factory for files with the extension \a extension, which is
+     * compared case-insensitively and has to be ASCII.  The factory is used
+     * after the resolvers added with addFileTypeResolver() and before the
+     * content of the file is checked, and takes precedence over the default
+     * file types of the extension.  Files which are not valid are deleted and
+     * left to the detection by content.
+     *
+     * Unlike a FileTypeResolver, the factory is only called for its
+     * extension, which is looked up in constant time.
+     *
+     * \note This may be called while files are read in other threads.
+     *
+     * \see defaultFileExtensions()
+     */
+    static void addFileExtension(const String &extension, const FileFactory &factory);
+
+    /*!
+     * Removes all extensions added by addFileExtension(), the default file
+     * types are detected again.
+     */
+    static void clearFileExtensions();
+
     /*!
      * As is mentioned elsewhere in this class's documentation, the default file
      * type resolution code provided by TagLib only works by comparing file
@@ -369,9 +594,10 @@ namespace TagLib {
      * The extensions are all returned in lowercase, though the comparison used
      * by TagLib for resolution is case-insensitive.
      *
-     * \note This does not account for any additional file type resolvers that
-     * are plugged in.  Also note that this is not intended to replace a proper
-     * mime-type resolution system, but is just here for reference.
+     * \note This does not account for any additional file type resolvers or
+     * extensions that are plugged in.  Also note that this is not intended to
+     * replace a proper mime-type resolution system, but is just here for
+     * reference.
      *
      * \see FileTypeResolver
      */
@@ -404,8 +630,17 @@ namespace TagLib {
     bool operator!=(const FileRef &ref) const;
 
   private:
-    void parse(FileName fileName, bool readAudioProperties, AudioProperties::ReadStyle audioPropertiesStyle);
-    void parse(IOStream *stream, bool readAudioProperties, AudioProperties::ReadStyle audioPropertiesStyle);
+    class ResolverMemo;
+
+    FileRef(FileName fileName, bool readAudioProperties, AudioProperties::ReadStyle audioPropertiesStyle,
+            File::PayloadStyle payloadStyle, ResolverMemo *memo);
+    FileRef(IOStream *stream, bool readAudioProperties, AudioProperties::ReadStyle audioPropertiesStyle,
+            File::PayloadStyle payloadStyle, ResolverMemo *memo);
+
+    void parse(FileName fileName, bool readAudioProperties, AudioProperties::ReadStyle audioPropertiesStyle,
+               File::PayloadStyle payloadStyle, ResolverMemo *memo);
+    void parse(IOStream *stream, bool readAudioProperties, AudioProperties::ReadStyle audioPropertiesStyle,
+               File::PayloadStyle payloadStyle, ResolverMemo *memo);
 
     class FileRefPrivate;
     TAGLIB_MSVC_SUPPRESS_WARNING_NEEDS_TO_HAVE_DLL_INTERFACE
@@ -0,0 +1,236 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include "filetypes.h"
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+
+#include "tbytevectorstream.h"
+#include "id3v2header.h"
+#include "mpegfile.h"
+
+using namespace TagLib;
+
+namespace
+{
+  // The ID3v2 tag which may precede some formats is skipped, and the patterns
+  // which may be anywhere are searched in the first SearchLength bytes, as
+  // done by the isSupported() functions of the file classes.  The window
+  // also holds the following MPEG frame header for the frames found in
+  // them.
+
+  constexpr unsigned int SearchLength = 1024;
+  constexpr unsigned int WindowLength = 4096;
+
+  enum class Window { Start, AfterID3v2 };
+
+  struct Pattern
+  {
+    Window window;
+    // Offset of the pattern in the window, -1 if it may be anywhere in the
+    // first SearchLength bytes.
+    int offset;
+    const char *data;
+    unsigned int length;
+  };
+
+  // The patterns, which are referenced by their index from the signatures.
+
+  constexpr std::array patterns {
+    Pattern { Window::Start, 0, "\x30\x26\xB2\x75\x8E\x66\xCF\x11\xA6\xD9\x00\xAA\x00\x62\xCE\x6C", 16 },
+    Pattern { Window::Start, 4, "ftyp", 4 },
+    Pattern { Window::Start, 0, "RIFF", 4 },
+    Pattern { Window::Start, 8, "WAVE", 4 },
+    Pattern { Window::Start, 0, "FORM", 4 },
+    Pattern { Window::Start, 8, "AIFF", 4 },
+    Pattern { Window::Start, 8, "AIFC", 4 },
+    Pattern { Window::Start, 0, "FRM8", 4 },
+    Pattern { Window::Start, 12, "DSD ", 4 },
+    Pattern { Window::Start, 0, "DSD ", 4 },
+    Pattern { Window::Start, 0, "wvpk", 4 },
+    Pattern { Window::Start, 0, "ajkg", 4 },
+    Pattern { Window::AfterID3v2, 0, "MPCK", 4 },
+    Pattern { Window::AfterID3v2, 0, "MP+", 3 },
+    Pattern { Window::AfterID3v2, 0, "TTA", 3 },
+    Pattern { Window::Start, -1, "OggS", 4 },
+    Pattern { Window::Start, -1, "\x01vorbis", 7 },
+    Pattern { Window::Start, -1, "fLaC", 4 },
+    Pattern { Window::Start, -1, "Speex   ", 8 },
+    Pattern { Window::Start, -1, "OpusHead", 8 },
+    Pattern { Window::AfterID3v2, -1, "fLaC", 4 },
+    Pattern { Window::AfterID3v2, -1, "MAC ", 4 }
+  };
+
+  using PatternSet = std::bitset<patterns.size()>;
+
+  struct Signature
+  {
+    FileTypes::Type type;
+    // Indexes of the patterns which all have to match.
+    std::array<int, 2> patterns;
+  };
+
+  // Ordered from the most to the least specific signature, the fixed
+  // positions first.
+
+  constexpr std::array signatures {
+    Signature { FileTypes::Type::ASF, { 0, -1 } },
+    Signature { FileTypes::Type::MP4, { 1, -1 } },
+    Signature { FileTypes::Type::WAV, { 2, 3 } },
+    Signature { FileTypes::Type::AIFF, { 4, 5 } },
+    Signature { FileTypes::Type::AIFF, { 4, 6 } },
+    Signature { FileTypes::Type::DSDIFF, { 7, 8 } },
+    Signature { FileTypes::Type::DSF, { 9, -1 } },
+    Signature { FileTypes::Type::WavPack, { 10, -1 } },
+    Signature { FileTypes::Type::Shorten, { 11, -1 } },
+    Signature { FileTypes::Type::MPC, { 12, -1 } },
+    Signature { FileTypes::Type::MPC, { 13, -1 } },
+    Signature { FileTypes::Type::TrueAudio, { 14, -1 } },
+    Signature { FileTypes::Type::OggVorbis, { 15, 16 } },
+    Signature { FileTypes::Type::OggFLAC, { 15, 17 } },
+    Signature { FileTypes::Type::Speex, { 15, 18 } },
+    Signature { FileTypes::Type::Opus, { 15, 19 } },
+    Signature { FileTypes::Type::FLAC, { 20, -1 } },
+    Signature { FileTypes::Type::APE, { 21, -1 } }
+  };
+
+  // The patterns which may be anywhere, indexed by their first byte, so that
+  // all of them are found in a single pass over a window.
+
+  using FirstByteIndex = std::array<std::vector<size_t>, 256>;
+
+  const FirstByteIndex &firstByteIndex()
+  {
+    static const FirstByteIndex index = [] {
+      FirstByteIndex result;
+      for(size_t i = 0; i < patterns.size(); ++i) {
+        if(patterns[i].offset < 0)
+          result[static_cast<unsigned char>(patterns[i].data[0])].push_back(i);
+      }
+      return result;
+    }();
+    return index;
+  }
+
+  bool matchesAt(const ByteVector &data, unsigned int offset, unsigned int end,
+                 const Pattern &pattern)
+  {
+    return offset + pattern.length <= end &&
+           std::equal(pattern.data, pattern.data + pattern.length, data.begin() + offset);
+  }
+
+  // Sets the bits of the patterns for the given windows which are found in
+  // data.
+
+  void match(const ByteVector &data, Window first, Window second, PatternSet &found)
+  {
+    const auto inWindow = [&](const Pattern &pattern) {
+      return pattern.window == first || pattern.window == second;
+    };
+
+    for(size_t i = 0; i < patterns.size(); ++i) {
+      if(patterns[i].offset >= 0 && inWindow(patterns[i]) &&
+         matchesAt(data, patterns[i].offset, data.size(), patterns[i])) {
+        found.set(i);
+      }
+    }
+
+    const FirstByteIndex &index = firstByteIndex();
+    const unsigned int end = std::min(data.size(), SearchLength);
+    for(unsigned int offset = 0; offset < end; ++offset) {
+      for(size_t i : index[static_cast<unsigned char>(data[offset])]) {
+        if(!found.test(i) && inWindow(patterns[i]) &&
+           matchesAt(data, offset, end, patterns[i])) {
+          found.set(i);
+        }
+      }
+    }
+  }
+}  // namespace
+
+std::vector<FileTypes::Type> FileTypes::detect(IOStream *stream)
+{
+  if(!stream || !stream->isOpen())
+    return std::vector<Type>();
+
+  const offset_t originalPosition = stream->tell();
+  const ByteVector start = stream->readBlockAt(0, HeaderLength);
+  stream->seek(originalPosition);
+
+  return detect(stream, start);
+}
+
+std::vector<FileTypes::Type> FileTypes::detect(IOStream *stream, const ByteVector &start)
+{
+  std::vector<Type> types;
+
+  if(!stream || !stream->isOpen())
+    return types;
+
+  const offset_t originalPosition = stream->tell();
+
+  const bool hasID3v2 = start.startsWith(ID3v2::Header::fileIdentifier());
+
+  ByteVector afterID3v2 = start;
+  if(hasID3v2) {
+    const offset_t tagSize = ID3v2::Header(start.mid(0, ID3v2::Header::size())).completeTagSize();
+    // The window is taken from the header if it is in there, or if the
+    // header holds the whole stream.
+
+    if(tagSize + WindowLength <= start.size() || start.size() < HeaderLength)
+      afterID3v2 = start.mid(static_cast<unsigned int>(std::min<offset_t>(tagSize, start.size())),
+                             WindowLength);
+    else
+      afterID3v2 = stream->readBlockAt(tagSize, WindowLength);
+  }
+
+  stream->seek(originalPosition);
+
+  PatternSet found;
+  if(!hasID3v2) {
+    match(start, Window::Start, Window::AfterID3v2, found);
+  }
+  else {
+    match(start, Window::Start, Window::Start, found);
+    match(afterID3v2, Window::AfterID3v2, Window::AfterID3v2, found);
+  }
+
+  for(const auto &signature : signatures) {
+    if(std::all_of(signature.patterns.begin(), signature.patterns.end(),
+                   [&](int i) { return i < 0 || found.test(i); }) &&
+       std::find(types.begin(), types.end(), signature.type) == types.end()) {
+      types.push_back(signature.type);
+    }
+  }
+
+  // MPEG frame headers are easily confused with other binary data, so they
+  // are validated like MPEG::File::isSupported() does, but in memory.
+
+  if(ByteVectorStream window(afterID3v2); MPEG::File::isSupported(&window))
+    types.push_back(Type::MPEG);
+
+  return types;
+}
@@ -0,0 +1,93 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_FILETYPES_H
+#define TAGLIB_FILETYPES_H
+
+// THIS FILE IS NOT A PART OF THE TAGLIB API
+
+#ifndef DO_NOT_DOCUMENT  // tell Doxygen not to document this header
+
+#include <vector>
+
+#include "taglib_export.h"
+
+namespace TagLib {
+
+  class ByteVector;
+  class IOStream;
+
+  namespace FileTypes {
+
+    /*!
+     * The file types which can be detected by their content.
+     */
+    enum class Type {
+      MPEG,
+      OggVorbis,
+      OggFLAC,
+      FLAC,
+      Speex,
+      Opus,
+      MPC,
+      WavPack,
+      APE,
+      TrueAudio,
+      MP4,
+      ASF,
+      AIFF,
+      WAV,
+      DSF,
+      DSDIFF,
+      Shorten
+    };
+
+    /*!
+     * Returns the types whose signatures are found at the beginning of
+     * \a stream, the most specific match first.  The stream is read at most
+     * twice, once at its beginning and once after a leading ID3v2 tag if it
+     * does not fit into the first read.  Like the isSupported() functions of
+     * the file classes, this only does a quick check.
+     */
+    TAGLIB_EXPORT std::vector<Type> detect(IOStream *stream);
+
+    /*!
+     * The number of bytes at the beginning of a stream which detect() reads.
+     * This leaves room for a small ID3v2 tag in front of the 4 KiB which are
+     * checked after it.
+     */
+    constexpr unsigned int HeaderLength = 16 * 1024;
+
+    /*!
+     * Like detect(IOStream *), but with the first HeaderLength bytes of
+     * \a stream already read into \a header.
+     */
+    TAGLIB_EXPORT std::vector<Type> detect(IOStream *stream, const ByteVector &header);
+
+  }  // namespace FileTypes
+}  // namespace TagLib
+
+#endif
+
+#endif
@@ -49,6 +49,12 @@ namespace
   constexpr long MaxPaddingLegnth = 1024 * 1024;
 
   constexpr char LastBlockFlag = '\x80';
+
+  // Picture blocks of at least this size are read partly if the file defers
+  // payloads.
+
+  constexpr unsigned int MinDeferredPictureSize = 16 * 1024;
+  constexpr unsigned int DeferredPictureReadSize = 1024;
 }  // namespace
 
 class FLAC::File::FilePrivate
@@ -94,12 +100,21 @@ bool FLAC::File::isSupported(IOStream *stream)
 ////////////////////////////////////////////////////////////////////////////////
 
 FLAC::File::File(FileName file, bool readProperties,
-                 Properties::ReadStyle,
+                 Properties::ReadStyle propertiesStyle,
                  ID3v2::FrameFactory *frameFactory) :
+  File(file, readProperties, propertiesStyle, frameFactory, ReadPayloads)
+{
+}
+
+FLAC::File::File(FileName file, bool readProperties,
+                 Properties::ReadStyle,
+                 ID3v2::FrameFactory *frameFactory,
+                 PayloadStyle payloadStyle) :
   TagLib::File(file),
   d(std::make_unique<FilePrivate>(
     frameFactory ? frameFactory : ID3v2::FrameFactory::instance()))
 {
+  setPayloadStyle(payloadStyle);
   if(isOpen())
     read(readProperties);
 }
@@ -114,12 +129,21 @@ FLAC::File::File(FileName file, ID3v2::FrameFactory *frameFactory,
 }
 
 FLAC::File::File(IOStream *stream, bool readProperties,
-                 Properties::ReadStyle,
+                 Properties::ReadStyle propertiesStyle,
                  ID3v2::FrameFactory *frameFactory) :
+  File(stream, readProperties, propertiesStyle, frameFactory, ReadPayloads)
+{
+}
+
+FLAC::File::File(IOStream *stream, bool readProperties,
+                 Properties::ReadStyle,
+                 ID3v2::FrameFactory *frameFactory,
+                 PayloadStyle payloadStyle) :
   TagLib::File(stream),
   d(std::make_unique<FilePrivate>(
     frameFactory ? frameFactory : ID3v2::FrameFactory::instance()))
 {
+  setPayloadStyle(payloadStyle);
   if(isOpen())
     read(readProperties);
 }
@@ -235,6 +259,99 @@ bool FLAC::File::save()
     return false;
   }
 
+  return saveWithStrategy([&] { return saveImpl(); });
+}
+
+ID3v2::Tag *FLAC::File::ID3v2Tag(bool create)
+{
+  return d->tag.access<ID3v2::Tag>(FlacID3v2Index, create,
+                                   d->ID3v2FrameFactory);
+}
+
+ID3v1::Tag *FLAC::File::ID3v1Tag(bool create)
+{
+  return d->tag.access<ID3v1::Tag>(FlacID3v1Index, create);
+}
+
+Ogg::XiphComment *FLAC::File::xiphComment(bool create)
+{
+  return d->tag.access<Ogg::XiphComment>(FlacXiphIndex, create);
+}
+
+List<FLAC::Picture *> FLAC::File::pictureList()
+{
+  List<Picture *> pictures;
+  for(const auto &block : std::as_const(d->blocks)) {
+    if(auto picture = dynamic_cast<Picture *>(block)) {
+      pictures.append(picture);
+    }
+  }
+  return pictures;
+}
+
+void FLAC::File::addPicture(Picture *picture)
+{
+  d->blocks.append(picture);
+}
+
+void FLAC::File::removePicture(Picture *picture, bool del)
+{
+  auto it = d->blocks.find(picture);
+  if(it != d->blocks.end())
+    d->blocks.erase(it);
+
+  if(del)
+    delete picture;
+}
+
+void FLAC::File::removePictures()
+{
+  for(auto it = d->blocks.begin(); it != d->blocks.end(); ) {
+    if(dynamic_cast<Picture *>(*it)) {
+      delete *it;
+      it = d->blocks.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+}
+
+void FLAC::File::strip(int tags)
+{
+  if(tags & ID3v1)
+    d->tag.set(FlacID3v1Index, nullptr);
+
+  if(tags & ID3v2)
+    d->tag.set(FlacID3v2Index, nullptr);
+
+  if(tags & XiphComment) {
+    xiphComment()->removeAllFields();
+    xiphComment()->removeAllPictures();
+  }
+}
+
+bool FLAC::File::hasXiphComment() const
+{
+  return !d->xiphCommentData.isEmpty();
+}
+
+bool FLAC::File::hasID3v1Tag() const
+{
+  return d->ID3v1Location >= 0;
+}
+
+bool FLAC::File::hasID3v2Tag() const
+{
+  return d->ID3v2Location >= 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// private members
+////////////////////////////////////////////////////////////////////////////////
+
+bool FLAC::File::saveImpl()
+{
   // Create new vorbis comments
   if(!hasXiphComment())
     Tag::duplicate(&d->tag, xiphComment(true), false);
@@ -378,94 +495,6 @@ bool FLAC::File::save()
   return true;
 }
 
-ID3v2::Tag *FLAC::File::ID3v2Tag(bool create)
-{
-  return d->tag.access<ID3v2::Tag>(FlacID3v2Index, create,
-                                   d->ID3v2FrameFactory);
-}
-
-ID3v1::Tag *FLAC::File::ID3v1Tag(bool create)
-{
-  return d->tag.access<ID3v1::Tag>(FlacID3v1Index, create);
-}
-
-Ogg::XiphComment *FLAC::File::xiphComment(bool create)
-{
-  return d->tag.access<Ogg::XiphComment>(FlacXiphIndex, create);
-}
-
-List<FLAC::Picture *> FLAC::File::pictureList()
-{
-  List<Picture *> pictures;
-  for(const auto &block : std::as_const(d->blocks)) {
-    if(auto picture = dynamic_cast<Picture *>(block)) {
-      pictures.append(picture);
-    }
-  }
-  return pictures;
-}
-
-void FLAC::File::addPicture(Picture *picture)
-{
-  d->blocks.append(picture);
-}
-
-void FLAC::File::removePicture(Picture *picture, bool del)
-{
-  auto it = d->blocks.find(picture);
-  if(it != d->blocks.end())
-    d->blocks.erase(it);
-
-  if(del)
-    delete picture;
-}
-
-void FLAC::File::removePictures()
-{
-  for(auto it = d->blocks.begin(); it != d->blocks.end(); ) {
-    if(dynamic_cast<Picture *>(*it)) {
-      delete *it;
-      it = d->blocks.erase(it);
-    }
-    else {
-      ++it;
-    }
-  }
-}
-
-void FLAC::File::strip(int tags)
-{
-  if(tags & ID3v1)
-    d->tag.set(FlacID3v1Index, nullptr);
-
-  if(tags & ID3v2)
-    d->tag.set(FlacID3v2Index, nullptr);
-
-  if(tags & XiphComment) {
-    xiphComment()->removeAllFields();
-    xiphComment()->removeAllPictures();
-  }
-}
-
-bool FLAC::File::hasXiphComment() const
-{
-  return !d->xiphCommentData.isEmpty();
-}
-
-bool FLAC::File::hasID3v1Tag() const
-{
-  return d->ID3v1Location >= 0;
-}
-
-bool FLAC::File::hasID3v2Tag() const
-{
-  return d->ID3v2Location >= 0;
-}
-
-////////////////////////////////////////////////////////////////////////////////
-// private members
-////////////////////////////////////////////////////////////////////////////////
-
 void FLAC::File::read(bool readProperties)
 {
   // Look for an ID3v2 tag
@@ -581,6 +610,26 @@ void FLAC::File::scan()
       return;
     }
 
+    // With deferred payloads, only the beginning of large picture blocks is
+    // read, the picture data is read on first access.
+
+    if(blockType == MetadataBlock::Picture && blockLength >= MinDeferredPictureSize &&
+       payloadStyle() == DeferPayloads) {
+      const offset_t blockOffset = nextBlockOffset + 4;
+      const ByteVector data = readBlock(DeferredPictureReadSize);
+      auto picture = new FLAC::Picture();
+      if(picture->parse(data, blockLength, deferredReadBlock(
+           blockOffset + data.size(), blockLength - data.size()))) {
+        d->blocks.append(picture);
+        nextBlockOffset += blockLength + 4;
+        if(isLastBlock)
+          break;
+        continue;
+      }
+      delete picture;
+      seek(blockOffset);
+    }
+
     const ByteVector data = readBlock(blockLength);
     if(data.size() != blockLength) {
       debug("FLAC::File::scan() -- Failed to read a metadata block");
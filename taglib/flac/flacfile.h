@@ -95,6 +95,16 @@ namespace TagLib {
            Properties::ReadStyle propertiesStyle = Properties::Average,
            ID3v2::FrameFactory *frameFactory = nullptr);
 
+      /*!
+       * Same as the constructor above, but \a payloadStyle specifies when
+       * pictures and other large binary payloads are read, see
+       * TagLib::File::payloadStyle().
+       */
+      File(FileName file, bool readProperties,
+           Properties::ReadStyle propertiesStyle,
+           ID3v2::FrameFactory *frameFactory,
+           PayloadStyle payloadStyle);
+
       /*!
        * Constructs a FLAC file from \a file.  If \a readProperties is \c true the
        * file's audio properties will also be read.
@@ -127,6 +137,16 @@ namespace TagLib {
            Properties::ReadStyle propertiesStyle = Properties::Average,
            ID3v2::FrameFactory *frameFactory = nullptr);
 
+      /*!
+       * Same as the constructor above, but \a payloadStyle specifies when
+       * pictures and other large binary payloads are read, see
+       * TagLib::File::payloadStyle().
+       */
+      File(IOStream *stream, bool readProperties,
+           Properties::ReadStyle propertiesStyle,
+           ID3v2::FrameFactory *frameFactory,
+           PayloadStyle payloadStyle);
+
       /*!
        * Constructs a FLAC file from \a stream.  If \a readProperties is \c true the
        * file's audio properties will also be read.
@@ -344,6 +364,7 @@ namespace TagLib {
     private:
       void read(bool readProperties);
       void scan();
+      bool saveImpl();
 
       class FilePrivate;
       TAGLIB_MSVC_SUPPRESS_WARNING_NEEDS_TO_HAVE_DLL_INTERFACE
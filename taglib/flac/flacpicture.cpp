@@ -25,6 +25,9 @@
 
 #include "flacpicture.h"
 
+#include <algorithm>
+#include <mutex>
+
 #include "tdebug.h"
 
 using namespace TagLib;
@@ -40,6 +43,11 @@ public:
   int colorDepth { 0 };
   int numColors { 0 };
   ByteVector data;
+
+  // Reads the rest of the block if the picture data was only partly read
+  unsigned int dataLength { 0 };
+  std::function<ByteVector()> readRest;
+  std::mutex readRestMutex;
 };
 
 FLAC::Picture::Picture() :
@@ -61,6 +69,12 @@ int FLAC::Picture::code() const
 }
 
 bool FLAC::Picture::parse(const ByteVector &data)
+{
+  return parse(data, data.size(), nullptr);
+}
+
+bool FLAC::Picture::parse(const ByteVector &data, unsigned int length,
+                          const std::function<ByteVector()> &readRest)
 {
   if(data.size() < 32) {
     debug("A picture block must contain at least 5 bytes.");
@@ -96,11 +110,13 @@ bool FLAC::Picture::parse(const ByteVector &data)
   pos += 4;
   unsigned int dataLength = data.toUInt(pos);
   pos += 4;
-  if(pos + dataLength > data.size()) {
+  if(pos + dataLength > length || (!readRest && pos + dataLength > data.size())) {
     debug("Invalid picture block.");
     return false;
   }
   d->data = data.mid(pos, dataLength);
+  d->dataLength = dataLength;
+  d->readRest = d->data.size() < dataLength ? readRest : nullptr;
 
   return true;
 }
@@ -119,8 +135,9 @@ ByteVector FLAC::Picture::render() const
   result.append(ByteVector::fromUInt(d->height));
   result.append(ByteVector::fromUInt(d->colorDepth));
   result.append(ByteVector::fromUInt(d->numColors));
-  result.append(ByteVector::fromUInt(d->data.size()));
-  result.append(d->data);
+  const ByteVector pictureData = data();
+  result.append(ByteVector::fromUInt(pictureData.size()));
+  result.append(pictureData);
   return result;
 }
 
@@ -196,10 +213,22 @@ void FLAC::Picture::setNumColors(int numColors)
 
 ByteVector FLAC::Picture::data() const
 {
+  // The rest is read at most once, even if data() is called from several
+  // threads.
+  {
+    std::lock_guard<std::mutex> lock(d->readRestMutex);
+    if(d->readRest) {
+      d->data.append(d->readRest());
+      d->data.resize(std::min(d->data.size(), d->dataLength));
+      d->readRest = nullptr;
+    }
+  }
   return d->data;
 }
 
 void FLAC::Picture::setData(const ByteVector &data)
 {
+  std::lock_guard<std::mutex> lock(d->readRestMutex);
   d->data = data;
+  d->readRest = nullptr;
 }
@@ -26,6 +26,8 @@
 #ifndef TAGLIB_FLACPICTURE_H
 #define TAGLIB_FLACPICTURE_H
 
+#include <functional>
+
 #include "tlist.h"
 #include "tstring.h"
 #include "tbytevector.h"
@@ -152,6 +154,16 @@ namespace TagLib {
       bool parse(const ByteVector &data);
 
     private:
+      friend class File;
+
+      /*!
+       * Parses the beginning \a data of a picture block of \a length bytes.
+       * The rest of the block is read by \a readRest when the picture data is
+       * first used.  The fields before the picture data must be in \a data.
+       */
+      bool parse(const ByteVector &data, unsigned int length,
+                 const std::function<ByteVector()> &readRest);
+
       class PicturePrivate;
       TAGLIB_MSVC_SUPPRESS_WARNING_NEEDS_TO_HAVE_DLL_INTERFACE
       std::unique_ptr<PicturePrivate> d;
@@ -0,0 +1,803 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#include "metadatacache.h"
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <cerrno>
+# include <fcntl.h>
+# include <sys/file.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "tfilestream.h"
+#include "tmappedfilestream.h"
+#include "tcachediostream.h"
+#include "trewritestream.h"
+#include "tserialization.h"
+#include "tdebug.h"
+
+using namespace TagLib;
+
+namespace
+{
+  // The cache file starts with a header, which is followed by the records.
+  // Each record consists of the length of its body, the body and a checksum
+  // of the body, so that an incomplete record at the end of the file can be
+  // detected.
+
+  const ByteVector FileIdentifier("TagLibMC", 8);
+  constexpr unsigned int FormatVersion = 2;
+  constexpr unsigned int HeaderSize = 12;
+
+  // The records are written in blocks of at least this size.
+
+  constexpr unsigned int FlushSize = 64 * 1024;
+
+  enum RecordFlags {
+    HasAudioProperties = 1
+  };
+
+  // The stat information which identifies an unchanged file
+
+  struct FileInfo
+  {
+    long long size { -1 };
+    long long modified { 0 };
+    long long id { 0 };
+
+    bool operator==(const FileInfo &other) const
+    {
+      return size == other.size && modified == other.modified && id == other.id;
+    }
+  };
+
+  bool fileInfo(FileName fileName, FileInfo &info)
+  {
+#ifdef _WIN32
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if(!GetFileAttributesExW(fileName.wstr().c_str(), GetFileExInfoStandard, &data) ||
+       (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+      return false;
+    info.size = static_cast<long long>(data.nFileSizeHigh) << 32 | data.nFileSizeLow;
+    info.modified = static_cast<long long>(data.ftLastWriteTime.dwHighDateTime) << 32 |
+                    data.ftLastWriteTime.dwLowDateTime;
+    info.id = 0;
+#else
+    struct stat st;
+    if(stat(fileName, &st) != 0 || !S_ISREG(st.st_mode))
+      return false;
+    info.size = static_cast<long long>(st.st_size);
+# ifdef HAVE_STAT_MTIM
+    info.modified = static_cast<long long>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+# else
+    info.modified = static_cast<long long>(st.st_mtime) * 1000000000LL;
+# endif
+    info.id = static_cast<long long>(st.st_ino);
+#endif
+    return true;
+  }
+
+#ifdef _WIN32
+
+  bool createFile(FileName fileName)
+  {
+    const HANDLE file = CreateFileW(fileName.wstr().c_str(), GENERIC_WRITE, FILE_SHARE_READ,
+                                    nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(file == INVALID_HANDLE_VALUE)
+      return false;
+    CloseHandle(file);
+    return true;
+  }
+
+#else
+
+  // flock() is used rather than fcntl() locks, which are released when the
+  // process closes any descriptor of the file, e.g. the one of a FileStream.
+
+  bool lockFile(int descriptor)
+  {
+    while(flock(descriptor, LOCK_EX) != 0) {
+      if(errno != EINTR)
+        return false;
+    }
+    return true;
+  }
+
+  // Returns true if the descriptor still refers to the file with the name,
+  // which compact() of another process may have replaced.
+
+  bool isSameFile(int descriptor, const std::string &fileName)
+  {
+    struct stat opened;
+    struct stat named;
+    return fstat(descriptor, &opened) == 0 && stat(fileName.c_str(), &named) == 0 &&
+           opened.st_dev == named.st_dev && opened.st_ino == named.st_ino;
+  }
+
+#endif
+
+  // The cache is keyed by the path in UTF-8 on Windows and by the path as it
+  // is given elsewhere.
+
+  std::string cacheKey(FileName fileName)
+  {
+#ifdef _WIN32
+    return fileName.toString().to8Bit(true);
+#else
+    return fileName;
+#endif
+  }
+
+#ifdef _WIN32
+  std::wstring fileNameForKey(const std::string &key)
+  {
+    return String(key, String::UTF8).toWString();
+  }
+#else
+  const std::string &fileNameForKey(const std::string &key)
+  {
+    return key;
+  }
+#endif
+
+  // FNV-1a, which is good enough to detect incompletely written records.
+
+  unsigned int checksum(const ByteVector &data)
+  {
+    unsigned int hash = 2166136261U;
+    for(auto c : data) {
+      hash ^= static_cast<unsigned char>(c);
+      hash *= 16777619U;
+    }
+    return hash;
+  }
+
+  ByteVector renderRecord(const std::string &key, const FileInfo &info,
+                          unsigned int flags, const FileRef::BatchResult &result)
+  {
+    ByteVector body;
+    Serialization::appendBytes(body, ByteVector(key.data(), static_cast<unsigned int>(key.size())));
+    body.append(ByteVector::fromLongLong(info.size));
+    body.append(ByteVector::fromLongLong(info.modified));
+    body.append(ByteVector::fromLongLong(info.id));
+    body.append(static_cast<char>(flags));
+    body.append(static_cast<char>(result.status));
+    body.append(ByteVector::fromUInt(static_cast<unsigned int>(result.lengthInMilliseconds)));
+    body.append(ByteVector::fromUInt(static_cast<unsigned int>(result.bitrate)));
+    body.append(ByteVector::fromUInt(static_cast<unsigned int>(result.sampleRate)));
+    body.append(ByteVector::fromUInt(static_cast<unsigned int>(result.channels)));
+    Serialization::appendStringList(body, result.complexPropertyKeys);
+    Serialization::appendBytes(body, result.properties.serialize());
+
+    ByteVector record = ByteVector::fromUInt(body.size());
+    record.append(body);
+    record.append(ByteVector::fromUInt(checksum(body)));
+    return record;
+  }
+
+  // Reads the key and the stat information at the start of a record body.
+
+  bool readRecordHead(Serialization::Reader &reader, std::string &key, FileInfo &info,
+                      unsigned int &flags)
+  {
+    const ByteVector keyData = reader.readBytes();
+    key.assign(keyData.data(), keyData.size());
+    info.size = static_cast<long long>(reader.readULongLong());
+    info.modified = static_cast<long long>(reader.readULongLong());
+    info.id = static_cast<long long>(reader.readULongLong());
+    flags = reader.readByte();
+    return reader.isValid();
+  }
+
+  bool readRecordResult(Serialization::Reader &reader, FileRef::BatchResult &result)
+  {
+    const unsigned int status = reader.readByte();
+    if(status > FileRef::BatchResult::InvalidFile)
+      return false;
+    result.status = static_cast<FileRef::BatchResult::Status>(status);
+    result.lengthInMilliseconds = static_cast<int>(reader.readUInt());
+    result.bitrate = static_cast<int>(reader.readUInt());
+    result.sampleRate = static_cast<int>(reader.readUInt());
+    result.channels = static_cast<int>(reader.readUInt());
+    result.complexPropertyKeys = reader.readStringList();
+    bool ok;
+    result.properties = PropertyMap::deserialize(reader.readBytes(), &ok);
+    return ok && reader.isValid();
+  }
+}  // namespace
+
+class MetadataCache::MetadataCachePrivate
+{
+public:
+  MetadataCachePrivate(FileName fileName) :
+    fileName(fileName)
+  {
+  }
+
+  ~MetadataCachePrivate()
+  {
+    close();
+  }
+
+  // The location of the latest record of a file
+
+  struct Entry
+  {
+    FileInfo info;
+    unsigned int flags;
+    offset_t offset;
+    unsigned int length;
+  };
+
+  void open();
+  void close();
+  bool flush();
+  ByteVector readRecord(const Entry &entry) const;
+
+  bool openFile();
+  bool lock(bool &replaced);
+  void unlock();
+  bool load();
+  bool reload();
+  bool update();
+  bool append();
+  bool write(const ByteVector &data);
+  offset_t indexRecords(IOStream *stream, offset_t offset, offset_t length);
+  offset_t currentLength();
+  bool truncate(offset_t length);
+
+#ifdef _WIN32
+  const std::wstring fileName;
+#else
+  const std::string fileName;
+#endif
+
+  mutable std::mutex mutex;
+  std::unordered_map<std::string, Entry> entries;
+
+  // The records which were in the file when it was opened are read from
+  // "source", which maps the file where possible, the records which were
+  // appended later from "file".  The records which have not been written yet
+  // are in "pending", their entries also in "pendingEntries".
+
+  std::unique_ptr<FileStream> file;
+  std::unique_ptr<IOStream> source;
+  offset_t sourceLength { 0 };
+  offset_t fileLength { 0 };
+  ByteVector pending;
+  std::vector<std::pair<std::string, Entry>> pendingEntries;
+
+#ifndef _WIN32
+  // Records are appended with O_APPEND through this descriptor, which is
+  // also locked while the file is read or written.
+  int descriptor { -1 };
+#endif
+};
+
+void MetadataCache::MetadataCachePrivate::open()
+{
+  close();
+
+  if(bool replaced; !lock(replaced)) {
+    close();
+    return;
+  }
+
+  const bool loaded = load();
+  unlock();
+
+  if(!loaded)
+    close();
+}
+
+void MetadataCache::MetadataCachePrivate::close()
+{
+  entries.clear();
+  pending.clear();
+  pendingEntries.clear();
+  source.reset();
+  file.reset();
+#ifndef _WIN32
+  if(descriptor >= 0) {
+    ::close(descriptor);
+    descriptor = -1;
+  }
+#endif
+  sourceLength = fileLength = 0;
+}
+
+bool MetadataCache::MetadataCachePrivate::flush()
+{
+  if(!file || pending.isEmpty())
+    return true;
+
+  bool replaced;
+  if(!lock(replaced))
+    return false;
+
+  const bool written = (!replaced || reload()) && update() && append();
+  unlock();
+  return written;
+}
+
+// Opens the cache file.  On Windows, the FileStream is opened for writing,
+// which keeps other processes from opening it.
+
+bool MetadataCache::MetadataCachePrivate::openFile()
+{
+#ifdef _WIN32
+  if(!createFile(fileName.c_str())) {
+    debug("MetadataCache::MetadataCache() -- Could not create the cache file.");
+    return false;
+  }
+
+  file = std::make_unique<FileStream>(fileName.c_str(), false);
+  if(!file->isOpen() || file->readOnly()) {
+    debug("MetadataCache::MetadataCache() -- Could not open the cache file for writing.");
+    file.reset();
+    return false;
+  }
+#else
+  descriptor = ::open(fileName.c_str(), O_RDWR | O_CREAT | O_APPEND, 0666);
+  if(descriptor < 0) {
+    debug("MetadataCache::MetadataCache() -- Could not open the cache file for writing.");
+    return false;
+  }
+#endif
+  return true;
+}
+
+// Locks the cache file, opening it first if needed.  If another process has
+// replaced it with compact(), the new file is opened and locked, and
+// "replaced" is set, then its records still have to be read.
+
+bool MetadataCache::MetadataCachePrivate::lock(bool &replaced)
+{
+  replaced = false;
+
+#ifdef _WIN32
+  return file || openFile();
+#else
+  for(int attempt = 0; attempt < 3; ++attempt) {
+    if(descriptor < 0) {
+      if(!openFile())
+        return false;
+      replaced = file != nullptr;
+    }
+
+    if(!lockFile(descriptor)) {
+      debug("MetadataCache -- Could not lock the cache file.");
+      return false;
+    }
+
+    if(isSameFile(descriptor, fileName))
+      return true;
+
+    ::close(descriptor);
+    descriptor = -1;
+  }
+
+  debug("MetadataCache -- The cache file keeps being replaced.");
+  return false;
+#endif
+}
+
+void MetadataCache::MetadataCachePrivate::unlock()
+{
+#ifndef _WIN32
+  if(descriptor >= 0)
+    flock(descriptor, LOCK_UN);
+#endif
+}
+
+// Reads the index of the locked cache file.  An incomplete record at its end,
+// e.g. of a process which was killed while writing it, is dropped.
+
+bool MetadataCache::MetadataCachePrivate::load()
+{
+  entries.clear();
+  source.reset();
+
+#ifndef _WIN32
+  file = std::make_unique<FileStream>(fileName.c_str(), true);
+  if(!file->isOpen()) {
+    debug("MetadataCache::MetadataCache() -- Could not open the cache file.");
+    file.reset();
+    return false;
+  }
+#endif
+
+  const offset_t length = currentLength();
+  const ByteVector header = file->readBlockAt(0, HeaderSize);
+  if(length > 0 && !header.startsWith(FileIdentifier)) {
+    debug("MetadataCache::MetadataCache() -- The file is not a metadata cache.");
+    file.reset();
+    return false;
+  }
+
+  if(header.size() < HeaderSize || header.toUInt(8U) != FormatVersion) {
+    // An empty file or a cache in a different format, which is replaced.
+    if(!truncate(0) || !write(FileIdentifier + ByteVector::fromUInt(FormatVersion))) {
+      file.reset();
+      return false;
+    }
+    sourceLength = fileLength = HeaderSize;
+    return true;
+  }
+
+  // The records are read once to build the index, so the file is read through
+  // a memory map or, where this is not supported, a page cache.
+
+  if(auto mapped = std::make_unique<MappedFileStream>(fileName.c_str()); mapped->isOpen())
+    source = std::move(mapped);
+  else
+    source = std::make_unique<CachedIOStream>(file.get(), 64 * 1024, 4);
+
+  const offset_t offset = indexRecords(source.get(), HeaderSize, length);
+  if(offset < length) {
+    debug("MetadataCache::MetadataCache() -- Dropping an incomplete record.");
+    truncate(offset);
+  }
+
+  sourceLength = fileLength = offset;
+  return true;
+}
+
+// Reads the index of a cache file which has replaced the former one and
+// moves the pending records after its records.
+
+bool MetadataCache::MetadataCachePrivate::reload()
+{
+  const offset_t formerLength = fileLength;
+  if(!load())
+    return false;
+
+  for(auto &[key, entry] : pendingEntries) {
+    entry.offset += fileLength - formerLength;
+    entries[key] = entry;
+  }
+  return true;
+}
+
+// Adds the records which other processes have appended since the file was
+// read to the index.  They precede the pending records, which are moved
+// after them and still supersede them.
+
+bool MetadataCache::MetadataCachePrivate::update()
+{
+  const offset_t length = currentLength();
+  if(length < fileLength) {
+    debug("MetadataCache::flush() -- The cache file was truncated.");
+    return false;
+  }
+  if(length == fileLength)
+    return true;
+
+  const offset_t offset = indexRecords(file.get(), fileLength, length);
+  if(offset < length) {
+    debug("MetadataCache::flush() -- Dropping an incomplete record.");
+    if(!truncate(offset))
+      return false;
+  }
+
+  for(auto &[key, entry] : pendingEntries) {
+    entry.offset += offset - fileLength;
+    entries[key] = entry;
+  }
+  fileLength = offset;
+  return true;
+}
+
+// Appends the pending records to the locked file, which is never larger than
+// fileLength then.
+
+bool MetadataCache::MetadataCachePrivate::append()
+{
+  if(!write(pending)) {
+    debug("MetadataCache::flush() -- Could not write the records.");
+    truncate(fileLength);
+    return false;
+  }
+
+  fileLength += pending.size();
+  pending.clear();
+  pendingEntries.clear();
+  return true;
+}
+
+// Adds the records from offset to length to the index and returns the end of
+// the last complete record.
+
+offset_t MetadataCache::MetadataCachePrivate::indexRecords(IOStream *stream, offset_t offset,
+                                                           offset_t length)
+{
+  while(offset + 8 <= length) {
+    const unsigned int bodyLength = stream->readBlockAt(offset, 4).toUInt();
+    if(static_cast<offset_t>(bodyLength) + 8 > length - offset)
+      break;
+
+    const ByteVector data = stream->readBlockAt(offset + 4, bodyLength + 4);
+    const ByteVector body = data.mid(0, bodyLength);
+    if(data.size() != bodyLength + 4 || data.toUInt(bodyLength) != checksum(body))
+      break;
+
+    Serialization::Reader reader(body);
+    std::string key;
+    Entry entry;
+    if(!readRecordHead(reader, key, entry.info, entry.flags))
+      break;
+
+    entry.offset = offset;
+    entry.length = bodyLength + 8;
+    entries[key] = entry;
+
+    offset += entry.length;
+  }
+  return offset;
+}
+
+// Writes the data at the end of the locked file.
+
+bool MetadataCache::MetadataCachePrivate::write(const ByteVector &data)
+{
+#ifdef _WIN32
+  const offset_t length = file->length();
+  file->seek(length);
+  file->writeBlock(data);
+  return file->length() == length + data.size();
+#else
+  const char *remaining = data.data();
+  size_t count = data.size();
+  while(count > 0) {
+    const ssize_t result = ::write(descriptor, remaining, count);
+    if(result > 0) {
+      remaining += result;
+      count -= static_cast<size_t>(result);
+    }
+    else if(result < 0 && errno == EINTR)
+      continue;
+    else
+      return false;
+  }
+  return true;
+#endif
+}
+
+offset_t MetadataCache::MetadataCachePrivate::currentLength()
+{
+#ifdef _WIN32
+  return file->length();
+#else
+  struct stat st;
+  return fstat(descriptor, &st) == 0 ? static_cast<offset_t>(st.st_size) : -1;
+#endif
+}
+
+bool MetadataCache::MetadataCachePrivate::truncate(offset_t length)
+{
+#ifdef _WIN32
+  file->truncate(length);
+  return file->length() == length;
+#else
+  if(ftruncate(descriptor, length) != 0) {
+    debug("MetadataCache -- Could not truncate the cache file.");
+    return false;
+  }
+  return true;
+#endif
+}
+
+ByteVector MetadataCache::MetadataCachePrivate::readRecord(const Entry &entry) const
+{
+  if(entry.offset + entry.length <= sourceLength && source)
+    return source->readBlockAt(entry.offset, entry.length);
+  if(entry.offset + entry.length <= fileLength)
+    return file->readBlockAt(entry.offset, entry.length);
+  return pending.mid(static_cast<unsigned int>(entry.offset - fileLength), entry.length);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+MetadataCache::MetadataCache(FileName cacheFile) :
+  d(std::make_unique<MetadataCachePrivate>(cacheFile))
+{
+  d->open();
+}
+
+MetadataCache::~MetadataCache()
+{
+  d->flush();
+}
+
+bool MetadataCache::isOpen() const
+{
+  std::lock_guard<std::mutex> lock(d->mutex);
+  return d->file != nullptr;
+}
+
+unsigned int MetadataCache::size() const
+{
+  std::lock_guard<std::mutex> lock(d->mutex);
+  return static_cast<unsigned int>(d->entries.size());
+}
+
+bool MetadataCache::find(FileName fileName, FileRef::BatchResult &result,
+                         bool readAudioProperties) const
+{
+  FileInfo info;
+  if(!fileInfo(fileName, info))
+    return false;
+
+  ByteVector record;
+  {
+    std::lock_guard<std::mutex> lock(d->mutex);
+
+    const auto it = d->entries.find(cacheKey(fileName));
+    if(it == d->entries.end() || !(it->second.info == info) ||
+       (readAudioProperties && !(it->second.flags & HasAudioProperties)))
+      return false;
+
+    record = d->readRecord(it->second);
+  }
+
+  // The record is decoded without holding the lock.
+
+  if(record.size() < 8)
+    return false;
+
+  const ByteVector body = record.mid(4, record.size() - 8);
+  Serialization::Reader reader(body);
+  std::string key;
+  FileInfo recordInfo;
+  unsigned int flags;
+  FileRef::BatchResult cached;
+  if(!readRecordHead(reader, key, recordInfo, flags) || !readRecordResult(reader, cached)) {
+    debug("MetadataCache::find() -- Invalid record.");
+    return false;
+  }
+
+  cached.index = result.index;
+  result = cached;
+  return true;
+}
+
+void MetadataCache::insert(FileName fileName, const FileRef::BatchResult &result,
+                           bool readAudioProperties)
+{
+  if(result.status == FileRef::BatchResult::OpenError)
+    return;
+
+  MetadataCachePrivate::Entry entry;
+  if(!fileInfo(fileName, entry.info))
+    return;
+
+  const std::string key = cacheKey(fileName);
+  // Files which are not read have no audio properties either way.
+
+  entry.flags = readAudioProperties || result.status != FileRef::BatchResult::Read
+    ? HasAudioProperties : 0;
+  const ByteVector record = renderRecord(key, entry.info, entry.flags, result);
+
+  std::lock_guard<std::mutex> lock(d->mutex);
+
+  if(!d->file)
+    return;
+
+  entry.offset = d->fileLength + d->pending.size();
+  entry.length = record.size();
+  d->pending.append(record);
+  d->pendingEntries.emplace_back(key, entry);
+  d->entries[key] = entry;
+
+  if(d->pending.size() >= FlushSize)
+    d->flush();
+}
+
+List<unsigned int> MetadataCache::validate(const List<FileName> &fileNames) const
+{
+  List<unsigned int> changed;
+  unsigned int index = 0;
+  for(const auto &fileName : fileNames) {
+    FileInfo info;
+    bool unchanged = fileInfo(fileName, info);
+    if(unchanged) {
+      std::lock_guard<std::mutex> lock(d->mutex);
+      const auto it = d->entries.find(cacheKey(fileName));
+      unchanged = it != d->entries.end() && it->second.info == info;
+    }
+    if(!unchanged)
+      changed.append(index);
+    ++index;
+  }
+  return changed;
+}
+
+bool MetadataCache::flush()
+{
+  std::lock_guard<std::mutex> lock(d->mutex);
+  return d->flush();
+}
+
+bool MetadataCache::compact()
+{
+  std::lock_guard<std::mutex> lock(d->mutex);
+
+  if(!d->file || !d->flush())
+    return false;
+
+  // The file stays locked until it is replaced, so that other processes do
+  // not append records to it which would be lost.
+
+  if(bool replaced; !d->lock(replaced) || (replaced && !d->reload()) || !d->update()) {
+    d->unlock();
+    return false;
+  }
+
+  ByteVector data = FileIdentifier + ByteVector::fromUInt(FormatVersion);
+  for(const auto &[key, entry] : d->entries) {
+    if(FileInfo info; fileInfo(fileNameForKey(key).c_str(), info) && info == entry.info)
+      data.append(d->readRecord(entry));
+  }
+
+  // The streams have to be closed before the file can be replaced on some
+  // platforms.
+
+  d->source.reset();
+  d->file.reset();
+
+  bool written = false;
+  {
+    FileStream stream(d->fileName.c_str());
+    if(RewriteStream::canRewrite(&stream)) {
+      RewriteStream rewriteStream(&stream);
+      rewriteStream.truncate(0);
+      rewriteStream.writeBlock(data);
+      written = rewriteStream.commit();
+    }
+  }
+
+  if(!written)
+    debug("MetadataCache::compact() -- Could not replace the cache file.");
+
+  d->unlock();
+  d->open();
+  return written;
+}
@@ -0,0 +1,143 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#ifndef TAGLIB_METADATACACHE_H
+#define TAGLIB_METADATACACHE_H
+
+#include "fileref.h"
+
+namespace TagLib {
+
+  //! A persistent cache of the metadata read by FileRef::readMany()
+
+  /*!
+   * The cache stores the results of reading files in a cache file, keyed by
+   * the path of each file together with its size, modification time and, where
+   * the platform has them, its inode number.  As long as these do not change,
+   * the result can be taken from the cache without opening the file, so that
+   * rescanning a large collection of unchanged files only needs a stat() call
+   * per file.
+   *
+   * The cache file is append-only: a changed file gets a new record, which
+   * supersedes the older ones.  compact() removes the superseded records.
+   * The existing records are read through a memory map where the platform
+   * supports it.  A record which was not completely written, e.g. because the
+   * process was killed, is ignored and overwritten.
+   *
+   * All methods may be called from several threads at once, e.g. from the
+   * handler of FileRef::readMany().
+   *
+   * On POSIX systems several processes may use the same cache file.  It is
+   * locked with flock() while it is read and while records are appended, and
+   * the records which other processes have appended are added when flush()
+   * is called.  If another process has replaced the file with compact(), it
+   * is read again.  On Windows the cache file can only be open in one
+   * process at a time, isOpen() returns \c false in the others.
+   *
+   * \see FileRef::readMany()
+   */
+  class TAGLIB_EXPORT MetadataCache
+  {
+  public:
+    /*!
+     * Opens the cache in \a cacheFile, which is created if it does not
+     * exist.  If it exists but is not a cache file, it is left untouched and
+     * isOpen() returns \c false.
+     */
+    explicit MetadataCache(FileName cacheFile);
+
+    /*!
+     * Writes the pending records to the cache file and closes it.
+     */
+    ~MetadataCache();
+
+    MetadataCache(const MetadataCache &) = delete;
+    MetadataCache &operator=(const MetadataCache &) = delete;
+
+    /*!
+     * Returns \c true if the cache file could be opened.
+     */
+    bool isOpen() const;
+
+    /*!
+     * Returns the number of files in the cache.
+     */
+    unsigned int size() const;
+
+    /*!
+     * Looks up \a fileName and copies its cached result to \a result if the
+     * size and modification time of the file are unchanged.  Returns \c false
+     * if there is no such result.  If \a readAudioProperties is \c true,
+     * results of files which were read without audio properties are not
+     * returned, results of files which are unsupported or invalid are.
+     *
+     * The index of \a result is not changed.
+     */
+    bool find(FileName fileName, FileRef::BatchResult &result,
+              bool readAudioProperties = true) const;
+
+    /*!
+     * Stores \a result for \a fileName together with the current size and
+     * modification time of the file.  \a readAudioProperties tells whether
+     * \a result contains the audio properties.  Results with the OpenError
+     * status are not stored.
+     *
+     * The record is written to the cache file by flush(), which is called
+     * when enough records are pending and when the cache is destroyed.
+     */
+    void insert(FileName fileName, const FileRef::BatchResult &result,
+                bool readAudioProperties = true);
+
+    /*!
+     * Returns the indexes of the files in \a fileNames which have no result
+     * in the cache or which have been changed since their result was stored.
+     * Only the stat information of the files is used, the files are not
+     * opened.
+     */
+    List<unsigned int> validate(const List<FileName> &fileNames) const;
+
+    /*!
+     * Writes the pending records to the cache file.  Returns \c false if
+     * they could not be written.
+     */
+    bool flush();
+
+    /*!
+     * Rewrites the cache file with only the latest record of each file,
+     * dropping the records of files which have been changed or removed since.
+     * The cache file is replaced atomically.  Returns \c false if it could
+     * not be rewritten.
+     */
+    bool compact();
+
+  private:
+    class MetadataCachePrivate;
+    TAGLIB_MSVC_SUPPRESS_WARNING_NEEDS_TO_HAVE_DLL_INTERFACE
+    std::unique_ptr<MetadataCachePrivate> d;
+  };
+
+}  // namespace TagLib
+
+#endif
@@ -52,45 +52,54 @@ public:
 };
 
 MP4::Atom::Atom(File *file)
-  : d(std::make_unique<AtomPrivate>(file->tell()))
+  : Atom(file, file->tell(), file->length())
+{
+  if(d->length == 0)
+    file->seek(0, File::End);
+  else
+    file->seek(d->offset + d->length);
+}
+
+MP4::Atom::Atom(File *file, offset_t offset, offset_t fileLength)
+  : d(std::make_unique<AtomPrivate>(offset))
 {
   d->children.setAutoDelete(true);
 
-  ByteVector header = file->readBlock(8);
+  const ByteVector header = file->readBlockAt(d->offset, 8);
   if(header.size() != 8) {
     // The atom header must be 8 bytes long, otherwise there is either
     // trailing garbage or the file is truncated
     debug("MP4: Couldn't read 8 bytes of data for atom header");
     d->length = 0;
-    file->seek(0, File::End);
     return;
   }
 
+  offset_t headerLength = 8;
+
   d->length = header.toUInt();
 
   if(d->length == 0) {
     // The last atom which extends to the end of the file.
-    d->length = file->length() - d->offset;
+    d->length = fileLength - d->offset;
   }
   else if(d->length == 1) {
     // The atom has a 64-bit length.
-    if(const long long longLength = file->readBlock(8).toLongLong();
+    if(const long long longLength = file->readBlockAt(d->offset + 8, 8).toLongLong();
        longLength <= LONG_MAX) {
       // The actual length fits in long. That's always the case if long is 64-bit.
       d->length = static_cast<long>(longLength);
+      headerLength += 8;
     }
     else {
       debug("MP4: 64-bit atoms are not supported");
       d->length = 0;
-      file->seek(0, File::End);
       return;
     }
   }
 
-  if(d->length < 8 || d->length > file->length() - d->offset) {
+  if(d->length < 8 || d->length > fileLength - d->offset) {
     debug("MP4: Invalid atom size");
     d->length = 0;
-    file->seek(0, File::End);
     return;
   }
 
@@ -98,33 +107,33 @@ MP4::Atom::Atom(File *file)
 
   for(auto c : containers) {
     if(d->name == c) {
+      offset_t childOffset = d->offset + headerLength;
       if(d->name == "meta") {
-        offset_t posAfterMeta = file->tell();
         static constexpr std::array metaChildrenNames {
           "hdlr", "ilst", "mhdr", "ctry", "lang"
         };
         // meta is not a full atom (i.e. not followed by version, flags). It
         // is followed by the size and type of the first child atom.
         auto metaIsFullAtom = std::none_of(metaChildrenNames.begin(), metaChildrenNames.end(),
-          [nextSize = file->readBlock(8).mid(4, 4)](const auto &child) { return nextSize == child; });
+          [nextSize = file->readBlockAt(childOffset, 8).mid(4, 4)](const auto &child) { return nextSize == child; });
         // Only skip next four bytes, which contain version and flags, if meta
         // is a full atom.
-        file->seek(posAfterMeta + (metaIsFullAtom ? 4 : 0));
+        if(metaIsFullAtom)
+          childOffset += 4;
       }
       else if(d->name == "stsd") {
-        file->seek(8, File::Current);
+        childOffset += 8;
       }
-      while(file->tell() < d->offset + d->length) {
-        auto child = new MP4::Atom(file);
+      while(childOffset < d->offset + d->length) {
+        auto child = new MP4::Atom(file, childOffset, fileLength);
         d->children.append(child);
         if(child->d->length == 0)
           return;
+        childOffset += child->d->length;
       }
       return;
     }
   }
-
-  file->seek(d->offset + d->length);
 }
 
 MP4::Atom::~Atom() = default;
@@ -212,22 +221,19 @@ class MP4::Atoms::AtomsPrivate
 {
 public:
   AtomList atoms;
+  bool complete { true };
 };
 
 MP4::Atoms::Atoms(File *file) :
+  Atoms(file, AudioProperties::Average)
+{
+}
+
+MP4::Atoms::Atoms(File *file, AudioProperties::ReadStyle readStyle) :
   d(std::make_unique<AtomsPrivate>())
 {
   d->atoms.setAutoDelete(true);
-
-  file->seek(0, File::End);
-  offset_t end = file->tell();
-  file->seek(0);
-  while(file->tell() + 8 <= end) {
-    auto atom = new MP4::Atom(file);
-    d->atoms.append(atom);
-    if (atom->length() == 0)
-      break;
-  }
+  read(file, readStyle == AudioProperties::Fast);
 }
 
 MP4::Atoms::~Atoms() = default;
@@ -293,3 +299,38 @@ const MP4::AtomList &MP4::Atoms::atoms() const
 {
   return d->atoms;
 }
+
+bool MP4::Atoms::isComplete() const
+{
+  return d->complete;
+}
+
+void MP4::Atoms::readAll(File *file)
+{
+  if(!d->complete)
+    read(file, false);
+}
+
+void MP4::Atoms::read(File *file, bool stopAfterMoov)
+{
+  d->atoms.clear();
+  d->complete = true;
+
+  // The tag and the audio properties are in "moov", which has to come before
+  // the fragments ("moof") of a fragmented file.  Fragmented files can have
+  // thousands of root level atoms, which are not needed to read the file.
+
+  const offset_t end = file->length();
+  offset_t offset = 0;
+  while(offset + 8 <= end) {
+    auto atom = new MP4::Atom(file, offset, end);
+    d->atoms.append(atom);
+    if (atom->length() == 0)
+      break;
+    offset += atom->length();
+    if(stopAfterMoov && atom->name() == "moov") {
+      d->complete = offset + 8 > end;
+      break;
+    }
+  }
+}
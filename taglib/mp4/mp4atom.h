@@ -30,6 +30,7 @@
 
 #include "tfile.h"
 #include "tlist.h"
+#include "audioproperties.h"
 
 namespace TagLib {
   namespace MP4 {
@@ -90,6 +91,9 @@ namespace TagLib {
       const AtomList &children() const;
 
     private:
+      friend class Atoms;
+      Atom(File *file, offset_t offset, offset_t fileLength);
+
       class AtomPrivate;
       TAGLIB_MSVC_SUPPRESS_WARNING_NEEDS_TO_HAVE_DLL_INTERFACE
       std::unique_ptr<AtomPrivate> d;
@@ -100,6 +104,9 @@ namespace TagLib {
     {
     public:
       Atoms(File *file);
+      // With the Fast read style, only the root level atoms up to "moov" are
+      // read, which skips the fragments of fragmented files.
+      Atoms(File *file, AudioProperties::ReadStyle readStyle);
       ~Atoms();
       Atoms(const Atoms &) = delete;
       Atoms &operator=(const Atoms &) = delete;
@@ -107,8 +114,14 @@ namespace TagLib {
       AtomList path(const char *name1, const char *name2 = nullptr, const char *name3 = nullptr, const char *name4 = nullptr) const;
       bool checkRootLevelAtoms();
       const AtomList &atoms() const;
+      // Returns false if root level atoms were skipped because of the read
+      // style.  They have to be read with readAll() before the file is changed.
+      bool isComplete() const;
+      void readAll(File *file);
 
     private:
+      void read(File *file, bool stopAfterMoov);
+
       class AtomsPrivate;
       TAGLIB_MSVC_SUPPRESS_WARNING_NEEDS_TO_HAVE_DLL_INTERFACE
       std::unique_ptr<AtomsPrivate> d;
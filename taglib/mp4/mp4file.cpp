@@ -66,22 +66,24 @@ bool MP4::File::isSupported(IOStream *stream)
 // public members
 ////////////////////////////////////////////////////////////////////////////////
 
-MP4::File::File(FileName file, bool readProperties, AudioProperties::ReadStyle,
+MP4::File::File(FileName file, bool readProperties,
+                AudioProperties::ReadStyle audioPropertiesStyle,
                 ItemFactory *itemFactory) :
   TagLib::File(file),
   d(std::make_unique<FilePrivate>(itemFactory))
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, audioPropertiesStyle);
 }
 
-MP4::File::File(IOStream *stream, bool readProperties, AudioProperties::ReadStyle,
+MP4::File::File(IOStream *stream, bool readProperties,
+                AudioProperties::ReadStyle audioPropertiesStyle,
                 ItemFactory *itemFactory) :
   TagLib::File(stream),
   d(std::make_unique<FilePrivate>(itemFactory))
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, audioPropertiesStyle);
 }
 
 MP4::File::~File() = default;
@@ -112,12 +114,12 @@ MP4::Properties *MP4::File::audioProperties() const
 }
 
 void
-MP4::File::read(bool readProperties)
+MP4::File::read(bool readProperties, Properties::ReadStyle readStyle)
 {
   if(!isValid())
     return;
 
-  d->atoms = std::make_unique<Atoms>(this);
+  d->atoms = std::make_unique<Atoms>(this, readStyle);
   if(!d->atoms->checkRootLevelAtoms()) {
     setValid(false);
     return;
@@ -131,10 +133,27 @@ MP4::File::read(bool readProperties)
 
   d->tag = std::make_unique<Tag>(this, d->atoms.get(), d->itemFactory);
   if(readProperties) {
-    d->properties = std::make_unique<Properties>(this, d->atoms.get());
+    d->properties = std::make_unique<Properties>(this, d->atoms.get(), readStyle);
   }
 }
 
+bool
+MP4::File::readAllAtoms()
+{
+  // The offsets in all atoms have to be updated when the tag changes size.
+
+  if(d->atoms->isComplete())
+    return true;
+
+  d->atoms->readAll(this);
+  if(!d->atoms->checkRootLevelAtoms()) {
+    debug("MP4::File::readAllAtoms() -- The file contains invalid atoms.");
+    setValid(false);
+    return false;
+  }
+  return true;
+}
+
 bool
 MP4::File::save()
 {
@@ -148,7 +167,10 @@ MP4::File::save()
     return false;
   }
 
-  return d->tag->save();
+  if(!readAllAtoms())
+    return false;
+
+  return saveWithStrategy([this] { return d->tag->save(); });
 }
 
 bool
@@ -164,8 +186,11 @@ MP4::File::strip(int tags)
     return false;
   }
 
+  if(!readAllAtoms())
+    return false;
+
   if(tags & MP4) {
-    return d->tag->strip();
+    return saveWithStrategy([this] { return d->tag->strip(); });
   }
 
   return true;
@@ -66,7 +66,10 @@ namespace TagLib {
        * Constructs an MP4 file from \a file.  If \a readProperties is \c true the
        * file's audio properties will also be read.
        *
-       * \note In the current implementation, \a propertiesStyle is ignored.
+       * With the Fast \a audioPropertiesStyle, only the atoms up to "moov" are
+       * read, so the fragments of fragmented files are skipped, and the bitrate
+       * is not calculated from the size of the media data if it is not stored
+       * in the file.
        *
        * The items will be created using \a itemFactory (default if null).
        */
@@ -81,7 +84,8 @@ namespace TagLib {
        * \note TagLib will *not* take ownership of the stream, the caller is
        * responsible for deleting it after the File object.
        *
-       * \note In the current implementation, \a propertiesStyle is ignored.
+       * With the Fast \a audioPropertiesStyle, only the atoms up to "moov" are
+       * read, see above.
        *
        * The items will be created using \a itemFactory (default if null).
        */
@@ -162,7 +166,8 @@ namespace TagLib {
       static bool isSupported(IOStream *stream);
 
     private:
-      void read(bool readProperties);
+      void read(bool readProperties, Properties::ReadStyle readStyle);
+      bool readAllAtoms();
 
       class FilePrivate;
       TAGLIB_MSVC_SUPPRESS_WARNING_NEEDS_TO_HAVE_DLL_INTERFACE
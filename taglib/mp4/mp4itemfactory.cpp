@@ -25,6 +25,7 @@
 
 #include "mp4itemfactory.h"
 
+#include <mutex>
 #include <utility>
 
 #include "tbytevector.h"
@@ -44,6 +45,13 @@ constexpr char freeFormPrefix[] = "----:com.apple.iTunes:";
 class ItemFactory::ItemFactoryPrivate
 {
 public:
+  // The maps are filled on first use because they are built by virtual
+  // functions.  As the factory is shared by all files, this has to be safe
+  // when files are read concurrently.
+
+  std::once_flag handlerTypeForNameFilled;
+  std::once_flag propertyKeyForNameFilled;
+  std::once_flag nameForPropertyKeyFilled;
   NameHandlerMap handlerTypeForName;
   Map<ByteVector, String> propertyKeyForName;
   Map<String, ByteVector> nameForPropertyKey;
@@ -234,9 +242,9 @@ std::pair<String, StringList> ItemFactory::itemToProperty(
 
 String ItemFactory::propertyKeyForName(const ByteVector &name) const
 {
-  if(d->propertyKeyForName.isEmpty()) {
+  std::call_once(d->propertyKeyForNameFilled, [this] {
     d->propertyKeyForName = namePropertyMap();
-  }
+  });
   String key = d->propertyKeyForName.value(name);
   if(key.isEmpty() && name.startsWith(freeFormPrefix)) {
     key = name.mid(std::size(freeFormPrefix) - 1);
@@ -246,14 +254,14 @@ String ItemFactory::propertyKeyForName(const ByteVector &name) const
 
 ByteVector ItemFactory::nameForPropertyKey(const String &key) const
 {
-  if(d->nameForPropertyKey.isEmpty()) {
-    if(d->propertyKeyForName.isEmpty()) {
-      d->propertyKeyForName = namePropertyMap();
-    }
+  std::call_once(d->propertyKeyForNameFilled, [this] {
+    d->propertyKeyForName = namePropertyMap();
+  });
+  std::call_once(d->nameForPropertyKeyFilled, [this] {
     for(const auto &[k, t] : std::as_const(d->propertyKeyForName)) {
       d->nameForPropertyKey[t] = k;
     }
-  }
+  });
   ByteVector name = d->nameForPropertyKey.value(key);
   if(name.isEmpty() && !key.isEmpty()) {
     const auto &firstChar = key[0];
@@ -311,9 +319,9 @@ ItemFactory::NameHandlerMap ItemFactory::nameHandlerMap() const
 ItemFactory::ItemHandlerType ItemFactory::handlerTypeForName(
   const ByteVector &name) const
 {
-  if(d->handlerTypeForName.isEmpty()) {
+  std::call_once(d->handlerTypeForNameFilled, [this] {
     d->handlerTypeForName = nameHandlerMap();
-  }
+  });
   auto type = d->handlerTypeForName.value(name, ItemHandlerType::Unknown);
   if (type == ItemHandlerType::Unknown && name.size() == 4) {
     type = ItemHandlerType::Text;
@@ -73,7 +73,7 @@ MP4::Properties::Properties(File *file, const MP4::Atoms *atoms, ReadStyle style
   AudioProperties(style),
   d(std::make_unique<PropertiesPrivate>())
 {
-  read(file, atoms);
+  read(file, atoms, style);
 }
 
 MP4::Properties::~Properties() = default;
@@ -125,7 +125,7 @@ MP4::Properties::codec() const
 ////////////////////////////////////////////////////////////////////////////////
 
 void
-MP4::Properties::read(File *file, const Atoms *atoms)
+MP4::Properties::read(File *file, const Atoms *atoms, ReadStyle style)
 {
   MP4::Atom *moov = atoms->find("moov");
   if(!moov) {
@@ -144,8 +144,7 @@ MP4::Properties::read(File *file, const Atoms *atoms)
       return;
     }
     trak = track;
-    file->seek(hdlr->offset());
-    data = file->readBlock(hdlr->length());
+    data = file->readBlockAt(hdlr->offset(), hdlr->length());
     if(data.containsAt("soun", 16)) {
       break;
     }
@@ -162,8 +161,7 @@ MP4::Properties::read(File *file, const Atoms *atoms)
     return;
   }
 
-  file->seek(mdhd->offset());
-  data = file->readBlock(mdhd->length());
+  data = file->readBlockAt(mdhd->offset(), mdhd->length());
 
   const unsigned int version = data.at(8);
   long long unit;
@@ -187,8 +185,7 @@ MP4::Properties::read(File *file, const Atoms *atoms)
   if(length == 0) {
     // No length found in the media header (mdhd), try the movie header (mvhd)
     if(const MP4::Atom *mvhd = moov->find("mvhd")) {
-      file->seek(mvhd->offset());
-      data = file->readBlock(mvhd->length());
+      data = file->readBlockAt(mvhd->offset(), mvhd->length());
       if(data.size() >= 24 + 4) {
         unit   = data.toUInt(20U);
         length = data.toUInt(24U);
@@ -203,8 +200,7 @@ MP4::Properties::read(File *file, const Atoms *atoms)
     return;
   }
 
-  file->seek(atom->offset());
-  data = file->readBlock(atom->length());
+  data = file->readBlockAt(atom->offset(), atom->length());
   if(data.containsAt("mp4a", 20)) {
     d->codec         = AAC;
     d->channels      = data.toShort(40U);
@@ -222,11 +218,10 @@ MP4::Properties::read(File *file, const Atoms *atoms)
           pos += 3;
         }
         pos += 10;
-        if(const unsigned int bitrateValue = data.toUInt(pos);
-           bitrateValue != 0 || d->length <= 0) {
+        if(const unsigned int bitrateValue = data.toUInt(pos); bitrateValue != 0) {
           d->bitrate = static_cast<int>((bitrateValue + 500) / 1000.0 + 0.5);
         }
-        else {
+        else if(d->length > 0 && style != Fast) {
           d->bitrate = static_cast<int>(
                 calculateMdatLength(atoms->atoms()) * 8 / d->length);
         }
@@ -241,7 +236,7 @@ MP4::Properties::read(File *file, const Atoms *atoms)
       d->bitrate       = static_cast<int>(data.toUInt(80U) / 1000.0 + 0.5);
       d->sampleRate    = data.toUInt(84U);
 
-      if(d->bitrate == 0 && d->length > 0) {
+      if(d->bitrate == 0 && d->length > 0 && style != Fast) {
         // There are files which do not contain a nominal bitrate, e.g. those
         // generated by refalac64.exe. Calculate the bitrate from the audio
         // data size (mdat atoms) and the duration.
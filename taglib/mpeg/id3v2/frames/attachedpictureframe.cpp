@@ -113,11 +113,13 @@ void AttachedPictureFrame::setDescription(const String &desc)
 
 ByteVector AttachedPictureFrame::picture() const
 {
+  appendDeferredPayload(d->data);
   return d->data;
 }
 
 void AttachedPictureFrame::setPicture(const ByteVector &p)
 {
+  discardDeferredPayload();
   d->data = p;
 }
 
@@ -161,7 +163,7 @@ ByteVector AttachedPictureFrame::renderFields() const
   data.append(static_cast<char>(d->type));
   data.append(d->description.data(encoding));
   data.append(textDelimiter(encoding));
-  data.append(d->data);
+  data.append(picture());
 
   return data;
 }
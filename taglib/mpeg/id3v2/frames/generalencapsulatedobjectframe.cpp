@@ -123,11 +123,13 @@ void GeneralEncapsulatedObjectFrame::setDescription(const String &desc)
 
 ByteVector GeneralEncapsulatedObjectFrame::object() const
 {
+  appendDeferredPayload(d->data);
   return d->data;
 }
 
 void GeneralEncapsulatedObjectFrame::setObject(const ByteVector &data)
 {
+  discardDeferredPayload();
   d->data = data;
 }
 
@@ -170,7 +172,7 @@ ByteVector GeneralEncapsulatedObjectFrame::renderFields() const
   data.append(textDelimiter(encoding));
   data.append(d->description.data(encoding));
   data.append(textDelimiter(encoding));
-  data.append(d->data);
+  data.append(object());
 
   return data;
 }
@@ -72,6 +72,7 @@ String PrivateFrame::owner() const
 
 ByteVector PrivateFrame::data() const
 {
+  appendDeferredPayload(d->data);
   return d->data;
 }
 
@@ -82,6 +83,7 @@ void PrivateFrame::setOwner(const String &s)
 
 void PrivateFrame::setData(const ByteVector & data)
 {
+  discardDeferredPayload();
   d->data = data;
 }
 
@@ -111,7 +113,7 @@ ByteVector PrivateFrame::renderFields() const
 
   v.append(d->owner.data(String::Latin1));
   v.append(textDelimiter(String::Latin1));
-  v.append(d->data);
+  v.append(data());
 
   return v;
 }
@@ -159,11 +159,12 @@ namespace
 
 const KeyConversionMap &TextIdentificationFrame::involvedPeopleMap() // static
 {
-  static KeyConversionMap m;
-  if(m.isEmpty()) {
+  static const KeyConversionMap m = [] {
+    KeyConversionMap keys;
     for(const auto &[o, t] : involvedPeople)
-      m.insert(t, o);
-  }
+      keys.insert(t, o);
+    return keys;
+  }();
   return m;
 }
 
@@ -27,6 +27,7 @@
 
 #include <array>
 #include <bitset>
+#include <mutex>
 
 #include "tdebug.h"
 #include "tstringlist.h"
@@ -53,6 +54,8 @@ public:
   FramePrivate &operator=(const FramePrivate &) = delete;
 
   Frame::Header *header { nullptr };
+  std::function<ByteVector()> readDeferredPayload;
+  std::mutex deferredPayloadMutex;
 };
 
 namespace
@@ -284,6 +287,21 @@ void Frame::parse(const ByteVector &data)
   parseFields(fieldData(data));
 }
 
+void Frame::appendDeferredPayload(ByteVector &payload) const
+{
+  std::lock_guard<std::mutex> lock(d->deferredPayloadMutex);
+  if(d->readDeferredPayload) {
+    payload.append(d->readDeferredPayload());
+    d->readDeferredPayload = nullptr;
+  }
+}
+
+void Frame::discardDeferredPayload()
+{
+  std::lock_guard<std::mutex> lock(d->deferredPayloadMutex);
+  d->readDeferredPayload = nullptr;
+}
+
 ByteVector Frame::fieldData(const ByteVector &frameData) const
 {
   unsigned int headerSize = d->header->size();
@@ -389,6 +407,15 @@ void Frame::splitProperties(const PropertyMap &original, PropertyMap &singleFram
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// private members
+////////////////////////////////////////////////////////////////////////////////
+
+void Frame::setDeferredPayload(const std::function<ByteVector()> &readPayload)
+{
+  d->readDeferredPayload = readPayload;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Frame::Header class
 ////////////////////////////////////////////////////////////////////////////////
@@ -26,6 +26,8 @@
 #ifndef TAGLIB_ID3V2FRAME_H
 #define TAGLIB_ID3V2FRAME_H
 
+#include <functional>
+
 #include "tstring.h"
 #include "tbytevector.h"
 #include "taglib_export.h"
@@ -266,7 +268,27 @@ namespace TagLib {
       static void splitProperties(const PropertyMap &original, PropertyMap &singleFrameProperties,
           PropertyMap &tiplProperties, PropertyMap &tmclProperties);
 
+      /*!
+       * Appends the rest of the payload at the end of the frame, which was not
+       * read with the tag (see File::DeferPayloads), to \a payload and forgets
+       * about it.  Frames which support deferred payloads call this before
+       * their payload is used.  This may be called from several threads at
+       * once, as const accessors do.
+       */
+      void appendDeferredPayload(ByteVector &payload) const;
+
+      /*!
+       * Forgets about a deferred payload without reading it.  This is called
+       * when the payload is replaced.
+       */
+      void discardDeferredPayload();
+
     private:
+      /*!
+       * Sets the function which reads the rest of the payload, used by Tag.
+       */
+      void setDeferredPayload(const std::function<ByteVector()> &readPayload);
+
       class FramePrivate;
       friend class FramePrivate;
       TAGLIB_MSVC_SUPPRESS_WARNING_NEEDS_TO_HAVE_DLL_INTERFACE
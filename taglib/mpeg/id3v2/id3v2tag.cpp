@@ -27,6 +27,7 @@
 
 #include <algorithm>
 #include <array>
+#include <map>
 #include <utility>
 
 #include "tdebug.h"
@@ -39,6 +40,7 @@
 #include "id3v1genres.h"
 #include "frames/attachedpictureframe.h"
 #include "frames/generalencapsulatedobjectframe.h"
+#include "frames/privateframe.h"
 #include "frames/textidentificationframe.h"
 #include "frames/commentsframe.h"
 #include "frames/urllinkframe.h"
@@ -78,6 +80,141 @@ namespace
            (!frame2 || frame2->textEncoding() == String::Latin1)
        ? String::Latin1 : String::UTF16;
   }
+
+  // Frames of at least this size have their payload read on first access if
+  // the file defers payloads.  Only the beginning of the frame, which holds
+  // the other fields, is read with the tag.
+
+  constexpr unsigned int MinDeferredFrameSize = 16 * 1024;
+  constexpr unsigned int DeferredFrameReadSize = 1024;
+
+  // The tag data is read in blocks of this size, skipping deferred payloads.
+
+  constexpr unsigned int TagReadBlockSize = 16 * 1024;
+
+  // A frame whose payload was not read with the tag.
+
+  struct DeferredFrame
+  {
+    // The position and length of the frame including its header in the file
+    offset_t offset;
+    unsigned int length;
+    // The length of the part at the start of the frame which was read
+    unsigned int readLength;
+  };
+
+  bool canDeferPayload(const Frame::Header &header)
+  {
+    const ByteVector id = header.frameID();
+    return (id == "APIC" || id == "GEOB" || id == "PRIV") &&
+           !header.compression() && !header.encryption() &&
+           !header.unsynchronisation() && !header.dataLengthIndicator();
+  }
+
+  // Returns true if \a data, the bytes after a frame, start a frame or the
+  // padding.  A frame header alone does not tell whether iTunes wrote the
+  // size of an ID3v2.4 frame without synchsafe integers, which Frame::Header
+  // detects by looking at the next frame.
+
+  bool isFrameEnd(const ByteVector &data)
+  {
+#ifndef NO_ITUNES_HACKS
+    return data.size() < 4 || data[0] == 0 ||
+           std::none_of(data.begin(), data.end(),
+             [](auto c) { return (c < 'A' || c > 'Z') && (c < '0' || c > '9'); });
+#else
+    static_cast<void>(data);
+    return true;
+#endif
+  }
+
+  // Returns the size of the payload that was parsed for a frame created from
+  // the beginning of a deferred frame.  If this is 0, the other fields did not
+  // fit into the part that was read.
+
+  unsigned int readPayloadSize(const Frame *frame)
+  {
+    if(auto f = dynamic_cast<const AttachedPictureFrame *>(frame))
+      return f->picture().size();
+    if(auto f = dynamic_cast<const GeneralEncapsulatedObjectFrame *>(frame))
+      return f->object().size();
+    if(auto f = dynamic_cast<const PrivateFrame *>(frame))
+      return f->data().size();
+    return 0;
+  }
+
+  // Reads the data of the ID3v2.3 or ID3v2.4 tag with \a header at
+  // \a tagOffset and fills \a deferredFrames.
+
+  ByteVector readDeferringPayloads(File *file, offset_t tagOffset, const Header &header,
+                                   std::map<unsigned int, DeferredFrame> &deferredFrames)
+  {
+    // The frames are walked through blocks of the tag data.  Large frames which
+    // can defer their payload are shortened to their beginning, which is passed
+    // to parse() with a frame header changed to that length.  The rest of these
+    // frames is skipped in the file.
+
+    const unsigned int version = header.majorVersion();
+    const unsigned int frameHeaderSize = 10;
+    const unsigned int tagSize = header.tagSize();
+    const offset_t tagDataOffset = tagOffset + Header::size();
+
+    ByteVector block;
+    unsigned int blockPosition = 0;
+
+    const auto read = [&](unsigned int position, unsigned int length) {
+      if(position < blockPosition || position + length > blockPosition + block.size()) {
+        blockPosition = position;
+        block = file->readBlockAt(tagDataOffset + position,
+                                  std::min(std::max(length, TagReadBlockSize), tagSize - position));
+      }
+      return block.mid(position - blockPosition, length);
+    };
+
+    ByteVector data;
+    unsigned int position = 0;
+
+    while(position + frameHeaderSize <= tagSize) {
+      const ByteVector headerData = read(position, frameHeaderSize);
+      if(headerData.size() < frameHeaderSize || headerData[0] == 0)
+        break;
+
+      const Frame::Header frameHeader(headerData, version);
+      const unsigned int frameLength = frameHeaderSize + frameHeader.frameSize();
+
+      if(frameHeader.frameSize() == 0 || frameLength > tagSize - position) {
+        // Leave invalid frames to parse().
+        data.append(read(position, tagSize - position));
+        break;
+      }
+
+      const bool defer = frameLength >= MinDeferredFrameSize && canDeferPayload(frameHeader);
+      const unsigned int fieldLength = DeferredFrameReadSize - frameHeaderSize;
+      const ByteVector frameData = defer
+        ? read(position + frameHeaderSize, fieldLength)
+        : read(position, frameLength);
+
+      if(version == 4 && !isFrameEnd(read(position + frameLength, 4))) {
+        // Leave frames whose size is ambiguous to parse().
+        data.append(read(position, tagSize - position));
+        break;
+      }
+
+      if(defer) {
+        deferredFrames[data.size()] =
+          { tagDataOffset + position, frameLength, DeferredFrameReadSize };
+        data.append(headerData.mid(0, 4));
+        data.append(version == 4 ? SynchData::fromUInt(fieldLength)
+                                 : ByteVector::fromUInt(fieldLength));
+        data.append(headerData.mid(8));
+      }
+      data.append(frameData);
+
+      position += frameLength;
+    }
+
+    return data;
+  }
 }  // namespace
 
 class ID3v2::Tag::TagPrivate
@@ -99,6 +236,11 @@ public:
 
   FrameListMap frameListMap;
   FrameList frameList;
+
+  // The frames whose payload is deferred by their position in the data
+  // passed to parse()
+
+  std::map<unsigned int, DeferredFrame> deferredFrames;
 };
 
 class ID3v2::Latin1StringHandler::Latin1StringHandlerPrivate
@@ -797,8 +939,15 @@ void ID3v2::Tag::read()
   // If the tag size is 0, then this is an invalid tag (tags must contain at
   // least one frame)
 
-  if(d->header.tagSize() != 0)
-    parse(d->file->readBlock(d->header.tagSize()));
+  if(d->header.tagSize() != 0) {
+    const unsigned int version = d->header.majorVersion();
+    if(d->file->payloadStyle() == File::DeferPayloads &&
+       (version == 3 || version == 4) && !d->header.unsynchronisation() &&
+       !d->header.extendedHeader() && !d->header.footerPresent())
+      parse(readDeferringPayloads(d->file, d->tagOffset, d->header, d->deferredFrames));
+    else
+      parse(d->file->readBlock(d->header.tagSize()));
+  }
 
   // Look for duplicate ID3v2 tags and treat them as an extra blank of this one.
   // It leads to overwriting them with zero when saving the tag.
@@ -874,6 +1023,32 @@ void ID3v2::Tag::parse(const ByteVector &origData)
     const ByteVector origData = data.mid(frameDataPosition);
     const Header *tagHeader = &d->header;
     unsigned int headerVersion = tagHeader->majorVersion();
+
+    if(const auto it = d->deferredFrames.find(frameDataPosition);
+       it != d->deferredFrames.end()) {
+      const DeferredFrame &deferred = it->second;
+      frameDataPosition += deferred.readLength;
+
+      // If the fields before the payload did not fit into the part which was
+      // read, the whole frame is read now.
+
+      Frame *frame = d->factory->createFrame(origData.mid(0, deferred.readLength), tagHeader);
+      if(frame && readPayloadSize(frame) > 0) {
+        frame->header()->setFrameSize(deferred.length - frame->headerSize());
+        frame->setDeferredPayload(d->file->deferredReadBlock(
+          deferred.offset + deferred.readLength, deferred.length - deferred.readLength));
+      }
+      else {
+        delete frame;
+        frame = d->factory->createFrame(
+          d->file->readBlockAt(deferred.offset, deferred.length), tagHeader);
+      }
+
+      if(frame)
+        addFrame(frame);
+      continue;
+    }
+
     Frame *frame = d->factory->createFrame(origData, tagHeader);
 
     if(!frame)
@@ -898,6 +1073,7 @@ void ID3v2::Tag::parse(const ByteVector &origData)
     addFrame(frame);
   }
 
+  d->deferredFrames.clear();
   d->factory->rebuildAggregateFrames(this);
 }
 
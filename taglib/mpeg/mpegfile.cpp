@@ -25,6 +25,8 @@
 
 #include "mpegfile.h"
 
+#include <algorithm>
+
 #include "taglib_config.h"
 #include "id3v2framefactory.h"
 #include "tdebug.h"
@@ -38,7 +40,9 @@
 #include "tagunion.h"
 #include "tagutils.h"
 #include "mpegheader.h"
+#include "mpegframescanner.h"
 #include "mpegutils.h"
+#include "xingheader.h"
 
 using namespace TagLib;
 
@@ -107,13 +111,12 @@ bool MPEG::File::isSupported(IOStream *stream)
 
   const offset_t originalPosition = stream->tell();
   AdapterFile file(stream);
+  FrameScanner scanner(&file, bufferSize(), headerOffset, buffer);
 
   for(unsigned int i = 0; i < buffer.size() - 1; ++i) {
-    if(isFrameSync(buffer, i)) {
-      if(const Header header(&file, headerOffset + i, true); header.isValid()) {
-        stream->seek(originalPosition);
-        return true;
-      }
+    if(isFrameSync(buffer, i) && scanner.isFrameAt(headerOffset + i)) {
+      stream->seek(originalPosition);
+      return true;
     }
   }
 
@@ -128,10 +131,19 @@ bool MPEG::File::isSupported(IOStream *stream)
 MPEG::File::File(FileName file, bool readProperties,
                  Properties::ReadStyle readStyle,
                  ID3v2::FrameFactory *frameFactory) :
+  File(file, readProperties, readStyle, frameFactory, ReadPayloads)
+{
+}
+
+MPEG::File::File(FileName file, bool readProperties,
+                 Properties::ReadStyle readStyle,
+                 ID3v2::FrameFactory *frameFactory,
+                 PayloadStyle payloadStyle) :
   TagLib::File(file),
   d(std::make_unique<FilePrivate>(
     frameFactory ? frameFactory : ID3v2::FrameFactory::instance()))
 {
+  setPayloadStyle(payloadStyle);
   if(isOpen())
     read(readProperties, readStyle);
 }
@@ -148,10 +160,19 @@ MPEG::File::File(FileName file, ID3v2::FrameFactory *frameFactory,
 MPEG::File::File(IOStream *stream, bool readProperties,
                  Properties::ReadStyle readStyle,
                  ID3v2::FrameFactory *frameFactory) :
+  File(stream, readProperties, readStyle, frameFactory, ReadPayloads)
+{
+}
+
+MPEG::File::File(IOStream *stream, bool readProperties,
+                 Properties::ReadStyle readStyle,
+                 ID3v2::FrameFactory *frameFactory,
+                 PayloadStyle payloadStyle) :
   TagLib::File(stream),
   d(std::make_unique<FilePrivate>(
     frameFactory ? frameFactory : ID3v2::FrameFactory::instance()))
 {
+  setPayloadStyle(payloadStyle);
   if(isOpen())
     read(readProperties, readStyle);
 }
@@ -209,6 +230,187 @@ bool MPEG::File::save(int tags, StripTags strip, ID3v2::Version version, Duplica
     return false;
   }
 
+  return saveWithStrategy([&] { return saveImpl(tags, strip, version, duplicate); });
+}
+
+ID3v2::Tag *MPEG::File::ID3v2Tag(bool create)
+{
+  return d->tag.access<ID3v2::Tag>(ID3v2Index, create, d->ID3v2FrameFactory);
+}
+
+ID3v1::Tag *MPEG::File::ID3v1Tag(bool create)
+{
+  return d->tag.access<ID3v1::Tag>(ID3v1Index, create);
+}
+
+APE::Tag *MPEG::File::APETag(bool create)
+{
+#ifdef TAGLIB_WITH_APE
+  return d->tag.access<APE::Tag>(APEIndex, create);
+#else
+  return nullptr;
+#endif
+}
+
+bool MPEG::File::strip(int tags, bool freeMemory)
+{
+  if(readOnly()) {
+    debug("MPEG::File::strip() - Cannot strip tags from a read only file.");
+    return false;
+  }
+
+  return saveWithStrategy([&] { return stripImpl(tags, freeMemory); });
+}
+
+offset_t MPEG::File::nextFrameOffset(offset_t position)
+{
+  FrameScanner scanner(this, bufferSize());
+
+  for(; scanner.load(position, 2); ++position) {
+    if(scanner.isFrameAt(position))
+      return position;
+  }
+
+  return -1;
+}
+
+offset_t MPEG::File::previousFrameOffset(offset_t position)
+{
+  FrameScanner scanner(this, bufferSize());
+
+  // The frame sync ending at the position itself is not found.
+
+  for(position -= 2; position >= 0; --position) {
+    if(int frameLength; scanner.isFrameAt(position, &frameLength))
+      return position + frameLength;
+  }
+
+  return -1;
+}
+
+offset_t MPEG::File::firstFrameOffset()
+{
+  offset_t position = 0;
+
+  if(hasID3v2Tag())
+    position = d->ID3v2Location + ID3v2Tag()->header()->completeTagSize();
+
+  return nextFrameOffset(position);
+}
+
+offset_t MPEG::File::lastFrameOffset()
+{
+  offset_t position;
+
+  if(hasAPETag())
+    position = d->APELocation - 1;
+  else if(hasID3v1Tag())
+    position = d->ID3v1Location - 1;
+  else
+    position = length();
+
+  return previousFrameOffset(position);
+}
+
+MPEG::FrameIndex MPEG::File::frameIndex(unsigned int interval)
+{
+  const offset_t firstFrameOffset = this->firstFrameOffset();
+  if(firstFrameOffset < 0)
+    return FrameIndex();
+
+  // The frame with a Xing or VBRI header holds no audio.
+
+  const Header firstHeader(this, firstFrameOffset, false);
+  offset_t start = firstFrameOffset;
+  if(XingHeader(readBlockAt(firstFrameOffset, firstHeader.frameLength())).isValid())
+    start += firstHeader.frameLength();
+
+  const offset_t lastFrameOffset = this->lastFrameOffset();
+
+  FrameIndex index(firstHeader.samplesPerFrame(), true);
+  if(interval == 0)
+    interval = 1;
+
+  unsigned long long frame = 0;
+  FrameScanner scanner(this, 1024 * 1024);
+  scanner.countFrames(start, lastFrameOffset + 1, [&](offset_t offset, unsigned int length) {
+    if(frame % interval == 0)
+      index.append(frame, offset, length);
+    ++frame;
+  });
+
+  return index;
+}
+
+MPEG::FrameIndex MPEG::File::tableOfContentsIndex()
+{
+  const offset_t firstFrameOffset = this->firstFrameOffset();
+  if(firstFrameOffset < 0)
+    return FrameIndex();
+
+  const Header firstHeader(this, firstFrameOffset, false);
+  const XingHeader xingHeader(readBlockAt(firstFrameOffset, firstHeader.frameLength()));
+  if(!xingHeader.isValid())
+    return FrameIndex();
+
+  const offset_t start = firstFrameOffset + firstHeader.frameLength();
+  const unsigned long long totalFrames = xingHeader.totalFrames();
+
+  FrameIndex index(firstHeader.samplesPerFrame(), false);
+
+  if(const ByteVector toc = xingHeader.tableOfContents(); !toc.isEmpty()) {
+
+    // The positions after each percent of the duration, as fractions of the
+    // stream size, which includes the frame with the Xing header.
+
+    for(unsigned int i = 0; i < 100; ++i) {
+      const offset_t offset = firstFrameOffset +
+        static_cast<offset_t>(static_cast<unsigned char>(toc[i])) * xingHeader.totalSize() / 256;
+      index.append(totalFrames * i / 100, std::max(offset, start), 0);
+    }
+  }
+  else if(const List<unsigned int> table = xingHeader.seekTable(); !table.isEmpty()) {
+
+    // The sizes of the parts of framesPerEntry frames following the frame with
+    // the VBRI header.
+
+    const unsigned int framesPerEntry = xingHeader.seekTableFramesPerEntry();
+    unsigned long long frame = 0;
+    offset_t offset = start;
+    index.append(frame, offset, 0);
+    for(const auto size : table) {
+      frame += framesPerEntry;
+      offset += size;
+      if(frame >= totalFrames)
+        break;
+      index.append(frame, offset, 0);
+    }
+  }
+
+  return index;
+}
+
+bool MPEG::File::hasID3v1Tag() const
+{
+  return d->ID3v1Location >= 0;
+}
+
+bool MPEG::File::hasID3v2Tag() const
+{
+  return d->ID3v2Location >= 0;
+}
+
+bool MPEG::File::hasAPETag() const
+{
+  return d->APELocation >= 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// private members
+////////////////////////////////////////////////////////////////////////////////
+
+bool MPEG::File::saveImpl(int tags, StripTags strip, ID3v2::Version version, DuplicateTags duplicate)
+{
   // Create the tags if we've been asked to.
 
   if(duplicate == Duplicate) {
@@ -314,33 +516,16 @@ bool MPEG::File::save(int tags, StripTags strip, ID3v2::Version version, Duplica
   return true;
 }
 
-ID3v2::Tag *MPEG::File::ID3v2Tag(bool create)
+bool MPEG::File::stripImpl(int tags, bool freeMemory)
 {
-  return d->tag.access<ID3v2::Tag>(ID3v2Index, create, d->ID3v2FrameFactory);
-}
-
-ID3v1::Tag *MPEG::File::ID3v1Tag(bool create)
-{
-  return d->tag.access<ID3v1::Tag>(ID3v1Index, create);
-}
+  if((tags & ID3v2) && d->ID3v2Location >= 0) {
 
-APE::Tag *MPEG::File::APETag(bool create)
-{
-#ifdef TAGLIB_WITH_APE
-  return d->tag.access<APE::Tag>(APEIndex, create);
-#else
-  return nullptr;
-#endif
-}
+    // The deferred payloads of a tag which is kept in memory can not be read
+    // once it is removed from the file.  Rendering the tag reads them.
 
-bool MPEG::File::strip(int tags, bool freeMemory)
-{
-  if(readOnly()) {
-    debug("MPEG::File::strip() - Cannot strip tags from a read only file.");
-    return false;
-  }
+    if(!freeMemory && d->tag[ID3v2Index] && payloadStyle() == DeferPayloads)
+      ID3v2Tag()->render();
 
-  if((tags & ID3v2) && d->ID3v2Location >= 0) {
     removeBlock(d->ID3v2Location, d->ID3v2OriginalSize);
 
     if(d->APELocation >= 0)
@@ -381,96 +566,6 @@ bool MPEG::File::strip(int tags, bool freeMemory)
   return true;
 }
 
-offset_t MPEG::File::nextFrameOffset(offset_t position)
-{
-  ByteVector frameSyncBytes(2, '\0');
-
-  while(true) {
-    seek(position);
-    const ByteVector buffer = readBlock(bufferSize());
-    if(buffer.isEmpty())
-      return -1;
-
-    for(unsigned int i = 0; i < buffer.size(); ++i) {
-      frameSyncBytes[0] = frameSyncBytes[1];
-      frameSyncBytes[1] = buffer[i];
-      if(isFrameSync(frameSyncBytes)) {
-        if(const Header header(this, position + i - 1, true); header.isValid())
-          return position + i - 1;
-      }
-    }
-
-    position += bufferSize();
-  }
-}
-
-offset_t MPEG::File::previousFrameOffset(offset_t position)
-{
-  ByteVector frameSyncBytes(2, '\0');
-
-  while(position > 0) {
-    const offset_t bufferLength = std::min<offset_t>(position, bufferSize());
-    position -= bufferLength;
-
-    seek(position);
-    const ByteVector buffer = readBlock(bufferLength);
-
-    for(int i = buffer.size() - 1; i >= 0; --i) {
-      frameSyncBytes[1] = frameSyncBytes[0];
-      frameSyncBytes[0] = buffer[i];
-      if(isFrameSync(frameSyncBytes)) {
-        if(const Header header(this, position + i, true); header.isValid())
-          return position + i + header.frameLength();
-      }
-    }
-  }
-
-  return -1;
-}
-
-offset_t MPEG::File::firstFrameOffset()
-{
-  offset_t position = 0;
-
-  if(hasID3v2Tag())
-    position = d->ID3v2Location + ID3v2Tag()->header()->completeTagSize();
-
-  return nextFrameOffset(position);
-}
-
-offset_t MPEG::File::lastFrameOffset()
-{
-  offset_t position;
-
-  if(hasAPETag())
-    position = d->APELocation - 1;
-  else if(hasID3v1Tag())
-    position = d->ID3v1Location - 1;
-  else
-    position = length();
-
-  return previousFrameOffset(position);
-}
-
-bool MPEG::File::hasID3v1Tag() const
-{
-  return d->ID3v1Location >= 0;
-}
-
-bool MPEG::File::hasID3v2Tag() const
-{
-  return d->ID3v2Location >= 0;
-}
-
-bool MPEG::File::hasAPETag() const
-{
-  return d->APELocation >= 0;
-}
-
-////////////////////////////////////////////////////////////////////////////////
-// private members
-////////////////////////////////////////////////////////////////////////////////
-
 void MPEG::File::read(bool readProperties, Properties::ReadStyle readStyle)
 {
   // Look for an ID3v2 tag
@@ -518,44 +613,25 @@ offset_t MPEG::File::findID3v2(Properties::ReadStyle readStyle)
   // An ID3v2 tag or MPEG frame is most likely be at the beginning of the file.
 
   const ByteVector headerID = ID3v2::Header::fileIdentifier();
+  FrameScanner scanner(this, bufferSize());
 
-  seek(0);
-  if(readBlock(headerID.size()) == headerID)
+  if(scanner.containsAt(headerID, 0))
     return 0;
 
   if(readStyle == Properties::Fast)
     return -1;
 
-  if(const Header firstHeader(this, 0, true); firstHeader.isValid())
+  if(scanner.isFrameAt(0))
     return -1;
 
   // Look for an ID3v2 tag until reaching the first valid MPEG frame.
 
-  ByteVector frameSyncBytes(2, '\0');
-  ByteVector tagHeaderBytes(3, '\0');
-  long position = 0;
-
-  while(true) {
-    seek(position);
-    const ByteVector buffer = readBlock(bufferSize());
-    if(buffer.isEmpty())
+  for(offset_t position = 1; scanner.load(position, 2); ++position) {
+    if(scanner.isFrameAt(position))
       return -1;
-
-    for(unsigned int i = 0; i < buffer.size(); ++i) {
-      frameSyncBytes[0] = frameSyncBytes[1];
-      frameSyncBytes[1] = buffer[i];
-      if(isFrameSync(frameSyncBytes)) {
-        if(const Header header(this, position + i - 1, true); header.isValid())
-          return -1;
-      }
-
-      tagHeaderBytes[0] = tagHeaderBytes[1];
-      tagHeaderBytes[1] = tagHeaderBytes[2];
-      tagHeaderBytes[2] = buffer[i];
-      if(tagHeaderBytes == headerID)
-        return position + i - 2;
-    }
-
-    position += bufferSize();
+    if(scanner.containsAt(headerID, position))
+      return position;
   }
+
+  return -1;
 }
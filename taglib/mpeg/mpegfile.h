@@ -30,6 +30,7 @@
 #include "taglib_export.h"
 #include "tag.h"
 #include "mpegproperties.h"
+#include "mpegframeindex.h"
 #include "id3v2.h"
 
 namespace TagLib {
@@ -84,6 +85,16 @@ namespace TagLib {
            Properties::ReadStyle readStyle = Properties::Average,
            ID3v2::FrameFactory *frameFactory = nullptr);
 
+      /*!
+       * Same as the constructor above, but \a payloadStyle specifies when
+       * pictures and other large binary payloads are read, see
+       * TagLib::File::payloadStyle().
+       */
+      File(FileName file, bool readProperties,
+           Properties::ReadStyle readStyle,
+           ID3v2::FrameFactory *frameFactory,
+           PayloadStyle payloadStyle);
+
       /*!
        * Constructs an MPEG file from \a file.  If \a readProperties is \c true the
        * file's audio properties will also be read.
@@ -121,6 +132,16 @@ namespace TagLib {
            Properties::ReadStyle readStyle = Properties::Average,
            ID3v2::FrameFactory *frameFactory = nullptr);
 
+      /*!
+       * Same as the constructor above, but \a payloadStyle specifies when
+       * pictures and other large binary payloads are read, see
+       * TagLib::File::payloadStyle().
+       */
+      File(IOStream *stream, bool readProperties,
+           Properties::ReadStyle readStyle,
+           ID3v2::FrameFactory *frameFactory,
+           PayloadStyle payloadStyle);
+
       /*!
        * Constructs an MPEG file from \a stream.  If \a readProperties is \c true the
        * file's audio properties will also be read.
@@ -319,6 +340,27 @@ namespace TagLib {
        */
       offset_t lastFrameOffset();
 
+      /*!
+       * Returns an index of the frames, with an entry for every \a interval-th
+       * frame, e.g. to build a seek table.  All frames are walked in one pass,
+       * like with the Accurate read style.  A Xing or VBRI header in the first
+       * frame is not part of the index, so that frame 0 holds the first
+       * samples of the audio.
+       *
+       * \see tableOfContentsIndex()
+       */
+      FrameIndex frameIndex(unsigned int interval = 1);
+
+      /*!
+       * Returns an index estimated from the table of contents of the Xing
+       * header or the seek table of the VBRI header, which does not read any
+       * frames.  The entries have no frame lengths.  The index is empty if
+       * there is no such table.
+       *
+       * \see frameIndex()
+       */
+      FrameIndex tableOfContentsIndex();
+
       /*!
        * Returns whether or not the file on disk actually has an ID3v1 tag.
        *
@@ -352,6 +394,9 @@ namespace TagLib {
     private:
       void read(bool readProperties, Properties::ReadStyle readStyle);
       offset_t findID3v2(Properties::ReadStyle readStyle);
+      bool saveImpl(int tags, StripTags strip, ID3v2::Version version,
+                    DuplicateTags duplicate);
+      bool stripImpl(int tags, bool freeMemory);
 
       class FilePrivate;
       TAGLIB_MSVC_SUPPRESS_WARNING_NEEDS_TO_HAVE_DLL_INTERFACE
@@ -0,0 +1,195 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include "mpegframeindex.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace TagLib;
+
+namespace
+{
+  // Entries are decoded from the previous entry, so that an entry at a
+  // checkpoint is found by decoding at most this many entries.
+  constexpr unsigned int CheckpointInterval = 64;
+
+  void appendNumber(std::vector<unsigned char> &data, unsigned long long value)
+  {
+    while(value >= 0x80) {
+      data.push_back(static_cast<unsigned char>(value | 0x80));
+      value >>= 7;
+    }
+    data.push_back(static_cast<unsigned char>(value));
+  }
+
+  unsigned long long readNumber(const std::vector<unsigned char> &data, size_t &position)
+  {
+    unsigned long long value = 0;
+    for(unsigned int shift = 0; position < data.size(); shift += 7) {
+      const unsigned char byte = data[position++];
+      value |= static_cast<unsigned long long>(byte & 0x7F) << shift;
+      if(!(byte & 0x80))
+        break;
+    }
+    return value;
+  }
+}  // namespace
+
+class MPEG::FrameIndex::FrameIndexPrivate
+{
+public:
+  FrameIndexPrivate(unsigned int samplesPerFrame, bool exact) :
+    samplesPerFrame(samplesPerFrame),
+    exact(exact)
+  {
+  }
+
+  // Decodes the entry following previous, which has been decoded from the
+  // data before position.
+  Entry next(const Entry &previous, size_t &position) const
+  {
+    Entry entry;
+    entry.frame = previous.frame + readNumber(data, position);
+    entry.offset = previous.offset + previous.length +
+                   static_cast<offset_t>(readNumber(data, position));
+    entry.length = static_cast<unsigned int>(readNumber(data, position));
+    entry.sample = entry.frame * samplesPerFrame;
+    return entry;
+  }
+
+  // Each entry is stored as the distance to the frame number of the
+  // previous entry, the gap after the end of the previous frame and the
+  // frame length.  For consecutive frames, these are 1, 0 and two bytes.
+  std::vector<unsigned char> data;
+
+  // Every CheckpointInterval-th entry and the position of the following one
+  // in data.
+  std::vector<std::pair<Entry, size_t>> checkpoints;
+
+  Entry last { 0, 0, 0, 0 };
+  unsigned int size { 0 };
+  unsigned int samplesPerFrame;
+  bool exact;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+MPEG::FrameIndex::FrameIndex() :
+  FrameIndex(0, true)
+{
+}
+
+MPEG::FrameIndex::FrameIndex(unsigned int samplesPerFrame, bool exact) :
+  d(std::make_shared<FrameIndexPrivate>(samplesPerFrame, exact))
+{
+}
+
+MPEG::FrameIndex::FrameIndex(const FrameIndex &) = default;
+
+MPEG::FrameIndex::~FrameIndex() = default;
+
+MPEG::FrameIndex &MPEG::FrameIndex::operator=(const FrameIndex &) = default;
+
+void MPEG::FrameIndex::append(unsigned long long frame, offset_t offset, unsigned int length)
+{
+  if(d->size > 0 && (frame <= d->last.frame || offset < d->last.offset + d->last.length))
+    return;
+
+  if(d.use_count() > 1)
+    d = std::make_shared<FrameIndexPrivate>(*d);
+
+  appendNumber(d->data, frame - d->last.frame);
+  appendNumber(d->data, static_cast<unsigned long long>(offset - d->last.offset - d->last.length));
+  appendNumber(d->data, length);
+
+  d->last = { frame, offset, frame * d->samplesPerFrame, length };
+  if(d->size % CheckpointInterval == 0)
+    d->checkpoints.emplace_back(d->last, d->data.size());
+  ++d->size;
+}
+
+bool MPEG::FrameIndex::isEmpty() const
+{
+  return d->size == 0;
+}
+
+unsigned int MPEG::FrameIndex::size() const
+{
+  return d->size;
+}
+
+MPEG::FrameIndex::Entry MPEG::FrameIndex::entry(unsigned int index) const
+{
+  if(index >= d->size)
+    return Entry();
+
+  auto [entry, position] = d->checkpoints[index / CheckpointInterval];
+  for(unsigned int i = 0; i < index % CheckpointInterval; ++i)
+    entry = d->next(entry, position);
+  return entry;
+}
+
+MPEG::FrameIndex::Entry MPEG::FrameIndex::find(unsigned long long sample) const
+{
+  if(d->checkpoints.empty())
+    return Entry();
+
+  // The last checkpoint at or before the sample, then the entries after it.
+
+  auto it = std::upper_bound(
+    d->checkpoints.begin(), d->checkpoints.end(), sample,
+    [](unsigned long long s, const std::pair<Entry, size_t> &checkpoint) {
+      return s < checkpoint.first.sample;
+    });
+  if(it != d->checkpoints.begin())
+    --it;
+
+  const auto index = static_cast<unsigned int>(it - d->checkpoints.begin()) * CheckpointInterval;
+  auto [entry, position] = *it;
+  for(unsigned int i = index + 1; i < d->size && i < index + CheckpointInterval; ++i) {
+    const Entry next = d->next(entry, position);
+    if(next.sample > sample)
+      break;
+    entry = next;
+  }
+  return entry;
+}
+
+unsigned int MPEG::FrameIndex::samplesPerFrame() const
+{
+  return d->samplesPerFrame;
+}
+
+bool MPEG::FrameIndex::isExact() const
+{
+  return d->exact;
+}
+
+size_t MPEG::FrameIndex::memoryUsage() const
+{
+  return d->data.size() + d->checkpoints.size() * sizeof(d->checkpoints.front());
+}
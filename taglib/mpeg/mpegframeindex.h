@@ -0,0 +1,144 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_MPEGFRAMEINDEX_H
+#define TAGLIB_MPEGFRAMEINDEX_H
+
+#include <memory>
+
+#include "taglib_export.h"
+#include "taglib.h"
+
+namespace TagLib {
+
+  namespace MPEG {
+
+    //! A compact index of the frames of an MPEG stream
+
+    /*!
+     * Holds the position in the file, the position in samples and the length
+     * of the frames of an MPEG stream, e.g. to build seek tables for streaming.
+     * The entries are delta encoded, so that an index of every frame of a long
+     * stream takes about four bytes per frame.
+     *
+     * \see File::frameIndex(), File::tableOfContentsIndex()
+     */
+    class TAGLIB_EXPORT FrameIndex
+    {
+    public:
+      //! An entry of the index
+      struct Entry
+      {
+        //! The number of the frame in the stream, starting at 0
+        unsigned long long frame { 0 };
+        //! The position of the frame in the file
+        offset_t offset { -1 };
+        //! The position of the first sample of the frame in the stream
+        unsigned long long sample { 0 };
+        //! The length of the frame in bytes, 0 if it is not known
+        unsigned int length { 0 };
+      };
+
+      /*!
+       * Constructs an empty index.
+       */
+      FrameIndex();
+
+      /*!
+       * Constructs an empty index of frames with \a samplesPerFrame samples.
+       * \a exact tells if the entries are the positions of actual frames,
+       * otherwise they are estimated, e.g. from a table of contents.
+       */
+      FrameIndex(unsigned int samplesPerFrame, bool exact);
+
+      /*!
+       * Does a shallow copy of \a index.
+       */
+      FrameIndex(const FrameIndex &index);
+
+      /*!
+       * Destroys this FrameIndex instance.
+       */
+      ~FrameIndex();
+
+      /*!
+       * Makes a shallow copy of \a index.
+       */
+      FrameIndex &operator=(const FrameIndex &index);
+
+      /*!
+       * Appends an entry for the frame number \a frame at \a offset with
+       * \a length bytes.  Entries have to be appended in the order of the
+       * frames and offsets, and the offset must not be before the end of the
+       * previous frame.
+       */
+      void append(unsigned long long frame, offset_t offset, unsigned int length);
+
+      /*!
+       * Returns \c true if the index has no entries.
+       */
+      bool isEmpty() const;
+
+      /*!
+       * Returns the number of entries.
+       */
+      unsigned int size() const;
+
+      /*!
+       * Returns the entry at \a index, which must be less than size().
+       */
+      Entry entry(unsigned int index) const;
+
+      /*!
+       * Returns the last entry which starts at or before \a sample, i.e. the
+       * frame from which to decode to reach \a sample, or an entry with an
+       * offset of -1 if the index is empty.
+       */
+      Entry find(unsigned long long sample) const;
+
+      /*!
+       * Returns the number of samples per frame.
+       */
+      unsigned int samplesPerFrame() const;
+
+      /*!
+       * Returns \c true if the entries are actual frames, \c false if they are
+       * estimated from a table of contents.
+       */
+      bool isExact() const;
+
+      /*!
+       * Returns the number of bytes used for the entries.
+       */
+      size_t memoryUsage() const;
+
+    private:
+      class FrameIndexPrivate;
+      TAGLIB_MSVC_SUPPRESS_WARNING_NEEDS_TO_HAVE_DLL_INTERFACE
+      std::shared_ptr<FrameIndexPrivate> d;
+    };
+  }  // namespace MPEG
+}  // namespace TagLib
+
+#endif
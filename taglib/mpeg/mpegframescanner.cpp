@@ -0,0 +1,377 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#include "mpegframescanner.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "tdebug.h"
+#include "tfile.h"
+#include "mpegheader.h"
+#include "mpegutils.h"
+
+using namespace TagLib;
+
+namespace
+{
+  // The bytes which are needed to parse a header, including the frame length
+  // of ADTS headers.
+  constexpr unsigned int HeaderSize = 6;
+
+  // The bits of a header which do not change between the frames of a stream,
+  // see MPEG::Header.
+  constexpr unsigned int HeaderMask = 0xfffe0c00;
+
+  // The threads which walk segments for all calls of countFrames().  When
+  // several files are read at once, e.g. by FileRef::readMany(), they share
+  // one thread per core instead of each starting one per core.
+
+  std::atomic<unsigned int> segmentThreads { 0 };
+
+  // Reserves up to wanted threads, returns the number which was reserved.
+
+  unsigned int reserveSegmentThreads(unsigned int wanted)
+  {
+    const unsigned int maximum = std::max(std::thread::hardware_concurrency(), 1U);
+    unsigned int running = segmentThreads.load();
+    unsigned int reserved;
+    do {
+      reserved = running < maximum ? std::min(wanted, maximum - running) : 0;
+    } while(reserved > 0 &&
+            !segmentThreads.compare_exchange_weak(running, running + reserved));
+    return reserved;
+  }
+
+  // The lengths of MPEG frames indexed by the low 5 bits of the second and
+  // the third header byte, 0 for invalid headers and ADTS, whose frame length
+  // is in the header.
+
+  using FrameLengths = std::array<unsigned short, 0x2000>;
+
+  const FrameLengths &frameLengths()
+  {
+    static const FrameLengths lengths = [] {
+      FrameLengths result {};
+
+      // A second byte of 0xFF is not a frame sync.
+
+      for(unsigned int i = 0; i < 0x1F00; ++i) {
+        const char header[] = {
+          '\xFF', static_cast<char>(0xE0 | (i >> 8)), static_cast<char>(i & 0xFF), '\0'
+        };
+        if(const MPEG::Header h(ByteVector(header, 4), 0, false); h.isValid() && !h.isADTS())
+          result[i] = static_cast<unsigned short>(h.frameLength());
+      }
+      return result;
+    }();
+    return lengths;
+  }
+
+  // The visitor of walks which only count the frames.
+  constexpr auto ignoreFrame = [](offset_t, unsigned int) {};
+
+  bool isADTS(unsigned int header)
+  {
+    // See MPEG::Header::parse(), ADTS has no layer.
+    return (header & 0x00060000) == 0;
+  }
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+MPEG::FrameScanner::FrameScanner(TagLib::File *file, unsigned int chunkSize) :
+  file(file),
+  chunkSize(chunkSize)
+{
+}
+
+MPEG::FrameScanner::FrameScanner(TagLib::File *file, unsigned int chunkSize, offset_t offset,
+                                 const ByteVector &data) :
+  file(file),
+  chunkSize(chunkSize),
+  offset(offset),
+  data(data)
+{
+}
+
+bool MPEG::FrameScanner::isFrameAt(offset_t position, int *frameLength)
+{
+  if(!load(position, 2) || !isFrameSync(data, static_cast<unsigned int>(position - offset)))
+    return false;
+
+  load(position, HeaderSize);
+  const Header header(data, static_cast<unsigned int>(position - offset), false);
+  if(!header.isValid() || header.frameLength() <= 0)
+    return false;
+
+  // The header of the following frame, which may be cut off by the end of
+  // the file.
+
+  load(position, header.frameLength() + 4);
+  if(!Header(data, static_cast<unsigned int>(position - offset), true).isValid())
+    return false;
+
+  if(frameLength)
+    *frameLength = header.frameLength();
+  return true;
+}
+
+MPEG::FrameScanner::FrameCount MPEG::FrameScanner::countFrames(offset_t position, offset_t end)
+{
+  if(!isFrameAt(position))
+    return FrameCount();
+
+  return walk(headerAt(position) & HeaderMask, position, end, true, ignoreFrame).count;
+}
+
+MPEG::FrameScanner::FrameCount MPEG::FrameScanner::countFrames(
+  offset_t position, offset_t end, const std::function<void(offset_t, unsigned int)> &visit)
+{
+  if(!isFrameAt(position))
+    return FrameCount();
+
+  return walk(headerAt(position) & HeaderMask, position, end, true, visit).count;
+}
+
+// static
+MPEG::FrameScanner::FrameCount MPEG::FrameScanner::countFrames(
+  TagLib::File *file, unsigned int chunkSize, offset_t position, offset_t end,
+  unsigned int segments)
+{
+  FrameScanner scanner(file, chunkSize);
+  if(segments <= 1 || !scanner.isFrameAt(position))
+    return scanner.countFrames(position, end);
+
+  const unsigned int reserved = reserveSegmentThreads(segments - 1);
+  if(reserved == 0)
+    return scanner.countFrames(position, end);
+
+  const unsigned int reference = scanner.headerAt(position) & HeaderMask;
+
+  std::vector<offset_t> boundaries(segments + 1);
+  for(unsigned int i = 0; i <= segments; ++i)
+    boundaries[i] = position + (end - position) * i / segments;
+
+  // The first segment starts at a known frame, the others search their
+  // first frame.
+
+  std::vector<Walk> walks(segments);
+  const auto walkSegment = [&](unsigned int i) {
+    FrameScanner segmentScanner(file, chunkSize);
+    walks[i] = segmentScanner.walk(reference, boundaries[i], boundaries[i + 1], false,
+                                   ignoreFrame);
+  };
+
+  // The segments for which no thread was reserved or could be started are
+  // walked on this thread.
+
+  std::vector<std::thread> threads;
+  unsigned int firstInline = reserved + 1;
+  for(unsigned int i = 1; i < firstInline; ++i) {
+    try {
+      threads.emplace_back(walkSegment, i);
+    }
+    catch(const std::system_error &) {
+      debug("MPEG::FrameScanner::countFrames() -- Could not start a thread.");
+      firstInline = i;
+      break;
+    }
+  }
+  walks[0] = scanner.walk(reference, position, boundaries[1], true, ignoreFrame);
+  for(unsigned int i = firstInline; i < segments; ++i)
+    walkSegment(i);
+
+  for(auto &thread : threads)
+    thread.join();
+
+  segmentThreads -= reserved;
+
+  // A segment is right if the walk before it stopped at the frame where it
+  // started, or if both were searching for a frame from the boundary.
+  // Otherwise its start was a false frame sync and the segment is walked
+  // again from where the previous walk stopped.
+
+  FrameCount count = walks[0].count;
+  for(unsigned int i = 1; i < segments; ++i) {
+    const Walk &previous = walks[i - 1];
+    Walk &current = walks[i];
+
+    const bool joined = previous.synchronized
+      ? current.count.frames > 0 && previous.next == current.start
+      : previous.next == boundaries[i];
+
+    if(!joined) {
+      FrameScanner segmentScanner(file, chunkSize);
+      current = segmentScanner.walk(reference, previous.next, boundaries[i + 1],
+                                    previous.synchronized, ignoreFrame);
+    }
+
+    count.frames += current.count.frames;
+    count.bytes += current.count.bytes;
+  }
+
+  return count;
+}
+
+bool MPEG::FrameScanner::containsAt(const ByteVector &pattern, offset_t position)
+{
+  return load(position, pattern.size()) &&
+         data.containsAt(pattern, static_cast<unsigned int>(position - offset));
+}
+
+bool MPEG::FrameScanner::load(offset_t position, unsigned int length)
+{
+  if(position < 0)
+    return false;
+
+  const offset_t windowEnd = offset + data.size();
+  if(position >= offset && position + length <= windowEnd)
+    return true;
+
+  if(end >= 0 && position + length > end) {
+    // The file is too short, but the part of the range which it holds is
+    // still loaded for headers which are cut off.
+
+    if(position >= offset && end <= windowEnd)
+      return false;
+  }
+
+  if(position >= offset && position <= windowEnd) {
+
+    // Extend the window, dropping the data before the position if the window
+    // would grow too large.
+
+    if(position - offset >= chunkSize) {
+      data = data.mid(static_cast<unsigned int>(position - offset));
+      offset = position;
+    }
+
+    const auto missing = static_cast<unsigned int>(position + length - (offset + data.size()));
+    const unsigned int size = std::max(missing, chunkSize);
+    const ByteVector block = file->readBlockAt(offset + data.size(), size);
+    if(block.size() < size)
+      end = offset + data.size() + block.size();
+    data.append(block);
+  }
+  else if(position < offset && position + length >= offset) {
+
+    // Move the window backwards, keeping the beginning of the old window.
+
+    const offset_t start = std::max<offset_t>(0, std::min<offset_t>(position, offset - chunkSize));
+    ByteVector block = file->readBlockAt(start, static_cast<unsigned int>(offset - start));
+    if(block.size() == offset - start)
+      block.append(data.mid(0, chunkSize));
+    else
+      end = start + block.size();
+    data = block;
+    offset = start;
+  }
+  else {
+
+    // Start a new window at the position.
+
+    const unsigned int size = std::max(length, chunkSize);
+    data = file->readBlockAt(position, size);
+    offset = position;
+    if(data.size() < size)
+      end = offset + data.size();
+  }
+
+  return position >= offset && position + length <= offset + data.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// private members
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename Visitor>
+MPEG::FrameScanner::Walk MPEG::FrameScanner::walk(unsigned int reference, offset_t position,
+                                                  offset_t end, bool synchronized,
+                                                  Visitor visit)
+{
+  const bool adts = isADTS(reference);
+  const FrameLengths &lengths = frameLengths();
+
+  Walk result;
+
+  while(position < end) {
+    if(!synchronized) {
+      if(!load(position, 2))
+        break;
+
+      // Search the next valid frame.
+
+      if(!isFrameAt(position)) {
+        ++position;
+        continue;
+      }
+      synchronized = true;
+    }
+
+    if(!load(position, 4))
+      break;
+
+    const unsigned int header = data.toUInt(static_cast<unsigned int>(position - offset), true);
+
+    // Loading the rest of an ADTS header may move the window.
+
+    unsigned int length = 0;
+    if((header & HeaderMask) == reference) {
+      if(!adts)
+        length = lengths[(header >> 8) & 0x1FFF];
+      else if(load(position, HeaderSize))
+        length = (data.toUInt(static_cast<unsigned int>(position - offset) + 2, true) >> 5) & 0x1FFF;
+    }
+
+    if(length > 0) {
+      if(result.start < 0)
+        result.start = position;
+      visit(position, length);
+      ++result.count.frames;
+      result.count.bytes += length;
+      position += length;
+    }
+    else {
+      synchronized = false;
+      ++position;
+    }
+  }
+
+  result.next = position;
+  result.synchronized = synchronized;
+  return result;
+}
+
+unsigned int MPEG::FrameScanner::headerAt(offset_t position)
+{
+  return load(position, 4) ? data.toUInt(static_cast<unsigned int>(position - offset), true) : 0;
+}
@@ -0,0 +1,156 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#ifndef TAGLIB_MPEGFRAMESCANNER_H
+#define TAGLIB_MPEGFRAMESCANNER_H
+
+#include <functional>
+
+#include "taglib_export.h"
+#include "taglib.h"
+#include "tbytevector.h"
+
+// THIS FILE IS NOT A PART OF THE TAGLIB API
+
+#ifndef DO_NOT_DOCUMENT  // tell Doxygen not to document this header
+
+namespace TagLib {
+
+  class File;
+
+  namespace MPEG {
+
+    //! Searches MPEG frame headers in a window of a file
+
+    /*!
+     * The window holds a part of the file.  Candidate frame headers are
+     * validated against the data in the window, including the header of the
+     * following frame, so that junk before the audio data does not cost a
+     * read for each candidate.  The window is only extended or moved when a
+     * candidate or the header of its following frame is outside of it, by at
+     * least \a chunkSize bytes at once.
+     */
+    class TAGLIB_EXPORT FrameScanner
+    {
+    public:
+      FrameScanner(TagLib::File *file, unsigned int chunkSize);
+
+      /*!
+       * Constructs a scanner whose window initially holds \a data, which
+       * has been read from \a offset of \a file.
+       */
+      FrameScanner(TagLib::File *file, unsigned int chunkSize, offset_t offset,
+                   const ByteVector &data);
+
+      /*!
+       * Returns \c true if a valid frame header is at \a position, like
+       * MPEG::Header(file, position, true).isValid().  If \a frameLength is
+       * not null, it is set to the length of the frame.
+       */
+      bool isFrameAt(offset_t position, int *frameLength = nullptr);
+
+      //! The frames counted by countFrames()
+      struct FrameCount
+      {
+        //! The number of frames
+        unsigned long long frames { 0 };
+        //! The sum of the frame lengths
+        unsigned long long bytes { 0 };
+      };
+
+      /*!
+       * Walks the frames from the valid frame at \a position and counts those
+       * starting before \a end which have the version, layer and sample rate
+       * of the first one.  After data which is not such a frame, the walk
+       * continues at the next valid frame.  The frame lengths are looked up
+       * in a table, so this costs a few operations per frame.
+       */
+      FrameCount countFrames(offset_t position, offset_t end);
+
+      /*!
+       * Counts the frames like countFrames() and calls \a visit with the
+       * offset and the length of each frame.
+       */
+      FrameCount countFrames(offset_t position, offset_t end,
+                             const std::function<void(offset_t, unsigned int)> &visit);
+
+      /*!
+       * Counts the frames like countFrames(), but splits the range into
+       * \a segments segments which are walked on their own threads, each
+       * starting at the first valid frame of its segment.  Where the walk of
+       * a segment ends on a different frame than the one at which the next
+       * segment was started, that segment is walked again from there, so the
+       * result is the same as the one of countFrames().  \a file has to
+       * support concurrent reads, see File::supportsConcurrentReads().
+       *
+       * All calls together start at most one thread per core, the segments
+       * for which no thread is left are walked on the calling thread.
+       */
+      static FrameCount countFrames(TagLib::File *file, unsigned int chunkSize,
+                                    offset_t position, offset_t end,
+                                    unsigned int segments);
+
+      /*!
+       * Returns \c true if \a pattern is at \a position.
+       */
+      bool containsAt(const ByteVector &pattern, offset_t position);
+
+      /*!
+       * Makes the window hold the \a length bytes at \a position.  Returns
+       * \c false if the file ends before.
+       */
+      bool load(offset_t position, unsigned int length);
+
+    private:
+      // The first frame of a walk and where it has stopped: at a frame if it
+      // is synchronized, otherwise at the position at which the search for
+      // the next frame continues.
+      struct Walk
+      {
+        FrameCount count;
+        offset_t start { -1 };
+        offset_t next { -1 };
+        bool synchronized { false };
+      };
+
+      template <typename Visitor>
+      Walk walk(unsigned int reference, offset_t position, offset_t end,
+                bool synchronized, Visitor visit);
+      unsigned int headerAt(offset_t position);
+
+      TagLib::File *const file;
+      const unsigned int chunkSize;
+      offset_t offset { 0 };
+      ByteVector data;
+      // The length of the file, once a read has reached its end
+      offset_t end { -1 };
+    };
+
+  }  // namespace MPEG
+}  // namespace TagLib
+
+#endif
+
+#endif
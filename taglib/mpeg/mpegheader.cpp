@@ -34,6 +34,38 @@
 
 using namespace TagLib;
 
+namespace
+{
+  // The bytes which are needed to parse a header, including the frame length
+  // of ADTS headers.
+  constexpr unsigned int MaxHeaderSize = 6;
+
+  // Returns true if the frame length has been calculated correctly, i.e. if
+  // the next frame header is right next to the end of this frame.
+
+  bool isFollowedBy(int frameLength, const ByteVector &data, const ByteVector &nextData)
+  {
+    // The MPEG versions, layers and sample rates of the two frames should be
+    // consistent. Otherwise, we assume that either or both of the frames are
+    // broken.
+
+    // A frame length of 0 is probably invalid and would pass the test below
+    // because nextData would be the same as data.
+    if(frameLength == 0)
+      return false;
+
+    if(nextData.size() < 4)
+      return false;
+
+    constexpr unsigned int HeaderMask = 0xfffe0c00;
+
+    const unsigned int header     = data.toUInt(0, true)     & HeaderMask;
+    const unsigned int nextHeader = nextData.toUInt(0, true) & HeaderMask;
+
+    return header == nextHeader;
+  }
+}  // namespace
+
 class MPEG::Header::HeaderPrivate
 {
 public:
@@ -59,7 +91,28 @@ public:
 MPEG::Header::Header(File *file, offset_t offset, bool checkLength) :
   d(std::make_shared<HeaderPrivate>())
 {
-  parse(file, offset, checkLength);
+  const ByteVector data = file->readBlockAt(offset, MaxHeaderSize);
+  if(!parse(data))
+    return;
+
+  if(checkLength && !isFollowedBy(d->frameLength, data,
+                                  file->readBlockAt(offset + d->frameLength, 4)))
+    return;
+
+  d->isValid = true;
+}
+
+MPEG::Header::Header(const ByteVector &data, unsigned int offset, bool checkLength) :
+  d(std::make_shared<HeaderPrivate>())
+{
+  if(offset >= data.size() || !parse(data.mid(offset, MaxHeaderSize)))
+    return;
+
+  if(checkLength && !isFollowedBy(d->frameLength, data.mid(offset, 4),
+                                  data.mid(offset + d->frameLength, 4)))
+    return;
+
+  d->isValid = true;
 }
 
 MPEG::Header::Header(const Header &) = default;
@@ -149,21 +202,18 @@ MPEG::Header &MPEG::Header::operator=(const Header &h)
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void MPEG::Header::parse(File *file, offset_t offset, bool checkLength)
+bool MPEG::Header::parse(const ByteVector &data)
 {
-  file->seek(offset);
-  const ByteVector data = file->readBlock(4);
-
   if(data.size() < 4) {
     debug("MPEG::Header::parse() -- data is too short for an MPEG frame header.");
-    return;
+    return false;
   }
 
   // Check for the MPEG synch bytes.
 
   if(!isFrameSync(data)) {
     debug("MPEG::Header::parse() -- MPEG header did not match MPEG synch.");
-    return;
+    return false;
   }
 
   // Set the MPEG version
@@ -177,7 +227,7 @@ void MPEG::Header::parse(File *file, offset_t offset, bool checkLength)
   else if(versionBits == 3)
     d->version = Version1;
   else
-    return;
+    return false;
 
   // Set the MPEG layer
 
@@ -206,7 +256,7 @@ void MPEG::Header::parse(File *file, offset_t offset, bool checkLength)
       d->layer = 0;
     }
     else {
-      return;
+      return false;
     }
   }
 
@@ -233,11 +283,10 @@ void MPEG::Header::parse(File *file, offset_t offset, bool checkLength)
     d->isCopyrighted = (static_cast<unsigned char>(data[3]) & 0x04) != 0;
 
     // Calculate the frame length
-    if(const ByteVector frameLengthData = file->readBlock(2);
-       frameLengthData.size() >= 2) {
+    if(data.size() >= 6) {
       d->frameLength = (static_cast<unsigned char>(data[3]) & 0x3) << 11 |
-                       (static_cast<unsigned char>(frameLengthData[0]) << 3) |
-                       (static_cast<unsigned char>(frameLengthData[1]) >> 5);
+                       (static_cast<unsigned char>(data[4]) << 3) |
+                       (static_cast<unsigned char>(data[5]) >> 5);
 
       d->bitrate = static_cast<int>(d->frameLength * d->sampleRate / 1024.0 + 0.5) * 8 / 1024;
     }
@@ -273,7 +322,7 @@ void MPEG::Header::parse(File *file, offset_t offset, bool checkLength)
     d->bitrate = bitrates[versionIndex][layerIndex][bitrateIndex];
 
     if(d->bitrate == 0)
-      return;
+      return false;
 
     // Set the sample rate
 
@@ -290,7 +339,7 @@ void MPEG::Header::parse(File *file, offset_t offset, bool checkLength)
     d->sampleRate = sampleRates[d->version][samplerateIndex];
 
     if(d->sampleRate == 0) {
-      return;
+      return false;
     }
 
     // The channel mode is encoded as a 2 bit value at the end of the 3rd byte,
@@ -327,36 +376,5 @@ void MPEG::Header::parse(File *file, offset_t offset, bool checkLength)
       d->frameLength += paddingSize[layerIndex];
   }
 
-  if(checkLength) {
-
-    // Check if the frame length has been calculated correctly, or the next frame
-    // header is right next to the end of this frame.
-
-    // The MPEG versions, layers and sample rates of the two frames should be
-    // consistent. Otherwise, we assume that either or both of the frames are
-    // broken.
-
-    // A frame length of 0 is probably invalid and would pass the test below
-    // because nextData would be the same as data.
-    if(d->frameLength == 0)
-      return;
-
-    file->seek(offset + d->frameLength);
-    const ByteVector nextData = file->readBlock(4);
-
-    if(nextData.size() < 4)
-      return;
-
-    constexpr unsigned int HeaderMask = 0xfffe0c00;
-
-    const unsigned int header     = data.toUInt(0, true)     & HeaderMask;
-
-    if(const unsigned int nextHeader = nextData.toUInt(0, true) & HeaderMask;
-       header != nextHeader)
-      return;
-  }
-
-  // Now that we're done parsing, set this to be a valid frame.
-
-  d->isValid = true;
+  return true;
 }
@@ -62,6 +62,15 @@ namespace TagLib {
        */
       Header(File *file, offset_t offset, bool checkLength = true);
 
+      /*!
+       * Parses an MPEG header at \a offset in \a data, which is not read from
+       * a file.
+       * \note If \a checkLength is \c true, the next MPEG frame header has to
+       * be in \a data too, otherwise the header is not valid.  See
+       * Header(File *, offset_t, bool).
+       */
+      Header(const ByteVector &data, unsigned int offset = 0, bool checkLength = true);
+
       /*!
        * Does a shallow copy of \a h.
        */
@@ -204,7 +213,7 @@ namespace TagLib {
       Header &operator=(const Header &h);
 
     private:
-      void parse(File *file, offset_t offset, bool checkLength);
+      bool parse(const ByteVector &data);
 
       class HeaderPrivate;
       TAGLIB_MSVC_SUPPRESS_WARNING_NEEDS_TO_HAVE_DLL_INTERFACE
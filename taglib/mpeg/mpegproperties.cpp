@@ -25,9 +25,16 @@
 
 #include "mpegproperties.h"
 
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+
 #include "taglib_config.h"
 #include "tdebug.h"
 #include "mpegfile.h"
+#include "mpegframescanner.h"
+#include "id3v2tag.h"
+#include "commentsframe.h"
 #include "xingheader.h"
 #ifdef TAGLIB_WITH_APE
 #include "apetag.h"
@@ -35,6 +42,28 @@
 
 using namespace TagLib;
 
+namespace
+{
+  // Streams of at least two segments of this length are walked on several
+  // threads if the file supports concurrent reads.
+  constexpr offset_t MinimumSegmentLength = 16 * 1024 * 1024;
+
+  MPEG::FrameScanner::FrameCount countFrames(MPEG::File *file, offset_t start, offset_t end)
+  {
+    unsigned int segments = 1;
+    if(file->supportsConcurrentReads()) {
+      const auto maximum = static_cast<offset_t>(std::max(std::thread::hardware_concurrency(), 1U));
+      segments = static_cast<unsigned int>(
+        std::clamp<offset_t>((end - start) / MinimumSegmentLength, 1, maximum));
+    }
+    return MPEG::FrameScanner::countFrames(file, 1024 * 1024, start, end, segments);
+  }
+
+  // The encoder delay and padding of an iTunSMPB comment are ignored if they
+  // are longer than this number of frames.
+  constexpr unsigned long MaximumGapFrames = 8;
+}  // namespace
+
 class MPEG::Properties::PropertiesPrivate
 {
 public:
@@ -50,6 +79,10 @@ public:
   bool protectionEnabled { false };
   bool isCopyrighted { false };
   bool isOriginal { false };
+  int encoderDelay { 0 };
+  int encoderPadding { 0 };
+  unsigned short musicCRC { 0 };
+  unsigned long long totalSamples { 0 };
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -131,6 +164,26 @@ bool MPEG::Properties::isOriginal() const
   return d->isOriginal;
 }
 
+int MPEG::Properties::encoderDelay() const
+{
+  return d->encoderDelay;
+}
+
+int MPEG::Properties::encoderPadding() const
+{
+  return d->encoderPadding;
+}
+
+unsigned short MPEG::Properties::musicCRC() const
+{
+  return d->musicCRC;
+}
+
+unsigned long long MPEG::Properties::totalSamples() const
+{
+  return d->totalSamples;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // private members
 ////////////////////////////////////////////////////////////////////////////////
@@ -147,11 +200,15 @@ void MPEG::Properties::read(File *file, ReadStyle readStyle)
 
   const Header firstHeader(file, firstFrameOffset, false);
 
+  // The number of frames if it is known exactly.
+
+  unsigned long long frames = 0;
+
   // Check for a VBR header that will help us in gathering information about a
   // VBR stream.
 
-  file->seek(firstFrameOffset);
-  d->xingHeader = std::make_unique<XingHeader>(file->readBlock(firstHeader.frameLength()));
+  d->xingHeader = std::make_unique<XingHeader>(
+    file->readBlockAt(firstFrameOffset, firstHeader.frameLength()));
   if(!d->xingHeader->isValid()) {
     d->xingHeader = nullptr;
   }
@@ -165,18 +222,34 @@ void MPEG::Properties::read(File *file, ReadStyle readStyle)
 
     d->length  = static_cast<int>(length + 0.5);
     d->bitrate = static_cast<int>(d->xingHeader->totalSize() * 8.0 / length + 0.5);
+    frames = d->xingHeader->totalFrames();
   }
   else {
     int bitRate = firstHeader.bitrate();
-    if(firstHeader.isADTS()) {
-      // ADTS is probably VBR, so to get the real length, we would have to go
-      // through all frames, count the frames in numFrames and sum their
-      // header.frameLength() to totalFrameSize, and finally calculate
-      // d->length = 1000LL * numFrames * firstHeader.samplesPerFrame() / firstHeader.sampleRate();
-      // d->bitrate = d->length > 0 ? totalFrameSize * 8 / d->length : 0;
-      //
-      // With Fast read style, we do not try to estimate the length and just set
-      // it and the bitrate to zero.
+    if(readStyle == Accurate && firstHeader.samplesPerFrame() > 0 &&
+       firstHeader.sampleRate() > 0) {
+      // Without a VBR header, the frames are walked to get the exact length of
+      // a VBR stream, e.g. ADTS.  Only the headers are looked at, so this is
+      // still fast.
+
+      if(const offset_t lastFrameOffset = file->lastFrameOffset();
+         lastFrameOffset >= firstFrameOffset) {
+        const auto count = countFrames(file, firstFrameOffset, lastFrameOffset + 1);
+        const double length = count.frames * firstHeader.samplesPerFrame() * 1000.0 /
+                              firstHeader.sampleRate();
+        if(length > 0) {
+          d->length  = static_cast<int>(length + 0.5);
+          d->bitrate = static_cast<int>(count.bytes * 8.0 / length + 0.5);
+          frames = count.frames;
+        }
+      }
+
+      // The length is already known, it must not be estimated below.
+      bitRate = 0;
+    }
+    else if(firstHeader.isADTS()) {
+      // ADTS is probably VBR.  With Fast read style, we do not try to estimate
+      // the length and just set it and the bitrate to zero.
       // With Average read style, in order to come faster to an estimate which
       // is accurate enough, we stop when the average bytes/frame rate is stable
       // for 10 frames and then calculate the length from the estimated bitrate
@@ -200,17 +273,15 @@ void MPEG::Properties::read(File *file, ReadStyle readStyle)
           totalFrameSize += header.frameLength();
           ++numFrames;
           bytesPerFrame = totalFrameSize / numFrames;
-          if(readStyle != Accurate) {
-            if(bytesPerFrame == lastBytesPerFrame) {
-              if(++sameBytesPerFrameCount >= 10) {
-                break;
-              }
-            }
-            else {
-              sameBytesPerFrameCount = 0;
+          if(bytesPerFrame == lastBytesPerFrame) {
+            if(++sameBytesPerFrameCount >= 10) {
+              break;
             }
-            lastBytesPerFrame = bytesPerFrame;
           }
+          else {
+            sameBytesPerFrameCount = 0;
+          }
+          lastBytesPerFrame = bytesPerFrame;
         }
         bitRate = firstHeader.samplesPerFrame() != 0
           ? static_cast<int>(bytesPerFrame * 8 * firstHeader.sampleRate()
@@ -221,9 +292,6 @@ void MPEG::Properties::read(File *file, ReadStyle readStyle)
     else if(firstHeader.bitrate() > 0) {
       // Since there was no valid VBR header found, we hope that we're in a constant
       // bitrate file.
-
-      // TODO: Make this more robust with audio property detection for VBR without a
-      // Xing header.
       bitRate = firstHeader.bitrate();
     }
     if(bitRate > 0) {
@@ -245,6 +313,8 @@ void MPEG::Properties::read(File *file, ReadStyle readStyle)
     }
   }
 
+  readGaplessInfo(file, firstHeader, frames);
+
   d->sampleRate        = firstHeader.sampleRate();
   d->channelConfiguration = firstHeader.channelConfiguration();
   switch(d->channelConfiguration) {
@@ -280,3 +350,57 @@ void MPEG::Properties::read(File *file, ReadStyle readStyle)
   d->isCopyrighted     = firstHeader.isCopyrighted();
   d->isOriginal        = firstHeader.isOriginal();
 }
+
+void MPEG::Properties::readGaplessInfo(File *file, const Header &firstHeader,
+                                       unsigned long long frames)
+{
+  unsigned long long samples = frames * firstHeader.samplesPerFrame();
+
+  // The LAME info tag is found with the Xing header.  Files encoded by
+  // iTunes have an iTunSMPB comment instead, whose hexadecimal fields are
+  // 0, the delay, the padding and the number of samples without them.
+
+  if(d->xingHeader && !d->xingHeader->encoderVersion().isEmpty()) {
+    d->encoderDelay   = d->xingHeader->encoderDelay();
+    d->encoderPadding = d->xingHeader->encoderPadding();
+    d->musicCRC       = d->xingHeader->musicCRC();
+  }
+  else if(ID3v2::Tag *tag = file->hasID3v2Tag() ? file->ID3v2Tag() : nullptr) {
+    for(const auto frame : tag->frameList("COMM")) {
+      const auto comment = dynamic_cast<const ID3v2::CommentsFrame *>(frame);
+      if(!comment || comment->description() != "iTunSMPB")
+        continue;
+
+      const StringList fields = comment->text().stripWhiteSpace().split(" ");
+      if(fields.size() >= 4) {
+        const unsigned long maximumGap = MaximumGapFrames * firstHeader.samplesPerFrame();
+        const unsigned long delay   = std::strtoul(fields[1].toCString(), nullptr, 16);
+        const unsigned long padding = std::strtoul(fields[2].toCString(), nullptr, 16);
+        const unsigned long long total = std::strtoull(fields[3].toCString(), nullptr, 16);
+        if(delay > maximumGap || padding > maximumGap) {
+          debug("MPEG::Properties::read() -- Invalid iTunSMPB comment.");
+          break;
+        }
+        d->encoderDelay   = static_cast<int>(delay);
+        d->encoderPadding = static_cast<int>(padding);
+
+        // The number of samples can not be more than the stream has.  If the
+        // frames were not counted, the estimated length only guards against
+        // values which are far off.
+
+        const unsigned long long available = samples > 0 ? samples
+          : 2ULL * static_cast<unsigned long long>(d->length) * firstHeader.sampleRate() / 1000;
+        if(total > 0 && total <= available)
+          samples = total + delay + padding;
+      }
+      break;
+    }
+  }
+
+  const unsigned long long gaps =
+    static_cast<unsigned long long>(d->encoderDelay) + static_cast<unsigned long long>(d->encoderPadding);
+  if(samples > gaps && firstHeader.sampleRate() > 0) {
+    d->totalSamples = samples - gaps;
+    d->length = static_cast<int>(d->totalSamples * 1000.0 / firstHeader.sampleRate() + 0.5);
+  }
+}
@@ -129,8 +129,41 @@ namespace TagLib {
        */
       bool isOriginal() const;
 
+      /*!
+       * Returns the number of samples which the encoder added before the audio,
+       * which a gapless player skips.  It is read from the LAME info tag or an
+       * iTunSMPB comment, 0 if it is not known.  The delay of a VBRI header
+       * (see XingHeader::encoderDelay()) is not used, because the padding is
+       * not known with it.
+       *
+       * \see encoderPadding(), totalSamples()
+       */
+      int encoderDelay() const;
+
+      /*!
+       * Returns the number of samples which the encoder added after the audio
+       * to fill the last frame, from the LAME info tag or an iTunSMPB comment,
+       * 0 if it is not known.
+       */
+      int encoderPadding() const;
+
+      /*!
+       * Returns the CRC-16 of the audio data from the LAME info tag, 0 if it is
+       * not known.
+       */
+      unsigned short musicCRC() const;
+
+      /*!
+       * Returns the number of samples of the audio without encoderDelay() and
+       * encoderPadding(), 0 if it is not known.  It is known from a VBR header,
+       * from an iTunSMPB comment or with the Accurate read style, and then
+       * lengthInMilliseconds() is calculated from it.
+       */
+      unsigned long long totalSamples() const;
+
     private:
       void read(File *file, ReadStyle readStyle);
+      void readGaplessInfo(File *file, const Header &firstHeader, unsigned long long frames);
 
       class PropertiesPrivate;
       TAGLIB_MSVC_SUPPRESS_WARNING_NEEDS_TO_HAVE_DLL_INTERFACE
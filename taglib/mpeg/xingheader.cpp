@@ -36,6 +36,14 @@ class MPEG::XingHeader::XingHeaderPrivate
 public:
   unsigned int frames { 0 };
   unsigned int size { 0 };
+  ByteVector tableOfContents;
+  List<unsigned int> seekTable;
+  unsigned int framesPerEntry { 0 };
+  String encoderVersion;
+  int encoderDelay { 0 };
+  int encoderPadding { 0 };
+  unsigned int musicLength { 0 };
+  unsigned short musicCRC { 0 };
 
   MPEG::XingHeader::HeaderType type { MPEG::XingHeader::Invalid };
 };
@@ -72,6 +80,46 @@ MPEG::XingHeader::HeaderType MPEG::XingHeader::type() const
   return d->type;
 }
 
+ByteVector MPEG::XingHeader::tableOfContents() const
+{
+  return d->tableOfContents;
+}
+
+List<unsigned int> MPEG::XingHeader::seekTable() const
+{
+  return d->seekTable;
+}
+
+unsigned int MPEG::XingHeader::seekTableFramesPerEntry() const
+{
+  return d->framesPerEntry;
+}
+
+String MPEG::XingHeader::encoderVersion() const
+{
+  return d->encoderVersion;
+}
+
+int MPEG::XingHeader::encoderDelay() const
+{
+  return d->encoderDelay;
+}
+
+int MPEG::XingHeader::encoderPadding() const
+{
+  return d->encoderPadding;
+}
+
+unsigned int MPEG::XingHeader::musicLength() const
+{
+  return d->musicLength;
+}
+
+unsigned short MPEG::XingHeader::musicCRC() const
+{
+  return d->musicCRC;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // private members
 ////////////////////////////////////////////////////////////////////////////////
@@ -101,6 +149,33 @@ void MPEG::XingHeader::parse(const ByteVector &data)
     d->frames = data.toUInt(offset + 8,  true);
     d->size   = data.toUInt(offset + 12, true);
     d->type   = Xing;
+
+    // The optional table of contents and quality indicator follow.
+
+    unsigned int pos = offset + 16;
+    if(data[offset + 7] & 0x04) {
+      if(data.size() >= pos + 100)
+        d->tableOfContents = data.mid(pos, 100);
+      pos += 100;
+    }
+    if(data[offset + 7] & 0x08)
+      pos += 4;
+
+    // Look for a LAME info tag, see http://gabriel.mp3-tech.org/mp3infotag.html
+
+    if(data.size() >= pos + 36 &&
+       (data.containsAt("LAME", pos) || data.containsAt("Lavf", pos) ||
+        data.containsAt("Lavc", pos))) {
+      d->encoderVersion = String(data.mid(pos, 9), String::Latin1).stripWhiteSpace();
+
+      // The delay and the padding are stored as two 12 bit values.
+
+      const unsigned int delayAndPadding = data.toUInt(pos + 21, 3, true);
+      d->encoderDelay   = static_cast<int>(delayAndPadding >> 12);
+      d->encoderPadding = static_cast<int>(delayAndPadding & 0xFFF);
+      d->musicLength    = data.toUInt(pos + 28, true);
+      d->musicCRC       = data.toUShort(pos + 32, true);
+    }
   }
   else {
 
@@ -117,9 +192,23 @@ void MPEG::XingHeader::parse(const ByteVector &data)
         return;
       }
 
-      d->frames = data.toUInt(offset + 14, true);
-      d->size   = data.toUInt(offset + 10, true);
-      d->type   = VBRI;
+      d->frames       = data.toUInt(offset + 14, true);
+      d->size         = data.toUInt(offset + 10, true);
+      d->encoderDelay = data.toUShort(offset + 6, true);
+      d->type         = VBRI;
+
+      // The seek table has entries of 1 to 4 bytes, which are multiplied by
+      // a scale factor.
+
+      const unsigned int entries = data.toUShort(offset + 18, true);
+      const unsigned int scale = data.toUShort(offset + 20, true);
+      const unsigned int entrySize = data.toUShort(offset + 22, true);
+      if(entrySize >= 1 && entrySize <= 4 &&
+         data.size() >= offset + 26 + entries * entrySize) {
+        for(unsigned int i = 0; i < entries; ++i)
+          d->seekTable.append(data.toUInt(offset + 26 + i * entrySize, entrySize, true) * scale);
+        d->framesPerEntry = data.toUShort(offset + 24, true);
+      }
     }
   }
 }
@@ -29,6 +29,8 @@
 #include <memory>
 
 #include "taglib_export.h"
+#include "tlist.h"
+#include "tstring.h"
 #include "mpegheader.h"
 
 namespace TagLib {
@@ -43,8 +45,9 @@ namespace TagLib {
      * This is a minimalistic implementation of the Xing/VBRI VBR headers.
      * Xing/VBRI headers are often added to VBR (variable bit rate) MP3 streams
      * to make it easy to compute the length and quality of a VBR stream.  Our
-     * implementation is only concerned with the total size of the stream (so
-     * that we can calculate the total playing time and the average bitrate).
+     * implementation reads the total size of the stream (so that we can
+     * calculate the total playing time and the average bitrate), the seek
+     * tables and the LAME info tag with the encoder delay and padding.
      * It uses <a href="https://multimedia.cx/mp3extensions.txt">
      * mp3extensions.txt</a> and the XMMS sources as references.
      */
@@ -108,6 +111,58 @@ namespace TagLib {
        */
       HeaderType type() const;
 
+      /*!
+       * Returns the table of contents of a Xing header, which has 100 entries,
+       * or an empty ByteVector if there is none.  Entry \e i is the position
+       * in the stream after \e i percent of the duration, as a fraction of
+       * totalSize() in units of 1/256.
+       */
+      ByteVector tableOfContents() const;
+
+      /*!
+       * Returns the seek table of a VBRI header, or an empty list if there is
+       * none.  Each entry is the size in bytes of the following
+       * seekTableFramesPerEntry() frames.
+       */
+      List<unsigned int> seekTable() const;
+
+      /*!
+       * Returns the number of frames covered by each entry of seekTable().
+       */
+      unsigned int seekTableFramesPerEntry() const;
+
+      /*!
+       * Returns the encoder version from the LAME info tag which follows a Xing
+       * header, e.g. "LAME3.100", or an empty string if there is none.  The
+       * info tag is also written by FFmpeg, whose versions start with "Lavf" or
+       * "Lavc".
+       */
+      String encoderVersion() const;
+
+      /*!
+       * Returns the number of samples which the encoder added before the audio,
+       * from the LAME info tag or the VBRI header, 0 if it is not known.
+       */
+      int encoderDelay() const;
+
+      /*!
+       * Returns the number of samples which the encoder added after the audio
+       * to fill the last frame, from the LAME info tag, 0 if it is not known.
+       */
+      int encoderPadding() const;
+
+      /*!
+       * Returns the length of the stream in bytes from the first frame to the
+       * end of the audio as stored in the LAME info tag, 0 if it is not known.
+       */
+      unsigned int musicLength() const;
+
+      /*!
+       * Returns the CRC-16 of the audio data from the LAME info tag, 0 if it is
+       * not known.
+       */
+      unsigned short musicCRC() const;
+
     private:
       void parse(const ByteVector &data);
 
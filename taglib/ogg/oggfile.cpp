@@ -147,12 +147,7 @@ bool Ogg::File::save()
     return false;
   }
 
-  for(const auto &[i, pkt] : std::as_const(d->dirtyPackets))
-    writePacket(i, pkt);
-
-  d->dirtyPackets.clear();
-
-  return true;
+  return saveWithStrategy([&] { return saveImpl(); });
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -175,6 +170,16 @@ Ogg::File::File(IOStream *stream) :
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
+bool Ogg::File::saveImpl()
+{
+  for(const auto &[i, pkt] : std::as_const(d->dirtyPackets))
+    writePacket(i, pkt);
+
+  d->dirtyPackets.clear();
+
+  return true;
+}
+
 bool Ogg::File::readPages(unsigned int i)
 {
   while(true) {
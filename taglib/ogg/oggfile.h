@@ -117,6 +117,11 @@ namespace TagLib {
        */
       void writePacket(unsigned int i, const ByteVector &packet);
 
+      /*!
+       * Writes the dirty packets to the file.
+       */
+      bool saveImpl();
+
       class FilePrivate;
       TAGLIB_MSVC_SUPPRESS_WARNING_NEEDS_TO_HAVE_DLL_INTERFACE
       std::unique_ptr<FilePrivate> d;
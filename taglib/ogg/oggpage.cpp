@@ -210,11 +210,17 @@ ByteVectorList Ogg::Page::packets() const
 
   if(d->file && d->header.isValid()) {
 
-    d->file->seek(d->fileOffset + d->header.size());
+    // Read all packets at once and split them.
 
+    const ByteVector data = d->file->readBlockAt(d->fileOffset + d->header.size(),
+                                                 d->header.dataSize());
+
+    unsigned int offset = 0;
     const List<int> packetSizes = d->header.packetSizes();
-    for(const auto &sz : packetSizes)
-      l.append(d->file->readBlock(sz));
+    for(const auto &sz : packetSizes) {
+      l.append(data.mid(offset, sz));
+      offset += sz;
+    }
   }
   else
     debug("Ogg::Page::packets() -- attempting to read packets from an invalid page.");
@@ -235,8 +241,8 @@ ByteVector Ogg::Page::render() const
 
   if(d->packets.isEmpty()) {
     if(d->file) {
-      d->file->seek(d->fileOffset + d->header.size());
-      data.append(d->file->readBlock(d->header.dataSize()));
+      data.append(d->file->readBlockAt(d->fileOffset + d->header.size(),
+                                       d->header.dataSize()));
     }
     else
       debug("Ogg::Page::render() -- this page is empty!");
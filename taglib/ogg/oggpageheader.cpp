@@ -211,12 +211,10 @@ ByteVector Ogg::PageHeader::render() const
 
 void Ogg::PageHeader::read(Ogg::File *file, offset_t pageOffset)
 {
-  file->seek(pageOffset);
-
   // An Ogg page header is at least 27 bytes, so we'll go ahead and read that
   // much and then get the rest when we're ready for it.
 
-  const ByteVector data = file->readBlock(27);
+  const ByteVector data = file->readBlockAt(pageOffset, 27);
 
   // Sanity check -- make sure that we were in fact able to read as much data as
   // we asked for and that the page begins with "OggS".
@@ -242,7 +240,7 @@ void Ogg::PageHeader::read(Ogg::File *file, offset_t pageOffset)
 
   int pageSegmentCount = static_cast<unsigned char>(data[26]);
 
-  const ByteVector pageSegments = file->readBlock(pageSegmentCount);
+  const ByteVector pageSegments = file->readBlockAt(pageOffset + 27, pageSegmentCount);
 
   // Another sanity check.
 
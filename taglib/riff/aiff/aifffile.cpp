@@ -127,6 +127,20 @@ bool RIFF::AIFF::File::save(ID3v2::Version version)
     return false;
   }
 
+  return saveWithStrategy([&] { return saveImpl(version); });
+}
+
+bool RIFF::AIFF::File::hasID3v2Tag() const
+{
+  return d->hasID3v2;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// private members
+////////////////////////////////////////////////////////////////////////////////
+
+bool RIFF::AIFF::File::saveImpl(ID3v2::Version version)
+{
   if(d->hasID3v2) {
     removeChunk("ID3 ");
     removeChunk("id3 ");
@@ -141,15 +155,6 @@ bool RIFF::AIFF::File::save(ID3v2::Version version)
   return true;
 }
 
-bool RIFF::AIFF::File::hasID3v2Tag() const
-{
-  return d->hasID3v2;
-}
-
-////////////////////////////////////////////////////////////////////////////////
-// private members
-////////////////////////////////////////////////////////////////////////////////
-
 void RIFF::AIFF::File::read(bool readProperties)
 {
   for(unsigned int i = 0; i < chunkCount(); ++i) {
@@ -152,6 +152,7 @@ namespace TagLib {
 
       private:
         void read(bool readProperties);
+        bool saveImpl(ID3v2::Version version);
 
         friend class Properties;
 
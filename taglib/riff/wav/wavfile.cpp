@@ -157,6 +157,25 @@ bool RIFF::WAV::File::save(TagTypes tags, StripTags strip, ID3v2::Version versio
     return false;
   }
 
+  return saveWithStrategy([&] { return saveImpl(tags, strip, version); });
+}
+
+bool RIFF::WAV::File::hasID3v2Tag() const
+{
+  return d->hasID3v2;
+}
+
+bool RIFF::WAV::File::hasInfoTag() const
+{
+  return d->hasInfo;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// private members
+////////////////////////////////////////////////////////////////////////////////
+
+bool RIFF::WAV::File::saveImpl(TagTypes tags, StripTags strip, ID3v2::Version version)
+{
   if(strip == StripOthers)
     File::strip(static_cast<TagTypes>(AllTags & ~tags));
 
@@ -181,20 +200,6 @@ bool RIFF::WAV::File::save(TagTypes tags, StripTags strip, ID3v2::Version versio
   return true;
 }
 
-bool RIFF::WAV::File::hasID3v2Tag() const
-{
-  return d->hasID3v2;
-}
-
-bool RIFF::WAV::File::hasInfoTag() const
-{
-  return d->hasInfo;
-}
-
-////////////////////////////////////////////////////////////////////////////////
-// private members
-////////////////////////////////////////////////////////////////////////////////
-
 void RIFF::WAV::File::read(bool readProperties)
 {
   for(unsigned int i = 0; i < chunkCount(); ++i) {
@@ -203,6 +203,7 @@ namespace TagLib {
       private:
         void read(bool readProperties);
         void removeTagChunks(TagTypes tags);
+        bool saveImpl(TagTypes tags, StripTags strip, ID3v2::Version version);
 
         friend class Properties;
 
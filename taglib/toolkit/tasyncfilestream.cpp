@@ -0,0 +1,182 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#include "tasyncfilestream.h"
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#ifdef HAVE_IO_URING
+# include <fcntl.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <limits>
+#include <string>
+
+#include "tasyncioqueue.h"
+#include "tfilestream.h"
+#include "tstring.h"
+#include "tdebug.h"
+
+using namespace TagLib;
+
+namespace
+{
+#ifdef _WIN32
+  using FileNameHandle = FileName;
+#else
+  struct FileNameHandle : public std::string
+  {
+    FileNameHandle(FileName name) : std::string(name) {}
+    operator FileName () const { return c_str(); }
+  };
+#endif
+}  // namespace
+
+class AsyncFileStream::AsyncFileStreamPrivate
+{
+public:
+  AsyncFileStreamPrivate(FileName fileName, AsyncIOQueue *queue) :
+    name(fileName),
+    ownQueue(queue ? nullptr : std::make_unique<AsyncIOQueue>()),
+    queue(queue ? queue : ownQueue.get())
+  {
+  }
+
+  const FileNameHandle name;
+  const std::unique_ptr<AsyncIOQueue> ownQueue;
+  AsyncIOQueue *const queue;
+
+  // The file is read through a descriptor if the queue uses io_uring and
+  // through a FileStream otherwise.
+
+  int fd { -1 };
+  std::unique_ptr<FileStream> stream;
+  offset_t length { 0 };
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+AsyncFileStream::AsyncFileStream(FileName fileName, AsyncIOQueue *queue) :
+  d(std::make_unique<AsyncFileStreamPrivate>(fileName, queue))
+{
+#ifdef HAVE_IO_URING
+  if(d->queue->usesIOUring()) {
+    d->fd = open(fileName, O_RDONLY | O_CLOEXEC);
+    if(struct stat st; d->fd >= 0 && fstat(d->fd, &st) == 0 && S_ISREG(st.st_mode)) {
+      d->length = static_cast<offset_t>(st.st_size);
+    }
+    else {
+      if(d->fd >= 0)
+        close(d->fd);
+      d->fd = -1;
+      debug("Could not open file " + String(static_cast<const char *>(d->name)));
+    }
+  }
+  else
+#endif
+  {
+    d->stream = std::make_unique<FileStream>(fileName, true);
+    if(d->stream->isOpen())
+      d->length = d->stream->length();
+    else
+      d->stream.reset();
+  }
+}
+
+AsyncFileStream::~AsyncFileStream()
+{
+  // The handlers are not called, neither those of this stream, which may
+  // refer to it, nor those of the other streams on the queue.
+
+  d->queue->cancel(this);
+
+#ifdef HAVE_IO_URING
+  if(d->fd >= 0)
+    close(d->fd);
+#endif
+}
+
+FileName AsyncFileStream::name() const
+{
+  return d->name;
+}
+
+bool AsyncFileStream::isOpen() const
+{
+  return d->fd >= 0 || d->stream;
+}
+
+offset_t AsyncFileStream::length()
+{
+  return d->length;
+}
+
+void AsyncFileStream::readBlockAt(offset_t offset, size_t length, const ReadHandler &handler)
+{
+  if(!isOpen()) {
+    debug("AsyncFileStream::readBlockAt() -- invalid file.");
+    d->queue->complete(this, ByteVector(), handler);
+    return;
+  }
+
+  // Reads are limited to the end of the file and the maximum ByteVector
+  // size, so that no larger buffer than needed is allocated.
+
+  offset = std::max<offset_t>(offset, 0);
+  const auto readLength = static_cast<unsigned int>(
+    std::min<unsigned long long>({ length, static_cast<unsigned long long>(
+      std::max<offset_t>(d->length - offset, 0)), std::numeric_limits<unsigned int>::max() }));
+
+#ifdef HAVE_IO_URING
+  if(d->fd >= 0) {
+    d->queue->read(this, d->fd, offset, readLength, handler);
+    return;
+  }
+#endif
+
+  d->queue->complete(this, d->stream->readBlockAt(offset, readLength), handler);
+}
+
+unsigned int AsyncFileStream::processCompletions(bool wait)
+{
+  return d->queue->processCompletions(wait);
+}
+
+unsigned int AsyncFileStream::waitForReads()
+{
+  return d->queue->wait(this);
+}
+
+AsyncIOQueue *AsyncFileStream::queue() const
+{
+  return d->queue;
+}
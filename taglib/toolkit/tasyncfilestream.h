@@ -0,0 +1,107 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#ifndef TAGLIB_ASYNCFILESTREAM_H
+#define TAGLIB_ASYNCFILESTREAM_H
+
+#include "tasynciostream.h"
+#include "taglib_export.h"
+
+namespace TagLib {
+
+  class AsyncIOQueue;
+
+  //! A file stream which reads without blocking where the platform supports it
+
+  /*!
+   * The reads are done through an AsyncIOQueue, which uses io_uring on
+   * Linux.  See AsyncIOQueue for the platforms where the reads block.  The
+   * file is opened read only.
+   *
+   * \see SyncIOStream
+   */
+  class TAGLIB_EXPORT AsyncFileStream : public AsyncIOStream
+  {
+  public:
+    /*!
+     * Opens \a fileName for reading through \a queue, which is not owned and
+     * has to outlive this stream.  If \a queue is null, the stream uses its
+     * own queue.
+     */
+    explicit AsyncFileStream(FileName fileName, AsyncIOQueue *queue = nullptr);
+
+    /*!
+     * Waits for the reads of this stream which the kernel is still doing and
+     * closes the file.  The handlers of the pending reads are not called, and
+     * the reads of other streams on the queue are left alone.
+     */
+    ~AsyncFileStream() override;
+
+    /*!
+     * Returns the file name in the local file system encoding.
+     */
+    FileName name() const override;
+
+    /*!
+     * Returns \c true if the file could be opened.
+     */
+    bool isOpen() const override;
+
+    /*!
+     * Returns the length of the file at the time it was opened.
+     */
+    offset_t length() override;
+
+    /*!
+     * Starts reading a block of size \a length at \a offset, see
+     * AsyncIOStream::readBlockAt().
+     */
+    void readBlockAt(offset_t offset, size_t length, const ReadHandler &handler) override;
+
+    /*!
+     * Calls AsyncIOQueue::processCompletions() of the queue of this stream.
+     */
+    unsigned int processCompletions(bool wait) override;
+
+    /*!
+     * Calls AsyncIOQueue::processCompletions() for the reads of this stream
+     * only, see AsyncIOStream::waitForReads().
+     */
+    unsigned int waitForReads() override;
+
+    /*!
+     * Returns the queue of this stream.
+     */
+    AsyncIOQueue *queue() const;
+
+  private:
+    class AsyncFileStreamPrivate;
+    TAGLIB_MSVC_SUPPRESS_WARNING_NEEDS_TO_HAVE_DLL_INTERFACE
+    std::unique_ptr<AsyncFileStreamPrivate> d;
+  };
+
+}  // namespace TagLib
+
+#endif
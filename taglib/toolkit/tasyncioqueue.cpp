@@ -0,0 +1,565 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#include "tasyncioqueue.h"
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#ifdef HAVE_IO_URING
+# include <cerrno>
+# include <cstring>
+# include <linux/io_uring.h>
+# include <sys/eventfd.h>
+# include <sys/mman.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "tstring.h"
+#include "tdebug.h"
+
+using namespace TagLib;
+
+namespace
+{
+  // A read whose handler is to be called by processCompletions()
+
+  struct Completion
+  {
+    const AsyncFileStream *owner;
+    ByteVector data;
+    AsyncIOStream::ReadHandler handler;
+  };
+
+#ifdef HAVE_IO_URING
+
+  // The rings shared with the kernel, see io_uring_setup(2).
+
+  class Ring
+  {
+  public:
+    explicit Ring(unsigned int entries)
+    {
+      io_uring_params params;
+      ::memset(&params, 0, sizeof(params));
+      fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+      if(fd < 0)
+        return;
+
+      sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+      cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+      if(params.features & IORING_FEAT_SINGLE_MMAP)
+        sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+
+      sqRing = map(sqRingSize, IORING_OFF_SQ_RING);
+      cqRing = params.features & IORING_FEAT_SINGLE_MMAP
+        ? sqRing : map(cqRingSize, IORING_OFF_CQ_RING);
+      sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+      sqes = static_cast<io_uring_sqe *>(map(sqesSize, IORING_OFF_SQES));
+      if(!sqRing || !cqRing || !sqes) {
+        close();
+        return;
+      }
+
+      sqEntries = params.sq_entries;
+      sqHead = pointer<unsigned int>(sqRing, params.sq_off.head);
+      sqTail = pointer<unsigned int>(sqRing, params.sq_off.tail);
+      sqMask = *pointer<unsigned int>(sqRing, params.sq_off.ring_mask);
+      sqArray = pointer<unsigned int>(sqRing, params.sq_off.array);
+      cqHead = pointer<unsigned int>(cqRing, params.cq_off.head);
+      cqTail = pointer<unsigned int>(cqRing, params.cq_off.tail);
+      cqMask = *pointer<unsigned int>(cqRing, params.cq_off.ring_mask);
+      cqes = pointer<io_uring_cqe>(cqRing, params.cq_off.cqes);
+
+      eventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+      if(eventFd >= 0 &&
+         syscall(__NR_io_uring_register, fd, IORING_REGISTER_EVENTFD, &eventFd, 1) < 0) {
+        ::close(eventFd);
+        eventFd = -1;
+      }
+    }
+
+    ~Ring()
+    {
+      close();
+    }
+
+    Ring(const Ring &) = delete;
+    Ring &operator=(const Ring &) = delete;
+
+    bool isValid() const
+    {
+      return fd >= 0;
+    }
+
+    // Adds a read to the submission queue, returns false if it is full.
+
+    bool prepareRead(int file, offset_t offset, char *buffer, unsigned int length,
+                     unsigned long long userData)
+    {
+      const unsigned int tail = *sqTail;
+      if(tail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) >= sqEntries)
+        return false;
+
+      const unsigned int index = tail & sqMask;
+      io_uring_sqe *sqe = &sqes[index];
+      ::memset(sqe, 0, sizeof(io_uring_sqe));
+      sqe->opcode = IORING_OP_READ;
+      sqe->fd = file;
+      sqe->off = static_cast<unsigned long long>(offset);
+      sqe->addr = reinterpret_cast<unsigned long long>(buffer);
+      sqe->len = length;
+      sqe->user_data = userData;
+      sqArray[index] = index;
+      __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+      ++unsubmitted;
+      return true;
+    }
+
+    // Submits the prepared reads and waits for \a minComplete completions.
+    // Returns false if the kernel cannot take the reads now, because too
+    // many completions have not been reaped.
+
+    bool enter(unsigned int minComplete)
+    {
+      for(;;) {
+        const long submitted = syscall(__NR_io_uring_enter, fd, unsubmitted, minComplete,
+                                       minComplete > 0 ? IORING_ENTER_GETEVENTS : 0,
+                                       nullptr, 0);
+        if(submitted >= 0) {
+          unsubmitted -= static_cast<unsigned int>(submitted);
+          return true;
+        }
+        if(errno != EINTR) {
+          if(errno != EAGAIN && errno != EBUSY)
+            debug("AsyncIOQueue -- io_uring_enter() failed: " + String(::strerror(errno)));
+          return false;
+        }
+      }
+    }
+
+    // Appends the results of the completed reads to \a results.
+
+    void reap(std::vector<std::pair<unsigned long long, int>> &results)
+    {
+      unsigned int head = *cqHead;
+      const unsigned int tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+      for(; head != tail; ++head) {
+        const io_uring_cqe &cqe = cqes[head & cqMask];
+        results.emplace_back(cqe.user_data, cqe.res);
+      }
+      __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+    }
+
+    unsigned int pendingSubmissions() const
+    {
+      return unsubmitted;
+    }
+
+    int eventDescriptor() const
+    {
+      return eventFd;
+    }
+
+  private:
+    template <typename T>
+    static T *pointer(void *base, unsigned int offset)
+    {
+      return reinterpret_cast<T *>(static_cast<char *>(base) + offset);
+    }
+
+    void *map(size_t size, off_t offset) const
+    {
+      void *p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                     fd, offset);
+      return p != MAP_FAILED ? p : nullptr;
+    }
+
+    void close()
+    {
+      if(sqes)
+        munmap(sqes, sqesSize);
+      if(cqRing && cqRing != sqRing)
+        munmap(cqRing, cqRingSize);
+      if(sqRing)
+        munmap(sqRing, sqRingSize);
+      if(eventFd >= 0)
+        ::close(eventFd);
+      if(fd >= 0)
+        ::close(fd);
+      sqes = nullptr;
+      sqRing = cqRing = nullptr;
+      eventFd = fd = -1;
+    }
+
+    int fd { -1 };
+    int eventFd { -1 };
+    void *sqRing { nullptr };
+    void *cqRing { nullptr };
+    io_uring_sqe *sqes { nullptr };
+    size_t sqRingSize { 0 };
+    size_t cqRingSize { 0 };
+    size_t sqesSize { 0 };
+    unsigned int sqEntries { 0 };
+    unsigned int *sqHead { nullptr };
+    unsigned int *sqTail { nullptr };
+    unsigned int sqMask { 0 };
+    unsigned int *sqArray { nullptr };
+    unsigned int *cqHead { nullptr };
+    unsigned int *cqTail { nullptr };
+    unsigned int cqMask { 0 };
+    io_uring_cqe *cqes { nullptr };
+    unsigned int unsubmitted { 0 };
+  };
+
+#endif
+
+}  // namespace
+
+class AsyncIOQueue::AsyncIOQueuePrivate
+{
+public:
+#ifdef HAVE_IO_URING
+  AsyncIOQueuePrivate(unsigned int entries) :
+    ring(entries)
+  {
+  }
+
+  // A read submitted to the ring, which may take several submissions if the
+  // kernel returns less data than requested.  The owner and handler of a
+  // read are null if its stream has been destroyed before it completed.
+
+  struct Request
+  {
+    const AsyncFileStream *owner;
+    int fd;
+    offset_t offset;
+    ByteVector buffer;
+    unsigned int done;
+    AsyncIOStream::ReadHandler handler;
+  };
+
+  bool submit(unsigned long long id);
+  void handleResults();
+  void erase(std::unordered_map<unsigned long long, Request>::iterator it);
+
+  bool isRunning(const AsyncFileStream *owner) const
+  {
+    return running.find(owner) != running.end();
+  }
+
+  Ring ring;
+  std::unordered_map<unsigned long long, Request> requests;
+
+  // The number of requests of each stream
+  std::unordered_map<const AsyncFileStream *, unsigned int> running;
+
+  // Reads which did not fit into the submission queue
+  std::vector<unsigned long long> waiting;
+
+  std::vector<std::pair<unsigned long long, int>> results;
+  unsigned long long nextId { 0 };
+#else
+  AsyncIOQueuePrivate(unsigned int)
+  {
+  }
+#endif
+
+  bool hasCompletions(const AsyncFileStream *owner) const
+  {
+    return std::any_of(completions.begin(), completions.end(),
+                       [owner](const Completion &c) { return c.owner == owner; });
+  }
+
+  std::vector<Completion> completions;
+};
+
+#ifdef HAVE_IO_URING
+
+bool AsyncIOQueue::AsyncIOQueuePrivate::submit(unsigned long long id)
+{
+  Request &request = requests[id];
+  if(!ring.prepareRead(request.fd, request.offset + request.done,
+                       request.buffer.data() + request.done,
+                       request.buffer.size() - request.done, id))
+    return false;
+
+  // If the kernel is busy, the read stays in the submission queue and is
+  // submitted with the next one or by processCompletions().
+
+  ring.enter(0);
+  return true;
+}
+
+void AsyncIOQueue::AsyncIOQueuePrivate::handleResults()
+{
+  ring.reap(results);
+
+  for(const auto &[id, result] : results) {
+    const auto it = requests.find(id);
+    if(it == requests.end())
+      continue;
+
+    Request &request = it->second;
+    if(!request.owner) {
+      requests.erase(it);
+      continue;
+    }
+    if(result == -EINTR || result == -EAGAIN) {
+      waiting.push_back(id);
+      continue;
+    }
+    if(result < 0) {
+      debug("AsyncIOQueue -- Read failed: " + String(::strerror(-result)));
+      request.buffer.clear();
+    }
+    else {
+      request.done += static_cast<unsigned int>(result);
+      if(result > 0 && request.done < request.buffer.size()) {
+        waiting.push_back(id);
+        continue;
+      }
+      request.buffer.resize(request.done);
+    }
+    completions.push_back({ request.owner, request.buffer, std::move(request.handler) });
+    erase(it);
+  }
+  results.clear();
+
+  // Submit the reads which did not fit before, now that there is room.
+
+  size_t submitted = 0;
+  while(submitted < waiting.size() && submit(waiting[submitted]))
+    ++submitted;
+  waiting.erase(waiting.begin(), waiting.begin() + submitted);
+}
+
+void AsyncIOQueue::AsyncIOQueuePrivate::erase(
+  std::unordered_map<unsigned long long, Request>::iterator it)
+{
+  if(it->second.owner) {
+    const auto count = running.find(it->second.owner);
+    if(--count->second == 0)
+      running.erase(count);
+  }
+  requests.erase(it);
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+AsyncIOQueue::AsyncIOQueue(unsigned int entries) :
+  d(std::make_unique<AsyncIOQueuePrivate>(std::max(entries, 1U)))
+{
+}
+
+AsyncIOQueue::~AsyncIOQueue()
+{
+#ifdef HAVE_IO_URING
+  // The kernel may still write to the buffers of the submitted reads, those
+  // which are still waiting for submission are dropped.
+
+  while(d->ring.isValid()) {
+    for(const auto id : d->waiting)
+      d->requests.erase(id);
+    d->waiting.clear();
+    if(d->requests.empty() || !d->ring.enter(1))
+      break;
+    d->handleResults();
+  }
+#endif
+}
+
+bool AsyncIOQueue::usesIOUring() const
+{
+#ifdef HAVE_IO_URING
+  return d->ring.isValid();
+#else
+  return false;
+#endif
+}
+
+int AsyncIOQueue::eventDescriptor() const
+{
+#ifdef HAVE_IO_URING
+  return d->ring.eventDescriptor();
+#else
+  return -1;
+#endif
+}
+
+unsigned int AsyncIOQueue::pendingReads() const
+{
+#ifdef HAVE_IO_URING
+  return static_cast<unsigned int>(d->requests.size() + d->completions.size());
+#else
+  return static_cast<unsigned int>(d->completions.size());
+#endif
+}
+
+unsigned int AsyncIOQueue::processCompletions([[maybe_unused]] bool wait)
+{
+#ifdef HAVE_IO_URING
+  if(d->ring.isValid()) {
+    if(d->ring.pendingSubmissions() > 0)
+      d->ring.enter(0);
+    d->handleResults();
+
+    while(wait && d->completions.empty() && !d->requests.empty()) {
+      if(!d->ring.enter(1)) {
+        debug("AsyncIOQueue::processCompletions() -- Cannot wait for the pending reads.");
+        break;
+      }
+      d->handleResults();
+    }
+  }
+#endif
+
+  // The handlers may start new reads, which are handled by the next call.
+
+  std::vector<Completion> completions;
+  completions.swap(d->completions);
+  for(const auto &completion : completions)
+    completion.handler(completion.data);
+
+  return static_cast<unsigned int>(completions.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// private members
+////////////////////////////////////////////////////////////////////////////////
+
+void AsyncIOQueue::read([[maybe_unused]] const AsyncFileStream *owner,
+                        [[maybe_unused]] int fd, [[maybe_unused]] offset_t offset,
+                        [[maybe_unused]] unsigned int length,
+                        [[maybe_unused]] const AsyncIOStream::ReadHandler &handler)
+{
+#ifdef HAVE_IO_URING
+  if(length == 0) {
+    complete(owner, ByteVector(), handler);
+    return;
+  }
+
+  const unsigned long long id = d->nextId++;
+  d->requests[id] = { owner, fd, offset, ByteVector(length), 0, handler };
+  ++d->running[owner];
+  if(!d->waiting.empty() || !d->submit(id))
+    d->waiting.push_back(id);
+#endif
+}
+
+void AsyncIOQueue::complete(const AsyncFileStream *owner, const ByteVector &data,
+                            const AsyncIOStream::ReadHandler &handler)
+{
+  d->completions.push_back({ owner, data, handler });
+}
+
+unsigned int AsyncIOQueue::wait(const AsyncFileStream *owner)
+{
+#ifdef HAVE_IO_URING
+  if(d->ring.isValid()) {
+    if(d->ring.pendingSubmissions() > 0)
+      d->ring.enter(0);
+    d->handleResults();
+
+    while(!d->hasCompletions(owner) && d->isRunning(owner)) {
+      if(!d->ring.enter(1)) {
+        debug("AsyncIOQueue::wait() -- Cannot wait for the pending reads.");
+        break;
+      }
+      d->handleResults();
+    }
+  }
+#endif
+
+  // The completions of the other streams are left for processCompletions(),
+  // so that their handlers are not called from within a read of this stream.
+
+  const auto others = std::stable_partition(
+    d->completions.begin(), d->completions.end(),
+    [owner](const Completion &c) { return c.owner != owner; });
+  std::vector<Completion> completions(std::make_move_iterator(others),
+                                      std::make_move_iterator(d->completions.end()));
+  d->completions.erase(others, d->completions.end());
+
+  // The handlers are called last, they may destroy the stream and its queue.
+
+  for(const auto &completion : completions)
+    completion.handler(completion.data);
+
+  return static_cast<unsigned int>(completions.size());
+}
+
+void AsyncIOQueue::cancel(const AsyncFileStream *owner)
+{
+#ifdef HAVE_IO_URING
+  // The kernel may still write to the buffers of the submitted reads and
+  // needs the file descriptor to resubmit them, so these are waited for.
+  // Only the results are collected, no handlers are called.
+
+  while(d->ring.isValid()) {
+    d->waiting.erase(std::remove_if(d->waiting.begin(), d->waiting.end(),
+      [this, owner](unsigned long long id) {
+        const auto it = d->requests.find(id);
+        if(it == d->requests.end() || it->second.owner != owner)
+          return false;
+        d->erase(it);
+        return true;
+      }), d->waiting.end());
+    if(!d->isRunning(owner) || !d->ring.enter(1))
+      break;
+    d->handleResults();
+  }
+
+  // If waiting failed, the remaining reads are detached from the stream and
+  // dropped when they complete.
+
+  if(d->isRunning(owner)) {
+    debug("AsyncIOQueue::cancel() -- Cannot wait for the pending reads.");
+    for(auto &entry : d->requests) {
+      if(entry.second.owner == owner) {
+        entry.second.owner = nullptr;
+        entry.second.handler = nullptr;
+      }
+    }
+    d->running.erase(owner);
+  }
+#endif
+
+  d->completions.erase(std::remove_if(
+    d->completions.begin(), d->completions.end(),
+    [owner](const Completion &c) { return c.owner == owner; }), d->completions.end());
+}
@@ -0,0 +1,133 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#ifndef TAGLIB_ASYNCIOQUEUE_H
+#define TAGLIB_ASYNCIOQUEUE_H
+
+#include "tasynciostream.h"
+#include "taglib_export.h"
+
+namespace TagLib {
+
+  class AsyncFileStream;
+
+  //! Queue of the pending reads of one or more AsyncFileStream objects
+
+  /*!
+   * On Linux, the reads are submitted to an io_uring instance, so that they
+   * do not block the calling thread.  Where io_uring is not available, e.g.
+   * on other platforms or if it is disabled by the system, the reads are
+   * done synchronously when they are started, and only their handlers are
+   * deferred to processCompletions().
+   *
+   * Many streams can share a queue, which keeps the number of kernel objects
+   * low when thousands of files are read at once:
+   *
+   * \code
+   * AsyncIOQueue queue;
+   * std::vector<std::unique_ptr<AsyncFileStream>> streams;
+   * for(const auto &path : paths) {
+   *   streams.push_back(std::make_unique<AsyncFileStream>(path.c_str(), &queue));
+   *   streams.back()->readBlockAt(0, 4096, [](const ByteVector &header) { ... });
+   * }
+   * while(queue.pendingReads() > 0)
+   *   queue.processCompletions(true);
+   * \endcode
+   *
+   * A queue and its streams must only be used by one thread at a time.
+   */
+  class TAGLIB_EXPORT AsyncIOQueue
+  {
+  public:
+    /*!
+     * Constructs a queue for up to \a entries reads, which are submitted at
+     * once.  More reads can be started, they are submitted when earlier
+     * ones completed.
+     */
+    explicit AsyncIOQueue(unsigned int entries = 256);
+
+    /*!
+     * Waits for the pending reads to complete without calling their
+     * handlers and destroys this AsyncIOQueue instance.
+     */
+    ~AsyncIOQueue();
+
+    AsyncIOQueue(const AsyncIOQueue &) = delete;
+    AsyncIOQueue &operator=(const AsyncIOQueue &) = delete;
+
+    /*!
+     * Returns \c true if the reads are done asynchronously using io_uring.
+     */
+    bool usesIOUring() const;
+
+    /*!
+     * Returns a file descriptor which becomes readable when reads complete,
+     * or -1 if there is none.  This allows an event loop to wait for
+     * completions with poll() or epoll, reading the descriptor to reset it
+     * before calling processCompletions().
+     *
+     * Without io_uring, the reads complete when they are started, so
+     * processCompletions() has to be called after starting them.
+     */
+    int eventDescriptor() const;
+
+    /*!
+     * Returns the number of reads whose handlers have not been called yet.
+     */
+    unsigned int pendingReads() const;
+
+    /*!
+     * Calls the handlers of the completed reads and returns their number.
+     * If \a wait is \c true and reads are pending, this blocks until at least
+     * one of them completed.  The handlers may start new reads.
+     */
+    unsigned int processCompletions(bool wait);
+
+  private:
+    friend class AsyncFileStream;
+
+    // Reads using io_uring, only called if usesIOUring() returns true.
+    void read(const AsyncFileStream *owner, int fd, offset_t offset, unsigned int length,
+              const AsyncIOStream::ReadHandler &handler);
+
+    // Queues the handler of a read which has already been done.
+    void complete(const AsyncFileStream *owner, const ByteVector &data,
+                  const AsyncIOStream::ReadHandler &handler);
+
+    // Like processCompletions(true), but only for the reads of \a owner.
+    unsigned int wait(const AsyncFileStream *owner);
+
+    // Waits for the submitted reads of \a owner and drops all of its reads
+    // without calling their handlers.
+    void cancel(const AsyncFileStream *owner);
+
+    class AsyncIOQueuePrivate;
+    TAGLIB_MSVC_SUPPRESS_WARNING_NEEDS_TO_HAVE_DLL_INTERFACE
+    std::unique_ptr<AsyncIOQueuePrivate> d;
+  };
+
+}  // namespace TagLib
+
+#endif
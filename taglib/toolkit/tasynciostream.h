@@ -0,0 +1,118 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#ifndef TAGLIB_ASYNCIOSTREAM_H
+#define TAGLIB_ASYNCIOSTREAM_H
+
+#include <functional>
+
+#include "tiostream.h"
+#include "taglib_export.h"
+
+namespace TagLib {
+
+  //! An abstract class for reading a sequence of bytes without blocking
+
+  /*!
+   * Reads are started with readBlockAt() and complete later: the handler
+   * passed to readBlockAt() is called with the data from
+   * processCompletions(), never from readBlockAt() itself.  This allows an
+   * event loop to have many reads in flight on a single thread.
+   *
+   * The format parsers read synchronously, use a SyncIOStream to pass an
+   * asynchronous stream to them.
+   *
+   * \see AsyncFileStream, SyncIOStream
+   */
+  class TAGLIB_EXPORT AsyncIOStream
+  {
+  public:
+    /*!
+     * Function which is called with the data of a completed read.  The data
+     * is shorter than requested if the end of the stream was reached, and
+     * empty if the read failed.
+     */
+    using ReadHandler = std::function<void(const ByteVector &)>;
+
+    AsyncIOStream();
+
+    /*!
+     * Destroys this AsyncIOStream instance.
+     */
+    virtual ~AsyncIOStream();
+
+    AsyncIOStream(const AsyncIOStream &) = delete;
+    AsyncIOStream &operator=(const AsyncIOStream &) = delete;
+
+    /*!
+     * Returns the stream name in the local file system encoding.
+     */
+    virtual FileName name() const = 0;
+
+    /*!
+     * Returns \c true if the stream could be opened.
+     */
+    virtual bool isOpen() const = 0;
+
+    /*!
+     * Returns the length of the stream.
+     */
+    virtual offset_t length() = 0;
+
+    /*!
+     * Starts reading a block of size \a length at \a offset.  \a handler is
+     * called with the data by processCompletions() once the read completed.
+     */
+    virtual void readBlockAt(offset_t offset, size_t length, const ReadHandler &handler) = 0;
+
+    /*!
+     * Calls the handlers of the completed reads and returns their number.
+     * If \a wait is \c true and reads are pending, this blocks until at least
+     * one of them completed.
+     *
+     * Streams which share a queue, like AsyncFileStream, also call the
+     * handlers of the other streams on the queue.
+     */
+    virtual unsigned int processCompletions(bool wait) = 0;
+
+    /*!
+     * Blocks until at least one of the pending reads of this stream
+     * completed, calls the handlers of its completed reads and returns their
+     * number, which is 0 if no reads are pending.  Unlike
+     * processCompletions(), this never calls the handlers of other streams
+     * sharing a queue, so it can be used while a handler or a parser is
+     * running.
+     */
+    virtual unsigned int waitForReads() = 0;
+
+  private:
+    class AsyncIOStreamPrivate;
+    TAGLIB_MSVC_SUPPRESS_WARNING_NEEDS_TO_HAVE_DLL_INTERFACE
+    std::unique_ptr<AsyncIOStreamPrivate> d;
+  };
+
+}  // namespace TagLib
+
+#endif
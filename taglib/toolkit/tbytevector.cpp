@@ -30,9 +30,11 @@
 #include <cmath>
 #include <cstring>
 #include <iostream>
+#include <mutex>
 
 #include "tdebug.h"
 #include "tutils.h"
+#include "tbytevectorsearch.h"
 
 // This is a bit ugly to keep writing over and over again.
 
@@ -43,70 +45,6 @@
 
 namespace TagLib {
 
-template <class TIterator>
-int findChar(
-  const TIterator dataBegin, const TIterator dataEnd,
-  char c, unsigned int offset, int byteAlign)
-{
-  if(const size_t dataSize = dataEnd - dataBegin; offset + 1 > dataSize)
-    return -1;
-
-  // n % 0 is invalid
-
-  if(byteAlign == 0)
-    return -1;
-
-  for(TIterator it = dataBegin + offset; it < dataEnd; it += byteAlign) {
-    if(*it == c)
-      return static_cast<int>(it - dataBegin);
-  }
-
-  return -1;
-}
-
-template <class TIterator>
-int findVector(
-  const TIterator dataBegin, const TIterator dataEnd,
-  const TIterator patternBegin, const TIterator patternEnd,
-  unsigned int offset, int byteAlign)
-{
-  const size_t dataSize    = dataEnd    - dataBegin;
-  const size_t patternSize = patternEnd - patternBegin;
-  if(patternSize == 0 || offset + patternSize > dataSize)
-    return -1;
-
-  // Special case that pattern contains just single char.
-
-  if(patternSize == 1)
-    return findChar(dataBegin, dataEnd, *patternBegin, offset, byteAlign);
-
-  // n % 0 is invalid
-
-  if(byteAlign == 0)
-    return -1;
-
-  // We don't use sophisticated algorithms like Knuth-Morris-Pratt here.
-
-  // In the current implementation of TagLib, data and patterns are too small
-  // for such algorithms to work effectively.
-
-  for(TIterator it = dataBegin + offset; it < dataEnd - patternSize + 1; it += byteAlign) {
-
-    TIterator itData    = it;
-    TIterator itPattern = patternBegin;
-
-    while(*itData == *itPattern) {
-      ++itData;
-      ++itPattern;
-
-      if(itPattern == patternEnd)
-        return static_cast<int>(it - dataBegin);
-    }
-  }
-
-  return -1;
-}
-
 template <class T>
 T toNumber(const ByteVector &v, size_t offset, size_t length, bool mostSignificantByteFirst)
 {
@@ -260,20 +198,69 @@ public:
 
   ByteVectorPrivate(const ByteVectorPrivate &d, unsigned int o, unsigned int l) :
     data(d.data),
+    rawData(d.rawData),
     offset(d.offset + o),
     length(l)
   {
   }
 
+  // Refers to the external data \a s without copying it.
+
+  ByteVectorPrivate(const char *s, unsigned int l, bool) :
+    rawData(s),
+    offset(0),
+    length(l) { }
+
+  // Returns a pointer to the first byte, no matter if the data is owned or not.
+
+  const char *begin() const
+  {
+    return rawData ? rawData + offset : data->data() + offset;
+  }
+
+  // Returns the vector which the const iterators point into and the offset
+  // of the first byte in it.  Borrowed data is copied once for this.  The
+  // copy is made under a once flag and leaves the other members untouched,
+  // so that const ByteVectors can still be used from several threads.
+
+  const std::vector<char> &vector() const
+  {
+    if(!rawData)
+      return *data;
+
+    std::call_once(copied, [this] {
+      copy = std::make_shared<std::vector<char>>(rawData + offset, rawData + offset + length);
+    });
+    return *copy;
+  }
+
+  unsigned int vectorOffset() const
+  {
+    return rawData ? 0 : offset;
+  }
+
   std::shared_ptr<std::vector<char>> data;
+  const char        *rawData { nullptr };
   unsigned int       offset;
   unsigned int       length;
+
+  // The copy of borrowed data for the const iterators
+  mutable std::once_flag copied;
+  mutable std::shared_ptr<std::vector<char>> copy;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
 // static members
 ////////////////////////////////////////////////////////////////////////////////
 
+ByteVector ByteVector::fromRawData(const char *data, unsigned int length)
+{
+  ByteVector v;
+  if(data && length > 0)
+    v.d = std::make_unique<ByteVectorPrivate>(data, length, true);
+  return v;
+}
+
 ByteVector ByteVector::fromCString(const char *s, unsigned int length)
 {
   if(length == 0xffffffff)
@@ -387,7 +374,7 @@ char *ByteVector::data()
 
 const char *ByteVector::data() const
 {
-  return !isEmpty() ? &(*d->data)[d->offset] : nullptr;
+  return !isEmpty() ? d->begin() : nullptr;
 }
 
 ByteVector ByteVector::mid(unsigned int index, unsigned int length) const
@@ -400,18 +387,24 @@ ByteVector ByteVector::mid(unsigned int index, unsigned int length) const
 
 char ByteVector::at(unsigned int index) const
 {
-  return index < size() ? (*d->data)[d->offset + index] : 0;
+  return index < size() ? d->begin()[index] : 0;
 }
 
 int ByteVector::find(const ByteVector &pattern, unsigned int offset, int byteAlign) const
 {
-  return findVector<ConstIterator>(
-    begin(), end(), pattern.begin(), pattern.end(), offset, byteAlign);
+  if(byteAlign <= 0)
+    return -1;
+
+  return ByteVectorSearch::find(
+    d->begin(), size(), pattern.d->begin(), pattern.size(), offset, byteAlign);
 }
 
 int ByteVector::find(char c, unsigned int offset, int byteAlign) const
 {
-  return findChar<ConstIterator>(begin(), end(), c, offset, byteAlign);
+  if(byteAlign <= 0)
+    return -1;
+
+  return ByteVectorSearch::find(d->begin(), size(), &c, 1, offset, byteAlign);
 }
 
 int ByteVector::rfind(const ByteVector &pattern, unsigned int offset, int byteAlign) const
@@ -422,12 +415,14 @@ int ByteVector::rfind(const ByteVector &pattern, unsigned int offset, int byteAl
       offset = 0;
   }
 
-  const int pos = findVector<ConstReverseIterator>(
-    rbegin(), rend(), pattern.rbegin(), pattern.rend(), offset, byteAlign);
+  // offset counts from the end of the data, searching backwards.
 
-  if(pos == -1)
+  if(byteAlign <= 0 || pattern.isEmpty() || offset + pattern.size() > size())
     return -1;
-  return size() - pos - pattern.size();
+
+  return ByteVectorSearch::rfind(
+    d->begin(), size(), pattern.d->begin(), pattern.size(),
+    size() - pattern.size() - offset, byteAlign);
 }
 
 bool ByteVector::containsAt(const ByteVector &pattern, unsigned int offset, unsigned int patternOffset, unsigned int patternLength) const
@@ -600,12 +595,12 @@ ByteVector::Iterator ByteVector::begin()
 
 ByteVector::ConstIterator ByteVector::begin() const
 {
-  return d->data->begin() + d->offset;
+  return d->vector().begin() + d->vectorOffset();
 }
 
 ByteVector::ConstIterator ByteVector::cbegin() const
 {
-  return d->data->cbegin() + d->offset;
+  return d->vector().cbegin() + d->vectorOffset();
 }
 
 ByteVector::Iterator ByteVector::end()
@@ -616,12 +611,12 @@ ByteVector::Iterator ByteVector::end()
 
 ByteVector::ConstIterator ByteVector::end() const
 {
-  return d->data->begin() + d->offset + d->length;
+  return d->vector().begin() + d->vectorOffset() + d->length;
 }
 
 ByteVector::ConstIterator ByteVector::cend() const
 {
-  return d->data->cbegin() + d->offset + d->length;
+  return d->vector().cbegin() + d->vectorOffset() + d->length;
 }
 
 ByteVector::ReverseIterator ByteVector::rbegin()
@@ -634,8 +629,8 @@ ByteVector::ConstReverseIterator ByteVector::rbegin() const
 {
   // Workaround for the Solaris Studio 12.4 compiler.
   // We need a const reference to the data vector so we can ensure the const version of rbegin() is called.
-  const std::vector<char> &v = *d->data;
-  return v.rbegin() + (v.size() - (d->offset + d->length));
+  const std::vector<char> &v = d->vector();
+  return v.rbegin() + (v.size() - (d->vectorOffset() + d->length));
 }
 
 ByteVector::ReverseIterator ByteVector::rend()
@@ -648,8 +643,8 @@ ByteVector::ConstReverseIterator ByteVector::rend() const
 {
   // Workaround for the Solaris Studio 12.4 compiler.
   // We need a const reference to the data vector so we can ensure the const version of rbegin() is called.
-  const std::vector<char> &v = *d->data;
-  return v.rbegin() + (v.size() - d->offset);
+  const std::vector<char> &v = d->vector();
+  return v.rbegin() + (v.size() - d->vectorOffset());
 }
 
 bool ByteVector::isEmpty() const
@@ -751,7 +746,7 @@ long double ByteVector::toFloat80BE(size_t offset) const
 
 const char &ByteVector::operator[](int index) const
 {
-  return (*d->data)[d->offset + index];
+  return d->begin()[index];
 }
 
 char &ByteVector::operator[](int index)
@@ -973,9 +968,9 @@ ByteVector ByteVector::toBase64() const
 
 void ByteVector::detach()
 {
-  if(d->data.use_count() > 1) {
+  if(d->rawData || d->data.use_count() > 1) {
     if(!isEmpty())
-      ByteVector(&d->data->front() + d->offset, d->length).swap(*this);
+      ByteVector(d->begin(), d->length).swap(*this);
     else
       ByteVector().swap(*this);
   }
@@ -988,8 +983,7 @@ void ByteVector::detach()
 
 std::ostream &operator<<(std::ostream &s, const TagLib::ByteVector &v)
 {
-  for(const auto &byte : v) {
-    s << byte;
-  }
+  if(!v.isEmpty())
+    s.write(v.data(), v.size());
   return s;
 }
@@ -550,6 +550,21 @@ namespace TagLib {
      */
     static ByteVector fromFloat64BE(double value);
 
+    /*!
+     * Returns a ByteVector which refers to the first \a length bytes of
+     * \a data without copying them.
+     *
+     * The returned vector and all its copies share the external buffer as long
+     * as they are only read.  Modifying one of them, or accessing it through
+     * an Iterator, makes a deep copy of the data first.  The ConstIterators
+     * point into a copy which is made on their first use, without changing
+     * the vector, so that a const vector can be read from several threads.
+     *
+     * \warning \a data must stay valid and unmodified as long as the returned
+     * vector or any vector derived from it (e.g. by mid() or copying) is in use.
+     */
+    static ByteVector fromRawData(const char *data, unsigned int length);
+
     /*!
      * Returns a ByteVector based on the CString \a s.
      */
@@ -647,9 +662,10 @@ namespace TagLib {
 
   protected:
     /*!
-     * If this ByteVector is being shared via implicit sharing, do a deep copy
-     * of the data and separate from the shared members.  This should be called
-     * by all non-const subclass members.
+     * If this ByteVector is being shared via implicit sharing or refers to
+     * external data (see fromRawData()), do a deep copy of the data and
+     * separate from the shared members.  This should be called by all
+     * non-const subclass members.
      */
     void detach();
 
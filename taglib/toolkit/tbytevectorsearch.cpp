@@ -0,0 +1,573 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#include "tbytevectorsearch.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define TAGLIB_SEARCH_SSE2
+# define TAGLIB_SEARCH_AVX2
+# include <immintrin.h>
+# ifdef _MSC_VER
+#  include <intrin.h>
+# endif
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+# define TAGLIB_SEARCH_NEON
+# include <arm_neon.h>
+#endif
+
+#ifdef _MSC_VER
+# define TAGLIB_FORCE_INLINE __forceinline
+# define TAGLIB_TARGET_AVX2
+#else
+# define TAGLIB_FORCE_INLINE inline __attribute__((always_inline))
+# define TAGLIB_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+using namespace TagLib;
+
+namespace
+{
+  // The scalar search, which is used if no vectorized kernel is available and
+  // for the parts of the data which are too short for a full vector.
+
+  template <class TIterator>
+  int findChar(
+    const TIterator dataBegin, const TIterator dataEnd,
+    char c, unsigned int offset, int byteAlign)
+  {
+    if(const size_t dataSize = dataEnd - dataBegin; offset + 1 > dataSize)
+      return -1;
+
+    // n % 0 is invalid
+
+    if(byteAlign == 0)
+      return -1;
+
+    for(TIterator it = dataBegin + offset; it < dataEnd; it += byteAlign) {
+      if(*it == c)
+        return static_cast<int>(it - dataBegin);
+    }
+
+    return -1;
+  }
+
+  template <class TIterator>
+  int findVector(
+    const TIterator dataBegin, const TIterator dataEnd,
+    const TIterator patternBegin, const TIterator patternEnd,
+    unsigned int offset, int byteAlign)
+  {
+    const size_t dataSize    = dataEnd    - dataBegin;
+    const size_t patternSize = patternEnd - patternBegin;
+    if(patternSize == 0 || offset + patternSize > dataSize)
+      return -1;
+
+    // Special case that pattern contains just single char.
+
+    if(patternSize == 1)
+      return findChar(dataBegin, dataEnd, *patternBegin, offset, byteAlign);
+
+    // n % 0 is invalid
+
+    if(byteAlign == 0)
+      return -1;
+
+    // We don't use sophisticated algorithms like Knuth-Morris-Pratt here.
+
+    // The patterns are short, so the vectorized kernels below, which find the
+    // candidates by their first and last byte, work better than those.
+
+    for(TIterator it = dataBegin + offset; it < dataEnd - patternSize + 1; it += byteAlign) {
+
+      TIterator itData    = it;
+      TIterator itPattern = patternBegin;
+
+      while(*itData == *itPattern) {
+        ++itData;
+        ++itPattern;
+
+        if(itPattern == patternEnd)
+          return static_cast<int>(it - dataBegin);
+      }
+    }
+
+    return -1;
+  }
+
+  int scalarFind(const char *data, size_t dataSize,
+                 const char *pattern, size_t patternSize,
+                 size_t offset, size_t byteAlign)
+  {
+    return findVector<const char *>(
+      data, data + dataSize, pattern, pattern + patternSize,
+      static_cast<unsigned int>(offset), static_cast<int>(byteAlign));
+  }
+
+  int scalarRFind(const char *data, size_t dataSize,
+                  const char *pattern, size_t patternSize,
+                  size_t last, size_t byteAlign)
+  {
+    // The reverse iterators count the offset from the end of the data.
+
+    using ReverseIterator = std::reverse_iterator<const char *>;
+
+    const int pos = findVector<ReverseIterator>(
+      ReverseIterator(data + dataSize), ReverseIterator(data),
+      ReverseIterator(pattern + patternSize), ReverseIterator(pattern),
+      static_cast<unsigned int>(dataSize - patternSize - last), static_cast<int>(byteAlign));
+
+    if(pos == -1)
+      return -1;
+    return static_cast<int>(dataSize - pos - patternSize);
+  }
+
+  TAGLIB_FORCE_INLINE unsigned int lowestBit(uint32_t mask)
+  {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return __builtin_ctz(mask);
+#endif
+  }
+
+  TAGLIB_FORCE_INLINE unsigned int highestBit(uint32_t mask)
+  {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse(&index, mask);
+    return index;
+#else
+    return 31 - __builtin_clz(mask);
+#endif
+  }
+
+#ifdef TAGLIB_SEARCH_NEON
+
+  TAGLIB_FORCE_INLINE unsigned int lowestBit(uint64_t mask)
+  {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return index;
+#else
+    return __builtin_ctzll(mask);
+#endif
+  }
+
+  TAGLIB_FORCE_INLINE unsigned int highestBit(uint64_t mask)
+  {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, mask);
+    return index;
+#else
+    return 63 - __builtin_clzll(mask);
+#endif
+  }
+
+#endif
+
+  // The vectorized kernels compare the first and the last byte of the pattern
+  // with a whole vector of positions at once and only compare the complete
+  // pattern at the positions where both match.  Each vector type provides
+  // matches(), which returns a mask with bitsPerByte bits set for each of
+  // these positions.
+
+#ifdef TAGLIB_SEARCH_SSE2
+
+  class SSE2Vector
+  {
+  public:
+    using Mask = uint32_t;
+    static constexpr size_t width = 16;
+    static constexpr unsigned int bitsPerByte = 1;
+    static constexpr Mask byteMask = 1;
+
+    SSE2Vector(char firstByte, char lastByte) :
+      first(_mm_set1_epi8(firstByte)),
+      last(_mm_set1_epi8(lastByte))
+    {
+    }
+
+    Mask matches(const char *firstData, const char *lastData) const
+    {
+      const __m128i firstEqual = _mm_cmpeq_epi8(
+        first, _mm_loadu_si128(reinterpret_cast<const __m128i *>(firstData)));
+      const __m128i lastEqual = _mm_cmpeq_epi8(
+        last, _mm_loadu_si128(reinterpret_cast<const __m128i *>(lastData)));
+      return static_cast<Mask>(_mm_movemask_epi8(_mm_and_si128(firstEqual, lastEqual)));
+    }
+
+  private:
+    const __m128i first;
+    const __m128i last;
+  };
+
+#endif
+
+#ifdef TAGLIB_SEARCH_AVX2
+
+  class AVX2Vector
+  {
+  public:
+    using Mask = uint32_t;
+    static constexpr size_t width = 32;
+    static constexpr unsigned int bitsPerByte = 1;
+    static constexpr Mask byteMask = 1;
+
+    TAGLIB_TARGET_AVX2 AVX2Vector(char firstByte, char lastByte) :
+      first(_mm256_set1_epi8(firstByte)),
+      last(_mm256_set1_epi8(lastByte))
+    {
+    }
+
+    TAGLIB_TARGET_AVX2 Mask matches(const char *firstData, const char *lastData) const
+    {
+      const __m256i firstEqual = _mm256_cmpeq_epi8(
+        first, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(firstData)));
+      const __m256i lastEqual = _mm256_cmpeq_epi8(
+        last, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lastData)));
+      return static_cast<Mask>(_mm256_movemask_epi8(_mm256_and_si256(firstEqual, lastEqual)));
+    }
+
+  private:
+    const __m256i first;
+    const __m256i last;
+  };
+
+#endif
+
+#ifdef TAGLIB_SEARCH_NEON
+
+  class NEONVector
+  {
+  public:
+    // NEON has no movemask, narrowing the comparison result yields four bits
+    // per byte instead.
+
+    using Mask = uint64_t;
+    static constexpr size_t width = 16;
+    static constexpr unsigned int bitsPerByte = 4;
+    static constexpr Mask byteMask = 0xf;
+
+    NEONVector(char firstByte, char lastByte) :
+      first(vdupq_n_u8(static_cast<uint8_t>(firstByte))),
+      last(vdupq_n_u8(static_cast<uint8_t>(lastByte)))
+    {
+    }
+
+    Mask matches(const char *firstData, const char *lastData) const
+    {
+      const uint8x16_t firstEqual = vceqq_u8(
+        first, vld1q_u8(reinterpret_cast<const uint8_t *>(firstData)));
+      const uint8x16_t lastEqual = vceqq_u8(
+        last, vld1q_u8(reinterpret_cast<const uint8_t *>(lastData)));
+      const uint8x8_t narrowed = vshrn_n_u16(
+        vreinterpretq_u16_u8(vandq_u8(firstEqual, lastEqual)), 4);
+      return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+    }
+
+  private:
+    const uint8x16_t first;
+    const uint8x16_t last;
+  };
+
+#endif
+
+  // Only alignments which divide the vector width are vectorized, so that the
+  // aligned positions are at the same places in every vector.
+
+  template <class Vector>
+  bool isVectorizable(size_t byteAlign)
+  {
+    return byteAlign <= Vector::width && Vector::width % byteAlign == 0;
+  }
+
+  template <class Vector>
+  TAGLIB_FORCE_INLINE typename Vector::Mask alignmentMask(size_t byteAlign, size_t first)
+  {
+    typename Vector::Mask mask = 0;
+    for(size_t i = first; i < Vector::width; i += byteAlign)
+      mask |= Vector::byteMask << (i * Vector::bitsPerByte);
+    return mask;
+  }
+
+  template <class Vector>
+  TAGLIB_FORCE_INLINE int vectorFind(const char *data, size_t dataSize,
+                                     const char *pattern, size_t patternSize,
+                                     size_t offset, size_t byteAlign)
+  {
+    const Vector vector(pattern[0], pattern[patternSize - 1]);
+    const typename Vector::Mask alignment = alignmentMask<Vector>(byteAlign, 0);
+
+    size_t i = offset;
+    for(; i + patternSize - 1 + Vector::width <= dataSize; i += Vector::width) {
+      typename Vector::Mask mask =
+        vector.matches(data + i, data + i + patternSize - 1) & alignment;
+
+      while(mask != 0) {
+        const unsigned int byte = lowestBit(mask) / Vector::bitsPerByte;
+        if(::memcmp(data + i + byte, pattern, patternSize) == 0)
+          return static_cast<int>(i + byte);
+        mask &= ~(Vector::byteMask << (byte * Vector::bitsPerByte));
+      }
+    }
+
+    return scalarFind(data, dataSize, pattern, patternSize, i, byteAlign);
+  }
+
+  template <class Vector>
+  TAGLIB_FORCE_INLINE int vectorRFind(const char *data, size_t dataSize,
+                                      const char *pattern, size_t patternSize,
+                                      size_t last, size_t byteAlign)
+  {
+    const Vector vector(pattern[0], pattern[patternSize - 1]);
+
+    // The blocks end at aligned positions, going backwards from last.
+
+    const typename Vector::Mask alignment =
+      alignmentMask<Vector>(byteAlign, (Vector::width - 1) % byteAlign);
+
+    size_t end = last + 1;
+    for(; end >= Vector::width; end -= Vector::width) {
+      const size_t i = end - Vector::width;
+      typename Vector::Mask mask =
+        vector.matches(data + i, data + i + patternSize - 1) & alignment;
+
+      while(mask != 0) {
+        const unsigned int byte = highestBit(mask) / Vector::bitsPerByte;
+        if(::memcmp(data + i + byte, pattern, patternSize) == 0)
+          return static_cast<int>(i + byte);
+        mask &= ~(Vector::byteMask << (byte * Vector::bitsPerByte));
+      }
+    }
+
+    if(end == 0)
+      return -1;
+    return scalarRFind(data, dataSize, pattern, patternSize, end - 1, byteAlign);
+  }
+
+#ifdef TAGLIB_SEARCH_SSE2
+
+  int findSSE2(const char *data, size_t dataSize, const char *pattern, size_t patternSize,
+               size_t offset, size_t byteAlign)
+  {
+    return vectorFind<SSE2Vector>(data, dataSize, pattern, patternSize, offset, byteAlign);
+  }
+
+  int rfindSSE2(const char *data, size_t dataSize, const char *pattern, size_t patternSize,
+                size_t last, size_t byteAlign)
+  {
+    return vectorRFind<SSE2Vector>(data, dataSize, pattern, patternSize, last, byteAlign);
+  }
+
+#endif
+
+#ifdef TAGLIB_SEARCH_AVX2
+
+  TAGLIB_TARGET_AVX2
+  int findAVX2(const char *data, size_t dataSize, const char *pattern, size_t patternSize,
+               size_t offset, size_t byteAlign)
+  {
+    return vectorFind<AVX2Vector>(data, dataSize, pattern, patternSize, offset, byteAlign);
+  }
+
+  TAGLIB_TARGET_AVX2
+  int rfindAVX2(const char *data, size_t dataSize, const char *pattern, size_t patternSize,
+                size_t last, size_t byteAlign)
+  {
+    return vectorRFind<AVX2Vector>(data, dataSize, pattern, patternSize, last, byteAlign);
+  }
+
+  bool cpuSupportsAVX2()
+  {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if(info[0] < 7)
+      return false;
+
+    // The OS has to save the YMM registers, too.
+
+    __cpuid(info, 1);
+    if((info[2] & (1 << 27)) == 0 || (_xgetbv(0) & 6) != 6)
+      return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+  }
+
+#endif
+
+#ifdef TAGLIB_SEARCH_NEON
+
+  int findNEON(const char *data, size_t dataSize, const char *pattern, size_t patternSize,
+               size_t offset, size_t byteAlign)
+  {
+    return vectorFind<NEONVector>(data, dataSize, pattern, patternSize, offset, byteAlign);
+  }
+
+  int rfindNEON(const char *data, size_t dataSize, const char *pattern, size_t patternSize,
+                size_t last, size_t byteAlign)
+  {
+    return vectorRFind<NEONVector>(data, dataSize, pattern, patternSize, last, byteAlign);
+  }
+
+#endif
+
+  ByteVectorSearch::Kernel detectKernel()
+  {
+#if defined(TAGLIB_SEARCH_AVX2)
+    if(cpuSupportsAVX2())
+      return ByteVectorSearch::Kernel::AVX2;
+#endif
+#if defined(TAGLIB_SEARCH_SSE2)
+    return ByteVectorSearch::Kernel::SSE2;
+#elif defined(TAGLIB_SEARCH_NEON)
+    return ByteVectorSearch::Kernel::NEON;
+#else
+    return ByteVectorSearch::Kernel::Scalar;
+#endif
+  }
+
+  // Searches done by static initializers which run before this one use the
+  // zero initialized value, which is the scalar kernel.
+
+  std::atomic<ByteVectorSearch::Kernel> currentKernel(detectKernel());
+}  // namespace
+
+bool ByteVectorSearch::isSupported(Kernel kernel)
+{
+  switch(kernel) {
+  case Kernel::Scalar:
+    return true;
+#ifdef TAGLIB_SEARCH_SSE2
+  case Kernel::SSE2:
+    return true;
+#endif
+#ifdef TAGLIB_SEARCH_AVX2
+  case Kernel::AVX2:
+    return cpuSupportsAVX2();
+#endif
+#ifdef TAGLIB_SEARCH_NEON
+  case Kernel::NEON:
+    return true;
+#endif
+  default:
+    return false;
+  }
+}
+
+ByteVectorSearch::Kernel ByteVectorSearch::kernel()
+{
+  return currentKernel.load(std::memory_order_relaxed);
+}
+
+bool ByteVectorSearch::setKernel(Kernel kernel)
+{
+  if(!isSupported(kernel))
+    return false;
+
+  currentKernel.store(kernel, std::memory_order_relaxed);
+  return true;
+}
+
+int ByteVectorSearch::find(const char *data, size_t dataSize,
+                           const char *pattern, size_t patternSize,
+                           size_t offset, size_t byteAlign)
+{
+  if(patternSize == 0 || byteAlign == 0 || offset + patternSize > dataSize)
+    return -1;
+
+  switch(currentKernel.load(std::memory_order_relaxed)) {
+#ifdef TAGLIB_SEARCH_SSE2
+  case Kernel::SSE2:
+    if(isVectorizable<SSE2Vector>(byteAlign))
+      return findSSE2(data, dataSize, pattern, patternSize, offset, byteAlign);
+    break;
+#endif
+#ifdef TAGLIB_SEARCH_AVX2
+  case Kernel::AVX2:
+    if(isVectorizable<AVX2Vector>(byteAlign))
+      return findAVX2(data, dataSize, pattern, patternSize, offset, byteAlign);
+    break;
+#endif
+#ifdef TAGLIB_SEARCH_NEON
+  case Kernel::NEON:
+    if(isVectorizable<NEONVector>(byteAlign))
+      return findNEON(data, dataSize, pattern, patternSize, offset, byteAlign);
+    break;
+#endif
+  default:
+    break;
+  }
+
+  return scalarFind(data, dataSize, pattern, patternSize, offset, byteAlign);
+}
+
+int ByteVectorSearch::rfind(const char *data, size_t dataSize,
+                            const char *pattern, size_t patternSize,
+                            size_t last, size_t byteAlign)
+{
+  if(patternSize == 0 || byteAlign == 0 || patternSize > dataSize ||
+     last > dataSize - patternSize)
+    return -1;
+
+  switch(currentKernel.load(std::memory_order_relaxed)) {
+#ifdef TAGLIB_SEARCH_SSE2
+  case Kernel::SSE2:
+    if(isVectorizable<SSE2Vector>(byteAlign))
+      return rfindSSE2(data, dataSize, pattern, patternSize, last, byteAlign);
+    break;
+#endif
+#ifdef TAGLIB_SEARCH_AVX2
+  case Kernel::AVX2:
+    if(isVectorizable<AVX2Vector>(byteAlign))
+      return rfindAVX2(data, dataSize, pattern, patternSize, last, byteAlign);
+    break;
+#endif
+#ifdef TAGLIB_SEARCH_NEON
+  case Kernel::NEON:
+    if(isVectorizable<NEONVector>(byteAlign))
+      return rfindNEON(data, dataSize, pattern, patternSize, last, byteAlign);
+    break;
+#endif
+  default:
+    break;
+  }
+
+  return scalarRFind(data, dataSize, pattern, patternSize, last, byteAlign);
+}
@@ -0,0 +1,92 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#ifndef TAGLIB_TBYTEVECTORSEARCH_H
+#define TAGLIB_TBYTEVECTORSEARCH_H
+
+#include <cstddef>
+
+#include "taglib_export.h"
+
+// THIS FILE IS NOT A PART OF THE TAGLIB API
+
+#ifndef DO_NOT_DOCUMENT  // tell Doxygen not to document this header
+
+namespace TagLib {
+
+  namespace ByteVectorSearch {
+
+    /*!
+     * The implementations of the search functions.  The vectorized kernels
+     * are only available if the CPU supports them, Scalar is always
+     * available.
+     */
+    enum class Kernel {
+      Scalar,
+      SSE2,
+      AVX2,
+      NEON
+    };
+
+    /*!
+     * Returns true if \a kernel can be used on this CPU.
+     */
+    bool TAGLIB_EXPORT isSupported(Kernel kernel);
+
+    /*!
+     * Returns the kernel which is currently used, by default the fastest one
+     * supported by the CPU.
+     */
+    Kernel TAGLIB_EXPORT kernel();
+
+    /*!
+     * Selects the kernel used by all searches, intended for tests and
+     * benchmarks.  Returns false and keeps the current kernel if \a kernel
+     * is not supported.
+     */
+    bool TAGLIB_EXPORT setKernel(Kernel kernel);
+
+    /*!
+     * Returns the first position \a offset + n * \a byteAlign at which
+     * \a pattern occurs in \a data, or -1 if there is none.
+     */
+    int find(const char *data, size_t dataSize,
+             const char *pattern, size_t patternSize,
+             size_t offset, size_t byteAlign);
+
+    /*!
+     * Returns the last position \a last - n * \a byteAlign at which
+     * \a pattern occurs in \a data, or -1 if there is none.
+     */
+    int rfind(const char *data, size_t dataSize,
+              const char *pattern, size_t patternSize,
+              size_t last, size_t byteAlign);
+
+  }  // namespace ByteVectorSearch
+}  // namespace TagLib
+
+#endif
+
+#endif
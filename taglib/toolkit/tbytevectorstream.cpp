@@ -52,6 +52,11 @@ ByteVectorStream::ByteVectorStream(const ByteVector &data) :
 {
 }
 
+ByteVectorStream::ByteVectorStream(const char *data, unsigned int length) :
+  d(std::make_unique<ByteVectorStreamPrivate>(ByteVector::fromRawData(data, length)))
+{
+}
+
 ByteVectorStream::~ByteVectorStream() = default;
 
 FileName ByteVectorStream::name() const
@@ -70,6 +75,20 @@ ByteVector ByteVectorStream::readBlock(size_t length)
   return v;
 }
 
+ByteVector ByteVectorStream::readBlockAt(offset_t offset, size_t length)
+{
+  if(length == 0 || offset < 0 || offset >= d->data.size())
+    return ByteVector();
+
+  return d->data.mid(static_cast<unsigned int>(offset),
+                     static_cast<unsigned int>(length));
+}
+
+bool ByteVectorStream::supportsConcurrentReads() const
+{
+  return true;
+}
+
 void ByteVectorStream::writeBlock(const ByteVector &data)
 {
   unsigned int size = data.size();
@@ -47,6 +47,18 @@ namespace TagLib {
      */
     ByteVectorStream(const ByteVector &data);
 
+    /*!
+     * Construct a ByteVectorStream from the first \a length bytes of \a data
+     * without copying them.  The data is only copied if the stream is
+     * modified, \a data itself is never written to.
+     *
+     * \warning \a data must stay valid as long as the stream and the objects
+     * created from it, e.g. a File and its tags, are in use.
+     *
+     * \see ByteVector::fromRawData()
+     */
+    ByteVectorStream(const char *data, unsigned int length);
+
     /*!
      * Destroys this ByteVectorStream instance.
      */
@@ -130,6 +142,18 @@ namespace TagLib {
      */
     void truncate(offset_t length) override;
 
+    /*!
+     * Returns the block of size \a length at \a offset without moving the
+     * get pointer.
+     */
+    ByteVector readBlockAt(offset_t offset, size_t length) override;
+
+    /*!
+     * Returns \c true, the data can be read concurrently as long as it is not
+     * modified.
+     */
+    bool supportsConcurrentReads() const override;
+
     ByteVector *data();
 
   private:
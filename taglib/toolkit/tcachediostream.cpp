@@ -0,0 +1,265 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include "tcachediostream.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "tstring.h"
+#include "tdebug.h"
+
+using namespace TagLib;
+
+namespace
+{
+  struct Page
+  {
+    offset_t index;
+    ByteVector data;
+    unsigned long long lastUse;
+  };
+}  // namespace
+
+class CachedIOStream::CachedIOStreamPrivate
+{
+public:
+  CachedIOStreamPrivate(IOStream *stream, unsigned int pageSize, unsigned int pageCount) :
+    stream(stream),
+    pageSize(std::max(pageSize, 1U)),
+    pageCount(std::max(pageCount, 1U)),
+    position(stream->tell())
+  {
+  }
+
+  // Returns the page with the given index, reading it into the least
+  // recently used slot if it is not cached.
+
+  const ByteVector &page(offset_t index)
+  {
+    ++useCount;
+
+    for(auto &page : pages) {
+      if(page.index == index) {
+        ++hits;
+        page.lastUse = useCount;
+        return page.data;
+      }
+    }
+
+    ++misses;
+
+    ByteVector data = stream->readBlockAt(index * pageSize, pageSize);
+    if(pages.size() < pageCount) {
+      pages.push_back({ index, std::move(data), useCount });
+      return pages.back().data;
+    }
+
+    const auto leastRecentlyUsed = std::min_element(
+      pages.begin(), pages.end(),
+      [](const Page &a, const Page &b) { return a.lastUse < b.lastUse; });
+    *leastRecentlyUsed = { index, std::move(data), useCount };
+    return leastRecentlyUsed->data;
+  }
+
+  ByteVector read(offset_t offset, size_t count)
+  {
+    if(count >= pageSize)
+      return stream->readBlockAt(offset, count);
+
+    ByteVector result;
+    while(result.size() < count) {
+      const ByteVector &data = page(offset / pageSize);
+      const auto begin = static_cast<unsigned int>(offset % pageSize);
+      if(begin >= data.size())
+        break;
+
+      const unsigned int size =
+        std::min(data.size() - begin, static_cast<unsigned int>(count - result.size()));
+      result.append(data.mid(begin, size));
+      offset += size;
+
+      if(data.size() < pageSize)
+        break;
+    }
+
+    return result;
+  }
+
+  // Drops the pages which overlap the given range, and the last page of the
+  // stream, since the end of the stream may move.
+
+  void invalidate(offset_t offset, offset_t end)
+  {
+    pages.erase(std::remove_if(pages.begin(), pages.end(), [&](const Page &page) {
+      const offset_t pageOffset = page.index * pageSize;
+      return (pageOffset < end && offset < pageOffset + pageSize) ||
+             page.data.size() < pageSize;
+    }), pages.end());
+    cachedLength = -1;
+  }
+
+  IOStream *const stream;
+  const unsigned int pageSize;
+  const unsigned int pageCount;
+  std::vector<Page> pages;
+  offset_t position;
+  offset_t cachedLength { -1 };
+  unsigned long long useCount { 0 };
+  unsigned long long hits { 0 };
+  unsigned long long misses { 0 };
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+CachedIOStream::CachedIOStream(IOStream *stream, unsigned int pageSize,
+                               unsigned int pageCount) :
+  d(std::make_unique<CachedIOStreamPrivate>(stream, pageSize, pageCount))
+{
+}
+
+CachedIOStream::~CachedIOStream() = default;
+
+FileName CachedIOStream::name() const
+{
+  return d->stream->name();
+}
+
+ByteVector CachedIOStream::readBlock(size_t length)
+{
+  ByteVector buffer = d->read(d->position, length);
+  d->position += buffer.size();
+
+  return buffer;
+}
+
+void CachedIOStream::writeBlock(const ByteVector &data)
+{
+  d->invalidate(d->position, d->position + data.size());
+
+  d->stream->seek(d->position);
+  d->stream->writeBlock(data);
+  d->position = d->stream->tell();
+}
+
+void CachedIOStream::insert(const ByteVector &data, offset_t start, size_t replace)
+{
+  d->invalidate(start, std::numeric_limits<offset_t>::max());
+
+  d->stream->insert(data, start, replace);
+  d->position = d->stream->tell();
+}
+
+void CachedIOStream::removeBlock(offset_t start, size_t length)
+{
+  d->invalidate(start, std::numeric_limits<offset_t>::max());
+
+  d->stream->removeBlock(start, length);
+  d->position = d->stream->tell();
+}
+
+bool CachedIOStream::readOnly() const
+{
+  return d->stream->readOnly();
+}
+
+bool CachedIOStream::isOpen() const
+{
+  return d->stream->isOpen();
+}
+
+void CachedIOStream::seek(offset_t offset, Position p)
+{
+  switch(p) {
+  case Beginning:
+    d->position = offset;
+    break;
+  case Current:
+    d->position += offset;
+    break;
+  case End:
+    d->position = length() + offset;
+    break;
+  default:
+    debug("CachedIOStream::seek() -- Invalid Position value.");
+    return;
+  }
+
+  if(d->position < 0)
+    d->position = 0;
+}
+
+void CachedIOStream::clear()
+{
+  d->stream->clear();
+}
+
+offset_t CachedIOStream::tell() const
+{
+  return d->position;
+}
+
+offset_t CachedIOStream::length()
+{
+  if(d->cachedLength < 0)
+    d->cachedLength = d->stream->length();
+
+  return d->cachedLength;
+}
+
+void CachedIOStream::truncate(offset_t length)
+{
+  d->invalidate(length, std::numeric_limits<offset_t>::max());
+
+  d->stream->truncate(length);
+}
+
+ByteVector CachedIOStream::readBlockAt(offset_t offset, size_t length)
+{
+  return d->read(offset, length);
+}
+
+bool CachedIOStream::supportsConcurrentReads() const
+{
+  return false;
+}
+
+void CachedIOStream::invalidate()
+{
+  d->pages.clear();
+  d->cachedLength = -1;
+}
+
+unsigned long long CachedIOStream::hits() const
+{
+  return d->hits;
+}
+
+unsigned long long CachedIOStream::misses() const
+{
+  return d->misses;
+}
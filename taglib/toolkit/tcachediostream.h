@@ -0,0 +1,176 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_CACHEDIOSTREAM_H
+#define TAGLIB_CACHEDIOSTREAM_H
+
+#include "tiostream.h"
+#include "taglib_export.h"
+
+namespace TagLib {
+
+  //! I/O stream which caches pages of another stream
+
+  /*!
+   * This keeps the most recently used pages of another stream in memory, so
+   * that the many small reads done while parsing a file only reach the
+   * other stream when a page is not cached.  This helps most with streams
+   * for which each call is expensive, e.g. files on network or FUSE file
+   * systems or custom streams:
+   *
+   * \code
+   * MyNetworkStream stream(url);
+   * CachedIOStream cached(&stream);
+   * FileRef file(&cached);
+   * \endcode
+   *
+   * Pages start at multiples of the page size.  Reads of at least a page
+   * are passed to the other stream.  Pages are invalidated when they are
+   * changed through this stream, the other stream must not be changed
+   * otherwise, or invalidate() has to be called.
+   *
+   * The other stream is not owned and has to outlive this stream.
+   */
+  class TAGLIB_EXPORT CachedIOStream : public IOStream
+  {
+  public:
+    /*!
+     * Constructs a stream which caches up to \a pageCount pages of
+     * \a pageSize bytes of \a stream, positioned at the current position of
+     * \a stream.
+     */
+    explicit CachedIOStream(IOStream *stream, unsigned int pageSize = 4096,
+                            unsigned int pageCount = 8);
+
+    /*!
+     * Destroys this CachedIOStream instance.
+     */
+    ~CachedIOStream() override;
+
+    CachedIOStream(const CachedIOStream &) = delete;
+    CachedIOStream &operator=(const CachedIOStream &) = delete;
+
+    /*!
+     * Returns the name of the other stream.
+     */
+    FileName name() const override;
+
+    /*!
+     * Reads a block of size \a length at the current get pointer.
+     */
+    ByteVector readBlock(size_t length) override;
+
+    /*!
+     * Writes the block \a data at the current get pointer and invalidates
+     * the pages which it overlaps.
+     */
+    void writeBlock(const ByteVector &data) override;
+
+    /*!
+     * Inserts \a data at position \a start, overwriting \a replace bytes, and
+     * invalidates the pages after \a start.
+     */
+    void insert(const ByteVector &data, offset_t start = 0, size_t replace = 0) override;
+
+    /*!
+     * Removes \a length bytes at \a start and invalidates the pages after
+     * \a start.
+     */
+    void removeBlock(offset_t start = 0, size_t length = 0) override;
+
+    /*!
+     * Returns \c true if the other stream is read only.
+     */
+    bool readOnly() const override;
+
+    /*!
+     * Returns \c true if the other stream is open.
+     */
+    bool isOpen() const override;
+
+    /*!
+     * Move the I/O pointer to \a offset in the stream from position \a p.
+     * This does not touch the other stream.
+     *
+     * \see Position
+     */
+    void seek(offset_t offset, Position p = Beginning) override;
+
+    /*!
+     * Reset the end-of-file and error flags on the other stream.
+     */
+    void clear() override;
+
+    /*!
+     * Returns the current offset within the stream.
+     */
+    offset_t tell() const override;
+
+    /*!
+     * Returns the length of the other stream, which is cached until the
+     * stream is changed.
+     */
+    offset_t length() override;
+
+    /*!
+     * Truncates the stream to \a length and invalidates the pages after it.
+     */
+    void truncate(offset_t length) override;
+
+    /*!
+     * Reads a block of size \a length at \a offset.  The get pointer is not
+     * moved.
+     */
+    ByteVector readBlockAt(offset_t offset, size_t length) override;
+
+    /*!
+     * Returns \c false, the cache is not shared between threads.
+     */
+    bool supportsConcurrentReads() const override;
+
+    /*!
+     * Drops all cached pages and the cached length.
+     */
+    void invalidate();
+
+    /*!
+     * Returns the number of pages which were read from the cache.
+     */
+    unsigned long long hits() const;
+
+    /*!
+     * Returns the number of pages which had to be read from the other
+     * stream.
+     */
+    unsigned long long misses() const;
+
+  private:
+    class CachedIOStreamPrivate;
+    TAGLIB_MSVC_SUPPRESS_WARNING_NEEDS_TO_HAVE_DLL_INTERFACE
+    std::unique_ptr<CachedIOStreamPrivate> d;
+  };
+
+}  // namespace TagLib
+
+#endif
@@ -25,9 +25,16 @@
 
 #include "tfile.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+
 #include "tfilestream.h"
+#include "trewritestream.h"
 #include "tpropertymap.h"
 #include "tstring.h"
+#include "tdebug.h"
 
 #ifdef _WIN32
 # include <windows.h>
@@ -45,12 +52,20 @@
 
 using namespace TagLib;
 
+namespace
+{
+  std::atomic<unsigned int> defaultInitialSearchBlockSize(1024);
+  std::atomic<unsigned int> defaultMaximumSearchBlockSize(64 * 1024);
+}  // namespace
+
 class File::FilePrivate
 {
 public:
   FilePrivate(IOStream *stream, bool owner) :
     stream(stream),
-    streamOwner(owner)
+    streamOwner(owner),
+    initialSearchBlockSize(defaultInitialSearchBlockSize),
+    maximumSearchBlockSize(defaultMaximumSearchBlockSize)
   {
   }
 
@@ -63,9 +78,31 @@ public:
   FilePrivate(const FilePrivate &) = delete;
   FilePrivate &operator=(const FilePrivate &) = delete;
 
+  // Returns the size of the block to read after a block of \a size bytes
+  // did not contain the search pattern.
+
+  unsigned int nextSearchBlockSize(unsigned int size) const
+  {
+    return size < maximumSearchBlockSize / 2 ? size * 2 : maximumSearchBlockSize;
+  }
+
   IOStream *stream;
   bool streamOwner;
   bool valid { true };
+  unsigned int initialSearchBlockSize;
+  unsigned int maximumSearchBlockSize;
+  SaveStrategy saveStrategy { InPlace };
+  PayloadStyle payloadStyle { ReadPayloads };
+
+  // Refers to the file from the functions returned by deferredReadBlock(),
+  // which may outlive it.
+
+  std::shared_ptr<File *> self;
+
+  // Serializes the reads of deferred payloads, which may be triggered by
+  // const accessors on several threads.
+
+  std::mutex deferredReadMutex;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -124,6 +161,11 @@ ByteVector File::readBlock(size_t length)
   return d->stream->readBlock(length);
 }
 
+ByteVector File::readBlockAt(offset_t offset, size_t length)
+{
+  return d->stream->readBlockAt(offset, length);
+}
+
 void File::writeBlock(const ByteVector &data)
 {
   d->stream->writeBlock(data);
@@ -131,87 +173,70 @@ void File::writeBlock(const ByteVector &data)
 
 offset_t File::find(const ByteVector &pattern, offset_t fromOffset, const ByteVector &before)
 {
-  if(!d->stream || pattern.size() > bufferSize())
+  if(!d->stream || pattern.isEmpty())
       return -1;
 
-  // The position in the file that the current buffer starts at.
+  // The search window consists of the end of the previous block followed by
+  // the current block.  Keeping the last n - 1 bytes of the previous block,
+  // n being the size of the longest pattern, makes sure that matches which
+  // cross the block boundary are found, no matter how large the blocks are.
 
-  offset_t bufferOffset = fromOffset;
+  const unsigned int overlap = std::max(pattern.size(), before.size()) - 1;
 
-  // These variables are used to keep track of a partial match that happens at
-  // the end of a buffer.
+  // The position in the file that the current window starts at.
 
-  int previousPartialMatch = -1;
-  int beforePreviousPartialMatch = -1;
+  offset_t windowOffset = fromOffset;
+
+  // The window is reused for all blocks, so it is only reallocated while the
+  // block size is growing.
+
+  ByteVector window;
+
+  unsigned int blockSize = d->initialSearchBlockSize;
 
   // Save the location of the current read pointer.  We will restore the
   // position using seek() before all returns.
 
-  offset_t originalPosition = tell();
+  const offset_t originalPosition = tell();
 
   // Start the search at the offset.
 
   seek(fromOffset);
 
-  // This loop is the crux of the find method.  There are three cases that we
-  // want to account for:
-  //
-  // (1) The previously searched buffer contained a partial match of the search
-  // pattern and we want to see if the next one starts with the remainder of
-  // that pattern.
-  //
-  // (2) The search pattern is wholly contained within the current buffer.
-  //
-  // (3) The current buffer ends with a partial match of the pattern.  We will
-  // note this for use in the next iteration, where we will check for the rest
-  // of the pattern.
-  //
-  // All three of these are done in two steps.  First we check for the pattern
-  // and do things appropriately if a match (or partial match) is found.  We
-  // then check for "before".  The order is important because it gives priority
-  // to "real" matches.
-
-  for(auto buffer = readBlock(bufferSize()); !buffer.isEmpty(); buffer = readBlock(bufferSize())) {
-
-    // (1) previous partial match
-
-    if(previousPartialMatch >= 0 && static_cast<int>(bufferSize()) > previousPartialMatch) {
-      if(const int patternOffset = bufferSize() - previousPartialMatch;
-         buffer.containsAt(pattern, 0, patternOffset)) {
-        seek(originalPosition);
-        return bufferOffset - bufferSize() + previousPartialMatch;
-      }
-    }
+  // A match of the pattern is only returned if it starts before the first
+  // match of "before", a "real" match takes priority if both start at the same
+  // position.  Comparing the positions makes the result independent of the
+  // block size.  If a block does not contain any of the patterns, the next
+  // block is read with a larger size (up to a maximum), so that a missed
+  // search does not end up in many small reads.
 
-    if(!before.isEmpty() && beforePreviousPartialMatch >= 0 && static_cast<int>(bufferSize()) > beforePreviousPartialMatch) {
-      if(const int beforeOffset = bufferSize() - beforePreviousPartialMatch;
-         buffer.containsAt(before, 0, beforeOffset)) {
-        seek(originalPosition);
-        return -1;
-      }
+  for(auto block = readBlock(blockSize); !block.isEmpty(); block = readBlock(blockSize)) {
+
+    if(const unsigned int kept = std::min(window.size(), overlap); kept == 0) {
+      windowOffset += window.size();
+      window = block;
+    }
+    else {
+      windowOffset += window.size() - kept;
+      ::memmove(window.data(), window.data() + window.size() - kept, kept);
+      window.resize(kept + block.size());
+      ::memcpy(window.data() + kept, block.data(), block.size());
     }
 
-    // (2) pattern contained in current buffer
+    const int location = window.find(pattern);
+    const int beforeLocation = !before.isEmpty() ? window.find(before) : -1;
 
-    long location = buffer.find(pattern);
-    if(location >= 0) {
+    if(location >= 0 && (beforeLocation < 0 || location <= beforeLocation)) {
       seek(originalPosition);
-      return bufferOffset + location;
+      return windowOffset + location;
     }
 
-    if(!before.isEmpty() && buffer.find(before) >= 0) {
+    if(beforeLocation >= 0) {
       seek(originalPosition);
       return -1;
     }
 
-    // (3) partial match
-
-    previousPartialMatch = buffer.endsWithPartialMatch(pattern);
-
-    if(!before.isEmpty())
-      beforePreviousPartialMatch = buffer.endsWithPartialMatch(before);
-
-    bufferOffset += bufferSize();
+    blockSize = d->nextSearchBlockSize(blockSize);
   }
 
   // Since we hit the end of the file, reset the status before continuing.
@@ -226,66 +251,73 @@ offset_t File::find(const ByteVector &pattern, offset_t fromOffset, const ByteVe
 
 offset_t File::rfind(const ByteVector &pattern, offset_t fromOffset, const ByteVector &before)
 {
-  if(!d->stream || pattern.size() > bufferSize())
+  if(!d->stream || pattern.isEmpty())
       return -1;
 
-  // The position in the file that the current buffer starts at.
+  // This works like find(), just backwards: the search window consists of the
+  // current block followed by the start of the previously read block, which
+  // comes after it in the file.  Keeping the first n - 1 bytes of the previous
+  // block makes sure that matches which cross the block boundary are found,
+  // and no byte of the file is read more than once.
 
-  ByteVector buffer;
+  const unsigned int overlap = std::max(pattern.size(), before.size()) - 1;
 
-  // These variables are used to keep track of a partial match that happens at
-  // the end of a buffer.
+  ByteVector window;
 
-  /*
-  int previousPartialMatch = -1;
-  int beforePreviousPartialMatch = -1;
-  */
+  unsigned int blockSize = d->initialSearchBlockSize;
 
   // Save the location of the current read pointer.  We will restore the
   // position using seek() before all returns.
 
-  offset_t originalPosition = tell();
+  const offset_t originalPosition = tell();
 
-  // Start the search at the offset.
+  // Matches starting at fromOffset are included, so the first block ends
+  // after the pattern starting there.
 
-  if(fromOffset == 0)
-    fromOffset = length();
+  const offset_t fileLength = length();
+  if(fromOffset == 0 || fromOffset > fileLength)
+    fromOffset = fileLength;
 
-  offset_t bufferLength = bufferSize();
-  offset_t bufferOffset = fromOffset + pattern.size();
+  offset_t blockEnd = std::min<offset_t>(fromOffset + pattern.size(), fileLength);
 
-  // See the notes in find() for an explanation of this algorithm.
+  while(blockEnd > 0) {
+    const offset_t blockOffset = std::max<offset_t>(blockEnd - blockSize, 0);
 
-  while(true) {
+    seek(blockOffset);
+    const ByteVector block = readBlock(static_cast<size_t>(blockEnd - blockOffset));
+    if(block.isEmpty())
+      break;
 
-    if(bufferOffset > bufferLength) {
-      bufferOffset -= bufferLength;
+    if(const unsigned int kept = std::min(window.size(), overlap); kept == 0) {
+      window = block;
     }
     else {
-      bufferLength = bufferOffset;
-      bufferOffset = 0;
+      const unsigned int windowSize = block.size() + kept;
+      if(windowSize > window.size())
+        window.resize(windowSize);
+      ::memmove(window.data() + block.size(), window.data(), kept);
+      ::memcpy(window.data(), block.data(), block.size());
+      window.resize(windowSize);
     }
-    seek(bufferOffset);
-
-    buffer = readBlock(bufferLength);
-    if(buffer.isEmpty())
-      break;
 
-    // TODO: (1) previous partial match
+    // A match of the pattern is only returned if it starts after the last
+    // match of "before", see find().
 
-    // (2) pattern contained in current buffer
+    const int location = window.rfind(pattern);
+    const int beforeLocation = !before.isEmpty() ? window.rfind(before) : -1;
 
-    if(const long location = buffer.rfind(pattern); location >= 0) {
+    if(location >= 0 && location >= beforeLocation) {
       seek(originalPosition);
-      return bufferOffset + location;
+      return blockOffset + location;
     }
 
-    if(!before.isEmpty() && buffer.find(before) >= 0) {
+    if(beforeLocation >= 0) {
       seek(originalPosition);
       return -1;
     }
 
-    // TODO: (3) partial match
+    blockEnd = blockOffset;
+    blockSize = d->nextSearchBlockSize(blockSize);
   }
 
   // Since we hit the end of the file, reset the status before continuing.
@@ -297,6 +329,19 @@ offset_t File::rfind(const ByteVector &pattern, offset_t fromOffset, const ByteV
   return -1;
 }
 
+void File::setSearchBlockSize(unsigned int initialSize, unsigned int maximumSize)
+{
+  d->initialSearchBlockSize = std::max(initialSize, 1U);
+  d->maximumSearchBlockSize = std::max(maximumSize, d->initialSearchBlockSize);
+}
+
+void File::setDefaultSearchBlockSize(unsigned int initialSize, unsigned int maximumSize) // static
+{
+  initialSize = std::max(initialSize, 1U);
+  defaultInitialSearchBlockSize = initialSize;
+  defaultMaximumSearchBlockSize = std::max(maximumSize, initialSize);
+}
+
 void File::insert(const ByteVector &data, offset_t start, size_t replace)
 {
   d->stream->insert(data, start, replace);
@@ -317,6 +362,11 @@ bool File::isOpen() const
   return d->stream->isOpen();
 }
 
+bool File::supportsConcurrentReads() const
+{
+  return d->stream->supportsConcurrentReads();
+}
+
 bool File::isValid() const
 {
   return isOpen() && d->valid;
@@ -347,6 +397,37 @@ offset_t File::length()
   return d->stream->length();
 }
 
+void File::setSaveStrategy(SaveStrategy strategy)
+{
+  d->saveStrategy = strategy;
+}
+
+File::SaveStrategy File::saveStrategy() const
+{
+  return d->saveStrategy;
+}
+
+File::PayloadStyle File::payloadStyle() const
+{
+  return d->payloadStyle;
+}
+
+std::function<ByteVector()> File::deferredReadBlock(offset_t offset, size_t length)
+{
+  if(!d->self)
+    d->self = std::make_shared<File *>(this);
+
+  return [file = std::weak_ptr<File *>(d->self), offset, length] {
+    if(const auto self = file.lock()) {
+      std::lock_guard<std::mutex> lock((*self)->d->deferredReadMutex);
+      return (*self)->readBlockAt(offset, length);
+    }
+
+    debug("File::deferredReadBlock() -- The file has been destroyed.");
+    return ByteVector();
+  };
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // protected members
 ////////////////////////////////////////////////////////////////////////////////
@@ -360,3 +441,51 @@ void File::setValid(bool valid)
 {
   d->valid = valid;
 }
+
+void File::setPayloadStyle(PayloadStyle style)
+{
+  d->payloadStyle = style;
+}
+
+bool File::saveWithStrategy(const std::function<bool()> &save)
+{
+  // Nested calls and streams other than files are changed in place.
+
+  auto fileStream = dynamic_cast<FileStream *>(d->stream);
+  if(d->saveStrategy != Rewrite || !RewriteStream::canRewrite(fileStream)) {
+    const bool saved = save();
+
+    // A failed write may have left the file damaged, e.g. with zeros where
+    // the data before an inserted range was.
+
+    if(fileStream && fileStream->hasWriteError()) {
+      debug("File::saveWithStrategy() -- Couldn't write the file.");
+      setValid(false);
+      return false;
+    }
+    return saved;
+  }
+
+  // The layout which save() records in memory describes the rewritten file.
+  // If the original file is kept, it no longer matches, and saving again
+  // would write to the wrong offsets.
+
+  if(!isValid()) {
+    debug("File::saveWithStrategy() -- Trying to save invalid file.");
+    return false;
+  }
+
+  RewriteStream rewriteStream(fileStream);
+
+  d->stream = &rewriteStream;
+  const bool saved = save();
+  d->stream = fileStream;
+
+  if(!saved || !rewriteStream.commit()) {
+    debug("File::saveWithStrategy() -- The file was not replaced and has to be reopened.");
+    setValid(false);
+    return false;
+  }
+
+  return true;
+}
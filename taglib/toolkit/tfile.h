@@ -26,6 +26,8 @@
 #ifndef TAGLIB_FILE_H
 #define TAGLIB_FILE_H
 
+#include <functional>
+
 #include "tbytevector.h"
 #include "tiostream.h"
 #include "taglib_export.h"
@@ -79,6 +81,28 @@ namespace TagLib {
       DoNotDuplicate //!< Do not synchronize values between different tag types
     };
 
+    /*!
+     * Specifies how save() writes the changes to the file.
+     */
+    enum SaveStrategy {
+      //! Change the file in place, moving its contents if the tags change in size
+      InPlace,
+      //! Write the changed file to a temporary file, which then replaces it
+      Rewrite
+    };
+
+    /*!
+     * Specifies when large binary payloads of the tags, e.g. pictures, are
+     * read from the file.
+     */
+    enum PayloadStyle {
+      //! Read the payloads when the file is opened
+      ReadPayloads,
+      //! Only record where the payloads are when the file is opened and read
+      //! them on first access
+      DeferPayloads
+    };
+
     /*!
      * Destroys this File instance.
      */
@@ -179,6 +203,12 @@ namespace TagLib {
      */
     ByteVector readBlock(size_t length);
 
+    /*!
+     * Reads a block of size \a length at \a offset.  The position of the get
+     * pointer after this call is unspecified, see IOStream::readBlockAt().
+     */
+    ByteVector readBlockAt(offset_t offset, size_t length);
+
     /*!
      * Attempts to write the block \a data at the current get pointer.  If the
      * file is currently only opened read only -- i.e. readOnly() returns \c true --
@@ -199,8 +229,8 @@ namespace TagLib {
      * Searching starts at \a fromOffset, which defaults to the beginning of the
      * file.
      *
-     * \note This has the practical limitation that \a pattern can not be longer
-     * than the buffer size used by readBlock().  Currently this is 1024 bytes.
+     * The file is read in blocks which grow after each miss, see
+     * setSearchBlockSize().
      */
     offset_t find(const ByteVector &pattern,
               offset_t fromOffset = 0,
@@ -215,13 +245,34 @@ namespace TagLib {
      * Searching starts at \a fromOffset and proceeds from the that point to the
      * beginning of the file and defaults to the end of the file.
      *
-     * \note This has the practical limitation that \a pattern can not be longer
-     * than the buffer size used by readBlock().  Currently this is 1024 bytes.
+     * The file is read in blocks which grow after each miss, see
+     * setSearchBlockSize().  No byte of the file is read more than once.
      */
     offset_t rfind(const ByteVector &pattern,
                offset_t fromOffset = 0,
                const ByteVector &before = ByteVector());
 
+    /*!
+     * Sets the size of the blocks which are read by find() and rfind().
+     *
+     * The first block of a search has \a initialSize bytes.  Each block which
+     * does not contain the pattern doubles the size of the next one, until
+     * \a maximumSize is reached, so that a search through a large part of the
+     * file results in a few large reads instead of many small ones.  Pass the
+     * same value for both sizes to read blocks of a fixed size.
+     *
+     * \see setDefaultSearchBlockSize()
+     */
+    void setSearchBlockSize(unsigned int initialSize, unsigned int maximumSize);
+
+    /*!
+     * Sets the search block sizes used by files which are created after this
+     * call.  The defaults are 1024 bytes initially and 64 KiB at most.
+     *
+     * \see setSearchBlockSize()
+     */
+    static void setDefaultSearchBlockSize(unsigned int initialSize, unsigned int maximumSize);
+
     /*!
      * Insert \a data at position \a start in the file overwriting \a replace
      * bytes of the original content.
@@ -251,6 +302,12 @@ namespace TagLib {
      */
     bool isOpen() const;
 
+    /*!
+     * Returns \c true if readBlockAt() may be called from several threads at
+     * the same time, see IOStream::supportsConcurrentReads().
+     */
+    bool supportsConcurrentReads() const;
+
     /*!
      * Returns \c true if the file is open and readable.
      */
@@ -279,6 +336,46 @@ namespace TagLib {
      */
     offset_t length();
 
+    /*!
+     * Sets how save() writes the changes to the file.  With Rewrite, the
+     * changes are collected in memory and the file is replaced by a new file
+     * with the changed contents, which is written next to it.  The file is
+     * thus never left partially written.  The unchanged parts are copied with
+     * copy_file_range() where available, which is cheap on file systems that
+     * share the copied blocks.
+     *
+     * Rewrite needs a file which was opened by name or with a FileStream and
+     * is supported by MPEG, FLAC, MP4, Ogg, WAV and AIFF files.  Other files
+     * are always changed in place.  The default is InPlace.
+     */
+    void setSaveStrategy(SaveStrategy strategy);
+
+    /*!
+     * Returns how save() writes the changes to the file.
+     *
+     * \see setSaveStrategy()
+     */
+    SaveStrategy saveStrategy() const;
+
+    /*!
+     * Returns when large binary payloads of the tags are read.  With
+     * DeferPayloads, the file must not be changed other than by save() while
+     * payloads are not yet read.  This is supported by MPEG and FLAC files for
+     * pictures and the payloads of ID3v2 GEOB and PRIV frames.  Other files
+     * always read the payloads when they are opened.  The const accessors of
+     * deferred payloads may be called from several threads at once.
+     */
+    PayloadStyle payloadStyle() const;
+
+    /*!
+     * Returns a function which reads \a length bytes at \a offset when it is
+     * called.  This is used to read deferred payloads.  If the file has been
+     * destroyed in the meantime, the function returns an empty ByteVector.
+     *
+     * \see payloadStyle()
+     */
+    std::function<ByteVector()> deferredReadBlock(offset_t offset, size_t length);
+
   protected:
     /*!
      * Construct a File object and open the \a fileName.  \a fileName should be a
@@ -317,6 +414,27 @@ namespace TagLib {
      */
     static unsigned int bufferSize();
 
+    /*!
+     * Calls \a save, which writes the changes to the file, according to
+     * saveStrategy().  With Rewrite, the file is only replaced if \a save
+     * returns \c true and left untouched otherwise.  Returns \c false if
+     * \a save fails or the file could not be replaced.  In that case the
+     * file is marked as invalid, because the layout recorded by \a save does
+     * not match the untouched file, and has to be opened again.  If the
+     * file is changed in place and a write to it fails, \c false is
+     * returned and the file is marked as invalid, too, see
+     * FileStream::hasWriteError().
+     */
+    bool saveWithStrategy(const std::function<bool()> &save);
+
+    /*!
+     * Sets when large binary payloads are read.  This has to be called by the
+     * constructors of subclasses before the tags are read.
+     *
+     * \see payloadStyle()
+     */
+    void setPayloadStyle(PayloadStyle style);
+
   private:
     class FilePrivate;
     TAGLIB_MSVC_SUPPRESS_WARNING_NEEDS_TO_HAVE_DLL_INTERFACE
@@ -25,11 +25,21 @@
 
 #include "tfilestream.h"
 
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <algorithm>
+
 #ifdef _WIN32
 # include <windows.h>
 #else
+# include <cerrno>
 # include <climits>
 # include <cstdio>
+# include <cstdlib>
+# include <fcntl.h>
+# include <sys/stat.h>
 # include <unistd.h>
 #endif
 
@@ -101,6 +111,30 @@ namespace
     return 0;
   }
 
+  size_t readFileAt(FileHandle file, char *data, size_t length, offset_t offset)
+  {
+    OVERLAPPED overlapped = {};
+    overlapped.Offset     = static_cast<DWORD>(offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+    DWORD count;
+    if(ReadFile(file, data, static_cast<DWORD>(length), &count, &overlapped))
+      return static_cast<size_t>(count);
+    return 0;
+  }
+
+  size_t writeFileAt(FileHandle file, const char *data, size_t length, offset_t offset)
+  {
+    OVERLAPPED overlapped = {};
+    overlapped.Offset     = static_cast<DWORD>(offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+    DWORD count;
+    if(WriteFile(file, data, static_cast<DWORD>(length), &count, &overlapped))
+      return static_cast<size_t>(count);
+    return 0;
+  }
+
 #else   // _WIN32
 
   struct FileNameHandle : public std::string
@@ -138,7 +172,274 @@ namespace
     return fwrite(buffer.data(), sizeof(char), buffer.size(), file);
   }
 
+  // The positional functions bypass the stdio buffer.  Before they write,
+  // it has to be flushed, which also drops the data read ahead into it,
+  // see FileStreamPrivate::flush().
+
+  size_t readFileAt(FileHandle file, char *data, size_t length, offset_t offset)
+  {
+    const int fileDescriptor = fileno(file);
+
+    size_t count = 0;
+    while(count < length) {
+      const ssize_t result = pread(fileDescriptor, data + count, length - count,
+                                   static_cast<off_t>(offset + count));
+      if(result > 0)
+        count += static_cast<size_t>(result);
+      else if(result < 0 && errno == EINTR)
+        continue;
+      else
+        break;
+    }
+
+    return count;
+  }
+
+  size_t writeFileAt(FileHandle file, const char *data, size_t length, offset_t offset)
+  {
+    const int fileDescriptor = fileno(file);
+
+    size_t count = 0;
+    while(count < length) {
+      const ssize_t result = pwrite(fileDescriptor, data + count, length - count,
+                                    static_cast<off_t>(offset + count));
+      if(result > 0)
+        count += static_cast<size_t>(result);
+      else if(result < 0 && errno == EINTR)
+        continue;
+      else
+        break;
+    }
+
+    return count;
+  }
+
+  // A rename() is only durable once the directory containing the file has
+  // been synchronized as well.
+
+  bool syncDirectory(const std::string &path)
+  {
+    const std::string::size_type slash = path.rfind('/');
+    const std::string directory = slash == std::string::npos ? std::string(".")
+                                : slash == 0 ? std::string("/")
+                                : path.substr(0, slash);
+#ifdef O_DIRECTORY
+    const int fileDescriptor = open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+#else
+    const int fileDescriptor = open(directory.c_str(), O_RDONLY);
+#endif
+    if(fileDescriptor < 0)
+      return false;
+
+    const bool synced = fsync(fileDescriptor) == 0;
+    close(fileDescriptor);
+    return synced;
+  }
+
 #endif  // _WIN32
+
+  // Data is moved inside the file in chunks of this size, which start at
+  // multiples of it in the source.
+
+  constexpr offset_t MoveChunkSize = 1024 * 1024;
+
+  bool moveFileDataThroughBuffer(FileHandle file, offset_t from, offset_t to, offset_t length)
+  {
+    ByteVector buffer(static_cast<unsigned int>(std::min(length, MoveChunkSize)));
+
+    offset_t done = 0;
+    while(done < length) {
+      offset_t chunkLength;
+      offset_t position;
+
+      if(to > from) {
+        // Moving towards the end of the file, start with the last chunk, so
+        // that nothing is overwritten before it has been read.
+
+        chunkLength = (from + length - done) % MoveChunkSize;
+        if(chunkLength == 0)
+          chunkLength = MoveChunkSize;
+        chunkLength = std::min(chunkLength, length - done);
+        position = length - done - chunkLength;
+      }
+      else {
+        chunkLength = std::min(MoveChunkSize - (from + done) % MoveChunkSize, length - done);
+        position = done;
+      }
+
+      const auto size = static_cast<size_t>(chunkLength);
+      if(readFileAt(file, buffer.data(), size, from + position) != size ||
+         writeFileAt(file, buffer.data(), size, to + position) != size) {
+        return false;
+      }
+
+      done += chunkLength;
+    }
+
+    return true;
+  }
+
+#ifdef HAVE_COPY_FILE_RANGE
+
+  // Only moves by at least this distance are done with copy_file_range(),
+  // since its chunks must not overlap and thus can not be larger.
+
+  constexpr offset_t MinimumCopyDistance = 64 * 1024;
+  constexpr offset_t MaximumCopyChunkSize = 16 * 1024 * 1024;
+
+  // Lets the kernel copy the data, so that it does not pass through user
+  // space and may even be shared on file systems which support that.
+  // Returns the number of bytes moved, which is less than length if the file
+  // system does not support it.  The remaining bytes are still in place.
+
+  offset_t copyFileData(FileHandle file, offset_t from, offset_t to, offset_t length)
+  {
+    const int fileDescriptor = fileno(file);
+    const offset_t chunkSize =
+      std::min(to > from ? to - from : from - to, MaximumCopyChunkSize);
+
+    offset_t done = 0;
+    while(done < length) {
+      const offset_t chunkLength = std::min(chunkSize, length - done);
+      const offset_t position = to > from ? length - done - chunkLength : done;
+
+      loff_t in = from + position;
+      loff_t out = to + position;
+      offset_t copied = 0;
+      while(copied < chunkLength) {
+        const ssize_t result = copy_file_range(
+          fileDescriptor, &in, fileDescriptor, &out,
+          static_cast<size_t>(chunkLength - copied), 0);
+        if(result > 0)
+          copied += result;
+        else if(result < 0 && errno == EINTR)
+          continue;
+        else
+          return done;
+      }
+
+      done += chunkLength;
+    }
+
+    return done;
+  }
+
+#endif
+
+  bool moveFileData(FileHandle file, offset_t from, offset_t to, offset_t length)
+  {
+    if(from == to || length <= 0)
+      return true;
+
+#ifdef HAVE_COPY_FILE_RANGE
+
+    if((to > from ? to - from : from - to) >= MinimumCopyDistance) {
+      const offset_t done = copyFileData(file, from, to, length);
+      if(done == length)
+        return true;
+
+      // Continue with the part which has not been copied.
+
+      if(to < from) {
+        from += done;
+        to += done;
+      }
+      length -= done;
+    }
+
+#endif
+
+    return moveFileDataThroughBuffer(file, from, to, length);
+  }
+
+#ifdef HAVE_FALLOCATE_RANGE
+
+  // These shift the extents of the file instead of its data, which is only
+  // supported by some file systems (e.g. ext4 and XFS) and only for whole
+  // blocks.  The bytes between the block boundary before offset and offset
+  // are shifted, too, and are written back afterwards.
+
+  // The outcome of shifting the extents of a file.
+
+  enum class RangeResult { Unsupported, Shifted, Damaged };
+
+  offset_t fileSystemBlockSize(FileHandle file)
+  {
+    struct stat st;
+    if(fstat(fileno(file), &st) != 0)
+      return 0;
+    return st.st_blksize;
+  }
+
+  RangeResult insertFileRange(FileHandle file, offset_t offset, offset_t length,
+                              offset_t fileLength)
+  {
+    const offset_t blockSize = fileSystemBlockSize(file);
+    if(blockSize <= 0 || length % blockSize != 0)
+      return RangeResult::Unsupported;
+
+    const offset_t blockOffset = offset - offset % blockSize;
+    if(blockOffset >= fileLength)
+      return RangeResult::Unsupported;
+
+    ByteVector head(static_cast<unsigned int>(offset - blockOffset));
+    if(readFileAt(file, head.data(), head.size(), blockOffset) != head.size())
+      return RangeResult::Unsupported;
+
+    if(fallocate(fileno(file), FALLOC_FL_INSERT_RANGE, blockOffset, length) != 0)
+      return RangeResult::Unsupported;
+
+    if(writeFileAt(file, head.data(), head.size(), blockOffset) != head.size()) {
+      debug("FileStream::insert() -- Couldn't write back the data before the inserted range.");
+      return RangeResult::Damaged;
+    }
+
+    return RangeResult::Shifted;
+  }
+
+  RangeResult collapseFileRange(FileHandle file, offset_t offset, offset_t length,
+                                offset_t fileLength)
+  {
+    const offset_t blockSize = fileSystemBlockSize(file);
+    if(blockSize <= 0 || length % blockSize != 0)
+      return RangeResult::Unsupported;
+
+    // The collapsed range must not reach the end of the file.
+
+    const offset_t blockOffset = offset - offset % blockSize;
+    if(blockOffset + length >= fileLength)
+      return RangeResult::Unsupported;
+
+    ByteVector head(static_cast<unsigned int>(offset - blockOffset));
+    if(readFileAt(file, head.data(), head.size(), blockOffset) != head.size())
+      return RangeResult::Unsupported;
+
+    if(fallocate(fileno(file), FALLOC_FL_COLLAPSE_RANGE, blockOffset, length) != 0)
+      return RangeResult::Unsupported;
+
+    if(writeFileAt(file, head.data(), head.size(), blockOffset) != head.size()) {
+      debug("FileStream::removeBlock() -- Couldn't write back the data before the removed range.");
+      return RangeResult::Damaged;
+    }
+
+    return RangeResult::Shifted;
+  }
+
+#else
+
+  enum class RangeResult { Unsupported, Shifted, Damaged };
+
+  RangeResult insertFileRange(FileHandle, offset_t, offset_t, offset_t)
+  {
+    return RangeResult::Unsupported;
+  }
+
+  RangeResult collapseFileRange(FileHandle, offset_t, offset_t, offset_t)
+  {
+    return RangeResult::Unsupported;
+  }
+
+#endif
 }  // namespace
 
 class FileStream::FileStreamPrivate
@@ -152,6 +453,32 @@ public:
   FileHandle file { InvalidFileHandle };
   FileNameHandle name;
   bool readOnly { true };
+  bool unflushedWrites { false };
+  bool writeError { false };
+
+  // Writes the stdio buffer to the file before it is read directly.
+
+  void flushWrites()
+  {
+#ifndef _WIN32
+    if(unflushedWrites) {
+      fflush(file);
+      unflushedWrites = false;
+    }
+#endif
+  }
+
+  // Writes the stdio buffer to the file and drops the data which was read
+  // ahead into it, before the file is changed directly.  The data would be
+  // stale afterwards, and not every libc drops it on fseek().
+
+  void flush()
+  {
+#ifndef _WIN32
+    fflush(file);
+    unflushedWrites = false;
+#endif
+  }
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -244,7 +571,11 @@ void FileStream::writeBlock(const ByteVector &data)
     return;
   }
 
-  writeFile(d->file, data);
+  if(writeFile(d->file, data) != data.size()) {
+    debug("FileStream::writeBlock() -- Couldn't write the data.");
+    d->writeError = true;
+  }
+  d->unflushedWrites = true;
 }
 
 void FileStream::insert(const ByteVector &data, offset_t start, size_t replace)
@@ -271,61 +602,28 @@ void FileStream::insert(const ByteVector &data, offset_t start, size_t replace)
     return;
   }
 
-  // Woohoo!  Faster (about 20%) than id3lib at last.  I had to get hardcore
-  // and avoid TagLib's high level API for rendering just copying parts of
-  // the file that don't contain tag data.
-  //
-  // Now I'll explain the steps in this ugliness:
-
-  // First, make sure that we're working with a buffer that is longer than
-  // the *difference* in the tag sizes.  We want to avoid overwriting parts
-  // that aren't yet in memory, so this is necessary.
-
-  size_t bufferLength = bufferSize();
-
-  while(data.size() - replace > bufferLength)
-    bufferLength += bufferSize();
+  // Make room for the data by moving everything after the replaced part
+  // towards the end of the file, then write the data into the gap.
 
-  // Set where to start the reading and writing.
+  d->flush();
 
-  offset_t readPosition = start + replace;
-  offset_t writePosition = start;
+  const offset_t fileLength = FileStream::length();
+  const offset_t growth = data.size() - replace;
 
-  ByteVector buffer = data;
-  ByteVector aboutToOverwrite(static_cast<unsigned int>(bufferLength));
-
-  while(true) {
-    // Seek to the current read position and read the data that we're about
-    // to overwrite.  Appropriately increment the readPosition.
-
-    seek(readPosition);
-    const auto bytesRead = static_cast<unsigned int>(readFile(d->file, aboutToOverwrite));
-    aboutToOverwrite.resize(bytesRead);
-    readPosition += bufferLength;
-
-    // Check to see if we just read the last block.  We need to call clear()
-    // if we did so that the last write succeeds.
-
-    if(bytesRead < bufferLength)
-      clear();
-
-    // Seek to the write position and write our buffer.  Increment the
-    // writePosition.
-
-    seek(writePosition);
-    writeBlock(buffer);
-
-    // We hit the end of the file.
-
-    if(bytesRead == 0)
-      break;
-
-    writePosition += buffer.size();
-
-    // Make the current buffer the data that we read in the beginning.
-
-    buffer = aboutToOverwrite;
+  if(const offset_t tailOffset = start + replace; tailOffset < fileLength) {
+    const RangeResult result = insertFileRange(d->file, start, growth, fileLength);
+    if(result == RangeResult::Damaged) {
+      d->writeError = true;
+    }
+    else if(result == RangeResult::Unsupported &&
+            !moveFileData(d->file, tailOffset, tailOffset + growth, fileLength - tailOffset)) {
+      debug("FileStream::insert() -- Couldn't move the data after the inserted block.");
+      d->writeError = true;
+    }
   }
+
+  seek(start);
+  writeBlock(data);
 }
 
 void FileStream::removeBlock(offset_t start, size_t length)
@@ -335,34 +633,31 @@ void FileStream::removeBlock(offset_t start, size_t length)
     return;
   }
 
-  unsigned int bufferLength = bufferSize();
-
-  offset_t readPosition = start + length;
-  offset_t writePosition = start;
+  // Move everything after the removed block to its start and cut off the end.
 
-  ByteVector buffer(bufferLength);
+  d->flush();
 
-  unsigned int bytesRead = UINT_MAX;
-  while(bytesRead != 0) {
-    seek(readPosition);
-    bytesRead = static_cast<unsigned int>(readFile(d->file, buffer));
-    readPosition += bytesRead;
+  const offset_t fileLength = FileStream::length();
+  const offset_t tailOffset = start + length;
+  const offset_t tailLength = std::max<offset_t>(fileLength - tailOffset, 0);
 
-    // Check to see if we just read the last block.  We need to call clear()
-    // if we did so that the last write succeeds.
-
-    if(bytesRead < buffer.size()) {
-      clear();
-      buffer.resize(bytesRead);
+  if(tailLength > 0 && length > 0) {
+    if(const RangeResult result = collapseFileRange(d->file, start, length, fileLength);
+       result != RangeResult::Unsupported) {
+      if(result == RangeResult::Damaged)
+        d->writeError = true;
+      seek(start);
+      return;
     }
+  }
 
-    seek(writePosition);
-    writeFile(d->file, buffer);
-
-    writePosition += bytesRead;
+  if(!moveFileData(d->file, tailOffset, start, tailLength)) {
+    debug("FileStream::removeBlock() -- Couldn't move the data after the removed block.");
+    d->writeError = true;
   }
 
-  truncate(writePosition);
+  truncate(start + tailLength);
+  seek(start);
 }
 
 bool FileStream::readOnly() const
@@ -473,6 +768,16 @@ offset_t FileStream::length()
 
 #else
 
+  // Ask the file system, which is a single call and does not move the get
+  // pointer, so that the length can be read concurrently.  Streams which
+  // are not regular files, and files with writes in the stdio buffer fall
+  // back to seeking to the end.
+
+  if(struct stat st; !d->unflushedWrites &&
+     fstat(fileno(d->file), &st) == 0 && S_ISREG(st.st_mode)) {
+    return st.st_size;
+  }
+
   const offset_t curpos = tell();
 
   seek(0, End);
@@ -485,6 +790,69 @@ offset_t FileStream::length()
 #endif
 }
 
+ByteVector FileStream::readBlockAt(offset_t offset, size_t length)
+{
+  if(!isOpen()) {
+    debug("FileStream::readBlockAt() -- invalid file.");
+    return ByteVector();
+  }
+
+  if(length == 0 || offset < 0)
+    return ByteVector();
+
+#ifdef _WIN32
+
+  if(length > bufferSize()) {
+    const offset_t streamLength = FileStream::length();
+    if(offset >= streamLength)
+      return ByteVector();
+    length = static_cast<size_t>(std::min<offset_t>(length, streamLength - offset));
+  }
+
+  ByteVector buffer(static_cast<unsigned int>(length));
+
+  const size_t count = readFileAt(d->file, buffer.data(), length, offset);
+  buffer.resize(static_cast<unsigned int>(count));
+
+  return buffer;
+
+#else
+
+  // Data which is still in the stdio buffer has to reach the file before it
+  // can be read with pread().
+
+  d->flushWrites();
+
+  if(length > bufferSize()) {
+    if(struct stat st; fstat(fileno(d->file), &st) == 0) {
+      if(offset >= st.st_size)
+        return ByteVector();
+      length = static_cast<size_t>(std::min<offset_t>(length, st.st_size - offset));
+    }
+  }
+
+  ByteVector buffer(static_cast<unsigned int>(length));
+
+  const size_t count = readFileAt(d->file, buffer.data(), length, offset);
+  buffer.resize(static_cast<unsigned int>(count));
+
+  return buffer;
+
+#endif
+}
+
+bool FileStream::hasWriteError() const
+{
+  return d->writeError;
+}
+
+bool FileStream::supportsConcurrentReads() const
+{
+  // Without writes, pread() and fstat() are all that is done, see length().
+
+  return isOpen() && readOnly();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // protected members
 ////////////////////////////////////////////////////////////////////////////////
@@ -499,15 +867,84 @@ void FileStream::truncate(offset_t length)
 
   if(!SetEndOfFile(d->file)) {
     debug("FileStream::truncate() -- Failed to truncate the file.");
+    d->writeError = true;
   }
 
   seek(currentPos);
 
 #else
 
-  fflush(d->file);
-  if(const int error = ftruncate(fileno(d->file), length); error != 0)
+  d->flush();
+  if(const int error = ftruncate(fileno(d->file), length); error != 0) {
     debug("FileStream::truncate() -- Couldn't truncate the file.");
+    d->writeError = true;
+  }
+
+#endif
+}
+
+bool FileStream::replaceWith(FileName fileName)
+{
+  if(!isOpen() || readOnly()) {
+    debug("FileStream::replaceWith() -- invalid or read only file.");
+    return false;
+  }
+
+#ifdef _WIN32
+
+  // Files which are open can not be replaced on Windows.
+
+  closeFile(d->file);
+
+  const bool replaced = MoveFileExW(fileName.wstr().c_str(), d->name.wstr().c_str(),
+                                    MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+  if(!replaced)
+    debug("FileStream::replaceWith() -- Couldn't replace the file.");
+
+  d->file = openFile(d->name, false);
+  if(d->file == InvalidFileHandle) {
+    debug("FileStream::replaceWith() -- Couldn't reopen the file.");
+    return false;
+  }
+
+  if(replaced)
+    d->writeError = false;
+
+  return replaced;
+
+#else
+
+  d->flush();
+
+  // A symbolic link is kept, the file which it refers to is replaced.
+
+  char *const resolved = realpath(d->name, nullptr);
+  if(!resolved) {
+    debug("FileStream::replaceWith() -- Couldn't resolve the name of the file.");
+    return false;
+  }
+  const std::string target(resolved);
+  free(resolved);
+
+  if(rename(fileName, target.c_str()) != 0) {
+    debug("FileStream::replaceWith() -- Couldn't replace the file.");
+    return false;
+  }
+
+  if(!syncDirectory(target))
+    debug("FileStream::replaceWith() -- Couldn't synchronize the directory.");
+
+  const FileHandle file = openFile(d->name, false);
+  if(file == InvalidFileHandle) {
+    debug("FileStream::replaceWith() -- Couldn't reopen the file.");
+    return false;
+  }
+
+  closeFile(d->file);
+  d->file = file;
+  d->writeError = false;
+
+  return true;
 
 #endif
 }
@@ -139,6 +139,37 @@ namespace TagLib {
      */
     void truncate(offset_t length) override;
 
+    /*!
+     * Reads a block of size \a length at \a offset with a single pread() or
+     * ReadFile() call.  On POSIX systems the get pointer is not moved.
+     */
+    ByteVector readBlockAt(offset_t offset, size_t length) override;
+
+    /*!
+     * Returns \c true if the file was opened read only.
+     */
+    bool supportsConcurrentReads() const override;
+
+    /*!
+     * Returns \c true if writing to the file failed since it was opened or
+     * replaced.  A failed insert() or removeBlock() may leave the file
+     * damaged, so this is not reset by clear().
+     */
+    bool hasWriteError() const;
+
+    /*!
+     * Replaces the file by the file \a fileName, which is renamed to the name
+     * of this file, and reopens it.  On POSIX systems the file is replaced
+     * atomically, i.e. it has either its former or its new contents at any
+     * time.  If the name of this file is a symbolic link, the file which it
+     * refers to is replaced.  Returns \c false if the file could not be
+     * replaced.
+     *
+     * \note The file \a fileName should be in the same directory as the
+     * replaced file, so that it is on the same file system.
+     */
+    bool replaceWith(FileName fileName);
+
   protected:
 
     /*!
@@ -93,3 +93,22 @@ IOStream::~IOStream() = default;
 void IOStream::clear()
 {
 }
+
+ByteVector IOStream::readBlockAt(offset_t offset, size_t length)
+{
+  seek(offset);
+  return readBlock(length);
+}
+
+ByteVectorList IOStream::readBlocks(const List<Region> &regions)
+{
+  ByteVectorList blocks;
+  for(const auto &region : regions)
+    blocks.append(readBlockAt(region.offset, region.length));
+  return blocks;
+}
+
+bool IOStream::supportsConcurrentReads() const
+{
+  return false;
+}
@@ -27,6 +27,7 @@
 #define TAGLIB_IOSTREAM_H
 
 #include "tbytevector.h"
+#include "tbytevectorlist.h"
 #include "taglib_export.h"
 #include "taglib.h"
 
@@ -76,6 +77,14 @@ namespace TagLib {
       End
     };
 
+    /*!
+     * A block of the stream, see readBlocks().
+     */
+    struct Region {
+      offset_t offset;
+      size_t length;
+    };
+
     IOStream();
 
     /*!
@@ -165,6 +174,45 @@ namespace TagLib {
      */
     virtual void truncate(offset_t length) = 0;
 
+    /*!
+     * Reads a block of size \a length at \a offset.  This saves the seek()
+     * before readBlock() and is implemented with a single positional read by
+     * the streams which support it.
+     *
+     * The position of the get pointer after this call is unspecified, use
+     * seek() before calling readBlock() or writeBlock() again.
+     *
+     * The default implementation calls seek() and readBlock().
+     *
+     * \see supportsConcurrentReads()
+     */
+    virtual ByteVector readBlockAt(offset_t offset, size_t length);
+
+    /*!
+     * Reads the blocks described by \a regions and returns them in the same
+     * order.  Blocks are shorter than requested at the end of the stream.
+     * Streams for which each request is expensive, e.g. streams reading from
+     * network storage, should implement this with a single request.
+     *
+     * The default implementation calls readBlockAt() for each region.
+     *
+     * \see PrefetchIOStream
+     */
+    virtual ByteVectorList readBlocks(const List<Region> &regions);
+
+    /*!
+     * Returns \c true if readBlockAt() and length() may be called from several
+     * threads at the same time.  This holds as long as none of the methods
+     * which modify the stream is called concurrently.  The get pointer is still
+     * shared, so readBlock() and seek() must not be used concurrently.  Give
+     * each thread its own SharedReadStream instead.
+     *
+     * This is the case for a FileStream which was opened read only, a
+     * MappedFileStream and a ByteVectorStream.  The default implementation
+     * returns \c false.
+     */
+    virtual bool supportsConcurrentReads() const;
+
   private:
     class IOStreamPrivate;
     TAGLIB_MSVC_SUPPRESS_WARNING_NEEDS_TO_HAVE_DLL_INTERFACE
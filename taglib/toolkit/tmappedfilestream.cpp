@@ -0,0 +1,294 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include "tmappedfilestream.h"
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#ifdef _WIN32
+# include <windows.h>
+#elif defined(HAVE_MMAP)
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <string>
+
+#include "tstring.h"
+#include "tdebug.h"
+
+using namespace TagLib;
+
+namespace
+{
+  struct Mapping
+  {
+    const char *data { nullptr };
+    size_t size { 0 };
+    bool valid { false };
+  };
+
+#ifdef _WIN32
+
+  using FileNameHandle = FileName;
+
+  Mapping mapFile(const FileName &path)
+  {
+    Mapping mapping;
+
+#if !defined(PLATFORM_WINRT)
+    const HANDLE file = CreateFileW(path.wstr().c_str(), GENERIC_READ, FILE_SHARE_READ,
+                                    nullptr, OPEN_EXISTING, 0, nullptr);
+    if(file == INVALID_HANDLE_VALUE)
+      return mapping;
+
+    LARGE_INTEGER fileSize;
+    if(GetFileSizeEx(file, &fileSize) &&
+       static_cast<unsigned long long>(fileSize.QuadPart) <= static_cast<size_t>(-1)) {
+      mapping.size = static_cast<size_t>(fileSize.QuadPart);
+      if(mapping.size == 0) {
+        mapping.valid = true;
+      }
+      else if(const HANDLE fileMapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr)) {
+        mapping.data = static_cast<const char *>(MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0));
+        mapping.valid = mapping.data != nullptr;
+
+        // The view keeps the mapping object alive.
+        CloseHandle(fileMapping);
+      }
+    }
+
+    CloseHandle(file);
+#endif
+
+    return mapping;
+  }
+
+  void unmapFile(const Mapping &mapping)
+  {
+    if(mapping.data)
+      UnmapViewOfFile(mapping.data);
+  }
+
+#else   // _WIN32
+
+  struct FileNameHandle : public std::string
+  {
+    FileNameHandle(FileName name) : std::string(name) {}
+    operator FileName () const { return c_str(); }
+  };
+
+  Mapping mapFile([[maybe_unused]] const FileName &path)
+  {
+    Mapping mapping;
+
+#ifdef HAVE_MMAP
+    const int fd = open(path, O_RDONLY);
+    if(fd < 0)
+      return mapping;
+
+    if(struct stat st; fstat(fd, &st) == 0 && S_ISREG(st.st_mode) &&
+       static_cast<unsigned long long>(st.st_size) <= static_cast<size_t>(-1)) {
+      mapping.size = static_cast<size_t>(st.st_size);
+      if(mapping.size == 0) {
+        mapping.valid = true;
+      }
+      else {
+        void *data = mmap(nullptr, mapping.size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(data != MAP_FAILED) {
+          mapping.data = static_cast<const char *>(data);
+          mapping.valid = true;
+        }
+      }
+    }
+
+    // The mapping stays valid after the file descriptor is closed.
+    close(fd);
+#endif
+
+    return mapping;
+  }
+
+  void unmapFile([[maybe_unused]] const Mapping &mapping)
+  {
+#ifdef HAVE_MMAP
+    if(mapping.data)
+      munmap(const_cast<char *>(mapping.data), mapping.size);
+#endif
+  }
+
+#endif  // _WIN32
+}  // namespace
+
+class MappedFileStream::MappedFileStreamPrivate
+{
+public:
+  MappedFileStreamPrivate(const FileName &fileName) :
+    name(fileName),
+    mapping(mapFile(fileName))
+  {
+  }
+
+  ~MappedFileStreamPrivate()
+  {
+    unmapFile(mapping);
+  }
+
+  MappedFileStreamPrivate(const MappedFileStreamPrivate &) = delete;
+  MappedFileStreamPrivate &operator=(const MappedFileStreamPrivate &) = delete;
+
+  FileNameHandle name;
+  Mapping mapping;
+  offset_t position { 0 };
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+MappedFileStream::MappedFileStream(FileName fileName) :
+  d(std::make_unique<MappedFileStreamPrivate>(fileName))
+{
+  if(!d->mapping.valid)
+# ifdef _WIN32
+    debug("Could not map file " + fileName.toString());
+# else
+    debug("Could not map file " + String(static_cast<const char *>(d->name)));
+# endif
+}
+
+MappedFileStream::~MappedFileStream() = default;
+
+FileName MappedFileStream::name() const
+{
+  return d->name;
+}
+
+ByteVector MappedFileStream::readBlock(size_t length)
+{
+  if(!isOpen()) {
+    debug("MappedFileStream::readBlock() -- invalid file.");
+    return ByteVector();
+  }
+
+  ByteVector buffer = readBlockAt(d->position, length);
+  d->position += buffer.size();
+
+  return buffer;
+}
+
+ByteVector MappedFileStream::readBlockAt(offset_t offset, size_t length)
+{
+  if(!isOpen()) {
+    debug("MappedFileStream::readBlockAt() -- invalid file.");
+    return ByteVector();
+  }
+
+  const auto size = static_cast<offset_t>(d->mapping.size);
+  if(length == 0 || offset < 0 || offset >= size)
+    return ByteVector();
+
+  length = static_cast<size_t>(std::min<offset_t>(length, size - offset));
+
+  // The block is copied rather than returned with ByteVector::fromRawData().
+  // Tags keep the blocks they are parsed from, e.g. as picture data, and
+  // these usually outlive the stream, which unmaps the file when it is
+  // destroyed.  What the mapping saves are the system calls and the stdio
+  // buffering of each read.
+
+  return ByteVector(d->mapping.data + offset, static_cast<unsigned int>(length));
+}
+
+bool MappedFileStream::supportsConcurrentReads() const
+{
+  return true;
+}
+
+void MappedFileStream::writeBlock(const ByteVector &)
+{
+  debug("MappedFileStream::writeBlock() -- read only file.");
+}
+
+void MappedFileStream::insert(const ByteVector &, offset_t, size_t)
+{
+  debug("MappedFileStream::insert() -- read only file.");
+}
+
+void MappedFileStream::removeBlock(offset_t, size_t)
+{
+  debug("MappedFileStream::removeBlock() -- read only file.");
+}
+
+bool MappedFileStream::readOnly() const
+{
+  return true;
+}
+
+bool MappedFileStream::isOpen() const
+{
+  return d->mapping.valid;
+}
+
+void MappedFileStream::seek(offset_t offset, Position p)
+{
+  if(!isOpen()) {
+    debug("MappedFileStream::seek() -- invalid file.");
+    return;
+  }
+
+  switch(p) {
+  case Beginning:
+    d->position = offset;
+    break;
+  case Current:
+    d->position += offset;
+    break;
+  case End:
+    d->position = static_cast<offset_t>(d->mapping.size) + offset;
+    break;
+  default:
+    debug("MappedFileStream::seek() -- Invalid Position value.");
+    return;
+  }
+}
+
+offset_t MappedFileStream::tell() const
+{
+  return d->position;
+}
+
+offset_t MappedFileStream::length()
+{
+  return static_cast<offset_t>(d->mapping.size);
+}
+
+void MappedFileStream::truncate(offset_t)
+{
+  debug("MappedFileStream::truncate() -- read only file.");
+}
@@ -0,0 +1,153 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_MAPPEDFILESTREAM_H
+#define TAGLIB_MAPPEDFILESTREAM_H
+
+#include "tbytevector.h"
+#include "tiostream.h"
+#include "taglib_export.h"
+#include "taglib.h"
+
+namespace TagLib {
+
+  //! Read only I/O stream with data from a memory mapped file.
+
+  /*!
+   * This maps the whole file into memory and serves readBlock(), seek(),
+   * tell() and length() directly from the mapping, so that reading many
+   * small blocks does not cost a system call each.  The blocks which are
+   * returned are still copies, so they stay valid after the stream is
+   * destroyed.
+   *
+   * The stream is always read only, all write operations are ignored.  If
+   * the file can not be mapped (e.g. because it is not a regular file or the
+   * platform does not support memory mapped files), isOpen() returns
+   * \c false and FileStream should be used instead.
+   *
+   * FileRef never uses this stream on its own, it has to be passed to
+   * FileRef(IOStream *, bool, AudioProperties::ReadStyle).
+   *
+   * \warning If the file is truncated while it is mapped, reading the part
+   * beyond the new end raises SIGBUS on POSIX systems, which terminates the
+   * process.  Only use this stream for files which are not changed by
+   * others, and keep in mind that File::DeferPayloads reads from the stream
+   * long after the file was opened.
+   */
+
+  class TAGLIB_EXPORT MappedFileStream : public IOStream
+  {
+  public:
+    /*!
+     * Construct a MappedFileStream object and map the \a fileName.
+     * \a fileName should be a C-string in the local file system encoding.
+     */
+    MappedFileStream(FileName fileName);
+
+    /*!
+     * Destroys this MappedFileStream instance and unmaps the file.
+     */
+    ~MappedFileStream() override;
+
+    MappedFileStream(const MappedFileStream &) = delete;
+    MappedFileStream &operator=(const MappedFileStream &) = delete;
+
+    /*!
+     * Returns the file name in the local file system encoding.
+     */
+    FileName name() const override;
+
+    /*!
+     * Reads a block of size \a length at the current get pointer.
+     */
+    ByteVector readBlock(size_t length) override;
+
+    /*!
+     * Does nothing, the stream is read only.
+     */
+    void writeBlock(const ByteVector &data) override;
+
+    /*!
+     * Does nothing, the stream is read only.
+     */
+    void insert(const ByteVector &data, offset_t start = 0, size_t replace = 0) override;
+
+    /*!
+     * Does nothing, the stream is read only.
+     */
+    void removeBlock(offset_t start = 0, size_t length = 0) override;
+
+    /*!
+     * Returns \c true.
+     */
+    bool readOnly() const override;
+
+    /*!
+     * Returns \c true if the file could be mapped.
+     */
+    bool isOpen() const override;
+
+    /*!
+     * Move the I/O pointer to \a offset in the file from position \a p.  This
+     * defaults to seeking from the beginning of the file.
+     *
+     * \see Position
+     */
+    void seek(offset_t offset, Position p = Beginning) override;
+
+    /*!
+     * Returns the current offset within the file.
+     */
+    offset_t tell() const override;
+
+    /*!
+     * Returns the length of the file.
+     */
+    offset_t length() override;
+
+    /*!
+     * Does nothing, the stream is read only.
+     */
+    void truncate(offset_t length) override;
+
+    /*!
+     * Copies the block of size \a length at \a offset out of the mapping
+     * without moving the get pointer.
+     */
+    ByteVector readBlockAt(offset_t offset, size_t length) override;
+
+    /*!
+     * Returns \c true, the mapping can be read concurrently.
+     */
+    bool supportsConcurrentReads() const override;
+
+  private:
+    class MappedFileStreamPrivate;
+    TAGLIB_MSVC_SUPPRESS_WARNING_NEEDS_TO_HAVE_DLL_INTERFACE
+    std::unique_ptr<MappedFileStreamPrivate> d;
+  };
+
+}  // namespace TagLib
+
+#endif
@@ -0,0 +1,334 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#include "tprefetchiostream.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "tstring.h"
+#include "tdebug.h"
+
+using namespace TagLib;
+
+namespace
+{
+  struct Window
+  {
+    offset_t offset;
+    ByteVector data;
+
+    offset_t end() const
+    {
+      return offset + data.size();
+    }
+  };
+}  // namespace
+
+class PrefetchIOStream::PrefetchIOStreamPrivate
+{
+public:
+  PrefetchIOStreamPrivate(IOStream *stream) :
+    stream(stream),
+    position(stream->tell())
+  {
+  }
+
+  offset_t length()
+  {
+    if(cachedLength < 0)
+      cachedLength = stream->length();
+
+    return cachedLength;
+  }
+
+  void fetch(const List<Region> &regions)
+  {
+    std::vector<Region> resolved;
+    for(const auto &region : regions) {
+      offset_t offset = region.offset;
+      if(offset < 0)
+        offset = std::max<offset_t>(length() + offset, 0);
+      if(region.length > 0)
+        resolved.push_back({ offset, region.length });
+    }
+
+    std::sort(resolved.begin(), resolved.end(), [](const Region &a, const Region &b) {
+      return a.offset < b.offset;
+    });
+
+    List<Region> merged;
+    for(const auto &region : resolved) {
+      if(!merged.isEmpty()) {
+        Region &last = merged.back();
+        const offset_t lastEnd = last.offset + static_cast<offset_t>(last.length);
+        if(region.offset <= lastEnd) {
+          last.length = static_cast<size_t>(std::max<offset_t>(
+            lastEnd, region.offset + static_cast<offset_t>(region.length)) - last.offset);
+          continue;
+        }
+      }
+      merged.append(region);
+    }
+
+    if(merged.isEmpty())
+      return;
+
+    const ByteVectorList blocks = stream->readBlocks(merged);
+    auto block = blocks.begin();
+    for(const auto &region : merged) {
+      if(block == blocks.end())
+        break;
+
+      windows.push_back({ region.offset, *block });
+
+      // A short block shows where the stream ends, so that reads after it
+      // do not have to reach the other stream.
+
+      if(block->size() < region.length && cachedLength < 0)
+        cachedLength = windows.back().end();
+      ++block;
+    }
+
+    // The stream may have ended before the start of a region.
+
+    windows.erase(std::remove_if(windows.begin(), windows.end(), [](const Window &window) {
+      return window.data.isEmpty();
+    }), windows.end());
+  }
+
+  ByteVector read(offset_t offset, size_t count)
+  {
+    ByteVector result;
+    bool missed = false;
+
+    while(result.size() < count) {
+      const auto remaining = static_cast<unsigned int>(
+        std::min<size_t>(count - result.size(), std::numeric_limits<unsigned int>::max()));
+
+      // The first window which ends after the offset
+
+      const auto window = std::upper_bound(
+        windows.begin(), windows.end(), offset,
+        [](offset_t value, const Window &w) { return value < w.end(); });
+
+      if(window != windows.end() && window->offset <= offset) {
+        const auto begin = static_cast<unsigned int>(offset - window->offset);
+        const unsigned int size = std::min(window->data.size() - begin, remaining);
+
+        // Reads from a single window share its data.
+
+        if(result.isEmpty() && size == count) {
+          result = window->data.mid(begin, size);
+          break;
+        }
+
+        result.append(window->data.mid(begin, size));
+        offset += size;
+        continue;
+      }
+
+      if(cachedLength >= 0 && offset >= cachedLength)
+        break;
+
+      // Read the gap up to the next window from the other stream.
+
+      unsigned int size = remaining;
+      if(window != windows.end())
+        size = static_cast<unsigned int>(std::min<offset_t>(size, window->offset - offset));
+
+      const ByteVector data = stream->readBlockAt(offset, size);
+      missed = true;
+      result.append(data);
+      offset += data.size();
+
+      if(data.size() < size)
+        break;
+    }
+
+    if(missed)
+      ++misses;
+    else
+      ++hits;
+
+    return result;
+  }
+
+  // Drops the windows which overlap the given range, and the length of the
+  // stream, since it may change.
+
+  void invalidate(offset_t offset, offset_t rangeEnd)
+  {
+    windows.erase(std::remove_if(windows.begin(), windows.end(), [&](const Window &window) {
+      return window.offset < rangeEnd && offset < window.end();
+    }), windows.end());
+    cachedLength = -1;
+  }
+
+  IOStream *const stream;
+
+  // The fetched data, sorted by offset and not overlapping
+  std::vector<Window> windows;
+
+  offset_t position;
+  offset_t cachedLength { -1 };
+  unsigned long long hits { 0 };
+  unsigned long long misses { 0 };
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+PrefetchIOStream::PrefetchIOStream(IOStream *stream, unsigned int headSize,
+                                   unsigned int tailSize) :
+  d(std::make_unique<PrefetchIOStreamPrivate>(stream))
+{
+  List<Region> regions;
+  regions.append({ 0, headSize });
+  if(tailSize > 0)
+    regions.append({ -static_cast<offset_t>(tailSize), tailSize });
+  d->fetch(regions);
+}
+
+PrefetchIOStream::PrefetchIOStream(IOStream *stream, const List<Region> &regions) :
+  d(std::make_unique<PrefetchIOStreamPrivate>(stream))
+{
+  d->fetch(regions);
+}
+
+PrefetchIOStream::~PrefetchIOStream() = default;
+
+FileName PrefetchIOStream::name() const
+{
+  return d->stream->name();
+}
+
+ByteVector PrefetchIOStream::readBlock(size_t length)
+{
+  ByteVector buffer = d->read(d->position, length);
+  d->position += buffer.size();
+
+  return buffer;
+}
+
+void PrefetchIOStream::writeBlock(const ByteVector &data)
+{
+  d->invalidate(d->position, d->position + data.size());
+
+  d->stream->seek(d->position);
+  d->stream->writeBlock(data);
+  d->position = d->stream->tell();
+}
+
+void PrefetchIOStream::insert(const ByteVector &data, offset_t start, size_t replace)
+{
+  d->invalidate(start, std::numeric_limits<offset_t>::max());
+
+  d->stream->insert(data, start, replace);
+  d->position = d->stream->tell();
+}
+
+void PrefetchIOStream::removeBlock(offset_t start, size_t length)
+{
+  d->invalidate(start, std::numeric_limits<offset_t>::max());
+
+  d->stream->removeBlock(start, length);
+  d->position = d->stream->tell();
+}
+
+bool PrefetchIOStream::readOnly() const
+{
+  return d->stream->readOnly();
+}
+
+bool PrefetchIOStream::isOpen() const
+{
+  return d->stream->isOpen();
+}
+
+void PrefetchIOStream::seek(offset_t offset, Position p)
+{
+  switch(p) {
+  case Beginning:
+    d->position = offset;
+    break;
+  case Current:
+    d->position += offset;
+    break;
+  case End:
+    d->position = length() + offset;
+    break;
+  default:
+    debug("PrefetchIOStream::seek() -- Invalid Position value.");
+    return;
+  }
+
+  if(d->position < 0)
+    d->position = 0;
+}
+
+void PrefetchIOStream::clear()
+{
+  d->stream->clear();
+}
+
+offset_t PrefetchIOStream::tell() const
+{
+  return d->position;
+}
+
+offset_t PrefetchIOStream::length()
+{
+  return d->length();
+}
+
+void PrefetchIOStream::truncate(offset_t length)
+{
+  d->invalidate(length, std::numeric_limits<offset_t>::max());
+
+  d->stream->truncate(length);
+}
+
+ByteVector PrefetchIOStream::readBlockAt(offset_t offset, size_t length)
+{
+  return d->read(offset, length);
+}
+
+bool PrefetchIOStream::supportsConcurrentReads() const
+{
+  return false;
+}
+
+unsigned long long PrefetchIOStream::hits() const
+{
+  return d->hits;
+}
+
+unsigned long long PrefetchIOStream::misses() const
+{
+  return d->misses;
+}
@@ -0,0 +1,183 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#ifndef TAGLIB_PREFETCHIOSTREAM_H
+#define TAGLIB_PREFETCHIOSTREAM_H
+
+#include "tiostream.h"
+#include "taglib_export.h"
+
+namespace TagLib {
+
+  //! I/O stream which fetches the regions holding the tags in one request
+
+  /*!
+   * Most formats read their headers at the start of the file and look for
+   * tags like ID3v1 and APE at its end.  This stream reads such regions of
+   * another stream up front with a single call to IOStream::readBlocks(),
+   * and serves later reads from them.  Only the parts of a read which are
+   * outside of the regions reach the other stream.  This helps with streams
+   * for which each request has a high latency, e.g. streams reading from
+   * object storage, which should implement IOStream::readBlocks() with a
+   * single request:
+   *
+   * \code
+   * MyObjectStream stream(url);
+   * PrefetchIOStream prefetched(&stream);
+   * FileRef file(&prefetched);
+   * \endcode
+   *
+   * The fetched regions are dropped where the stream is changed through this
+   * stream, the other stream must not be changed otherwise.  The other stream
+   * is not owned and has to outlive this stream.
+   *
+   * \see CachedIOStream
+   */
+  class TAGLIB_EXPORT PrefetchIOStream : public IOStream
+  {
+  public:
+    /*!
+     * Constructs a stream which fetches the first \a headSize and the last
+     * \a tailSize bytes of \a stream, positioned at the current position of
+     * \a stream.
+     */
+    explicit PrefetchIOStream(IOStream *stream, unsigned int headSize = 65536,
+                              unsigned int tailSize = 65536);
+
+    /*!
+     * Constructs a stream which fetches \a regions of \a stream, positioned at
+     * the current position of \a stream.  Regions with a negative offset are
+     * relative to the end of the stream.  Overlapping and adjacent regions are
+     * merged.
+     */
+    PrefetchIOStream(IOStream *stream, const List<Region> &regions);
+
+    /*!
+     * Destroys this PrefetchIOStream instance.
+     */
+    ~PrefetchIOStream() override;
+
+    PrefetchIOStream(const PrefetchIOStream &) = delete;
+    PrefetchIOStream &operator=(const PrefetchIOStream &) = delete;
+
+    /*!
+     * Returns the name of the other stream.
+     */
+    FileName name() const override;
+
+    /*!
+     * Reads a block of size \a length at the current get pointer.
+     */
+    ByteVector readBlock(size_t length) override;
+
+    /*!
+     * Writes the block \a data at the current get pointer and drops the
+     * fetched data which it overlaps.
+     */
+    void writeBlock(const ByteVector &data) override;
+
+    /*!
+     * Inserts \a data at position \a start, overwriting \a replace bytes, and
+     * drops the fetched data after \a start.
+     */
+    void insert(const ByteVector &data, offset_t start = 0, size_t replace = 0) override;
+
+    /*!
+     * Removes \a length bytes at \a start and drops the fetched data after
+     * \a start.
+     */
+    void removeBlock(offset_t start = 0, size_t length = 0) override;
+
+    /*!
+     * Returns \c true if the other stream is read only.
+     */
+    bool readOnly() const override;
+
+    /*!
+     * Returns \c true if the other stream is open.
+     */
+    bool isOpen() const override;
+
+    /*!
+     * Move the I/O pointer to \a offset in the stream from position \a p.
+     * This does not touch the other stream.
+     *
+     * \see Position
+     */
+    void seek(offset_t offset, Position p = Beginning) override;
+
+    /*!
+     * Reset the end-of-file and error flags on the other stream.
+     */
+    void clear() override;
+
+    /*!
+     * Returns the current offset within the stream.
+     */
+    offset_t tell() const override;
+
+    /*!
+     * Returns the length of the other stream, which is cached until the
+     * stream is changed.
+     */
+    offset_t length() override;
+
+    /*!
+     * Truncates the stream to \a length and drops the fetched data after it.
+     */
+    void truncate(offset_t length) override;
+
+    /*!
+     * Reads a block of size \a length at \a offset.  The get pointer is not
+     * moved.
+     */
+    ByteVector readBlockAt(offset_t offset, size_t length) override;
+
+    /*!
+     * Returns \c false, the fetched data is not shared between threads.
+     */
+    bool supportsConcurrentReads() const override;
+
+    /*!
+     * Returns the number of reads which were served from the fetched data
+     * only.
+     */
+    unsigned long long hits() const;
+
+    /*!
+     * Returns the number of reads which had to read from the other stream,
+     * not counting the initial fetch.
+     */
+    unsigned long long misses() const;
+
+  private:
+    class PrefetchIOStreamPrivate;
+    TAGLIB_MSVC_SUPPRESS_WARNING_NEEDS_TO_HAVE_DLL_INTERFACE
+    std::unique_ptr<PrefetchIOStreamPrivate> d;
+  };
+
+}  // namespace TagLib
+
+#endif
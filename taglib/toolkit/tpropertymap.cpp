@@ -27,6 +27,8 @@
 
 #include <utility>
 
+#include "tserialization.h"
+
 using namespace TagLib;
 
 class PropertyMap::PropertyMapPrivate
@@ -169,6 +171,34 @@ String PropertyMap::toString() const
   return ret;
 }
 
+ByteVector PropertyMap::serialize() const
+{
+  ByteVector data;
+  Serialization::appendUInt(data, size());
+  for(const auto &[property, val] : *this) {
+    Serialization::appendString(data, property);
+    Serialization::appendStringList(data, val);
+  }
+  Serialization::appendStringList(data, d->unsupported);
+  return data;
+}
+
+PropertyMap PropertyMap::deserialize(const ByteVector &data, bool *ok) // static
+{
+  Serialization::Reader reader(data);
+  PropertyMap m;
+  for(unsigned int count = reader.readUInt(); count > 0 && reader.isValid(); --count) {
+    const String property = reader.readString();
+    m.SimplePropertyMap::insert(property, reader.readStringList());
+  }
+  m.d->unsupported = reader.readStringList();
+
+  const bool valid = reader.isValid() && reader.atEnd();
+  if(ok)
+    *ok = valid;
+  return valid ? m : PropertyMap();
+}
+
 void PropertyMap::removeEmpty()
 {
   PropertyMap m;
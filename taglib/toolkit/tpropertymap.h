@@ -281,6 +281,25 @@ namespace TagLib {
     TAGLIB_EXPORT
     String toString() const;
 
+    /*!
+     * Returns the map including its unsupportedData() in a compact binary
+     * format, which can be converted back with deserialize().  This is much
+     * faster and smaller than a textual representation, e.g. to store
+     * metadata in a cache or to pass it to another process.
+     *
+     * \see StringList::serialize(), Variant::serialize()
+     */
+    TAGLIB_EXPORT
+    ByteVector serialize() const;
+
+    /*!
+     * Returns the map stored in \a data by serialize().  If \a ok is passed,
+     * it is set to \c false and an empty map is returned if \a data is not a
+     * valid serialized map.
+     */
+    TAGLIB_EXPORT
+    static PropertyMap deserialize(const ByteVector &data, bool *ok = nullptr);
+
   private:
     class PropertyMapPrivate;
     std::unique_ptr<PropertyMapPrivate> d;
@@ -0,0 +1,544 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include "trewritestream.h"
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <cerrno>
+# include <cstdio>
+# include <cstdlib>
+# include <fcntl.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+#include "tfilestream.h"
+#include "tstring.h"
+#include "tdebug.h"
+
+using namespace TagLib;
+
+namespace
+{
+  // A range of the original file or, if offset is negative, new data.
+
+  struct Piece
+  {
+    offset_t offset;
+    offset_t length;
+    ByteVector data;
+  };
+
+  // Unchanged ranges which can not be copied by the system are copied in
+  // chunks of this size.
+
+  constexpr offset_t CopyChunkSize = 1024 * 1024;
+
+#ifdef _WIN32
+
+  using FileHandle = HANDLE;
+
+  const FileHandle InvalidFileHandle = INVALID_HANDLE_VALUE;
+
+  FileHandle createFile(const std::wstring &name)
+  {
+#if defined (PLATFORM_WINRT)
+    return CreateFile2(name.c_str(), GENERIC_WRITE, 0, CREATE_NEW, nullptr);
+#else
+    return CreateFileW(name.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_NEW,
+                       FILE_ATTRIBUTE_NORMAL, nullptr);
+#endif
+  }
+
+  bool writeFile(FileHandle file, const char *data, size_t length)
+  {
+    DWORD count;
+    return WriteFile(file, data, static_cast<DWORD>(length), &count, nullptr) &&
+           count == length;
+  }
+
+  bool syncFile(FileHandle file)
+  {
+    return FlushFileBuffers(file) != 0;
+  }
+
+  void closeFile(FileHandle file)
+  {
+    CloseHandle(file);
+  }
+
+  // A link would be replaced by a copy of the file, which the other names
+  // of the file would not refer to.
+
+  bool isSingleLink(const std::wstring &name)
+  {
+    const DWORD attributes = GetFileAttributesW(name.c_str());
+    if(attributes == INVALID_FILE_ATTRIBUTES || (attributes & FILE_ATTRIBUTE_REPARSE_POINT))
+      return false;
+
+#if defined (PLATFORM_WINRT)
+    return true;
+#else
+    const FileHandle file = CreateFileW(name.c_str(), 0,
+      FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+      FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(file == InvalidFileHandle)
+      return false;
+
+    BY_HANDLE_FILE_INFORMATION information;
+    const bool single = GetFileInformationByHandle(file, &information) &&
+                        information.nNumberOfLinks == 1;
+    CloseHandle(file);
+    return single;
+#endif
+  }
+
+#else
+
+  using FileHandle = int;
+
+  const FileHandle InvalidFileHandle = -1;
+
+  bool writeFile(FileHandle file, const char *data, size_t length)
+  {
+    while(length > 0) {
+      const ssize_t result = write(file, data, length);
+      if(result > 0) {
+        data += result;
+        length -= static_cast<size_t>(result);
+      }
+      else if(result < 0 && errno == EINTR)
+        continue;
+      else
+        return false;
+    }
+    return true;
+  }
+
+  bool syncFile(FileHandle file)
+  {
+    return fsync(file) == 0;
+  }
+
+  void closeFile(FileHandle file)
+  {
+    close(file);
+  }
+
+  // Returns the path of the file which name refers to with all symbolic links
+  // resolved, or an empty string if it can not be resolved.  The file is
+  // replaced there, so that the links keep referring to it.
+
+  std::string resolvePath(const std::string &name)
+  {
+    char *const resolved = realpath(name.c_str(), nullptr);
+    if(!resolved)
+      return std::string();
+
+    std::string path(resolved);
+    free(resolved);
+    return path;
+  }
+
+#endif
+}  // namespace
+
+class RewriteStream::RewriteStreamPrivate
+{
+public:
+  RewriteStreamPrivate(FileStream *stream) :
+    stream(stream),
+    length(stream->length())
+  {
+    if(length > 0)
+      pieces.push_back({ 0, length, ByteVector() });
+  }
+
+  // Returns the index of the piece which starts at offset, splitting the
+  // piece which contains it if needed.
+
+  size_t split(offset_t offset)
+  {
+    offset_t pieceOffset = 0;
+    for(size_t i = 0; i < pieces.size(); ++i) {
+      if(pieceOffset == offset)
+        return i;
+
+      Piece &piece = pieces[i];
+      if(offset < pieceOffset + piece.length) {
+        const offset_t head = offset - pieceOffset;
+
+        Piece tail { -1, piece.length - head, ByteVector() };
+        if(piece.offset >= 0) {
+          tail.offset = piece.offset + head;
+        }
+        else {
+          tail.data = piece.data.mid(static_cast<unsigned int>(head));
+          piece.data.resize(static_cast<unsigned int>(head));
+        }
+        piece.length = head;
+
+        pieces.insert(pieces.begin() + i + 1, tail);
+        return i + 1;
+      }
+
+      pieceOffset += piece.length;
+    }
+
+    return pieces.size();
+  }
+
+  // Replaces count bytes at offset with data, filling any gap after the end
+  // with zeros.
+
+  void replace(offset_t offset, offset_t count, const ByteVector &data)
+  {
+    modified = true;
+
+    if(offset > length) {
+      const auto size = static_cast<unsigned int>(offset - length);
+      pieces.push_back({ -1, size, ByteVector(size, '\0') });
+      length = offset;
+    }
+
+    count = std::min(count, length - offset);
+
+    const size_t first = split(offset);
+    const size_t last = split(offset + count);
+    pieces.erase(pieces.begin() + first, pieces.begin() + last);
+    length -= count;
+
+    if(data.isEmpty())
+      return;
+
+    // Keep consecutive new data in a single piece.
+
+    auto piece = pieces.insert(pieces.begin() + first, { -1, data.size(), data });
+    if(const auto next = piece + 1; next != pieces.end() && next->offset < 0) {
+      piece->data.append(next->data);
+      piece->length += next->length;
+      piece = pieces.erase(next) - 1;
+    }
+    if(piece != pieces.begin()) {
+      if(const auto previous = piece - 1; previous->offset < 0) {
+        previous->data.append(piece->data);
+        previous->length += piece->length;
+        pieces.erase(piece);
+      }
+    }
+
+    length += data.size();
+  }
+
+  ByteVector read(offset_t offset, size_t count)
+  {
+    ByteVector result;
+
+    offset_t pieceOffset = 0;
+    for(const auto &piece : pieces) {
+      if(result.size() >= count)
+        break;
+
+      const offset_t pieceEnd = pieceOffset + piece.length;
+      if(offset < pieceEnd) {
+        const offset_t begin = offset - pieceOffset;
+        const auto size = static_cast<size_t>(
+          std::min<offset_t>(piece.length - begin, count - result.size()));
+
+        if(piece.offset >= 0)
+          result.append(stream->readBlockAt(piece.offset + begin, size));
+        else
+          result.append(piece.data.mid(static_cast<unsigned int>(begin),
+                                       static_cast<unsigned int>(size)));
+
+        offset += size;
+      }
+
+      pieceOffset = pieceEnd;
+    }
+
+    return result;
+  }
+
+  // Copies a range of the original file to the end of target.
+
+  bool copy(FileHandle target, [[maybe_unused]] FileHandle source, offset_t offset, offset_t count)
+  {
+#ifdef HAVE_COPY_FILE_RANGE
+
+    loff_t in = offset;
+    while(count > 0) {
+      const ssize_t result = copy_file_range(source, &in, target, nullptr,
+                                             static_cast<size_t>(count), 0);
+      if(result > 0)
+        count -= result;
+      else if(result < 0 && errno == EINTR)
+        continue;
+      else
+        break;
+    }
+    offset = in;
+
+#endif
+
+    while(count > 0) {
+      const ByteVector data = stream->readBlockAt(
+        offset, static_cast<size_t>(std::min(count, CopyChunkSize)));
+      if(data.isEmpty() || !writeFile(target, data.data(), data.size()))
+        return false;
+
+      offset += data.size();
+      count -= data.size();
+    }
+
+    return true;
+  }
+
+  bool write(FileHandle target, FileHandle source)
+  {
+    for(const auto &piece : pieces) {
+      if(piece.offset >= 0) {
+        if(!copy(target, source, piece.offset, piece.length))
+          return false;
+      }
+      else if(!writeFile(target, piece.data.data(), piece.data.size())) {
+        return false;
+      }
+    }
+
+    return syncFile(target);
+  }
+
+  FileStream *const stream;
+  std::vector<Piece> pieces;
+  offset_t length;
+  offset_t position { 0 };
+  bool modified { false };
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+RewriteStream::RewriteStream(FileStream *stream) :
+  d(std::make_unique<RewriteStreamPrivate>(stream))
+{
+}
+
+RewriteStream::~RewriteStream() = default;
+
+bool RewriteStream::canRewrite(FileStream *stream)
+{
+  if(!stream || !stream->isOpen() || stream->readOnly())
+    return false;
+
+  // A file with several hard links is changed in place, so that all of its
+  // names refer to the changed file.
+
+#ifdef _WIN32
+  const std::wstring name = stream->name().wstr();
+  return !name.empty() && isSingleLink(name);
+#else
+  const std::string path = resolvePath(stream->name());
+  struct stat st;
+  return !path.empty() && stat(path.c_str(), &st) == 0 && st.st_nlink == 1;
+#endif
+}
+
+FileName RewriteStream::name() const
+{
+  return d->stream->name();
+}
+
+ByteVector RewriteStream::readBlock(size_t length)
+{
+  ByteVector data = d->read(d->position, length);
+  d->position += data.size();
+  return data;
+}
+
+void RewriteStream::writeBlock(const ByteVector &data)
+{
+  d->replace(d->position, data.size(), data);
+  d->position += data.size();
+}
+
+void RewriteStream::insert(const ByteVector &data, offset_t start, size_t replace)
+{
+  d->replace(start, replace, data);
+}
+
+void RewriteStream::removeBlock(offset_t start, size_t length)
+{
+  if(start < d->length)
+    d->replace(start, length, ByteVector());
+}
+
+bool RewriteStream::readOnly() const
+{
+  return false;
+}
+
+bool RewriteStream::isOpen() const
+{
+  return d->stream->isOpen();
+}
+
+void RewriteStream::seek(offset_t offset, Position p)
+{
+  switch(p) {
+  case Beginning:
+    d->position = offset;
+    break;
+  case Current:
+    d->position += offset;
+    break;
+  case End:
+    d->position = d->length + offset;
+    break;
+  }
+
+  d->position = std::max<offset_t>(d->position, 0);
+}
+
+void RewriteStream::clear()
+{
+}
+
+offset_t RewriteStream::tell() const
+{
+  return d->position;
+}
+
+offset_t RewriteStream::length()
+{
+  return d->length;
+}
+
+void RewriteStream::truncate(offset_t length)
+{
+  if(length < d->length)
+    d->replace(length, d->length - length, ByteVector());
+  else if(length > d->length)
+    d->replace(length, 0, ByteVector());
+}
+
+ByteVector RewriteStream::readBlockAt(offset_t offset, size_t length)
+{
+  return d->read(offset, length);
+}
+
+bool RewriteStream::isModified() const
+{
+  return d->modified;
+}
+
+bool RewriteStream::commit()
+{
+  if(!d->modified)
+    return true;
+
+#ifdef _WIN32
+
+  const std::wstring fileName = d->stream->name().wstr();
+  const std::wstring tempName = fileName + L".taglib-" + std::to_wstring(GetCurrentProcessId());
+
+  const FileHandle target = createFile(tempName);
+  const FileHandle source = InvalidFileHandle;
+
+  if(target == InvalidFileHandle) {
+    debug("RewriteStream::commit() -- Couldn't create a temporary file.");
+    return false;
+  }
+
+#else
+
+  // The temporary file is created next to the target of a symbolic link, so
+  // that it can be renamed over it.
+
+  const std::string fileName = resolvePath(d->stream->name());
+  if(fileName.empty()) {
+    debug("RewriteStream::commit() -- Couldn't resolve the name of the file.");
+    return false;
+  }
+
+  std::string tempName = fileName + ".XXXXXX";
+
+  const FileHandle target = mkstemp(tempName.data());
+  if(target == InvalidFileHandle) {
+    debug("RewriteStream::commit() -- Couldn't create a temporary file.");
+    return false;
+  }
+
+  // The original file is opened a second time to copy from it with
+  // copy_file_range().  Its permissions and, if possible, its owner are
+  // kept for the new file.
+
+  const FileHandle source = open(fileName.c_str(), O_RDONLY);
+  if(struct stat st; source != InvalidFileHandle && fstat(source, &st) == 0) {
+    if(fchmod(target, st.st_mode & 07777) != 0)
+      debug("RewriteStream::commit() -- Couldn't keep the permissions of the file.");
+    if((st.st_uid != geteuid() || st.st_gid != getegid()) &&
+       fchown(target, st.st_uid, st.st_gid) != 0) {
+      debug("RewriteStream::commit() -- Couldn't keep the owner of the file.");
+    }
+  }
+
+#endif
+
+  const bool written = d->write(target, source);
+
+  closeFile(target);
+  if(source != InvalidFileHandle)
+    closeFile(source);
+
+  if(!written)
+    debug("RewriteStream::commit() -- Couldn't write the temporary file.");
+
+  if(!written || !d->stream->replaceWith(tempName.c_str())) {
+#ifdef _WIN32
+    DeleteFileW(tempName.c_str());
+#else
+    unlink(tempName.c_str());
+#endif
+    return false;
+  }
+
+  d->modified = false;
+  d->pieces.clear();
+  if(d->length > 0)
+    d->pieces.push_back({ 0, d->length, ByteVector() });
+
+  return true;
+}
@@ -0,0 +1,105 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_REWRITESTREAM_H
+#define TAGLIB_REWRITESTREAM_H
+
+#include <memory>
+
+#include "tiostream.h"
+
+// THIS FILE IS NOT A PART OF THE TAGLIB API
+
+#ifndef DO_NOT_DOCUMENT  // tell Doxygen not to document this header
+
+namespace TagLib {
+
+  class FileStream;
+
+  //! Stream which collects the changes to a file and writes them to a copy.
+
+  /*!
+   * All changes are kept in memory as a list of pieces, which are either
+   * ranges of the original file or new data, and the original file is only
+   * read.  commit() writes the pieces to a temporary file next to the
+   * original file, copying the unchanged ranges with copy_file_range() where
+   * available, and renames it over the original file.
+   */
+  class RewriteStream : public IOStream
+  {
+  public:
+    /*!
+     * Constructs a stream with the contents of \a stream, which must stay
+     * valid while this stream is used.
+     */
+    explicit RewriteStream(FileStream *stream);
+
+    ~RewriteStream() override;
+
+    /*!
+     * Returns \c true if \a stream is a writable file with a name, which can
+     * be replaced.  Files with several hard links are not replaced, and for
+     * symbolic links the file they refer to is replaced.
+     */
+    static bool canRewrite(FileStream *stream);
+
+    RewriteStream(const RewriteStream &) = delete;
+    RewriteStream &operator=(const RewriteStream &) = delete;
+
+    FileName name() const override;
+    ByteVector readBlock(size_t length) override;
+    void writeBlock(const ByteVector &data) override;
+    void insert(const ByteVector &data, offset_t start = 0, size_t replace = 0) override;
+    void removeBlock(offset_t start = 0, size_t length = 0) override;
+    bool readOnly() const override;
+    bool isOpen() const override;
+    void seek(offset_t offset, Position p = Beginning) override;
+    void clear() override;
+    offset_t tell() const override;
+    offset_t length() override;
+    void truncate(offset_t length) override;
+    ByteVector readBlockAt(offset_t offset, size_t length) override;
+
+    /*!
+     * Returns \c true if the stream has been changed.
+     */
+    bool isModified() const;
+
+    /*!
+     * Replaces the original file by a file with the contents of this stream
+     * if it has been changed.  Returns \c false and leaves the original file
+     * untouched if this fails.
+     */
+    bool commit();
+
+  private:
+    class RewriteStreamPrivate;
+    std::unique_ptr<RewriteStreamPrivate> d;
+  };
+
+}  // namespace TagLib
+
+#endif
+
+#endif
@@ -0,0 +1,154 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#include "tserialization.h"
+
+#include "tstringlist.h"
+
+using namespace TagLib;
+
+void Serialization::appendUInt(ByteVector &data, unsigned int value)
+{
+  // Written in place, creating a ByteVector for each number would dominate
+  // the time needed to serialize short strings.
+
+  const unsigned int offset = data.size();
+  data.resize(offset + 4);
+  char *p = data.data() + offset;
+  p[0] = static_cast<char>(value >> 24);
+  p[1] = static_cast<char>(value >> 16);
+  p[2] = static_cast<char>(value >> 8);
+  p[3] = static_cast<char>(value);
+}
+
+void Serialization::appendBytes(ByteVector &data, const ByteVector &bytes)
+{
+  appendUInt(data, bytes.size());
+  data.append(bytes);
+}
+
+void Serialization::appendString(ByteVector &data, const String &string)
+{
+  appendBytes(data, string.data(String::UTF8));
+}
+
+void Serialization::appendStringList(ByteVector &data, const StringList &list)
+{
+  appendUInt(data, list.size());
+  for(const auto &string : list)
+    appendString(data, string);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Reader
+////////////////////////////////////////////////////////////////////////////////
+
+Serialization::Reader::Reader(const ByteVector &data) :
+  data(data)
+{
+}
+
+bool Serialization::Reader::isValid() const
+{
+  return valid;
+}
+
+bool Serialization::Reader::atEnd() const
+{
+  return pos == data.size();
+}
+
+unsigned char Serialization::Reader::readByte()
+{
+  if(!check(1))
+    return 0;
+  return static_cast<unsigned char>(data[pos++]);
+}
+
+unsigned int Serialization::Reader::readUInt()
+{
+  if(!check(4))
+    return 0;
+  const unsigned int value = data.toUInt(pos);
+  pos += 4;
+  return value;
+}
+
+unsigned long long Serialization::Reader::readULongLong()
+{
+  if(!check(8))
+    return 0;
+  const unsigned long long value = data.toULongLong(pos);
+  pos += 8;
+  return value;
+}
+
+double Serialization::Reader::readDouble()
+{
+  if(!check(8))
+    return 0.0;
+  const double value = data.toFloat64BE(pos);
+  pos += 8;
+  return value;
+}
+
+ByteVector Serialization::Reader::readBytes()
+{
+  const unsigned int length = readUInt();
+  if(!check(length))
+    return ByteVector();
+  const ByteVector bytes = data.mid(pos, length);
+  pos += length;
+  return bytes;
+}
+
+String Serialization::Reader::readString()
+{
+  return String(readBytes(), String::UTF8);
+}
+
+StringList Serialization::Reader::readStringList()
+{
+  StringList list;
+
+  // Every string takes at least four bytes, so the loop ends when the count
+  // is too large for the remaining data.
+
+  for(unsigned int count = readUInt(); count > 0 && valid; --count) {
+    const String string = readString();
+    if(valid)
+      list.append(string);
+  }
+  return list;
+}
+
+bool Serialization::Reader::check(unsigned int length)
+{
+  if(!valid || length > data.size() - pos) {
+    valid = false;
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,115 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#ifndef TAGLIB_SERIALIZATION_H
+#define TAGLIB_SERIALIZATION_H
+
+#include "tbytevector.h"
+#include "tstring.h"
+
+// THIS FILE IS NOT A PART OF THE TAGLIB API
+
+#ifndef DO_NOT_DOCUMENT  // tell Doxygen not to document this header
+
+namespace TagLib {
+
+  class StringList;
+
+  namespace Serialization {
+
+    // The binary format used by StringList::serialize(), Variant::serialize()
+    // and PropertyMap::serialize().  Numbers are stored big-endian, strings
+    // as UTF-8 and byte vectors, strings and lists are prefixed with their
+    // size as a 32-bit number.
+
+    /*!
+     * Appends \a value to \a data.
+     */
+    void appendUInt(ByteVector &data, unsigned int value);
+
+    /*!
+     * Appends the size of \a bytes followed by \a bytes to \a data.
+     */
+    void appendBytes(ByteVector &data, const ByteVector &bytes);
+
+    /*!
+     * Appends \a string as UTF-8 with its size to \a data.
+     */
+    void appendString(ByteVector &data, const String &string);
+
+    /*!
+     * Appends the number of strings in \a list followed by the strings to
+     * \a data.
+     */
+    void appendStringList(ByteVector &data, const StringList &list);
+
+    /*!
+     * Reads the values appended by the functions above.  Instead of reading
+     * past the end of the data, an error flag is set and empty values are
+     * returned.
+     */
+    class Reader
+    {
+    public:
+      explicit Reader(const ByteVector &data);
+
+      /*!
+       * Returns \c false if an attempt was made to read past the end.
+       */
+      bool isValid() const;
+
+      /*!
+       * Returns \c true if all data has been read.
+       */
+      bool atEnd() const;
+
+      unsigned char readByte();
+      unsigned int readUInt();
+      unsigned long long readULongLong();
+      double readDouble();
+
+      /*!
+       * Returns the next byte vector, which shares the data passed to the
+       * constructor instead of copying it.
+       */
+      ByteVector readBytes();
+
+      String readString();
+      StringList readStringList();
+
+    private:
+      bool check(unsigned int length);
+
+      const ByteVector &data;
+      unsigned int pos { 0 };
+      bool valid { true };
+    };
+
+  }  // namespace Serialization
+}  // namespace TagLib
+
+#endif
+
+#endif
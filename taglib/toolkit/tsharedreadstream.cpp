@@ -0,0 +1,140 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#include "tsharedreadstream.h"
+
+#include "tstring.h"
+#include "tdebug.h"
+
+using namespace TagLib;
+
+class SharedReadStream::SharedReadStreamPrivate
+{
+public:
+  SharedReadStreamPrivate(IOStream *stream) :
+    stream(stream)
+  {
+  }
+
+  IOStream *const stream;
+  offset_t position { 0 };
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+SharedReadStream::SharedReadStream(IOStream *stream) :
+  d(std::make_unique<SharedReadStreamPrivate>(stream))
+{
+  if(!stream->supportsConcurrentReads())
+    debug("SharedReadStream::SharedReadStream() -- the stream does not support concurrent reads.");
+}
+
+SharedReadStream::~SharedReadStream() = default;
+
+FileName SharedReadStream::name() const
+{
+  return d->stream->name();
+}
+
+ByteVector SharedReadStream::readBlock(size_t length)
+{
+  ByteVector buffer = d->stream->readBlockAt(d->position, length);
+  d->position += buffer.size();
+
+  return buffer;
+}
+
+void SharedReadStream::writeBlock(const ByteVector &)
+{
+  debug("SharedReadStream::writeBlock() -- read only stream.");
+}
+
+void SharedReadStream::insert(const ByteVector &, offset_t, size_t)
+{
+  debug("SharedReadStream::insert() -- read only stream.");
+}
+
+void SharedReadStream::removeBlock(offset_t, size_t)
+{
+  debug("SharedReadStream::removeBlock() -- read only stream.");
+}
+
+bool SharedReadStream::readOnly() const
+{
+  return true;
+}
+
+bool SharedReadStream::isOpen() const
+{
+  return d->stream->isOpen();
+}
+
+void SharedReadStream::seek(offset_t offset, Position p)
+{
+  switch(p) {
+  case Beginning:
+    d->position = offset;
+    break;
+  case Current:
+    d->position += offset;
+    break;
+  case End:
+    d->position = length() + offset;
+    break;
+  default:
+    debug("SharedReadStream::seek() -- Invalid Position value.");
+    return;
+  }
+
+  if(d->position < 0)
+    d->position = 0;
+}
+
+offset_t SharedReadStream::tell() const
+{
+  return d->position;
+}
+
+offset_t SharedReadStream::length()
+{
+  return d->stream->length();
+}
+
+void SharedReadStream::truncate(offset_t)
+{
+  debug("SharedReadStream::truncate() -- read only stream.");
+}
+
+ByteVector SharedReadStream::readBlockAt(offset_t offset, size_t length)
+{
+  return d->stream->readBlockAt(offset, length);
+}
+
+bool SharedReadStream::supportsConcurrentReads() const
+{
+  return d->stream->supportsConcurrentReads();
+}
@@ -0,0 +1,149 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#ifndef TAGLIB_SHAREDREADSTREAM_H
+#define TAGLIB_SHAREDREADSTREAM_H
+
+#include "tiostream.h"
+#include "taglib_export.h"
+
+namespace TagLib {
+
+  //! Read only I/O stream with its own position on a stream shared between threads
+
+  /*!
+   * This reads from another stream using only IOStream::readBlockAt() and
+   * IOStream::length(), and keeps its own get pointer.  If the shared stream
+   * supports concurrent reads (see IOStream::supportsConcurrentReads()),
+   * several threads can read the same file at once, each through its own
+   * SharedReadStream:
+   *
+   * \code
+   * FileStream stream(fileName, true);
+   *
+   * // In each thread
+   * SharedReadStream reader(&stream);
+   * FileRef file(&reader);
+   * \endcode
+   *
+   * The shared stream is not owned and has to outlive this stream.  It must
+   * not be modified while it is read.  A single SharedReadStream must not be
+   * used by several threads at once.
+   */
+  class TAGLIB_EXPORT SharedReadStream : public IOStream
+  {
+  public:
+    /*!
+     * Constructs a read only stream on \a stream, positioned at its
+     * beginning.
+     */
+    explicit SharedReadStream(IOStream *stream);
+
+    /*!
+     * Destroys this SharedReadStream instance.
+     */
+    ~SharedReadStream() override;
+
+    SharedReadStream(const SharedReadStream &) = delete;
+    SharedReadStream &operator=(const SharedReadStream &) = delete;
+
+    /*!
+     * Returns the name of the shared stream.
+     */
+    FileName name() const override;
+
+    /*!
+     * Reads a block of size \a length at the current get pointer.
+     */
+    ByteVector readBlock(size_t length) override;
+
+    /*!
+     * Does nothing, the stream is read only.
+     */
+    void writeBlock(const ByteVector &data) override;
+
+    /*!
+     * Does nothing, the stream is read only.
+     */
+    void insert(const ByteVector &data, offset_t start = 0, size_t replace = 0) override;
+
+    /*!
+     * Does nothing, the stream is read only.
+     */
+    void removeBlock(offset_t start = 0, size_t length = 0) override;
+
+    /*!
+     * Returns \c true.
+     */
+    bool readOnly() const override;
+
+    /*!
+     * Returns \c true if the shared stream is open.
+     */
+    bool isOpen() const override;
+
+    /*!
+     * Move the I/O pointer to \a offset in the stream from position \a p.
+     * This does not touch the shared stream.
+     *
+     * \see Position
+     */
+    void seek(offset_t offset, Position p = Beginning) override;
+
+    /*!
+     * Returns the current offset within the stream.
+     */
+    offset_t tell() const override;
+
+    /*!
+     * Returns the length of the shared stream.
+     */
+    offset_t length() override;
+
+    /*!
+     * Does nothing, the stream is read only.
+     */
+    void truncate(offset_t length) override;
+
+    /*!
+     * Reads a block of size \a length at \a offset from the shared stream.
+     * The get pointer is not moved.
+     */
+    ByteVector readBlockAt(offset_t offset, size_t length) override;
+
+    /*!
+     * Returns whether the shared stream supports concurrent reads.
+     */
+    bool supportsConcurrentReads() const override;
+
+  private:
+    class SharedReadStreamPrivate;
+    TAGLIB_MSVC_SUPPRESS_WARNING_NEEDS_TO_HAVE_DLL_INTERFACE
+    std::unique_ptr<SharedReadStreamPrivate> d;
+  };
+
+}  // namespace TagLib
+
+#endif
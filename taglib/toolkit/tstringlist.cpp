@@ -25,6 +25,8 @@
 
 #include "tstringlist.h"
 
+#include "tserialization.h"
+
 using namespace TagLib;
 
 class StringList::StringListPrivate
@@ -50,6 +52,16 @@ StringList StringList::split(const String &s, const String &pattern)
   return l;
 }
 
+StringList StringList::deserialize(const ByteVector &data, bool *ok)
+{
+  Serialization::Reader reader(data);
+  StringList l = reader.readStringList();
+  const bool valid = reader.isValid() && reader.atEnd();
+  if(ok)
+    *ok = valid;
+  return valid ? l : StringList();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // public members
 ////////////////////////////////////////////////////////////////////////////////
@@ -124,6 +136,13 @@ StringList &StringList::append(const StringList &l)
   return *this;
 }
 
+ByteVector StringList::serialize() const
+{
+  ByteVector data;
+  Serialization::appendStringList(data, *this);
+  return data;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // related functions
 ////////////////////////////////////////////////////////////////////////////////
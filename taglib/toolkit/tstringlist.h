@@ -117,6 +117,24 @@ namespace TagLib {
     TAGLIB_EXPORT
     static StringList split(const String &s, const String &pattern);
 
+    /*!
+     * Returns the list in a compact binary format, which can be converted
+     * back with deserialize().  The strings are stored as UTF-8, each prefixed
+     * with its size.
+     *
+     * \see Variant::serialize(), PropertyMap::serialize()
+     */
+    TAGLIB_EXPORT
+    ByteVector serialize() const;
+
+    /*!
+     * Returns the list stored in \a data by serialize().  If \a ok is passed,
+     * it is set to \c false and an empty list is returned if \a data is not a
+     * valid serialized list.
+     */
+    TAGLIB_EXPORT
+    static StringList deserialize(const ByteVector &data, bool *ok = nullptr);
+
   private:
     class StringListPrivate;
     std::unique_ptr<StringListPrivate> d;
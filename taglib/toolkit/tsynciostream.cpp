@@ -0,0 +1,156 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#include "tsynciostream.h"
+
+#include "tasynciostream.h"
+#include "tstring.h"
+#include "tdebug.h"
+
+using namespace TagLib;
+
+class SyncIOStream::SyncIOStreamPrivate
+{
+public:
+  SyncIOStreamPrivate(AsyncIOStream *stream) :
+    stream(stream)
+  {
+  }
+
+  AsyncIOStream *const stream;
+  offset_t position { 0 };
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+SyncIOStream::SyncIOStream(AsyncIOStream *stream) :
+  d(std::make_unique<SyncIOStreamPrivate>(stream))
+{
+}
+
+SyncIOStream::~SyncIOStream() = default;
+
+FileName SyncIOStream::name() const
+{
+  return d->stream->name();
+}
+
+ByteVector SyncIOStream::readBlock(size_t length)
+{
+  ByteVector buffer = readBlockAt(d->position, length);
+  d->position += buffer.size();
+
+  return buffer;
+}
+
+void SyncIOStream::writeBlock(const ByteVector &)
+{
+  debug("SyncIOStream::writeBlock() -- read only stream.");
+}
+
+void SyncIOStream::insert(const ByteVector &, offset_t, size_t)
+{
+  debug("SyncIOStream::insert() -- read only stream.");
+}
+
+void SyncIOStream::removeBlock(offset_t, size_t)
+{
+  debug("SyncIOStream::removeBlock() -- read only stream.");
+}
+
+bool SyncIOStream::readOnly() const
+{
+  return true;
+}
+
+bool SyncIOStream::isOpen() const
+{
+  return d->stream->isOpen();
+}
+
+void SyncIOStream::seek(offset_t offset, Position p)
+{
+  switch(p) {
+  case Beginning:
+    d->position = offset;
+    break;
+  case Current:
+    d->position += offset;
+    break;
+  case End:
+    d->position = length() + offset;
+    break;
+  default:
+    debug("SyncIOStream::seek() -- Invalid Position value.");
+    return;
+  }
+
+  if(d->position < 0)
+    d->position = 0;
+}
+
+offset_t SyncIOStream::tell() const
+{
+  return d->position;
+}
+
+offset_t SyncIOStream::length()
+{
+  return d->stream->length();
+}
+
+void SyncIOStream::truncate(offset_t)
+{
+  debug("SyncIOStream::truncate() -- read only stream.");
+}
+
+ByteVector SyncIOStream::readBlockAt(offset_t offset, size_t length)
+{
+  // The result is shared with the handler, which is still called if waiting
+  // fails.
+
+  struct Result
+  {
+    ByteVector data;
+    bool complete { false };
+  };
+  const auto result = std::make_shared<Result>();
+
+  d->stream->readBlockAt(offset, length, [result](const ByteVector &data) {
+    result->data = data;
+    result->complete = true;
+  });
+
+  while(!result->complete) {
+    if(d->stream->waitForReads() == 0 && !result->complete) {
+      debug("SyncIOStream::readBlockAt() -- The read did not complete.");
+      return ByteVector();
+    }
+  }
+
+  return result->data;
+}
@@ -0,0 +1,144 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#ifndef TAGLIB_SYNCIOSTREAM_H
+#define TAGLIB_SYNCIOSTREAM_H
+
+#include "tiostream.h"
+#include "taglib_export.h"
+
+namespace TagLib {
+
+  class AsyncIOStream;
+
+  //! Read only I/O stream which waits for the reads of an AsyncIOStream
+
+  /*!
+   * This allows to pass an AsyncIOStream to the format parsers, which read
+   * synchronously:
+   *
+   * \code
+   * AsyncFileStream asyncStream(fileName, &queue);
+   * SyncIOStream stream(&asyncStream);
+   * FileRef file(&stream);
+   * \endcode
+   *
+   * Each read blocks the calling thread in AsyncIOStream::waitForReads()
+   * until it completed, so the parsers are not suspended while a read is
+   * running, and a thread parsing through a SyncIOStream cannot serve other
+   * reads in the meantime.  Only the handlers of reads started on the same
+   * asynchronous stream are called while waiting, those of other streams on
+   * a shared queue are left for its event loop.  The asynchronous stream is
+   * not owned and has to outlive this stream.
+   */
+  class TAGLIB_EXPORT SyncIOStream : public IOStream
+  {
+  public:
+    /*!
+     * Constructs a read only stream on \a stream, positioned at its
+     * beginning.
+     */
+    explicit SyncIOStream(AsyncIOStream *stream);
+
+    /*!
+     * Destroys this SyncIOStream instance.
+     */
+    ~SyncIOStream() override;
+
+    SyncIOStream(const SyncIOStream &) = delete;
+    SyncIOStream &operator=(const SyncIOStream &) = delete;
+
+    /*!
+     * Returns the name of the asynchronous stream.
+     */
+    FileName name() const override;
+
+    /*!
+     * Reads a block of size \a length at the current get pointer.
+     */
+    ByteVector readBlock(size_t length) override;
+
+    /*!
+     * Does nothing, the stream is read only.
+     */
+    void writeBlock(const ByteVector &data) override;
+
+    /*!
+     * Does nothing, the stream is read only.
+     */
+    void insert(const ByteVector &data, offset_t start = 0, size_t replace = 0) override;
+
+    /*!
+     * Does nothing, the stream is read only.
+     */
+    void removeBlock(offset_t start = 0, size_t length = 0) override;
+
+    /*!
+     * Returns \c true.
+     */
+    bool readOnly() const override;
+
+    /*!
+     * Returns \c true if the asynchronous stream is open.
+     */
+    bool isOpen() const override;
+
+    /*!
+     * Move the I/O pointer to \a offset in the stream from position \a p.
+     *
+     * \see Position
+     */
+    void seek(offset_t offset, Position p = Beginning) override;
+
+    /*!
+     * Returns the current offset within the stream.
+     */
+    offset_t tell() const override;
+
+    /*!
+     * Returns the length of the asynchronous stream.
+     */
+    offset_t length() override;
+
+    /*!
+     * Does nothing, the stream is read only.
+     */
+    void truncate(offset_t length) override;
+
+    /*!
+     * Reads a block of size \a length at \a offset and waits for it.  The
+     * get pointer is not moved.
+     */
+    ByteVector readBlockAt(offset_t offset, size_t length) override;
+
+  private:
+    class SyncIOStreamPrivate;
+    TAGLIB_MSVC_SUPPRESS_WARNING_NEEDS_TO_HAVE_DLL_INTERFACE
+    std::unique_ptr<SyncIOStreamPrivate> d;
+  };
+
+}  // namespace TagLib
+
+#endif
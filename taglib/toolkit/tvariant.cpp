@@ -32,6 +32,7 @@
 #include "tstringlist.h"
 #include "tbytevector.h"
 #include "tbytevectorlist.h"
+#include "tserialization.h"
 
 using namespace TagLib;
 
@@ -195,6 +196,146 @@ void printVariantToStream(std::ostream &s, const StdVariantType &v)
   }
 }
 
+// Deeper nesting is considered invalid when deserializing, so that malformed
+// data cannot exhaust the stack.
+constexpr unsigned int MaximumNestingDepth = 64;
+
+// Append a possibly recursive Variant to the data returned by
+// Variant::serialize(), the type is followed by the value.
+void appendVariant(ByteVector &data, const Variant &v)
+{
+  data.append(static_cast<char>(v.type()));
+  switch(v.type()) {
+  case Variant::Void:
+    break;
+  case Variant::Bool:
+    data.append(static_cast<char>(v.toBool() ? 1 : 0));
+    break;
+  case Variant::Int:
+    Serialization::appendUInt(data, static_cast<unsigned int>(v.toInt()));
+    break;
+  case Variant::UInt:
+    Serialization::appendUInt(data, v.toUInt());
+    break;
+  case Variant::LongLong:
+    data.append(ByteVector::fromLongLong(v.toLongLong()));
+    break;
+  case Variant::ULongLong:
+    data.append(ByteVector::fromULongLong(v.toULongLong()));
+    break;
+  case Variant::Double:
+    data.append(ByteVector::fromFloat64BE(v.toDouble()));
+    break;
+  case Variant::String:
+    Serialization::appendString(data, v.toString());
+    break;
+  case Variant::StringList:
+    Serialization::appendStringList(data, v.toStringList());
+    break;
+  case Variant::ByteVector:
+    Serialization::appendBytes(data, v.toByteVector());
+    break;
+  case Variant::ByteVectorList: {
+    const ByteVectorList list = v.toByteVectorList();
+    Serialization::appendUInt(data, list.size());
+    for(const auto &bytes : list)
+      Serialization::appendBytes(data, bytes);
+    break;
+  }
+  case Variant::VariantList: {
+    const VariantList list = v.toList();
+    Serialization::appendUInt(data, list.size());
+    for(const auto &item : list)
+      appendVariant(data, item);
+    break;
+  }
+  case Variant::VariantMap: {
+    const VariantMap map = v.toMap();
+    Serialization::appendUInt(data, map.size());
+    for(const auto &[key, item] : map) {
+      Serialization::appendString(data, key);
+      appendVariant(data, item);
+    }
+    break;
+  }
+  }
+}
+
+// Read a Variant written by appendVariant(), returns false if the data is
+// invalid.
+bool readVariant(Serialization::Reader &reader, Variant &v, unsigned int depth)
+{
+  switch(reader.readByte()) {
+  case Variant::Void:
+    v = Variant();
+    break;
+  case Variant::Bool:
+    v = reader.readByte() != 0;
+    break;
+  case Variant::Int:
+    v = static_cast<int>(reader.readUInt());
+    break;
+  case Variant::UInt:
+    v = reader.readUInt();
+    break;
+  case Variant::LongLong:
+    v = static_cast<long long>(reader.readULongLong());
+    break;
+  case Variant::ULongLong:
+    v = reader.readULongLong();
+    break;
+  case Variant::Double:
+    v = reader.readDouble();
+    break;
+  case Variant::String:
+    v = reader.readString();
+    break;
+  case Variant::StringList:
+    v = reader.readStringList();
+    break;
+  case Variant::ByteVector:
+    v = reader.readBytes();
+    break;
+  case Variant::ByteVectorList: {
+    ByteVectorList list;
+    for(unsigned int count = reader.readUInt(); count > 0 && reader.isValid(); --count)
+      list.append(reader.readBytes());
+    v = list;
+    break;
+  }
+  case Variant::VariantList: {
+    if(depth >= MaximumNestingDepth)
+      return false;
+    VariantList list;
+    for(unsigned int count = reader.readUInt(); count > 0 && reader.isValid(); --count) {
+      Variant item;
+      if(!readVariant(reader, item, depth + 1))
+        return false;
+      list.append(item);
+    }
+    v = list;
+    break;
+  }
+  case Variant::VariantMap: {
+    if(depth >= MaximumNestingDepth)
+      return false;
+    VariantMap map;
+    for(unsigned int count = reader.readUInt(); count > 0 && reader.isValid(); --count) {
+      const String key = reader.readString();
+      Variant item;
+      if(!readVariant(reader, item, depth + 1))
+        return false;
+      map.insert(key, item);
+    }
+    v = map;
+    break;
+  }
+  default:
+    return false;
+  }
+  return reader.isValid();
+}
+
 } // namespace
 
 class Variant::VariantPrivate
@@ -373,6 +514,23 @@ TagLib::Map<TagLib::String, TagLib::Variant> Variant::toMap(bool *ok) const
   return value<TagLib::Map<TagLib::String, TagLib::Variant>>(ok);
 }
 
+TagLib::ByteVector Variant::serialize() const
+{
+  TagLib::ByteVector data;
+  appendVariant(data, *this);
+  return data;
+}
+
+Variant Variant::deserialize(const TagLib::ByteVector &data, bool *ok) // static
+{
+  Serialization::Reader reader(data);
+  Variant v;
+  const bool valid = readVariant(reader, v, 0) && reader.atEnd();
+  if(ok)
+    *ok = valid;
+  return valid ? v : Variant();
+}
+
 bool Variant::operator==(const Variant &v) const
 {
   return d == v.d || d->data == v.d->data;
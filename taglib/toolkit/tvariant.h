@@ -164,6 +164,27 @@ namespace TagLib {
     template<typename T>
     T value(bool *ok = nullptr) const;
 
+    /*!
+     * Returns the Variant including its type in a compact binary format, which
+     * can be converted back with deserialize().  Lists and maps are stored
+     * recursively, so a VariantMap, e.g. from File::complexProperties(), is
+     * serialized by wrapping it in a Variant.
+     *
+     * \see StringList::serialize(), PropertyMap::serialize()
+     */
+    TagLib::ByteVector serialize() const;
+
+    /*!
+     * Returns the Variant stored in \a data by serialize().  If \a ok is
+     * passed, it is set to \c false and an empty Variant is returned if
+     * \a data is not a valid serialized Variant.
+     *
+     * The contained ByteVector values are not copied, they share the data of
+     * \a data.  If \a data was created with ByteVector::fromRawData(), the
+     * external data has to stay valid as long as they are used.
+     */
+    static Variant deserialize(const TagLib::ByteVector &data, bool *ok = nullptr);
+
     /*!
      * Returns \c true if the Variant and \a v are of the same type and contain the
      * same value.
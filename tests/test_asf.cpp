@@ -31,6 +31,7 @@
 #include "tpropertymap.h"
 #include "tag.h"
 #include "asffile.h"
+#include "plainfile.h"
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
 
@@ -53,6 +54,7 @@ class TestASF : public CppUnit::TestFixture
   CPPUNIT_TEST(testProperties);
   CPPUNIT_TEST(testPropertiesAllSupported);
   CPPUNIT_TEST(testRepeatedSave);
+  CPPUNIT_TEST(testReadStyleFast);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -404,6 +406,32 @@ public:
     CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(68202), f.length());
   }
 
+  void testReadStyleFast()
+  {
+    ByteVector fastData;
+    {
+      ScopedFileCopy copy("silence-1", ".wma");
+      {
+        ASF::File f(copy.fileName().c_str(), true, ASF::Properties::Fast);
+        CPPUNIT_ASSERT(f.isValid());
+        CPPUNIT_ASSERT_EQUAL(3712, f.audioProperties()->lengthInMilliseconds());
+        CPPUNIT_ASSERT_EQUAL(64, f.audioProperties()->bitrate());
+        CPPUNIT_ASSERT_EQUAL(String("Windows Media Audio 9.1"), f.audioProperties()->codecName());
+        f.tag()->setTitle("Title");
+        f.save();
+      }
+      fastData = PlainFile(copy.fileName().c_str()).readAll();
+    }
+    ScopedFileCopy copy("silence-1", ".wma");
+    {
+      ASF::File f(copy.fileName().c_str());
+      f.tag()->setTitle("Title");
+      f.save();
+    }
+    // The header objects which were skipped are saved unchanged.
+    CPPUNIT_ASSERT(fastData == PlainFile(copy.fileName().c_str()).readAll());
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestASF);
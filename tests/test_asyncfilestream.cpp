@@ -0,0 +1,254 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#include <memory>
+#include <vector>
+
+#ifndef _WIN32
+# include <poll.h>
+#endif
+
+#include "tasyncfilestream.h"
+#include "tasyncioqueue.h"
+#include "tsynciostream.h"
+#include "tpropertymap.h"
+#include "fileref.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include "plainfile.h"
+#include "utils.h"
+
+using namespace std;
+using namespace TagLib;
+
+class TestAsyncFileStream : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestAsyncFileStream);
+  CPPUNIT_TEST(testReadBlockAt);
+  CPPUNIT_TEST(testSharedQueue);
+  CPPUNIT_TEST(testNonExistent);
+  CPPUNIT_TEST(testEventDescriptor);
+  CPPUNIT_TEST(testDestroyWithPendingReads);
+  CPPUNIT_TEST(testWaitForReads);
+  CPPUNIT_TEST(testSyncIOStream);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void testReadBlockAt()
+  {
+    const string fileName = testFilePath("xing.mp3");
+    const ByteVector data = PlainFile(fileName.c_str()).readAll();
+
+    AsyncFileStream stream(fileName.c_str());
+    CPPUNIT_ASSERT(stream.isOpen());
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(data.size()), stream.length());
+
+    const pair<offset_t, unsigned int> reads[] = {
+      { 0, 10 }, { 100, 1000 }, { 0, data.size() }, { data.size() - 5, 100 },
+      { data.size(), 10 }, { data.size() + 10, 10 }, { 50, 0 }
+    };
+    unsigned int completed = 0;
+    for(const auto &[offset, length] : reads) {
+      stream.readBlockAt(offset, length, [&, offset = offset, length = length](const ByteVector &result) {
+        CPPUNIT_ASSERT_EQUAL(data.mid(static_cast<unsigned int>(min<offset_t>(offset, data.size())), length),
+                             result);
+        ++completed;
+      });
+    }
+
+    // The handlers are only called by processCompletions().
+    CPPUNIT_ASSERT_EQUAL(0U, completed);
+    CPPUNIT_ASSERT_EQUAL(7U, stream.queue()->pendingReads());
+    while(completed < 7)
+      stream.processCompletions(true);
+    CPPUNIT_ASSERT_EQUAL(7U, completed);
+    CPPUNIT_ASSERT_EQUAL(0U, stream.queue()->pendingReads());
+    CPPUNIT_ASSERT_EQUAL(0U, stream.processCompletions(false));
+  }
+
+  void testSharedQueue()
+  {
+    const char *names[] = {
+      "xing.mp3", "has-tags.m4a", "silence-44-s.flac", "empty.ogg", "click.wv"
+    };
+
+    // Fewer entries than reads, so that some reads wait for submission.
+    AsyncIOQueue queue(4);
+    vector<unique_ptr<AsyncFileStream>> streams;
+    vector<ByteVector> contents;
+    contents.reserve(50);
+    unsigned int completed = 0;
+    unsigned int started = 0;
+    for(int i = 0; i < 10; ++i) {
+      for(const auto name : names) {
+        const string fileName = testFilePath(name);
+        contents.push_back(PlainFile(fileName.c_str()).readAll());
+        streams.push_back(make_unique<AsyncFileStream>(fileName.c_str(), &queue));
+        const ByteVector &expected = contents.back();
+        for(unsigned int offset : { 0U, 1000U, 4000U }) {
+          streams.back()->readBlockAt(offset, 2048, [&, offset](const ByteVector &data) {
+            CPPUNIT_ASSERT_EQUAL(expected.mid(offset, 2048), data);
+            ++completed;
+          });
+          ++started;
+        }
+      }
+    }
+    while(queue.pendingReads() > 0)
+      queue.processCompletions(true);
+    CPPUNIT_ASSERT_EQUAL(started, completed);
+  }
+
+  void testNonExistent()
+  {
+    AsyncFileStream stream(TEST_FILE_PATH_C("no-such-file.mp3"));
+    CPPUNIT_ASSERT(!stream.isOpen());
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(0), stream.length());
+
+    bool completed = false;
+    stream.readBlockAt(0, 10, [&completed](const ByteVector &data) {
+      CPPUNIT_ASSERT(data.isEmpty());
+      completed = true;
+    });
+    CPPUNIT_ASSERT_EQUAL(1U, stream.processCompletions(true));
+    CPPUNIT_ASSERT(completed);
+  }
+
+  void testEventDescriptor()
+  {
+    AsyncIOQueue queue;
+    if(!queue.usesIOUring()) {
+      CPPUNIT_ASSERT_EQUAL(-1, queue.eventDescriptor());
+      return;
+    }
+
+#ifndef _WIN32
+    CPPUNIT_ASSERT(queue.eventDescriptor() >= 0);
+    AsyncFileStream stream(TEST_FILE_PATH_C("xing.mp3"), &queue);
+    ByteVector header;
+    stream.readBlockAt(0, 3, [&header](const ByteVector &data) { header = data; });
+
+    pollfd fds = { queue.eventDescriptor(), POLLIN, 0 };
+    CPPUNIT_ASSERT_EQUAL(1, poll(&fds, 1, 5000));
+    CPPUNIT_ASSERT_EQUAL(1U, queue.processCompletions(false));
+    CPPUNIT_ASSERT_EQUAL(PlainFile(TEST_FILE_PATH_C("xing.mp3")).readAll().mid(0, 3), header);
+#endif
+  }
+
+  void testDestroyWithPendingReads()
+  {
+    AsyncIOQueue queue;
+    AsyncFileStream other(TEST_FILE_PATH_C("click.wv"), &queue);
+    bool otherCompleted = false;
+    other.readBlockAt(0, 4, [&otherCompleted](const ByteVector &data) {
+      CPPUNIT_ASSERT_EQUAL(ByteVector("wvpk"), data);
+      otherCompleted = true;
+    });
+
+    unsigned int completed = 0;
+    {
+      AsyncFileStream stream(TEST_FILE_PATH_C("xing.mp3"), &queue);
+      for(int i = 0; i < 10; ++i)
+        stream.readBlockAt(i * 100, 100, [&completed](const ByteVector &) {
+          ++completed;
+        });
+    }
+
+    // Neither the handlers of the destroyed stream nor those of the other
+    // stream are called by the destructor.
+    CPPUNIT_ASSERT_EQUAL(0U, completed);
+    CPPUNIT_ASSERT(!otherCompleted);
+    CPPUNIT_ASSERT_EQUAL(1U, queue.pendingReads());
+    while(queue.pendingReads() > 0)
+      queue.processCompletions(true);
+    CPPUNIT_ASSERT_EQUAL(0U, completed);
+    CPPUNIT_ASSERT(otherCompleted);
+  }
+
+  void testWaitForReads()
+  {
+    AsyncIOQueue queue;
+    AsyncFileStream other(TEST_FILE_PATH_C("click.wv"), &queue);
+    AsyncFileStream asyncStream(TEST_FILE_PATH_C("xing.mp3"), &queue);
+    CPPUNIT_ASSERT_EQUAL(0U, asyncStream.waitForReads());
+
+    unsigned int otherCompleted = 0;
+    for(int i = 0; i < 3; ++i)
+      other.readBlockAt(0, 4, [&otherCompleted](const ByteVector &) { ++otherCompleted; });
+
+    // Reading through the SyncIOStream leaves the reads of the other stream
+    // to the event loop.
+    const ByteVector data = PlainFile(TEST_FILE_PATH_C("xing.mp3")).readAll();
+    SyncIOStream stream(&asyncStream);
+    CPPUNIT_ASSERT_EQUAL(data.mid(0, 10), stream.readBlock(10));
+    CPPUNIT_ASSERT_EQUAL(0U, otherCompleted);
+    CPPUNIT_ASSERT_EQUAL(3U, queue.pendingReads());
+
+    bool completed = false;
+    asyncStream.readBlockAt(0, 3, [&](const ByteVector &result) {
+      CPPUNIT_ASSERT_EQUAL(data.mid(0, 3), result);
+      completed = true;
+    });
+    while(!completed)
+      asyncStream.waitForReads();
+    CPPUNIT_ASSERT_EQUAL(0U, otherCompleted);
+
+    while(queue.pendingReads() > 0)
+      queue.processCompletions(true);
+    CPPUNIT_ASSERT_EQUAL(3U, otherCompleted);
+  }
+
+  void testSyncIOStream()
+  {
+    for(const char *name : { "xing.mp3", "has-tags.m4a", "silence-44-s.flac" }) {
+      const string fileName = testFilePath(name);
+      const FileRef expected(fileName.c_str());
+
+      AsyncFileStream asyncStream(fileName.c_str());
+      SyncIOStream stream(&asyncStream);
+      CPPUNIT_ASSERT(stream.isOpen());
+      CPPUNIT_ASSERT(stream.readOnly());
+      CPPUNIT_ASSERT_EQUAL(asyncStream.length(), stream.length());
+
+      const FileRef f(&stream);
+      CPPUNIT_ASSERT(!f.isNull());
+      CPPUNIT_ASSERT(expected.properties() == f.properties());
+      CPPUNIT_ASSERT_EQUAL(expected.audioProperties()->lengthInMilliseconds(),
+                           f.audioProperties()->lengthInMilliseconds());
+      CPPUNIT_ASSERT_EQUAL(expected.audioProperties()->bitrate(),
+                           f.audioProperties()->bitrate());
+    }
+
+    AsyncFileStream asyncStream(TEST_FILE_PATH_C("xing.mp3"));
+    SyncIOStream stream(&asyncStream);
+    stream.seek(-10, IOStream::End);
+    CPPUNIT_ASSERT_EQUAL(asyncStream.length() - 10, stream.tell());
+    CPPUNIT_ASSERT_EQUAL(10U, stream.readBlock(100).size());
+    CPPUNIT_ASSERT_EQUAL(asyncStream.length(), stream.tell());
+  }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestAsyncFileStream);
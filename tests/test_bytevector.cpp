@@ -29,9 +29,13 @@
 
 #include <cstring>
 #include <cmath>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "tbytevector.h"
 #include "tbytevectorlist.h"
+#include "tbytevectorsearch.h"
 #include <cppunit/extensions/HelperMacros.h>
 
 using namespace std;
@@ -58,6 +62,8 @@ class TestByteVector : public CppUnit::TestFixture
   CPPUNIT_TEST(testAppend2);
   CPPUNIT_TEST(testBase64);
   CPPUNIT_TEST(testEmpty);
+  CPPUNIT_TEST(testFromRawData);
+  CPPUNIT_TEST(testSearchKernels);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -705,6 +711,119 @@ public:
     CPPUNIT_ASSERT_EQUAL(empty.toBase64(), empty);
   }
 
+  void testFromRawData()
+  {
+    char buffer[] = "0123456789abcdef";
+
+    const ByteVector v = ByteVector::fromRawData(buffer, 16);
+    CPPUNIT_ASSERT_EQUAL(16U, v.size());
+    CPPUNIT_ASSERT(v.data() == buffer);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("0123456789abcdef"), v);
+    CPPUNIT_ASSERT_EQUAL('5', v[5]);
+    CPPUNIT_ASSERT_EQUAL('f', v.at(15));
+    CPPUNIT_ASSERT_EQUAL(10, v.find("ab"));
+    CPPUNIT_ASSERT_EQUAL(3, v.find('3'));
+    CPPUNIT_ASSERT_EQUAL(4, v.rfind("45"));
+    CPPUNIT_ASSERT(v.startsWith("0123"));
+    CPPUNIT_ASSERT_EQUAL(0x30313233U, v.toUInt());
+
+    // Copies and slices share the external buffer.
+
+    const ByteVector copy(v);
+    CPPUNIT_ASSERT(copy.data() == buffer);
+    const ByteVector slice = v.mid(4, 4);
+    CPPUNIT_ASSERT(slice.data() == buffer + 4);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("4567"), slice);
+
+    // Modifications detach from the external buffer, which is left untouched.
+
+    ByteVector modified(v);
+    modified[0] = 'x';
+    CPPUNIT_ASSERT(modified.data() != buffer);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("x123456789abcdef"), modified);
+    CPPUNIT_ASSERT_EQUAL('0', buffer[0]);
+
+    ByteVector appended = v.mid(14);
+    appended.append('g');
+    CPPUNIT_ASSERT_EQUAL(ByteVector("efg"), appended);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("0123456789abcdef"), v);
+
+    // Iterator access works on a private copy.
+
+    const ByteVector iterated = v.mid(0, 4);
+    CPPUNIT_ASSERT_EQUAL(std::string("0123"), std::string(iterated.cbegin(), iterated.cend()));
+    CPPUNIT_ASSERT_EQUAL('3', *iterated.rbegin());
+    CPPUNIT_ASSERT(iterated.data() == buffer);
+    CPPUNIT_ASSERT(slice.data() == buffer + 4);
+
+    // Const iterators can be used from several threads.
+
+    std::vector<std::string> results(4);
+    std::vector<std::thread> threads;
+    for(auto &result : results)
+      threads.emplace_back([&v, &result] { result.assign(v.begin(), v.end()); });
+    for(auto &thread : threads)
+      thread.join();
+    for(const auto &result : results)
+      CPPUNIT_ASSERT_EQUAL(std::string("0123456789abcdef"), result);
+
+    CPPUNIT_ASSERT(ByteVector::fromRawData(nullptr, 0).isEmpty());
+    CPPUNIT_ASSERT(ByteVector::fromRawData(buffer, 0).isEmpty());
+  }
+
+
+  void testSearchKernels()
+  {
+    using ByteVectorSearch::Kernel;
+
+    // Few different bytes, so that there are many partial matches.
+
+    ByteVector data(300, 0);
+    unsigned int seed = 1;
+    for(auto &c : data) {
+      seed = seed * 1103515245U + 12345U;
+      c = static_cast<char>('a' + (seed >> 16) % 3);
+    }
+
+    ByteVectorList patterns;
+    for(unsigned int length : { 1U, 2U, 3U, 5U, 17U, 33U, 40U })
+      for(unsigned int start : { 0U, 7U, 150U, 260U })
+        patterns.append(data.mid(start, length));
+    patterns.append("d");
+    patterns.append("abd");
+
+    const auto search = [&data, &patterns] {
+      std::vector<int> results;
+      for(const auto &pattern : patterns) {
+        for(int byteAlign : { 1, 2, 3, 4, 8, 16, 32, 64 }) {
+          for(unsigned int offset = 0; offset < data.size(); offset += 13) {
+            results.push_back(data.find(pattern, offset, byteAlign));
+            results.push_back(data.rfind(pattern, offset, byteAlign));
+          }
+          results.push_back(data.find(pattern[0], 5, byteAlign));
+        }
+      }
+      return results;
+    };
+
+    const Kernel defaultKernel = ByteVectorSearch::kernel();
+    CPPUNIT_ASSERT(ByteVectorSearch::isSupported(defaultKernel));
+
+    CPPUNIT_ASSERT(ByteVectorSearch::setKernel(Kernel::Scalar));
+    const std::vector<int> expected = search();
+
+    for(Kernel kernel : { Kernel::SSE2, Kernel::AVX2, Kernel::NEON }) {
+      if(ByteVectorSearch::setKernel(kernel)) {
+        CPPUNIT_ASSERT(expected == search());
+      }
+      else {
+        CPPUNIT_ASSERT(!ByteVectorSearch::isSupported(kernel));
+      }
+    }
+
+    ByteVectorSearch::setKernel(defaultKernel);
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestByteVector);
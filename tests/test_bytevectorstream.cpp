@@ -36,9 +36,11 @@ class TestByteVectorStream : public CppUnit::TestFixture
   CPPUNIT_TEST(testWriteBlock);
   CPPUNIT_TEST(testWriteBlockResize);
   CPPUNIT_TEST(testReadBlock);
+  CPPUNIT_TEST(testReadBlockAt);
   CPPUNIT_TEST(testRemoveBlock);
   CPPUNIT_TEST(testInsert);
   CPPUNIT_TEST(testSeekEnd);
+  CPPUNIT_TEST(testRawData);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -85,6 +87,20 @@ public:
     CPPUNIT_ASSERT_EQUAL(ByteVector(""), stream.readBlock(3));
   }
 
+  void testReadBlockAt()
+  {
+    ByteVector v("abcd");
+    ByteVectorStream stream(v);
+
+    stream.seek(1);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("cd"), stream.readBlockAt(2, 2));
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abcd"), stream.readBlockAt(0, 10));
+    CPPUNIT_ASSERT_EQUAL(ByteVector(""), stream.readBlockAt(4, 1));
+    CPPUNIT_ASSERT_EQUAL(ByteVector(""), stream.readBlockAt(-1, 1));
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(1), stream.tell());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("b"), stream.readBlock(1));
+  }
+
   void testRemoveBlock()
   {
     ByteVector v("abcd");
@@ -126,6 +142,24 @@ public:
     CPPUNIT_ASSERT_EQUAL(ByteVector("b"), stream.readBlock(1));
   }
 
+  void testRawData()
+  {
+    const char buffer[] = "abcdefgh";
+    ByteVectorStream stream(buffer, 8);
+
+    const ByteVector *data = stream.data();
+    CPPUNIT_ASSERT(data->data() == buffer);
+    const ByteVector block = stream.readBlock(4);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abcd"), block);
+    CPPUNIT_ASSERT(block.data() == buffer);
+
+    stream.seek(2);
+    stream.writeBlock(ByteVector("xx"));
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abxxefgh"), *stream.data());
+    CPPUNIT_ASSERT_EQUAL(std::string("abcdefgh"), std::string(buffer));
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abcd"), block);
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestByteVectorStream);
@@ -0,0 +1,169 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include "tcachediostream.h"
+#include "tbytevectorstream.h"
+#include "tfilestream.h"
+#include "tpropertymap.h"
+#include "fileref.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include "utils.h"
+
+using namespace std;
+using namespace TagLib;
+
+namespace
+{
+  ByteVector testData(unsigned int size)
+  {
+    ByteVector data(size, '\0');
+    for(unsigned int i = 0; i < size; ++i)
+      data[i] = static_cast<char>(i);
+    return data;
+  }
+}  // namespace
+
+class TestCachedIOStream : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestCachedIOStream);
+  CPPUNIT_TEST(testReadBlock);
+  CPPUNIT_TEST(testLeastRecentlyUsed);
+  CPPUNIT_TEST(testWrite);
+  CPPUNIT_TEST(testFileRef);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void testReadBlock()
+  {
+    const ByteVector data = testData(100);
+    ByteVectorStream stream(data);
+    CachedIOStream cached(&stream, 16, 2);
+
+    CPPUNIT_ASSERT(cached.isOpen());
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(100), cached.length());
+
+    for(unsigned int i = 0; i < 30; ++i)
+      CPPUNIT_ASSERT_EQUAL(data.mid(i, 1), cached.readBlock(1));
+    CPPUNIT_ASSERT_EQUAL(2ULL, cached.misses());
+    CPPUNIT_ASSERT_EQUAL(28ULL, cached.hits());
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(30), cached.tell());
+
+    // Reads across pages and beyond the end
+
+    CPPUNIT_ASSERT_EQUAL(data.mid(14, 4), cached.readBlockAt(14, 4));
+    cached.seek(-5, IOStream::End);
+    CPPUNIT_ASSERT_EQUAL(data.mid(95), cached.readBlock(10));
+    CPPUNIT_ASSERT_EQUAL(ByteVector(), cached.readBlock(1));
+    cached.seek(200);
+    CPPUNIT_ASSERT_EQUAL(ByteVector(), cached.readBlock(4));
+
+    // Reads of at least a page are passed to the stream.
+
+    const unsigned long long misses = cached.misses();
+    const unsigned long long hits = cached.hits();
+    cached.seek(3);
+    CPPUNIT_ASSERT_EQUAL(data.mid(3, 40), cached.readBlock(40));
+    CPPUNIT_ASSERT_EQUAL(misses, cached.misses());
+    CPPUNIT_ASSERT_EQUAL(hits, cached.hits());
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(43), cached.tell());
+  }
+
+  void testLeastRecentlyUsed()
+  {
+    const ByteVector data = testData(100);
+    ByteVectorStream stream(data);
+    CachedIOStream cached(&stream, 16, 2);
+
+    cached.readBlockAt(0, 1);
+    cached.readBlockAt(16, 1);
+    cached.readBlockAt(0, 1);
+    CPPUNIT_ASSERT_EQUAL(2ULL, cached.misses());
+
+    // The page at 16 is dropped for the one at 32.
+
+    cached.readBlockAt(32, 1);
+    CPPUNIT_ASSERT_EQUAL(3ULL, cached.misses());
+    cached.readBlockAt(0, 1);
+    CPPUNIT_ASSERT_EQUAL(3ULL, cached.misses());
+    cached.readBlockAt(16, 1);
+    CPPUNIT_ASSERT_EQUAL(4ULL, cached.misses());
+
+    cached.invalidate();
+    cached.readBlockAt(16, 1);
+    CPPUNIT_ASSERT_EQUAL(5ULL, cached.misses());
+  }
+
+  void testWrite()
+  {
+    ByteVectorStream stream(testData(100));
+    CachedIOStream cached(&stream, 16, 4);
+
+    cached.readBlockAt(0, 1);
+    cached.readBlockAt(96, 1);
+
+    cached.seek(10);
+    cached.writeBlock("abcd");
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(14), cached.tell());
+    CPPUNIT_ASSERT_EQUAL(*stream.data(), cached.readBlockAt(0, 100));
+
+    cached.seek(0, IOStream::End);
+    cached.writeBlock("efgh");
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(104), cached.length());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("efgh"), cached.readBlockAt(100, 8));
+
+    cached.insert("ijkl", 20, 2);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(106), cached.length());
+    CPPUNIT_ASSERT_EQUAL(*stream.data(), cached.readBlockAt(0, 106));
+
+    cached.removeBlock(5, 30);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(76), cached.length());
+    CPPUNIT_ASSERT_EQUAL(*stream.data(), cached.readBlockAt(0, 100));
+
+    cached.truncate(50);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(50), cached.length());
+    CPPUNIT_ASSERT_EQUAL(*stream.data(), cached.readBlockAt(0, 100));
+  }
+
+  void testFileRef()
+  {
+    for(const auto &name : { "xing.mp3", "no-tags.flac", "empty.ogg", "empty.wav", "empty.aiff" }) {
+      FileStream fileStream(TEST_FILE_PATH_C(name), true);
+      CachedIOStream cached(&fileStream);
+      const FileRef direct(TEST_FILE_PATH_C(name));
+      const FileRef file(&cached);
+
+      CPPUNIT_ASSERT(!file.isNull());
+      CPPUNIT_ASSERT(file.file()->properties() == direct.file()->properties());
+      CPPUNIT_ASSERT_EQUAL(direct.audioProperties()->lengthInMilliseconds(),
+                           file.audioProperties()->lengthInMilliseconds());
+      CPPUNIT_ASSERT_EQUAL(direct.audioProperties()->bitrate(),
+                           file.audioProperties()->bitrate());
+      CPPUNIT_ASSERT(cached.hits() > 0);
+    }
+  }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestCachedIOStream);
@@ -35,8 +35,12 @@ class TestFile : public CppUnit::TestFixture
   CPPUNIT_TEST_SUITE(TestFile);
   CPPUNIT_TEST(testFindInSmallFile);
   CPPUNIT_TEST(testRFindInSmallFile);
+  CPPUNIT_TEST(testFindAcrossBlocks);
+  CPPUNIT_TEST(testRFindAcrossBlocks);
   CPPUNIT_TEST(testSeek);
+  CPPUNIT_TEST(testReadBlockAt);
   CPPUNIT_TEST(testTruncate);
+  CPPUNIT_TEST(testInsertAndRemove);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -97,6 +101,92 @@ public:
     }
   }
 
+  void testFindAcrossBlocks()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    std::string name = copy.fileName();
+
+    ByteVector data(5000, 'a');
+    for(int i = 6; i < 5000; i += 7)
+      data[i] = 'c';
+    data[1021] = 'a';
+    data[1022] = 'b';
+    data[4999] = 'd';
+    {
+      PlainFile file(name.c_str());
+      file.seek(0);
+      file.writeBlock(data);
+      file.truncate(data.size());
+    }
+
+    const ByteVector patterns[] = { "aab", "bac", "ac", "aaaac", "cd", "d", "aaad" };
+    const unsigned int blockSizes[][2] = { { 1, 1 }, { 3, 3 }, { 4, 64 }, { 1024, 1024 }, { 1024, 65536 } };
+    for(const auto &blockSize : blockSizes) {
+      PlainFile file(name.c_str());
+      file.setSearchBlockSize(blockSize[0], blockSize[1]);
+      for(const auto &pattern : patterns) {
+        for(unsigned int offset : { 0U, 1U, 1021U, 1023U, 2047U, 4990U }) {
+          CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(data.find(pattern, offset)),
+                               file.find(pattern, offset));
+        }
+      }
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(-1), file.find("aab", 0, "ac"));
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(1020), file.find("aab", 0, "aab"));
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(-1), file.find("d", 0, "c"));
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(4999), file.find("d", 4998, "c"));
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(0), file.tell());
+    }
+  }
+
+  void testRFindAcrossBlocks()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    std::string name = copy.fileName();
+
+    ByteVector data(5000, 'a');
+    for(int i = 6; i < 5000; i += 7)
+      data[i] = 'c';
+    data[1021] = 'a';
+    data[1022] = 'b';
+    data[4999] = 'd';
+    {
+      PlainFile file(name.c_str());
+      file.seek(0);
+      file.writeBlock(data);
+      file.truncate(data.size());
+    }
+
+    // The last match which starts at or before offset, 0 meaning the end.
+    const auto expected = [&data](const ByteVector &pattern, unsigned int offset) {
+      int i = static_cast<int>(data.size() - pattern.size());
+      if(offset != 0)
+        i = std::min(i, static_cast<int>(offset));
+      while(i >= 0 && !data.containsAt(pattern, i))
+        --i;
+      return static_cast<offset_t>(i);
+    };
+
+    const ByteVector patterns[] = { "aab", "bac", "ac", "aaaac", "cd", "ad", "d", "caaa" };
+    const unsigned int blockSizes[][2] = { { 1, 1 }, { 3, 3 }, { 4, 64 }, { 1024, 1024 }, { 1024, 65536 } };
+    for(const auto &blockSize : blockSizes) {
+      PlainFile file(name.c_str());
+      file.setSearchBlockSize(blockSize[0], blockSize[1]);
+      file.seek(100);
+      for(const auto &pattern : patterns) {
+        for(unsigned int offset : { 0U, 1U, 1019U, 1020U, 1021U, 2047U, 4997U, 6000U }) {
+          CPPUNIT_ASSERT_EQUAL(expected(pattern, offset), file.rfind(pattern, offset));
+        }
+      }
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(-1), file.rfind("aab", 0, "ac"));
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(1020), file.rfind("aab", 1020, "ac"));
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(-1), file.rfind("aab", 1030, "ac"));
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(1020), file.rfind("aab", 0, "aab"));
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(4999), file.rfind("d", 0, "c"));
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(-1), file.rfind("b", 0, "d"));
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(100), file.tell());
+    }
+  }
+
   void testSeek()
   {
     ScopedFileCopy copy("empty", ".ogg");
@@ -121,6 +211,25 @@ public:
     CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(4428), f.tell());
   }
 
+  void testReadBlockAt()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    std::string name = copy.fileName();
+
+    PlainFile f(name.c_str());
+    const ByteVector header = f.readBlockAt(0, 4);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("OggS"), header);
+    CPPUNIT_ASSERT_EQUAL(ByteVector(), f.readBlockAt(4328, 4));
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(28), f.readBlockAt(4300, 100000).size());
+
+    // Data written before is visible, even if still buffered.
+
+    f.seek(100);
+    f.writeBlock("abcd");
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abcd"), f.readBlockAt(100, 4));
+    CPPUNIT_ASSERT_EQUAL(f.readBlockAt(0, 100), f.readAll().mid(0, 100));
+  }
+
   void testTruncate()
   {
     ScopedFileCopy copy("empty", ".ogg");
@@ -139,6 +248,50 @@ public:
     }
   }
 
+  void testInsertAndRemove()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    std::string name = copy.fileName();
+
+    ByteVector expected(3 * 1024 * 1024 + 123, '\0');
+    for(unsigned int i = 0; i < expected.size(); ++i)
+      expected[i] = static_cast<char>(i * 7 + i / 251);
+
+    PlainFile file(name.c_str());
+    file.seek(0);
+    file.writeBlock(expected);
+    file.truncate(expected.size());
+
+    // Sizes which are multiples of the file system block size, chunks larger
+    // than the distance moved and moves of more than one chunk.
+
+    const unsigned int inserts[][3] = {
+      { 100, 10, 0 }, { 5000, 4096, 0 }, { 1000001, 4099, 3 }, { 10, 200000, 0 },
+      { 0, 2 * 1024 * 1024, 0 }, { 4096, 8192, 4096 }, { 50, 3, 1000 }
+    };
+    for(const auto &insert : inserts) {
+      const ByteVector data(insert[1], static_cast<char>('a' + insert[0] % 26));
+      file.insert(data, insert[0], insert[2]);
+      expected = expected.mid(0, insert[0]) + data + expected.mid(insert[0] + insert[2]);
+      CPPUNIT_ASSERT(expected == file.readAll());
+    }
+
+    const unsigned int removes[][2] = {
+      { 100, 7 }, { 5000, 4096 }, { 10, 200000 }, { 0, 2 * 1024 * 1024 },
+      { 123456, 8192 }
+    };
+    for(const auto &remove : removes) {
+      file.removeBlock(remove[0], remove[1]);
+      expected = expected.mid(0, remove[0]) + expected.mid(remove[0] + remove[1]);
+      CPPUNIT_ASSERT(expected == file.readAll());
+    }
+
+    // Removing beyond the end of the file truncates it.
+
+    file.removeBlock(expected.size() - 100, 1000);
+    CPPUNIT_ASSERT(expected.mid(0, expected.size() - 100) == file.readAll());
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestFile);
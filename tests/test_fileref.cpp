@@ -23,15 +23,26 @@
  *   http://www.mozilla.org/MPL/                                           *
  ***************************************************************************/
 
+#include <algorithm>
+#include <atomic>
 #include <string>
 #include <cstdio>
+#include <vector>
+
+#ifndef _WIN32
+#include <csignal>
+#include <sys/resource.h>
+#endif
 
 #include "taglib_config.h"
 #include "tfilestream.h"
 #include "tbytevectorstream.h"
+#include "tmappedfilestream.h"
 #include "tag.h"
 #include "fileref.h"
 #include "mpegfile.h"
+#include "id3v2tag.h"
+#include "filetypes.h"
 #ifdef TAGLIB_WITH_VORBIS
 #include "oggflacfile.h"
 #include "vorbisfile.h"
@@ -64,7 +75,11 @@
 #include "dsffile.h"
 #include "dsdifffile.h"
 #endif
+#ifdef TAGLIB_WITH_SHORTEN
+#include "shortenfile.h"
+#endif
 #include <cppunit/extensions/HelperMacros.h>
+#include "plainfile.h"
 #include "utils.h"
 
 using namespace std;
@@ -98,6 +113,70 @@ namespace
     }
   };
 #endif
+
+  // Counts its calls and never creates a file
+  class FilteredResolver : public FileRef::StreamTypeResolver, public FileRef::ResolverFilter
+  {
+  public:
+    FilteredResolver(const StringList &extensions, const List<Signature> &signatures) :
+      m_extensions(extensions), m_signatures(signatures) { }
+
+    File *createFile(FileName, bool, AudioProperties::ReadStyle) const override
+    {
+      ++fileCalls;
+      return nullptr;
+    }
+
+    File *createFileFromStream(IOStream *, bool, AudioProperties::ReadStyle) const override
+    {
+      ++streamCalls;
+      return nullptr;
+    }
+
+    StringList fileExtensions() const override { return m_extensions; }
+    List<Signature> signatures() const override { return m_signatures; }
+
+    mutable std::atomic<int> fileCalls { 0 };
+    mutable std::atomic<int> streamCalls { 0 };
+
+  private:
+    const StringList m_extensions;
+    const List<Signature> m_signatures;
+  };
+
+  // A stream in memory with a file name
+  class NamedStream : public ByteVectorStream
+  {
+  public:
+    NamedStream(const ByteVector &data, const char *name) :
+      ByteVectorStream(data), m_name(name) { }
+
+    FileName name() const override { return m_name.c_str(); }
+
+  private:
+    const string m_name;
+  };
+
+  // Counts the reads from a stream in memory
+  class CountingByteVectorStream : public ByteVectorStream
+  {
+  public:
+    explicit CountingByteVectorStream(const ByteVector &data) : ByteVectorStream(data) { }
+
+    ByteVector readBlock(size_t length) override
+    {
+      ++reads;
+      return ByteVectorStream::readBlock(length);
+    }
+
+    ByteVector readBlockAt(offset_t offset, size_t length) override
+    {
+      ++reads;
+      return ByteVectorStream::readBlockAt(offset, length);
+    }
+
+    unsigned int reads = 0;
+  };
 } // namespace
 
 class TestFileRef : public CppUnit::TestFixture
@@ -108,6 +187,15 @@ class TestFileRef : public CppUnit::TestFixture
   CPPUNIT_TEST(testAudioProperties);
   CPPUNIT_TEST(testDefaultFileExtensions);
   CPPUNIT_TEST(testFileResolver);
+  CPPUNIT_TEST(testFileExtensions);
+  CPPUNIT_TEST(testResolverFilters);
+  CPPUNIT_TEST(testDetectByContent);
+  CPPUNIT_TEST(testDetectReads);
+  CPPUNIT_TEST(testReadMany);
+  CPPUNIT_TEST(testSaveStrategy);
+  CPPUNIT_TEST(testSaveStrategyFailure);
+  CPPUNIT_TEST(testSaveStrategyLinks);
+  CPPUNIT_TEST(testSaveWriteError);
 #ifdef TAGLIB_WITH_ASF
   CPPUNIT_TEST(testASF);
 #endif
@@ -236,6 +324,18 @@ public:
       fileContent = fs.readBlock(fs.length());
     }
 
+    {
+      MappedFileStream ms(newname.c_str());
+      CPPUNIT_ASSERT(ms.isOpen());
+      FileRef f(&ms);
+      CPPUNIT_ASSERT(dynamic_cast<T*>(f.file()));
+      CPPUNIT_ASSERT(!f.isNull());
+      CPPUNIT_ASSERT_EQUAL(f.tag()->artist(), String("test artist"));
+      CPPUNIT_ASSERT_EQUAL(f.tag()->title(), String("test title"));
+      CPPUNIT_ASSERT_EQUAL(f.tag()->track(), static_cast<unsigned int>(5));
+      CPPUNIT_ASSERT_EQUAL(f.tag()->year(), static_cast<unsigned int>(2020));
+    }
+
     {
       ByteVectorStream bs(fileContent);
       FileRef f(&bs);
@@ -506,6 +606,414 @@ public:
     FileRef::clearFileTypeResolvers();
   }
 
+  void testResolverFilters()
+  {
+    FilteredResolver all({}, {});
+    FilteredResolver mp3({ "MP3", "mp2" }, {});
+    FilteredResolver flac({}, List<FileRef::ResolverFilter::Signature>({ { 0, "fLaC" } }));
+    FileRef::addFileTypeResolver(&all);
+    FileRef::addFileTypeResolver(&mp3);
+    FileRef::addFileTypeResolver(&flac);
+
+    {
+      FileRef f(TEST_FILE_PATH_C("xing.mp3"));
+      CPPUNIT_ASSERT(dynamic_cast<MPEG::File *>(f.file()) != nullptr);
+      CPPUNIT_ASSERT_EQUAL(1, all.fileCalls.load());
+      CPPUNIT_ASSERT_EQUAL(1, mp3.fileCalls.load());
+      CPPUNIT_ASSERT_EQUAL(0, flac.fileCalls.load());
+    }
+    {
+      FileStream stream(TEST_FILE_PATH_C("no-tags.flac"), true);
+      FileRef f(&stream);
+      CPPUNIT_ASSERT(!f.isNull());
+      CPPUNIT_ASSERT_EQUAL(1, all.streamCalls.load());
+      CPPUNIT_ASSERT_EQUAL(0, mp3.streamCalls.load());
+      CPPUNIT_ASSERT_EQUAL(1, flac.streamCalls.load());
+      CPPUNIT_ASSERT_EQUAL(1, flac.fileCalls.load());
+    }
+
+    // The candidates of each extension are found once per batch.
+
+    const string flacFile = TEST_FILE_PATH_C("no-tags.flac");
+    List<FileName> fileNames;
+    for(int i = 0; i < 10; ++i)
+      fileNames.append(flacFile.c_str());
+    int read = 0;
+    FileRef::readMany(fileNames, [&read](const FileRef::BatchResult &result) {
+      if(result.status == FileRef::BatchResult::Read)
+        ++read;
+    }, 2);
+    CPPUNIT_ASSERT_EQUAL(10, read);
+    CPPUNIT_ASSERT_EQUAL(12, all.fileCalls.load());
+    CPPUNIT_ASSERT_EQUAL(1, mp3.fileCalls.load());
+    CPPUNIT_ASSERT_EQUAL(11, flac.fileCalls.load());
+
+    FileRef::clearFileTypeResolvers();
+  }
+
+  void testFileExtensions()
+  {
+    const StringList defaultExtensions = FileRef::defaultFileExtensions();
+    for(const auto &extension : defaultExtensions)
+      CPPUNIT_ASSERT(extension.upper() != extension);
+
+    const ByteVector data = PlainFile(TEST_FILE_PATH_C("xing.mp3")).readAll();
+    int calls = 0;
+    const FileRef::FileFactory factory =
+      [&calls](IOStream *stream, bool readProperties, AudioProperties::ReadStyle style) {
+        ++calls;
+        return new MPEG::File(stream, readProperties, style);
+      };
+
+    FileRef::addFileExtension("XyZ", factory);
+    {
+      NamedStream stream(data, "/tmp/dir.mp3/file.xYz");
+      FileRef f(&stream);
+      CPPUNIT_ASSERT(dynamic_cast<MPEG::File *>(f.file()) != nullptr);
+      CPPUNIT_ASSERT_EQUAL(1, calls);
+    }
+    {
+      NamedStream stream(data, "file.mp3");
+      FileRef f(&stream);
+      CPPUNIT_ASSERT(dynamic_cast<MPEG::File *>(f.file()) != nullptr);
+      CPPUNIT_ASSERT_EQUAL(1, calls);
+    }
+
+    // An added extension takes precedence over the default one.
+
+    FileRef::addFileExtension("mp3", factory);
+    {
+      NamedStream stream(data, "FILE.MP3");
+      FileRef f(&stream);
+      CPPUNIT_ASSERT(dynamic_cast<MPEG::File *>(f.file()) != nullptr);
+      CPPUNIT_ASSERT_EQUAL(2, calls);
+    }
+    CPPUNIT_ASSERT(FileRef::defaultFileExtensions() == defaultExtensions);
+
+    FileRef::clearFileExtensions();
+    {
+      NamedStream stream(data, "file.xyz");
+      FileRef f(&stream);
+      CPPUNIT_ASSERT(dynamic_cast<MPEG::File *>(f.file()) != nullptr);
+      NamedStream mp3Stream(data, "file.mp3");
+      FileRef mp3(&mp3Stream);
+      CPPUNIT_ASSERT(dynamic_cast<MPEG::File *>(mp3.file()) != nullptr);
+      CPPUNIT_ASSERT_EQUAL(2, calls);
+    }
+  }
+
+  template <typename T>
+  void detectByContent(const char *fileName)
+  {
+    FileStream fs(TEST_FILE_PATH_C(fileName), true);
+    ByteVector data = fs.readBlock(static_cast<size_t>(fs.length()));
+    ByteVectorStream s(data);
+    FileRef f(&s);
+    CPPUNIT_ASSERT(dynamic_cast<T *>(f.file()) != nullptr);
+    CPPUNIT_ASSERT(f.file()->isValid());
+  }
+
+  void testDetectByContent()
+  {
+    detectByContent<MPEG::File>("xing.mp3");
+    detectByContent<MPEG::File>("ape-id3v2.mp3");
+#ifdef TAGLIB_WITH_VORBIS
+    detectByContent<Ogg::Vorbis::File>("empty.ogg");
+    detectByContent<Ogg::Vorbis::File>("empty_vorbis.oga");
+    detectByContent<Ogg::FLAC::File>("empty_flac.oga");
+    detectByContent<Ogg::Speex::File>("empty.spx");
+    detectByContent<Ogg::Opus::File>("correctness_gain_silent_output.opus");
+    detectByContent<FLAC::File>("silence-44-s.flac");
+#endif
+#ifdef TAGLIB_WITH_APE
+    detectByContent<MPC::File>("click.mpc");
+    detectByContent<WavPack::File>("click.wv");
+    detectByContent<APE::File>("mac-399.ape");
+    detectByContent<APE::File>("mac-399-id3v2.ape");
+#endif
+#ifdef TAGLIB_WITH_ASF
+    detectByContent<ASF::File>("silence-1.wma");
+#endif
+#ifdef TAGLIB_WITH_TRUEAUDIO
+    detectByContent<TrueAudio::File>("empty.tta");
+#endif
+#ifdef TAGLIB_WITH_MP4
+    detectByContent<MP4::File>("has-tags.m4a");
+    detectByContent<MP4::File>("no-tags.3g2");
+#endif
+#ifdef TAGLIB_WITH_RIFF
+    detectByContent<RIFF::WAV::File>("empty.wav");
+    detectByContent<RIFF::AIFF::File>("empty.aiff");
+    detectByContent<RIFF::AIFF::File>("alaw.aifc");
+#endif
+#ifdef TAGLIB_WITH_DSF
+    detectByContent<DSF::File>("empty10ms.dsf");
+    detectByContent<DSDIFF::File>("empty10ms.dff");
+#endif
+#ifdef TAGLIB_WITH_SHORTEN
+    detectByContent<Shorten::File>("2sec-silence.shn");
+#endif
+
+    FileStream fs(TEST_FILE_PATH_C("no-extension"), true);
+    ByteVector data = fs.readBlock(static_cast<size_t>(fs.length()));
+    ByteVectorStream s(data);
+    CPPUNIT_ASSERT(FileRef(&s).isNull());
+  }
+
+  void testDetectReads()
+  {
+    // A small ID3v2 tag is read together with the data after it, a large
+    // one needs a second read.
+
+    const ByteVector audio = PlainFile(TEST_FILE_PATH_C("xing.mp3")).readAll();
+    for(const auto &[titleLength, reads] : { std::pair(100U, 1U), std::pair(20000U, 2U) }) {
+      ID3v2::Tag tag;
+      tag.setTitle(longText(titleLength));
+      CountingByteVectorStream stream(tag.render() + audio);
+      const std::vector<FileTypes::Type> types = FileTypes::detect(&stream);
+      CPPUNIT_ASSERT_EQUAL(reads, stream.reads);
+      CPPUNIT_ASSERT(std::find(types.begin(), types.end(), FileTypes::Type::MPEG) != types.end());
+    }
+  }
+
+  void testReadMany()
+  {
+    const string names[] = {
+      TEST_FILE_PATH_C("xing.mp3"), TEST_FILE_PATH_C("has-tags.m4a"),
+      TEST_FILE_PATH_C("silence-44-s.flac"), TEST_FILE_PATH_C("empty.ogg"),
+      TEST_FILE_PATH_C("click.wv"), TEST_FILE_PATH_C("empty.aiff"),
+      TEST_FILE_PATH_C("unsupported-extension.xx"), TEST_FILE_PATH_C("no-such-file.mp3")
+    };
+
+    List<FileName> fileNames;
+    for(int i = 0; i < 20; ++i) {
+      for(const auto &name : names)
+        fileNames.append(name.c_str());
+    }
+
+    for(unsigned int threadCount : { 1U, 4U, 0U }) {
+      List<FileRef::BatchResult> results;
+      FileRef::readMany(fileNames, [&results](const FileRef::BatchResult &result) {
+        results.append(result);
+      }, threadCount);
+
+      CPPUNIT_ASSERT_EQUAL(fileNames.size(), results.size());
+      std::vector<bool> seen(fileNames.size(), false);
+      for(const auto &result : results) {
+        CPPUNIT_ASSERT(!seen[result.index]);
+        seen[result.index] = true;
+
+        const FileName fileName = fileNames[result.index];
+        const FileRef f(fileName);
+        if(result.index % 8 == 7) {
+          CPPUNIT_ASSERT_EQUAL(FileRef::BatchResult::OpenError, result.status);
+        }
+        else if(result.index % 8 == 6) {
+          CPPUNIT_ASSERT_EQUAL(FileRef::BatchResult::UnknownType, result.status);
+        }
+        else {
+          CPPUNIT_ASSERT_EQUAL(FileRef::BatchResult::Read, result.status);
+          CPPUNIT_ASSERT(f.properties() == result.properties);
+          CPPUNIT_ASSERT_EQUAL(f.complexPropertyKeys(), result.complexPropertyKeys);
+          CPPUNIT_ASSERT_EQUAL(f.audioProperties()->lengthInMilliseconds(),
+                               result.lengthInMilliseconds);
+          CPPUNIT_ASSERT_EQUAL(f.audioProperties()->bitrate(), result.bitrate);
+          CPPUNIT_ASSERT_EQUAL(f.audioProperties()->sampleRate(), result.sampleRate);
+          CPPUNIT_ASSERT_EQUAL(f.audioProperties()->channels(), result.channels);
+        }
+      }
+    }
+
+    {
+      ScopedFileCopy copy("unsupported-extension", ".mp4");
+      FileStream valid(TEST_FILE_PATH_C("empty.wav"), true);
+      FileStream invalid(copy.fileName().c_str(), true);
+      List<IOStream *> streams;
+      streams.append(&valid);
+      streams.append(&invalid);
+      streams.append(nullptr);
+
+      FileRef::BatchResult::Status statuses[3] = {};
+      FileRef::readMany(streams, [&statuses](const FileRef::BatchResult &result) {
+        statuses[result.index] = result.status;
+      }, 2, false);
+      CPPUNIT_ASSERT_EQUAL(FileRef::BatchResult::Read, statuses[0]);
+      CPPUNIT_ASSERT_EQUAL(FileRef::BatchResult::InvalidFile, statuses[1]);
+      CPPUNIT_ASSERT_EQUAL(FileRef::BatchResult::OpenError, statuses[2]);
+    }
+  }
+
+  void testSaveStrategy()
+  {
+    const char *files[][2] = {
+      { "xing", ".mp3" }, { "no-tags", ".flac" }, { "empty", ".ogg" },
+      { "empty", ".wav" }, { "empty", ".aiff" },
+#ifdef TAGLIB_WITH_MP4
+      { "has-tags", ".m4a" },
+#endif
+    };
+    for(const auto &[file, ext] : files) {
+      ScopedFileCopy copy(file, ext);
+      const string rewriteName = copy.fileName();
+      const string inPlaceName = rewriteName + ext;
+      {
+        ifstream source(rewriteName.c_str(), std::ios::binary);
+        ofstream destination(inPlaceName.c_str(), std::ios::binary);
+        destination << source.rdbuf();
+      }
+
+#ifndef _WIN32
+      // The original file is kept open, so that its inode is not reused.
+
+      chmod(rewriteName.c_str(), 0640);
+      ifstream original(rewriteName.c_str(), std::ios::binary);
+      struct stat before;
+      CPPUNIT_ASSERT_EQUAL(0, stat(rewriteName.c_str(), &before));
+#endif
+
+      for(const auto &[name, strategy] : {
+            std::pair(rewriteName, File::Rewrite), std::pair(inPlaceName, File::InPlace) }) {
+        {
+          FileRef f(name.c_str());
+          CPPUNIT_ASSERT(!f.isNull());
+          f.file()->setSaveStrategy(strategy);
+          CPPUNIT_ASSERT_EQUAL(strategy, f.file()->saveStrategy());
+          f.tag()->setTitle(longText(20000));
+          f.tag()->setArtist("artist");
+          CPPUNIT_ASSERT(f.save());
+
+          // The stream refers to the new file after it has been replaced.
+
+          CPPUNIT_ASSERT(f.file()->isOpen());
+          CPPUNIT_ASSERT_EQUAL(FileStream(name.c_str(), true).length(), f.file()->length());
+        }
+        {
+          FileRef f(name.c_str());
+          f.file()->setSaveStrategy(strategy);
+          f.tag()->setTitle("title");
+          f.tag()->setAlbum(longText(100));
+          CPPUNIT_ASSERT(f.save());
+        }
+      }
+
+      CPPUNIT_ASSERT(fileEqual(rewriteName, inPlaceName));
+      {
+        FileRef f(rewriteName.c_str());
+        CPPUNIT_ASSERT_EQUAL(String("title"), f.tag()->title());
+        CPPUNIT_ASSERT_EQUAL(String("artist"), f.tag()->artist());
+      }
+
+#ifndef _WIN32
+      struct stat after;
+      CPPUNIT_ASSERT_EQUAL(0, stat(rewriteName.c_str(), &after));
+      CPPUNIT_ASSERT(before.st_ino != after.st_ino);
+      CPPUNIT_ASSERT_EQUAL(static_cast<mode_t>(0640), after.st_mode & 0777);
+#endif
+
+      deleteFile(inPlaceName);
+    }
+  }
+
+  void testSaveStrategyFailure()
+  {
+#ifndef _WIN32
+    // The name of the file leaves no room for the suffix of the temporary
+    // file, so that it can not be created.
+
+    ScopedFileCopy copy("xing", ".mp3");
+    const string name = copy.fileName() + ".d/" + string(251, 'x') + ".mp3";
+    CPPUNIT_ASSERT_EQUAL(0, mkdir((copy.fileName() + ".d").c_str(), 0700));
+    CPPUNIT_ASSERT_EQUAL(0, rename(copy.fileName().c_str(), name.c_str()));
+
+    MPEG::File f(name.c_str());
+    CPPUNIT_ASSERT(f.isValid());
+    f.setSaveStrategy(File::Rewrite);
+
+    f.ID3v2Tag(true)->setTitle(longText(20000));
+    CPPUNIT_ASSERT(!f.save());
+    CPPUNIT_ASSERT(!f.isValid());
+
+    // The layout of the tags would not match the file any more.
+
+    f.ID3v2Tag()->setTitle("title");
+    CPPUNIT_ASSERT(!f.save());
+
+    CPPUNIT_ASSERT_EQUAL(0, unlink(name.c_str()));
+    CPPUNIT_ASSERT_EQUAL(0, rmdir((copy.fileName() + ".d").c_str()));
+#endif
+  }
+
+  void testSaveWriteError()
+  {
+#ifndef _WIN32
+    // The file can not grow beyond its size, so that moving its data to
+    // make room for the larger tag fails.
+
+    ScopedFileCopy copy("xing", ".mp3");
+    MPEG::File f(copy.fileName().c_str());
+    CPPUNIT_ASSERT(f.isValid());
+    f.setSaveStrategy(File::InPlace);
+    f.ID3v2Tag(true)->setTitle(longText(20000));
+
+    struct rlimit limit;
+    CPPUNIT_ASSERT_EQUAL(0, getrlimit(RLIMIT_FSIZE, &limit));
+    const struct rlimit restricted = { static_cast<rlim_t>(f.length()), limit.rlim_max };
+    const auto handler = signal(SIGXFSZ, SIG_IGN);
+    CPPUNIT_ASSERT_EQUAL(0, setrlimit(RLIMIT_FSIZE, &restricted));
+    const bool saved = f.save();
+    setrlimit(RLIMIT_FSIZE, &limit);
+    signal(SIGXFSZ, handler);
+
+    CPPUNIT_ASSERT(!saved);
+    CPPUNIT_ASSERT(!f.isValid());
+#endif
+  }
+
+  void testSaveStrategyLinks()
+  {
+#ifndef _WIN32
+    ScopedFileCopy copy("xing", ".mp3");
+    const string symbolicLink = copy.fileName() + ".symlink";
+    const string hardLink = copy.fileName() + ".hardlink";
+    CPPUNIT_ASSERT_EQUAL(0, symlink(copy.fileName().c_str(), symbolicLink.c_str()));
+
+    // The file which the symbolic link refers to is replaced.
+    {
+      MPEG::File f(symbolicLink.c_str());
+      f.setSaveStrategy(File::Rewrite);
+      f.ID3v2Tag(true)->setTitle(longText(20000));
+      CPPUNIT_ASSERT(f.save());
+    }
+    struct stat st;
+    CPPUNIT_ASSERT_EQUAL(0, lstat(symbolicLink.c_str(), &st));
+    CPPUNIT_ASSERT(S_ISLNK(st.st_mode));
+    {
+      MPEG::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT_EQUAL(longText(20000), f.ID3v2Tag()->title());
+    }
+    CPPUNIT_ASSERT_EQUAL(0, unlink(symbolicLink.c_str()));
+
+    // A file with several hard links is changed in place.
+
+    CPPUNIT_ASSERT_EQUAL(0, link(copy.fileName().c_str(), hardLink.c_str()));
+    CPPUNIT_ASSERT_EQUAL(0, stat(copy.fileName().c_str(), &st));
+    {
+      MPEG::File f(hardLink.c_str());
+      f.setSaveStrategy(File::Rewrite);
+      f.ID3v2Tag()->setTitle("title");
+      CPPUNIT_ASSERT(f.save());
+    }
+    struct stat after;
+    CPPUNIT_ASSERT_EQUAL(0, stat(hardLink.c_str(), &after));
+    CPPUNIT_ASSERT_EQUAL(st.st_ino, after.st_ino);
+    {
+      MPEG::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT_EQUAL(String("title"), f.ID3v2Tag()->title());
+    }
+    CPPUNIT_ASSERT_EQUAL(0, unlink(hardLink.c_str()));
+#endif
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestFileRef);
@@ -67,6 +67,7 @@ class TestFLAC : public CppUnit::TestFixture
   CPPUNIT_TEST(testRemoveXiphField);
   CPPUNIT_TEST(testEmptySeekTable);
   CPPUNIT_TEST(testPictureStoredAfterComment);
+  CPPUNIT_TEST(testDeferPictureData);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -663,6 +664,60 @@ public:
     CPPUNIT_ASSERT(fileData.startsWith(expectedData));
   }
 
+  void testDeferPictureData()
+  {
+    ByteVector picData(50000, 'x');
+    for(unsigned int i = 0; i < picData.size(); i += 5)
+      picData[i] = static_cast<char>(i);
+
+    ScopedFileCopy copy("no-tags", ".flac");
+    {
+      FLAC::File f(copy.fileName().c_str());
+      auto pic = new FLAC::Picture;
+      pic->setData(picData);
+      pic->setType(FLAC::Picture::FrontCover);
+      pic->setMimeType("image/jpeg");
+      pic->setDescription("large.jpg");
+      pic->setWidth(300);
+      pic->setHeight(200);
+      f.addPicture(pic);
+      pic = new FLAC::Picture;
+      pic->setData("small");
+      pic->setType(FLAC::Picture::BackCover);
+      f.addPicture(pic);
+      f.xiphComment(true)->setTitle("Title");
+      f.save();
+    }
+    {
+      FLAC::File f(copy.fileName().c_str(), true, FLAC::Properties::Average,
+                   nullptr, File::DeferPayloads);
+      CPPUNIT_ASSERT(f.isValid());
+      const List<FLAC::Picture *> pictures = f.pictureList();
+      CPPUNIT_ASSERT_EQUAL(2U, pictures.size());
+      CPPUNIT_ASSERT_EQUAL(FLAC::Picture::FrontCover, pictures[0]->type());
+      CPPUNIT_ASSERT_EQUAL(String("image/jpeg"), pictures[0]->mimeType());
+      CPPUNIT_ASSERT_EQUAL(String("large.jpg"), pictures[0]->description());
+      CPPUNIT_ASSERT_EQUAL(300, pictures[0]->width());
+      CPPUNIT_ASSERT_EQUAL(200, pictures[0]->height());
+      CPPUNIT_ASSERT_EQUAL(FLAC::Picture::BackCover, pictures[1]->type());
+      CPPUNIT_ASSERT_EQUAL(ByteVector("small"), pictures[1]->data());
+
+      // The picture data, which was not used, is read when the file is saved.
+      f.xiphComment()->setTitle("New Title");
+      f.save();
+    }
+    {
+      FLAC::File f(copy.fileName().c_str(), true, FLAC::Properties::Average,
+                   nullptr, File::DeferPayloads);
+      CPPUNIT_ASSERT_EQUAL(String("New Title"), f.xiphComment()->title());
+      const List<FLAC::Picture *> pictures = f.pictureList();
+      CPPUNIT_ASSERT_EQUAL(2U, pictures.size());
+      CPPUNIT_ASSERT_EQUAL(picData, pictures[0]->data());
+      CPPUNIT_ASSERT_EQUAL(picData, pictures[0]->data());
+      CPPUNIT_ASSERT_EQUAL(String("large.jpg"), pictures[0]->description());
+    }
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestFLAC);
@@ -0,0 +1,134 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include "tmappedfilestream.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include "utils.h"
+
+using namespace std;
+using namespace TagLib;
+
+class TestMappedFileStream : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestMappedFileStream);
+  CPPUNIT_TEST(testReadBlock);
+  CPPUNIT_TEST(testSeek);
+  CPPUNIT_TEST(testReadOnly);
+  CPPUNIT_TEST(testEmptyFile);
+  CPPUNIT_TEST(testNonExistent);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void testReadBlock()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    {
+      ofstream out(copy.fileName().c_str(), ios::binary | ios::trunc);
+      out << "abcdefgh";
+    }
+
+    MappedFileStream stream(copy.fileName().c_str());
+    CPPUNIT_ASSERT(stream.isOpen());
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(8), stream.length());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abc"), stream.readBlock(3));
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(3), stream.tell());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("defgh"), stream.readBlock(100));
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(8), stream.tell());
+    CPPUNIT_ASSERT_EQUAL(ByteVector(), stream.readBlock(1));
+
+    CPPUNIT_ASSERT_EQUAL(ByteVector("cde"), stream.readBlockAt(2, 3));
+    CPPUNIT_ASSERT_EQUAL(ByteVector("gh"), stream.readBlockAt(6, 100));
+    CPPUNIT_ASSERT_EQUAL(ByteVector(), stream.readBlockAt(8, 1));
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(8), stream.tell());
+  }
+
+  void testSeek()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    {
+      ofstream out(copy.fileName().c_str(), ios::binary | ios::trunc);
+      out << "abcdefgh";
+    }
+
+    MappedFileStream stream(copy.fileName().c_str());
+    stream.seek(-2, IOStream::End);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(6), stream.tell());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("gh"), stream.readBlock(2));
+    stream.seek(-4, IOStream::Current);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("ef"), stream.readBlock(2));
+    stream.seek(1);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("b"), stream.readBlock(1));
+    stream.seek(20);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(20), stream.tell());
+    CPPUNIT_ASSERT_EQUAL(ByteVector(), stream.readBlock(1));
+  }
+
+  void testReadOnly()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    {
+      ofstream out(copy.fileName().c_str(), ios::binary | ios::trunc);
+      out << "abcd";
+    }
+
+    {
+      MappedFileStream stream(copy.fileName().c_str());
+      CPPUNIT_ASSERT(stream.readOnly());
+      stream.writeBlock(ByteVector("xx"));
+      stream.insert(ByteVector("yy"), 1);
+      stream.removeBlock(0, 2);
+      stream.truncate(1);
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(4), stream.length());
+      CPPUNIT_ASSERT_EQUAL(ByteVector("abcd"), stream.readBlock(4));
+    }
+
+    ifstream in(copy.fileName().c_str(), ios::binary);
+    string content((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    CPPUNIT_ASSERT_EQUAL(string("abcd"), content);
+  }
+
+  void testEmptyFile()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    {
+      ofstream out(copy.fileName().c_str(), ios::binary | ios::trunc);
+    }
+
+    MappedFileStream stream(copy.fileName().c_str());
+    CPPUNIT_ASSERT(stream.isOpen());
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(0), stream.length());
+    CPPUNIT_ASSERT_EQUAL(ByteVector(), stream.readBlock(10));
+  }
+
+  void testNonExistent()
+  {
+    MappedFileStream stream(TEST_FILE_PATH_C("doesnotexist.mp3"));
+    CPPUNIT_ASSERT(!stream.isOpen());
+    CPPUNIT_ASSERT_EQUAL(ByteVector(), stream.readBlock(10));
+  }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestMappedFileStream);
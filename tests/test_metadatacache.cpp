@@ -0,0 +1,351 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#include <cstdio>
+
+#include "tpropertymap.h"
+#include "tag.h"
+#include "fileref.h"
+#include "metadatacache.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include "plainfile.h"
+#include "utils.h"
+
+using namespace std;
+using namespace TagLib;
+
+namespace
+{
+  FileRef::BatchResult readFile(const string &fileName)
+  {
+    FileRef::BatchResult result;
+    FileRef::readMany(List<FileName>({ fileName.c_str() }),
+                      [&result](const FileRef::BatchResult &r) { result = r; }, 1);
+    return result;
+  }
+
+  bool resultEqual(const FileRef::BatchResult &r1, const FileRef::BatchResult &r2)
+  {
+    return r1.status == r2.status &&
+      r1.properties == r2.properties &&
+      r1.complexPropertyKeys == r2.complexPropertyKeys &&
+      r1.lengthInMilliseconds == r2.lengthInMilliseconds &&
+      r1.bitrate == r2.bitrate &&
+      r1.sampleRate == r2.sampleRate &&
+      r1.channels == r2.channels;
+  }
+}  // namespace
+
+class TestMetadataCache : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestMetadataCache);
+  CPPUNIT_TEST(testInsertAndFind);
+  CPPUNIT_TEST(testPersistence);
+  CPPUNIT_TEST(testChangedFile);
+  CPPUNIT_TEST(testTruncatedRecord);
+  CPPUNIT_TEST(testNotACacheFile);
+  CPPUNIT_TEST(testCompact);
+  CPPUNIT_TEST(testSharedFile);
+  CPPUNIT_TEST(testReadMany);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void testInsertAndFind()
+  {
+    ScopedTempFile tempFile("metadata.cache");
+    ScopedFileCopy mp3("xing", ".mp3");
+    MetadataCache cache(tempFile.fileName().c_str());
+    CPPUNIT_ASSERT(cache.isOpen());
+    CPPUNIT_ASSERT_EQUAL(0U, cache.size());
+
+    FileRef::BatchResult result;
+    CPPUNIT_ASSERT(!cache.find(mp3.fileName().c_str(), result));
+
+    FileRef::BatchResult read = readFile(mp3.fileName());
+    read.properties["TITLE"] = String("T\xc3\xaftle", String::UTF8);
+    read.complexPropertyKeys.append("PICTURE");
+    cache.insert(mp3.fileName().c_str(), read);
+    CPPUNIT_ASSERT_EQUAL(1U, cache.size());
+
+    result.index = 7;
+    CPPUNIT_ASSERT(cache.find(mp3.fileName().c_str(), result));
+    CPPUNIT_ASSERT(resultEqual(read, result));
+    CPPUNIT_ASSERT_EQUAL(7U, result.index);
+
+    // Results without audio properties are only found if they are not needed.
+    ScopedFileCopy flac("silence-44-s", ".flac");
+    cache.insert(flac.fileName().c_str(), readFile(flac.fileName()), false);
+    CPPUNIT_ASSERT(!cache.find(flac.fileName().c_str(), result));
+    CPPUNIT_ASSERT(cache.find(flac.fileName().c_str(), result, false));
+
+    // Files of unknown type are found as well.
+    ScopedFileCopy unsupported("unsupported-extension", ".xx");
+    const FileRef::BatchResult unknown = readFile(unsupported.fileName());
+    CPPUNIT_ASSERT_EQUAL(FileRef::BatchResult::UnknownType, unknown.status);
+    cache.insert(unsupported.fileName().c_str(), unknown);
+    CPPUNIT_ASSERT(cache.find(unsupported.fileName().c_str(), result));
+    CPPUNIT_ASSERT_EQUAL(FileRef::BatchResult::UnknownType, result.status);
+
+    // Files which could not be opened are not stored.
+    const string missing = testFilePath("no-such-file.mp3");
+    cache.insert(missing.c_str(), readFile(missing));
+    CPPUNIT_ASSERT_EQUAL(3U, cache.size());
+  }
+
+  void testPersistence()
+  {
+    ScopedTempFile tempFile("metadata.cache");
+    ScopedFileCopy mp3("xing", ".mp3");
+    const string cacheFile = tempFile.fileName();
+    const FileRef::BatchResult read = readFile(mp3.fileName());
+    {
+      MetadataCache cache(cacheFile.c_str());
+      cache.insert(mp3.fileName().c_str(), read);
+    }
+    MetadataCache cache(cacheFile.c_str());
+    CPPUNIT_ASSERT(cache.isOpen());
+    CPPUNIT_ASSERT_EQUAL(1U, cache.size());
+    FileRef::BatchResult result;
+    CPPUNIT_ASSERT(cache.find(mp3.fileName().c_str(), result));
+    CPPUNIT_ASSERT(resultEqual(read, result));
+  }
+
+  void testChangedFile()
+  {
+    ScopedTempFile tempFile("metadata.cache");
+    ScopedFileCopy mp3("xing", ".mp3");
+    ScopedFileCopy flac("silence-44-s", ".flac");
+    MetadataCache cache(tempFile.fileName().c_str());
+    cache.insert(mp3.fileName().c_str(), readFile(mp3.fileName()));
+    cache.insert(flac.fileName().c_str(), readFile(flac.fileName()));
+
+    const string mp3File = mp3.fileName();
+    const string flacFile = flac.fileName();
+    const string missing = testFilePath("no-such-file.mp3");
+    const List<FileName> fileNames = { mp3File.c_str(), flacFile.c_str(), missing.c_str() };
+    CPPUNIT_ASSERT_EQUAL(List<unsigned int>({ 2U }), cache.validate(fileNames));
+
+    {
+      FileRef f(mp3.fileName().c_str());
+      f.tag()->setTitle("Changed");
+      f.save();
+    }
+    List<unsigned int> expected;
+    expected.append(0U);
+    expected.append(2U);
+    CPPUNIT_ASSERT_EQUAL(expected, cache.validate(fileNames));
+
+    FileRef::BatchResult result;
+    CPPUNIT_ASSERT(!cache.find(mp3.fileName().c_str(), result));
+    CPPUNIT_ASSERT(cache.find(flac.fileName().c_str(), result));
+
+    cache.insert(mp3.fileName().c_str(), readFile(mp3.fileName()));
+    CPPUNIT_ASSERT(cache.find(mp3.fileName().c_str(), result));
+    CPPUNIT_ASSERT_EQUAL(String("Changed"), result.properties["TITLE"].front());
+    CPPUNIT_ASSERT_EQUAL(List<unsigned int>({ 2U }), cache.validate(fileNames));
+  }
+
+  void testTruncatedRecord()
+  {
+    ScopedTempFile tempFile("metadata.cache");
+    ScopedFileCopy mp3("xing", ".mp3");
+    ScopedFileCopy flac("silence-44-s", ".flac");
+    const string cacheFile = tempFile.fileName();
+    {
+      MetadataCache cache(cacheFile.c_str());
+      cache.insert(mp3.fileName().c_str(), readFile(mp3.fileName()));
+      CPPUNIT_ASSERT(cache.flush());
+      cache.insert(flac.fileName().c_str(), readFile(flac.fileName()));
+    }
+
+    // Cut off the end of the last record, as if writing it was interrupted.
+    ByteVector data = PlainFile(cacheFile.c_str()).readAll();
+    data.resize(data.size() - 5);
+    {
+      ofstream out(cacheFile.c_str(), ios::binary | ios::trunc);
+      out.write(data.data(), data.size());
+    }
+    {
+      MetadataCache cache(cacheFile.c_str());
+      CPPUNIT_ASSERT(cache.isOpen());
+      CPPUNIT_ASSERT_EQUAL(1U, cache.size());
+      FileRef::BatchResult result;
+      CPPUNIT_ASSERT(cache.find(mp3.fileName().c_str(), result));
+      CPPUNIT_ASSERT(!cache.find(flac.fileName().c_str(), result));
+
+      // The torn record is overwritten by the next one.
+      cache.insert(flac.fileName().c_str(), readFile(flac.fileName()));
+    }
+    MetadataCache cache(cacheFile.c_str());
+    CPPUNIT_ASSERT_EQUAL(2U, cache.size());
+    FileRef::BatchResult result;
+    CPPUNIT_ASSERT(cache.find(flac.fileName().c_str(), result));
+
+    // A corrupted record is dropped along with those after it.
+    data = PlainFile(cacheFile.c_str()).readAll();
+    data[20] = static_cast<char>(data[20] ^ 0xff);
+    {
+      ofstream out(cacheFile.c_str(), ios::binary | ios::trunc);
+      out.write(data.data(), data.size());
+    }
+    MetadataCache corrupted(cacheFile.c_str());
+    CPPUNIT_ASSERT(corrupted.isOpen());
+    CPPUNIT_ASSERT_EQUAL(0U, corrupted.size());
+  }
+
+  void testNotACacheFile()
+  {
+    ScopedFileCopy copy("xing", ".mp3");
+    {
+      MetadataCache cache(copy.fileName().c_str());
+      CPPUNIT_ASSERT(!cache.isOpen());
+      CPPUNIT_ASSERT_EQUAL(0U, cache.size());
+      cache.insert(copy.fileName().c_str(), readFile(copy.fileName()));
+      FileRef::BatchResult result;
+      CPPUNIT_ASSERT(!cache.find(copy.fileName().c_str(), result));
+      CPPUNIT_ASSERT(!cache.compact());
+    }
+    CPPUNIT_ASSERT(fileEqual(copy.fileName(), TEST_FILE_PATH_C("xing.mp3")));
+  }
+
+  void testCompact()
+  {
+    ScopedTempFile tempFile("metadata.cache");
+    ScopedFileCopy mp3("xing", ".mp3");
+    const string cacheFile = tempFile.fileName();
+    const string flacFile = copyFile("silence-44-s", ".flac");
+    MetadataCache cache(cacheFile.c_str());
+    for(int i = 0; i < 10; ++i)
+      cache.insert(mp3.fileName().c_str(), readFile(mp3.fileName()));
+    cache.insert(flacFile.c_str(), readFile(flacFile));
+    CPPUNIT_ASSERT(cache.flush());
+    const long long fullSize = PlainFile(cacheFile.c_str()).readAll().size();
+
+    deleteFile(flacFile);
+    CPPUNIT_ASSERT(cache.compact());
+    CPPUNIT_ASSERT(cache.isOpen());
+    CPPUNIT_ASSERT_EQUAL(1U, cache.size());
+    const long long compactSize = PlainFile(cacheFile.c_str()).readAll().size();
+    CPPUNIT_ASSERT(compactSize < fullSize / 5);
+
+    FileRef::BatchResult result;
+    CPPUNIT_ASSERT(cache.find(mp3.fileName().c_str(), result));
+    CPPUNIT_ASSERT(resultEqual(readFile(mp3.fileName()), result));
+
+    // The cache can still be added to after compacting.
+    ScopedFileCopy flac("silence-44-s", ".flac");
+    cache.insert(flac.fileName().c_str(), readFile(flac.fileName()));
+    CPPUNIT_ASSERT(cache.flush());
+    MetadataCache reopened(cacheFile.c_str());
+    CPPUNIT_ASSERT_EQUAL(2U, reopened.size());
+  }
+
+  void testSharedFile()
+  {
+    // Two caches with the same file behave like two processes, they take
+    // turns appending and see each other's records when flushing.
+
+    ScopedTempFile tempFile("metadata.cache");
+    ScopedFileCopy mp3("xing", ".mp3");
+    ScopedFileCopy flac("silence-44-s", ".flac");
+    ScopedFileCopy ogg("empty", ".ogg");
+    const string cacheFile = tempFile.fileName();
+    FileRef::BatchResult result;
+
+    MetadataCache first(cacheFile.c_str());
+    MetadataCache second(cacheFile.c_str());
+    CPPUNIT_ASSERT(first.isOpen());
+    CPPUNIT_ASSERT(second.isOpen());
+    first.insert(mp3.fileName().c_str(), readFile(mp3.fileName()));
+    second.insert(flac.fileName().c_str(), readFile(flac.fileName()));
+    CPPUNIT_ASSERT(first.flush());
+    CPPUNIT_ASSERT(second.flush());
+    CPPUNIT_ASSERT_EQUAL(1U, first.size());
+    CPPUNIT_ASSERT_EQUAL(2U, second.size());
+    CPPUNIT_ASSERT(second.find(mp3.fileName().c_str(), result));
+    CPPUNIT_ASSERT(resultEqual(readFile(mp3.fileName()), result));
+    CPPUNIT_ASSERT(second.find(flac.fileName().c_str(), result));
+    CPPUNIT_ASSERT(resultEqual(readFile(flac.fileName()), result));
+    {
+      MetadataCache reopened(cacheFile.c_str());
+      CPPUNIT_ASSERT_EQUAL(2U, reopened.size());
+    }
+
+    // The records which are pending when the other cache compacts the file
+    // are written to the new file.
+
+    first.insert(ogg.fileName().c_str(), readFile(ogg.fileName()));
+    CPPUNIT_ASSERT(second.compact());
+    CPPUNIT_ASSERT(first.flush());
+    CPPUNIT_ASSERT_EQUAL(3U, first.size());
+    CPPUNIT_ASSERT(first.find(flac.fileName().c_str(), result));
+    CPPUNIT_ASSERT(resultEqual(readFile(flac.fileName()), result));
+    CPPUNIT_ASSERT(first.find(ogg.fileName().c_str(), result));
+    CPPUNIT_ASSERT(resultEqual(readFile(ogg.fileName()), result));
+    {
+      MetadataCache reopened(cacheFile.c_str());
+      CPPUNIT_ASSERT_EQUAL(3U, reopened.size());
+    }
+  }
+
+  void testReadMany()
+  {
+    ScopedTempFile tempFile("metadata.cache");
+    const string cacheFile = tempFile.fileName();
+    const string names[] = {
+      TEST_FILE_PATH_C("xing.mp3"), TEST_FILE_PATH_C("has-tags.m4a"),
+      TEST_FILE_PATH_C("silence-44-s.flac"), TEST_FILE_PATH_C("empty.ogg"),
+      TEST_FILE_PATH_C("unsupported-extension.xx"), TEST_FILE_PATH_C("no-such-file.mp3")
+    };
+    List<FileName> fileNames;
+    for(const auto &name : names)
+      fileNames.append(name.c_str());
+
+    vector<FileRef::BatchResult> expected(fileNames.size());
+    FileRef::readMany(fileNames, [&expected](const FileRef::BatchResult &result) {
+      expected[result.index] = result;
+    });
+
+    MetadataCache cache(cacheFile.c_str());
+    CPPUNIT_ASSERT_EQUAL(fileNames.size(), cache.validate(fileNames).size());
+
+    for(int pass = 0; pass < 2; ++pass) {
+      vector<FileRef::BatchResult> results(fileNames.size());
+      FileRef::readMany(fileNames, [&results](const FileRef::BatchResult &result) {
+        results[result.index] = result;
+      }, 0, true, AudioProperties::Average, &cache);
+      for(unsigned int i = 0; i < fileNames.size(); ++i) {
+        CPPUNIT_ASSERT_EQUAL(i, results[i].index);
+        CPPUNIT_ASSERT(resultEqual(expected[i], results[i]));
+      }
+      // Only the missing file is left to be read.
+      CPPUNIT_ASSERT_EQUAL(List<unsigned int>({ 5U }), cache.validate(fileNames));
+    }
+  }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestMetadataCache);
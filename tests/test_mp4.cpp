@@ -102,6 +102,7 @@ class TestMP4 : public CppUnit::TestFixture
   CPPUNIT_TEST(testNonFullMetaAtom);
   CPPUNIT_TEST(testItemFactory);
   CPPUNIT_TEST(testNonPrintableAtom);
+  CPPUNIT_TEST(testReadStyleFast);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -874,6 +875,77 @@ public:
         CPPUNIT_ASSERT_EQUAL(String("TITLE"), f.tag()->title());
     }
   }
+
+  void testReadStyleFast()
+  {
+    // Append a fragment with a base data offset in its track fragment header
+    // to a file which has "moov" before "mdat".
+    ByteVector data = PlainFile(TEST_FILE_PATH_C("nonprintable-atom-type.m4a")).readAll();
+    const unsigned int moofOffset = data.size();
+    const ByteVector mfhd = ByteVector::fromUInt(16U) + ByteVector("mfhd") +
+      ByteVector::fromUInt(0U) + ByteVector::fromUInt(1U);
+    const ByteVector tfhd = ByteVector::fromUInt(24U) + ByteVector("tfhd") +
+      ByteVector::fromUInt(1U) + ByteVector::fromUInt(1U) +
+      ByteVector::fromLongLong(moofOffset + 56);
+    data.append(ByteVector::fromUInt(56U) + ByteVector("moof") + mfhd +
+                ByteVector::fromUInt(32U) + ByteVector("traf") + tfhd);
+    data.append(ByteVector::fromUInt(12U) + ByteVector("mdat") + ByteVector("data"));
+
+    ByteVectorStream fastStream(data);
+    ByteVectorStream averageStream(data);
+    {
+      MP4::File fast(&fastStream, true, MP4::Properties::Fast);
+      MP4::File average(&averageStream, true, MP4::Properties::Average);
+      CPPUNIT_ASSERT(fast.isValid());
+      CPPUNIT_ASSERT(average.isValid());
+      CPPUNIT_ASSERT_EQUAL(average.audioProperties()->lengthInMilliseconds(),
+                           fast.audioProperties()->lengthInMilliseconds());
+      CPPUNIT_ASSERT_EQUAL(average.audioProperties()->bitrate(),
+                           fast.audioProperties()->bitrate());
+      CPPUNIT_ASSERT_EQUAL(32000, fast.audioProperties()->sampleRate());
+      CPPUNIT_ASSERT_EQUAL(1, fast.audioProperties()->channels());
+      CPPUNIT_ASSERT(!fast.hasMP4Tag());
+
+      // The fragments are read before saving to update their offsets.
+      fast.tag()->setTitle("TITLE");
+      average.tag()->setTitle("TITLE");
+      CPPUNIT_ASSERT(fast.save());
+      CPPUNIT_ASSERT(average.save());
+      CPPUNIT_ASSERT(fast.hasMP4Tag());
+    }
+    CPPUNIT_ASSERT(*averageStream.data() == *fastStream.data());
+    const ByteVector &saved = *fastStream.data();
+    const unsigned int delta = saved.size() - data.size();
+    CPPUNIT_ASSERT(delta > 0);
+    CPPUNIT_ASSERT_EQUAL(static_cast<long long>(moofOffset + delta + 56),
+                         saved.toLongLong(static_cast<unsigned int>(saved.find("tfhd") + 12)));
+
+    // Without a nominal bitrate, the bitrate is not calculated from "mdat".
+    ByteVector alacData = PlainFile(TEST_FILE_PATH_C("empty_alac.m4a")).readAll();
+    CPPUNIT_ASSERT_EQUAL(ByteVector("alac"), alacData.mid(446, 4));
+    for(int offset = 470; offset < 474; ++offset) {
+      alacData[offset] = 0;
+    }
+    ByteVectorStream alacStream(alacData);
+    MP4::File f(&alacStream, true, MP4::Properties::Fast);
+    CPPUNIT_ASSERT_EQUAL(3705, f.audioProperties()->lengthInMilliseconds());
+    CPPUNIT_ASSERT_EQUAL(0, f.audioProperties()->bitrate());
+    CPPUNIT_ASSERT_EQUAL(44100, f.audioProperties()->sampleRate());
+
+    // The same for AAC with an average bitrate of zero in "esds".
+    ByteVector aacData = PlainFile(TEST_FILE_PATH_C("no-tags.m4a")).readAll();
+    CPPUNIT_ASSERT_EQUAL(2914U, aacData.toUInt(1964U));
+    for(int offset = 1964; offset < 1968; ++offset) {
+      aacData[offset] = 0;
+    }
+    ByteVectorStream aacFastStream(aacData);
+    ByteVectorStream aacAverageStream(aacData);
+    MP4::File aacFast(&aacFastStream, true, MP4::Properties::Fast);
+    MP4::File aacAverage(&aacAverageStream, true, MP4::Properties::Average);
+    CPPUNIT_ASSERT_EQUAL(MP4::Properties::AAC, aacFast.audioProperties()->codec());
+    CPPUNIT_ASSERT_EQUAL(0, aacFast.audioProperties()->bitrate());
+    CPPUNIT_ASSERT(aacAverage.audioProperties()->bitrate() > 0);
+  }
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestMP4);
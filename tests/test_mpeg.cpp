@@ -25,11 +25,15 @@
 
 #include <string>
 #include <cstdio>
+#include <algorithm>
 #include <array>
+#include <thread>
+#include <vector>
 
 #include "taglib_config.h"
 #include "tstring.h"
 #include "tpropertymap.h"
+#include "tbytevectorstream.h"
 #include "mpegfile.h"
 #include "id3v2tag.h"
 #include "id3v1tag.h"
@@ -39,20 +43,53 @@
 #include "mpegproperties.h"
 #include "xingheader.h"
 #include "mpegheader.h"
+#include "mpegframescanner.h"
 #include "id3v2extendedheader.h"
+#include "attachedpictureframe.h"
+#include "commentsframe.h"
+#include "generalencapsulatedobjectframe.h"
+#include "privateframe.h"
 #include <cppunit/extensions/HelperMacros.h>
+#include "plainfile.h"
 #include "utils.h"
 
 using namespace std;
 using namespace TagLib;
 
+namespace
+{
+  // Counts the reads from a stream in memory
+  class CountingByteVectorStream : public ByteVectorStream
+  {
+  public:
+    explicit CountingByteVectorStream(const ByteVector &data) : ByteVectorStream(data) { }
+
+    ByteVector readBlock(size_t length) override
+    {
+      ++reads;
+      return ByteVectorStream::readBlock(length);
+    }
+
+    ByteVector readBlockAt(offset_t offset, size_t length) override
+    {
+      ++reads;
+      return ByteVectorStream::readBlockAt(offset, length);
+    }
+
+    unsigned int reads = 0;
+  };
+}  // namespace
+
 class TestMPEG : public CppUnit::TestFixture
 {
   CPPUNIT_TEST_SUITE(TestMPEG);
   CPPUNIT_TEST(testAudioPropertiesXingHeaderCBR);
   CPPUNIT_TEST(testAudioPropertiesXingHeaderVBR);
   CPPUNIT_TEST(testAudioPropertiesVBRIHeader);
+  CPPUNIT_TEST(testXingHeaderTables);
+  CPPUNIT_TEST(testVBRIHeaderTables);
   CPPUNIT_TEST(testAudioPropertiesNoVBRHeaders);
+  CPPUNIT_TEST(testAudioPropertiesITunSMPB);
   CPPUNIT_TEST(testAudioPropertiesADTS);
   CPPUNIT_TEST(testSkipInvalidFrames1);
   CPPUNIT_TEST(testSkipInvalidFrames2);
@@ -63,6 +100,12 @@ class TestMPEG : public CppUnit::TestFixture
   CPPUNIT_TEST(testDuplicateID3v2);
   CPPUNIT_TEST(testFuzzedFile);
   CPPUNIT_TEST(testFrameOffset);
+  CPPUNIT_TEST(testHeaderFromData);
+  CPPUNIT_TEST(testJunkBeforeFrames);
+  CPPUNIT_TEST(testVBRWithoutXingHeader);
+  CPPUNIT_TEST(testSegmentedFrameCount);
+  CPPUNIT_TEST(testADTSFrameCountAcrossChunks);
+  CPPUNIT_TEST(testFrameIndex);
   CPPUNIT_TEST(testStripAndProperties);
   CPPUNIT_TEST(testProperties);
   CPPUNIT_TEST(testRepeatedSave1);
@@ -77,6 +120,8 @@ class TestMPEG : public CppUnit::TestFixture
   CPPUNIT_TEST(testExtendedHeader);
   CPPUNIT_TEST(testReadStyleFast);
   CPPUNIT_TEST(testID3v22Properties);
+  CPPUNIT_TEST(testDeferPayloads);
+  CPPUNIT_TEST(testDeferPayloadsStripped);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -86,7 +131,7 @@ public:
     MPEG::File f(TEST_FILE_PATH_C("lame_cbr.mp3"));
     CPPUNIT_ASSERT(f.audioProperties());
     CPPUNIT_ASSERT_EQUAL(1887, f.audioProperties()->lengthInSeconds());
-    CPPUNIT_ASSERT_EQUAL(1887164, f.audioProperties()->lengthInMilliseconds());
+    CPPUNIT_ASSERT_EQUAL(1887138, f.audioProperties()->lengthInMilliseconds());
     CPPUNIT_ASSERT_EQUAL(64, f.audioProperties()->bitrate());
     CPPUNIT_ASSERT_EQUAL(1, f.audioProperties()->channels());
     CPPUNIT_ASSERT_EQUAL(44100, f.audioProperties()->sampleRate());
@@ -99,12 +144,16 @@ public:
     MPEG::File f(TEST_FILE_PATH_C("lame_vbr.mp3"));
     CPPUNIT_ASSERT(f.audioProperties());
     CPPUNIT_ASSERT_EQUAL(1887, f.audioProperties()->lengthInSeconds());
-    CPPUNIT_ASSERT_EQUAL(1887164, f.audioProperties()->lengthInMilliseconds());
+    CPPUNIT_ASSERT_EQUAL(1887138, f.audioProperties()->lengthInMilliseconds());
     CPPUNIT_ASSERT_EQUAL(70, f.audioProperties()->bitrate());
     CPPUNIT_ASSERT_EQUAL(1, f.audioProperties()->channels());
     CPPUNIT_ASSERT_EQUAL(44100, f.audioProperties()->sampleRate());
     CPPUNIT_ASSERT_EQUAL(MPEG::XingHeader::Xing, f.audioProperties()->xingHeader()->type());
     CPPUNIT_ASSERT(!f.audioProperties()->isADTS());
+    CPPUNIT_ASSERT_EQUAL(576, f.audioProperties()->encoderDelay());
+    CPPUNIT_ASSERT_EQUAL(576, f.audioProperties()->encoderPadding());
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned short>(0x753f), f.audioProperties()->musicCRC());
+    CPPUNIT_ASSERT_EQUAL(72243ULL * 1152 - 576 - 576, f.audioProperties()->totalSamples());
   }
 
   void testAudioPropertiesVBRIHeader()
@@ -120,6 +169,47 @@ public:
     CPPUNIT_ASSERT(!f.audioProperties()->isADTS());
   }
 
+  void testXingHeaderTables()
+  {
+    MPEG::File f(TEST_FILE_PATH_C("lame_vbr.mp3"));
+    const MPEG::XingHeader *xingHeader = f.audioProperties()->xingHeader();
+    CPPUNIT_ASSERT_EQUAL(100U, xingHeader->tableOfContents().size());
+    CPPUNIT_ASSERT_EQUAL(2, static_cast<int>(xingHeader->tableOfContents()[1]));
+    CPPUNIT_ASSERT(xingHeader->seekTable().isEmpty());
+    CPPUNIT_ASSERT_EQUAL(String("LAME3.99r"), xingHeader->encoderVersion());
+    CPPUNIT_ASSERT_EQUAL(576, xingHeader->encoderDelay());
+    CPPUNIT_ASSERT_EQUAL(576, xingHeader->encoderPadding());
+    CPPUNIT_ASSERT_EQUAL(16578604U, xingHeader->musicLength());
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned short>(0x753f), xingHeader->musicCRC());
+
+    const MPEG::FrameIndex index = f.tableOfContentsIndex();
+    CPPUNIT_ASSERT(!index.isExact());
+    CPPUNIT_ASSERT_EQUAL(100U, index.size());
+    CPPUNIT_ASSERT_EQUAL(1152U, index.samplesPerFrame());
+    CPPUNIT_ASSERT_EQUAL(722ULL, index.entry(1).frame);
+    CPPUNIT_ASSERT_EQUAL(722ULL * 1152, index.entry(1).sample);
+    CPPUNIT_ASSERT_EQUAL(f.firstFrameOffset() + 2 * 16578604 / 256, index.entry(1).offset);
+    CPPUNIT_ASSERT_EQUAL(0U, index.entry(1).length);
+    CPPUNIT_ASSERT_EQUAL(index.entry(1).offset, index.find(722 * 1152 + 1000).offset);
+  }
+
+  void testVBRIHeaderTables()
+  {
+    MPEG::File f(TEST_FILE_PATH_C("rare_frames.mp3"));
+    const MPEG::XingHeader *xingHeader = f.audioProperties()->xingHeader();
+    CPPUNIT_ASSERT(xingHeader->tableOfContents().isEmpty());
+    CPPUNIT_ASSERT_EQUAL(132U, xingHeader->seekTable().size());
+    CPPUNIT_ASSERT_EQUAL(39089U, xingHeader->seekTable().front());
+    CPPUNIT_ASSERT_EQUAL(64U, xingHeader->seekTableFramesPerEntry());
+    CPPUNIT_ASSERT_EQUAL(3505, xingHeader->encoderDelay());
+    CPPUNIT_ASSERT(xingHeader->encoderVersion().isEmpty());
+
+    const MPEG::FrameIndex index = f.tableOfContentsIndex();
+    CPPUNIT_ASSERT_EQUAL(133U, index.size());
+    CPPUNIT_ASSERT_EQUAL(64ULL, index.entry(1).frame);
+    CPPUNIT_ASSERT_EQUAL(index.entry(0).offset + 39089, index.entry(1).offset);
+  }
+
   void testAudioPropertiesNoVBRHeaders()
   {
     MPEG::File f(TEST_FILE_PATH_C("bladeenc.mp3"));
@@ -139,6 +229,58 @@ public:
     CPPUNIT_ASSERT_EQUAL(209, lastHeader.frameLength());
   }
 
+  void testAudioPropertiesITunSMPB()
+  {
+    ScopedFileCopy copy("bladeenc", ".mp3");
+
+    {
+      MPEG::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT_EQUAL(0, f.audioProperties()->encoderDelay());
+      CPPUNIT_ASSERT_EQUAL(0ULL, f.audioProperties()->totalSamples());
+
+      auto frame = new ID3v2::CommentsFrame(String::Latin1);
+      frame->setDescription("iTunSMPB");
+      frame->setText(" 00000000 00000840 000001C0 0000000000020000 00000000 00000000");
+      f.ID3v2Tag(true)->addFrame(frame);
+      f.save();
+    }
+    {
+      MPEG::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT_EQUAL(0x840, f.audioProperties()->encoderDelay());
+      CPPUNIT_ASSERT_EQUAL(0x1C0, f.audioProperties()->encoderPadding());
+      CPPUNIT_ASSERT_EQUAL(0x20000ULL, f.audioProperties()->totalSamples());
+      CPPUNIT_ASSERT_EQUAL(2972, f.audioProperties()->lengthInMilliseconds());
+      CPPUNIT_ASSERT_EQUAL(64, f.audioProperties()->bitrate());
+    }
+
+    // Delays and paddings of more than a few frames are ignored, as are more
+    // samples than the stream has.
+
+    const String invalid[] = {
+      " 00000000 FFFFFFFF 000001C0 0000000000020000",
+      " 00000000 7FFFFFFF 7FFFFFFF 0000000000020000",
+      " 00000000 00000840 000001C0 FFFFFFFFFFFFFFFF"
+    };
+    for(const auto &text : invalid) {
+      int length;
+      {
+        MPEG::File f(copy.fileName().c_str());
+        dynamic_cast<ID3v2::CommentsFrame *>(
+          f.ID3v2Tag()->frameList("COMM").front())->setText(text);
+        f.save();
+      }
+      {
+        MPEG::File f(copy.fileName().c_str());
+        CPPUNIT_ASSERT(f.audioProperties()->encoderDelay() >= 0);
+        CPPUNIT_ASSERT(f.audioProperties()->encoderDelay() <= 0x840);
+        CPPUNIT_ASSERT(f.audioProperties()->encoderPadding() <= 0x1C0);
+        length = f.audioProperties()->lengthInMilliseconds();
+      }
+      CPPUNIT_ASSERT(length > 2972);
+      CPPUNIT_ASSERT(length < 4000);
+    }
+  }
+
   void testAudioPropertiesADTS()
   {
     constexpr std::array readStyles = {
@@ -151,7 +293,10 @@ public:
       CPPUNIT_ASSERT(f.audioProperties());
       CPPUNIT_ASSERT_EQUAL(readStyle == MPEG::Properties::Fast ? 0 : 1,
         f.audioProperties()->lengthInSeconds());
-      CPPUNIT_ASSERT_EQUAL(readStyle == MPEG::Properties::Fast ? 0 : 1176,
+      // The accurate read style counts the 12 frames, the average read style
+      // estimates the length from the bitrate.
+      CPPUNIT_ASSERT_EQUAL(readStyle == MPEG::Properties::Fast ? 0 :
+                           readStyle == MPEG::Properties::Average ? 1176 : 1115,
         f.audioProperties()->lengthInMilliseconds());
       CPPUNIT_ASSERT_EQUAL(readStyle == MPEG::Properties::Fast ? 0 : 1,
         f.audioProperties()->bitrate());
@@ -214,7 +359,7 @@ public:
     MPEG::File f(TEST_FILE_PATH_C("mpeg2.mp3"));
     CPPUNIT_ASSERT(f.audioProperties());
     CPPUNIT_ASSERT_EQUAL(5387, f.audioProperties()->lengthInSeconds());
-    CPPUNIT_ASSERT_EQUAL(5387285, f.audioProperties()->lengthInMilliseconds());
+    CPPUNIT_ASSERT_EQUAL(5387206, f.audioProperties()->lengthInMilliseconds());
   }
 
   void testSaveID3v24()
@@ -302,6 +447,221 @@ public:
     }
   }
 
+  void testHeaderFromData()
+  {
+    MPEG::File f(TEST_FILE_PATH_C("ape-id3v2.mp3"));
+    const offset_t offset = f.firstFrameOffset();
+    const MPEG::Header fileHeader(&f, offset, true);
+    CPPUNIT_ASSERT(fileHeader.isValid());
+
+    const ByteVector data = PlainFile(TEST_FILE_PATH_C("ape-id3v2.mp3")).readAll();
+    const MPEG::Header header(data, static_cast<unsigned int>(offset));
+    CPPUNIT_ASSERT(header.isValid());
+    CPPUNIT_ASSERT_EQUAL(fileHeader.version(), header.version());
+    CPPUNIT_ASSERT_EQUAL(fileHeader.layer(), header.layer());
+    CPPUNIT_ASSERT_EQUAL(fileHeader.bitrate(), header.bitrate());
+    CPPUNIT_ASSERT_EQUAL(fileHeader.sampleRate(), header.sampleRate());
+    CPPUNIT_ASSERT_EQUAL(fileHeader.channelMode(), header.channelMode());
+    CPPUNIT_ASSERT_EQUAL(fileHeader.frameLength(), header.frameLength());
+
+    // The next header is needed to check the frame length.
+
+    const ByteVector frame = data.mid(static_cast<unsigned int>(offset),
+                                      header.frameLength() + 3);
+    CPPUNIT_ASSERT(!MPEG::Header(frame).isValid());
+    CPPUNIT_ASSERT(MPEG::Header(frame, 0, false).isValid());
+    CPPUNIT_ASSERT(!MPEG::Header(frame, frame.size()).isValid());
+    CPPUNIT_ASSERT(!MPEG::Header(ByteVector("\xFF\xFB", 2), 0, false).isValid());
+  }
+
+  void testJunkBeforeFrames()
+  {
+    // Each 20 bytes of junk start with a frame header whose following frame
+    // header is missing.  Its sample rate differs from the one of the audio.
+
+    ByteVector data;
+    for(int i = 0; i < 3277; ++i) {
+      data.append(ByteVector("\xFF\xFB\x94\x00", 4));
+      data.append(ByteVector(16, '\0'));
+    }
+    const ByteVector audio = PlainFile(TEST_FILE_PATH_C("xing.mp3")).readAll();
+    data.append(audio);
+
+    CountingByteVectorStream stream(data);
+    MPEG::File f(&stream);
+    CPPUNIT_ASSERT(f.isValid());
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(65540), f.firstFrameOffset());
+    CPPUNIT_ASSERT(stream.reads < 300);
+
+    const MPEG::File direct(TEST_FILE_PATH_C("xing.mp3"));
+    CPPUNIT_ASSERT_EQUAL(direct.audioProperties()->lengthInMilliseconds(),
+                         f.audioProperties()->lengthInMilliseconds());
+    CPPUNIT_ASSERT_EQUAL(direct.audioProperties()->bitrate(),
+                         f.audioProperties()->bitrate());
+  }
+
+  void testVBRWithoutXingHeader()
+  {
+    // MPEG-1 Layer 3 frames at 44.1 kHz with bitrates from 128 to 320 kb/s,
+    // interrupted by a few bytes of junk.
+
+    ByteVector data;
+    unsigned long long bytes = 0;
+    for(int i = 0; i < 100; ++i) {
+      if(i == 50)
+        data.append(ByteVector(7, '\x55'));
+      ByteVector frame("\xFF\xFB\x00\x00", 4);
+      frame[2] = static_cast<char>((9 + i % 6) << 4);
+      const MPEG::Header header(frame, 0, false);
+      frame.resize(header.frameLength(), '\0');
+      data.append(frame);
+      bytes += frame.size();
+    }
+    const double length = 100 * 1152 * 1000.0 / 44100;
+
+    {
+      ByteVectorStream stream(data);
+      MPEG::File f(&stream, true, MPEG::Properties::Accurate);
+      CPPUNIT_ASSERT(f.isValid());
+      CPPUNIT_ASSERT(!f.audioProperties()->xingHeader());
+      CPPUNIT_ASSERT_EQUAL(static_cast<int>(length + 0.5),
+                           f.audioProperties()->lengthInMilliseconds());
+      CPPUNIT_ASSERT_EQUAL(static_cast<int>(bytes * 8.0 / length + 0.5),
+                           f.audioProperties()->bitrate());
+    }
+    {
+      // The average read style assumes a constant bitrate.
+
+      ByteVectorStream stream(data);
+      MPEG::File f(&stream, true, MPEG::Properties::Average);
+      CPPUNIT_ASSERT(f.isValid());
+      CPPUNIT_ASSERT_EQUAL(128, f.audioProperties()->bitrate());
+    }
+  }
+
+  void testSegmentedFrameCount()
+  {
+    // Frames whose payloads hold two headers one frame length apart, which
+    // look like valid frames when a segment starts in the payload, and runs
+    // of junk.
+
+    ByteVector data;
+    for(int i = 0; i < 400; ++i) {
+      if(i % 37 == 0)
+        data.append(ByteVector(i % 5 + 1, '\x55'));
+      ByteVector frame("\xFF\xFB\x00\x00", 4);
+      frame[2] = static_cast<char>((10 + i % 5) << 4);
+      const MPEG::Header header(frame, 0, false);
+      frame.resize(header.frameLength(), '\0');
+      for(unsigned int position : { i % 50 + 10, i % 50 + 10 + 417 })
+        std::copy_n("\xFF\xFB\x90\x00", 4, frame.data() + position);
+      data.append(frame);
+    }
+
+    ByteVectorStream stream(data);
+    MPEG::File f(&stream, false);
+    CPPUNIT_ASSERT(f.supportsConcurrentReads());
+
+    // The first frame follows a byte of junk.
+
+    const auto expected = MPEG::FrameScanner(&f, 4096).countFrames(1, data.size());
+    CPPUNIT_ASSERT_EQUAL(400ULL, expected.frames);
+    for(unsigned int segments = 2; segments <= 64; segments *= 2) {
+      const auto count = MPEG::FrameScanner::countFrames(&f, 4096, 1, data.size(), segments);
+      CPPUNIT_ASSERT_EQUAL(expected.frames, count.frames);
+      CPPUNIT_ASSERT_EQUAL(expected.bytes, count.bytes);
+    }
+
+    // Calls on several threads share the threads for the segments, the
+    // segments which get none are walked on the calling thread.
+
+    std::vector<MPEG::FrameScanner::FrameCount> counts(8);
+    std::vector<std::thread> threads;
+    for(auto &count : counts) {
+      threads.emplace_back([&f, &data, &count] {
+        count = MPEG::FrameScanner::countFrames(&f, 4096, 1, data.size(), 16);
+      });
+    }
+    for(auto &thread : threads)
+      thread.join();
+    for(const auto &count : counts) {
+      CPPUNIT_ASSERT_EQUAL(expected.frames, count.frames);
+      CPPUNIT_ASSERT_EQUAL(expected.bytes, count.bytes);
+    }
+  }
+
+  void testADTSFrameCountAcrossChunks()
+  {
+    // The second header is cut off after the first 4 bytes by the end of a
+    // window which is two chunks long, so that loading the rest of the
+    // header drops the data before it.
+
+    std::vector<unsigned int> lengths { 508, 511 };
+    for(unsigned int i = 0; i < 98; ++i)
+      lengths.push_back(200 + i % 23);
+
+    ByteVector data;
+    for(unsigned int length : lengths) {
+      ByteVector frame(length, '\0');
+      std::copy_n("\xFF\xF1\x50\x80\x00\x1F\xFC", 7, frame.data());
+      frame[3] = static_cast<char>(frame[3] | (length >> 11));
+      frame[4] = static_cast<char>(length >> 3);
+      frame[5] = static_cast<char>(frame[5] | (length & 7) << 5);
+      data.append(frame);
+    }
+
+    ByteVectorStream stream(data);
+    MPEG::File f(&stream, false);
+    const auto count = MPEG::FrameScanner(&f, 512).countFrames(0, data.size());
+    CPPUNIT_ASSERT_EQUAL(100ULL, count.frames);
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned long long>(data.size()), count.bytes);
+  }
+
+  void testFrameIndex()
+  {
+    // Frames of different lengths with a few bytes of junk after every 37th.
+
+    ByteVector data;
+    List<offset_t> offsets;
+    for(int i = 0; i < 200; ++i) {
+      ByteVector frame("\xFF\xFB\x00\x00", 4);
+      frame[2] = static_cast<char>((9 + i % 6) << 4);
+      const MPEG::Header header(frame, 0, false);
+      frame.resize(header.frameLength(), '\0');
+      offsets.append(data.size());
+      data.append(frame);
+      if(i % 37 == 36)
+        data.append(ByteVector(3, '\x55'));
+    }
+
+    ByteVectorStream stream(data);
+    MPEG::File f(&stream, false);
+
+    const MPEG::FrameIndex index = f.frameIndex();
+    CPPUNIT_ASSERT(index.isExact());
+    CPPUNIT_ASSERT_EQUAL(200U, index.size());
+    CPPUNIT_ASSERT(index.memoryUsage() < 200 * sizeof(MPEG::FrameIndex::Entry) / 2);
+    for(unsigned int i = 0; i < 200; ++i) {
+      const MPEG::FrameIndex::Entry entry = index.entry(i);
+      CPPUNIT_ASSERT_EQUAL(static_cast<unsigned long long>(i), entry.frame);
+      CPPUNIT_ASSERT_EQUAL(offsets[i], entry.offset);
+      CPPUNIT_ASSERT_EQUAL(i * 1152ULL, entry.sample);
+      CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(MPEG::Header(data, offsets[i], false).frameLength()),
+                           entry.length);
+    }
+    CPPUNIT_ASSERT_EQUAL(offsets[0], index.find(0).offset);
+    CPPUNIT_ASSERT_EQUAL(offsets[130], index.find(130 * 1152 + 1151).offset);
+    CPPUNIT_ASSERT_EQUAL(offsets[199], index.find(1000000).offset);
+
+    const MPEG::FrameIndex sparse = f.frameIndex(16);
+    CPPUNIT_ASSERT_EQUAL(13U, sparse.size());
+    CPPUNIT_ASSERT_EQUAL(offsets[48], sparse.entry(3).offset);
+    CPPUNIT_ASSERT_EQUAL(offsets[176], sparse.find(180 * 1152).offset);
+
+    CPPUNIT_ASSERT(f.tableOfContentsIndex().isEmpty());
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(-1), MPEG::FrameIndex().find(0).offset);
+  }
+
   void testStripAndProperties()
   {
     ScopedFileCopy copy("xing", ".mp3");
@@ -604,7 +964,7 @@ public:
       MPEG::File f(copy.fileName().c_str(), true, MPEG::Properties::Fast);
       CPPUNIT_ASSERT(f.audioProperties());
       CPPUNIT_ASSERT_EQUAL(1887, f.audioProperties()->lengthInSeconds());
-      CPPUNIT_ASSERT_EQUAL(1887164, f.audioProperties()->lengthInMilliseconds());
+      CPPUNIT_ASSERT_EQUAL(1887138, f.audioProperties()->lengthInMilliseconds());
       CPPUNIT_ASSERT_EQUAL(64, f.audioProperties()->bitrate());
       CPPUNIT_ASSERT_EQUAL(1, f.audioProperties()->channels());
       CPPUNIT_ASSERT_EQUAL(44100, f.audioProperties()->sampleRate());
@@ -686,6 +1046,151 @@ public:
     CPPUNIT_ASSERT_EQUAL(2315U, data.size());
   }
 
+  void testDeferPayloads()
+  {
+    ByteVector picture(40000, 'p');
+    ByteVector object(20000, 'o');
+    ByteVector privateData(30000, 'd');
+    for(unsigned int i = 0; i < picture.size(); i += 7)
+      picture[i] = static_cast<char>(i);
+
+    for(auto version : {ID3v2::v3, ID3v2::v4}) {
+      const ScopedFileCopy copy("xing", ".mp3");
+      {
+        MPEG::File f(copy.fileName().c_str());
+        ID3v2::Tag *tag = f.ID3v2Tag(true);
+        tag->setTitle("Title");
+        auto apic = new ID3v2::AttachedPictureFrame;
+        apic->setMimeType("image/png");
+        apic->setDescription("Cover");
+        apic->setType(ID3v2::AttachedPictureFrame::FrontCover);
+        apic->setPicture(picture);
+        tag->addFrame(apic);
+        auto geob = new ID3v2::GeneralEncapsulatedObjectFrame;
+        geob->setFileName("object.bin");
+        geob->setObject(object);
+        tag->addFrame(geob);
+        tag->addFrame(new ID3v2::PrivateFrame);
+        auto priv = new ID3v2::PrivateFrame;
+        priv->setOwner("owner");
+        priv->setData(privateData);
+        tag->addFrame(priv);
+        tag->setArtist("Artist");
+        CPPUNIT_ASSERT(f.save(MPEG::File::ID3v2, File::StripOthers, version));
+      }
+      {
+        MPEG::File f(copy.fileName().c_str(), true, MPEG::Properties::Average,
+                     nullptr, File::DeferPayloads);
+        CPPUNIT_ASSERT(f.isValid());
+        CPPUNIT_ASSERT_EQUAL(File::DeferPayloads, f.payloadStyle());
+        ID3v2::Tag *tag = f.ID3v2Tag();
+        CPPUNIT_ASSERT_EQUAL(String("Title"), tag->title());
+        CPPUNIT_ASSERT_EQUAL(String("Artist"), tag->artist());
+
+        const auto apic = dynamic_cast<ID3v2::AttachedPictureFrame *>(
+          tag->frameList("APIC").front());
+        CPPUNIT_ASSERT_EQUAL(String("image/png"), apic->mimeType());
+        CPPUNIT_ASSERT_EQUAL(String("Cover"), apic->description());
+        CPPUNIT_ASSERT_EQUAL(ID3v2::AttachedPictureFrame::FrontCover, apic->type());
+        CPPUNIT_ASSERT_EQUAL(picture, apic->picture());
+        CPPUNIT_ASSERT_EQUAL(picture, apic->picture());
+
+        const auto geob = dynamic_cast<ID3v2::GeneralEncapsulatedObjectFrame *>(
+          tag->frameList("GEOB").front());
+        CPPUNIT_ASSERT_EQUAL(String("object.bin"), geob->fileName());
+
+        CPPUNIT_ASSERT_EQUAL(2U, tag->frameList("PRIV").size());
+        const auto priv = dynamic_cast<ID3v2::PrivateFrame *>(
+          tag->frameList("PRIV").back());
+        CPPUNIT_ASSERT_EQUAL(String("owner"), priv->owner());
+        CPPUNIT_ASSERT_EQUAL(privateData.size() + 6, priv->size());
+
+        // The payloads which were not used are read when the tag is saved.
+        tag->setTitle("New Title");
+        CPPUNIT_ASSERT(f.save(MPEG::File::ID3v2, File::StripOthers, version));
+      }
+      {
+        MPEG::File f(copy.fileName().c_str());
+        ID3v2::Tag *tag = f.ID3v2Tag();
+        CPPUNIT_ASSERT_EQUAL(String("New Title"), tag->title());
+        CPPUNIT_ASSERT_EQUAL(picture, dynamic_cast<ID3v2::AttachedPictureFrame *>(
+          tag->frameList("APIC").front())->picture());
+        CPPUNIT_ASSERT_EQUAL(object, dynamic_cast<ID3v2::GeneralEncapsulatedObjectFrame *>(
+          tag->frameList("GEOB").front())->object());
+        CPPUNIT_ASSERT_EQUAL(privateData, dynamic_cast<ID3v2::PrivateFrame *>(
+          tag->frameList("PRIV").back())->data());
+      }
+      {
+        MPEG::File f(copy.fileName().c_str(), true, MPEG::Properties::Average,
+                     nullptr, File::DeferPayloads);
+        f.setSaveStrategy(File::Rewrite);
+        f.ID3v2Tag()->setTitle("Rewritten");
+        CPPUNIT_ASSERT(f.save(MPEG::File::ID3v2, File::StripOthers, version));
+      }
+      {
+        MPEG::File f(copy.fileName().c_str());
+        ID3v2::Tag *tag = f.ID3v2Tag();
+        CPPUNIT_ASSERT_EQUAL(String("Rewritten"), tag->title());
+        CPPUNIT_ASSERT_EQUAL(picture, dynamic_cast<ID3v2::AttachedPictureFrame *>(
+          tag->frameList("APIC").front())->picture());
+        CPPUNIT_ASSERT_EQUAL(object, dynamic_cast<ID3v2::GeneralEncapsulatedObjectFrame *>(
+          tag->frameList("GEOB").front())->object());
+      }
+    }
+  }
+
+  void testDeferPayloadsStripped()
+  {
+    ByteVector picture(40000, 'p');
+    for(unsigned int i = 0; i < picture.size(); i += 7)
+      picture[i] = static_cast<char>(i);
+
+    const ScopedFileCopy copy("xing", ".mp3");
+    {
+      MPEG::File f(copy.fileName().c_str());
+      auto apic = new ID3v2::AttachedPictureFrame;
+      apic->setPicture(picture);
+      f.ID3v2Tag(true)->addFrame(apic);
+      f.ID3v1Tag(true)->setTitle("Title");
+      CPPUNIT_ASSERT(f.save());
+    }
+    {
+      // The ID3v2 tag is removed from the file, but its payloads can still
+      // be read from the tag in memory.
+
+      MPEG::File f(copy.fileName().c_str(), true, MPEG::Properties::Average,
+                   nullptr, File::DeferPayloads);
+      CPPUNIT_ASSERT(f.save(MPEG::File::ID3v1, File::StripOthers));
+      CPPUNIT_ASSERT(!f.hasID3v2Tag());
+      const auto apic = dynamic_cast<ID3v2::AttachedPictureFrame *>(
+        f.ID3v2Tag()->frameList("APIC").front());
+      CPPUNIT_ASSERT_EQUAL(picture, apic->picture());
+    }
+    {
+      // Deferred payloads may be read from several threads at once.
+
+      MPEG::File f(copy.fileName().c_str());
+      auto apic = new ID3v2::AttachedPictureFrame;
+      apic->setPicture(picture);
+      f.ID3v2Tag(true)->addFrame(apic);
+      CPPUNIT_ASSERT(f.save());
+    }
+    {
+      MPEG::File f(copy.fileName().c_str(), true, MPEG::Properties::Average,
+                   nullptr, File::DeferPayloads);
+      const auto apic = dynamic_cast<const ID3v2::AttachedPictureFrame *>(
+        f.ID3v2Tag()->frameList("APIC").front());
+      std::vector<ByteVector> pictures(4);
+      std::vector<std::thread> threads;
+      for(auto &result : pictures)
+        threads.emplace_back([apic, &result] { result = apic->picture(); });
+      for(auto &thread : threads)
+        thread.join();
+      for(const auto &result : pictures)
+        CPPUNIT_ASSERT_EQUAL(picture, result);
+    }
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestMPEG);
@@ -0,0 +1,235 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#include "tprefetchiostream.h"
+#include "tbytevectorstream.h"
+#include "tfilestream.h"
+#include "tpropertymap.h"
+#include "fileref.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include "utils.h"
+
+using namespace std;
+using namespace TagLib;
+
+namespace
+{
+  ByteVector testData(unsigned int size)
+  {
+    ByteVector data(size, '\0');
+    for(unsigned int i = 0; i < size; ++i)
+      data[i] = static_cast<char>(i);
+    return data;
+  }
+
+  // Counts the requests which reach a stream
+  class RequestCountingStream : public IOStream
+  {
+  public:
+    explicit RequestCountingStream(IOStream *stream) : stream(stream) { }
+
+    FileName name() const override { return stream->name(); }
+
+    ByteVector readBlock(size_t length) override
+    {
+      ++requests;
+      return stream->readBlock(length);
+    }
+
+    ByteVector readBlockAt(offset_t offset, size_t length) override
+    {
+      ++requests;
+      return stream->readBlockAt(offset, length);
+    }
+
+    ByteVectorList readBlocks(const List<Region> &regions) override
+    {
+      ++requests;
+      ++batches;
+      return stream->readBlocks(regions);
+    }
+
+    void writeBlock(const ByteVector &data) override { stream->writeBlock(data); }
+    void insert(const ByteVector &data, offset_t start, size_t replace) override
+    {
+      stream->insert(data, start, replace);
+    }
+    void removeBlock(offset_t start, size_t length) override
+    {
+      stream->removeBlock(start, length);
+    }
+    bool readOnly() const override { return stream->readOnly(); }
+    bool isOpen() const override { return stream->isOpen(); }
+    void seek(offset_t offset, Position p) override { stream->seek(offset, p); }
+    void clear() override { stream->clear(); }
+    offset_t tell() const override { return stream->tell(); }
+    offset_t length() override { return stream->length(); }
+    void truncate(offset_t length) override { stream->truncate(length); }
+
+    IOStream *const stream;
+    unsigned int requests = 0;
+    unsigned int batches = 0;
+  };
+}  // namespace
+
+class TestPrefetchIOStream : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestPrefetchIOStream);
+  CPPUNIT_TEST(testReadBlocks);
+  CPPUNIT_TEST(testHeadAndTail);
+  CPPUNIT_TEST(testRegions);
+  CPPUNIT_TEST(testWrite);
+  CPPUNIT_TEST(testFileRef);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void testReadBlocks()
+  {
+    const ByteVector data = testData(100);
+    ByteVectorStream stream(data);
+
+    const ByteVectorList blocks = stream.readBlocks({ { 10, 5 }, { 0, 3 }, { 98, 4 }, { 120, 1 } });
+    CPPUNIT_ASSERT_EQUAL(4U, blocks.size());
+    CPPUNIT_ASSERT_EQUAL(data.mid(10, 5), blocks[0]);
+    CPPUNIT_ASSERT_EQUAL(data.mid(0, 3), blocks[1]);
+    CPPUNIT_ASSERT_EQUAL(data.mid(98), blocks[2]);
+    CPPUNIT_ASSERT_EQUAL(ByteVector(), blocks[3]);
+  }
+
+  void testHeadAndTail()
+  {
+    const ByteVector data = testData(100);
+    ByteVectorStream stream(data);
+    RequestCountingStream counting(&stream);
+    PrefetchIOStream prefetched(&counting, 16, 16);
+
+    CPPUNIT_ASSERT_EQUAL(1U, counting.batches);
+    CPPUNIT_ASSERT_EQUAL(1U, counting.requests);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(0), prefetched.tell());
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(100), prefetched.length());
+
+    CPPUNIT_ASSERT_EQUAL(data.mid(0, 10), prefetched.readBlock(10));
+    CPPUNIT_ASSERT_EQUAL(data.mid(10, 6), prefetched.readBlock(6));
+    CPPUNIT_ASSERT_EQUAL(data.mid(84, 16), prefetched.readBlockAt(84, 16));
+    prefetched.seek(-3, IOStream::End);
+    CPPUNIT_ASSERT_EQUAL(data.mid(97), prefetched.readBlock(10));
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(100), prefetched.tell());
+    CPPUNIT_ASSERT_EQUAL(1U, counting.requests);
+    CPPUNIT_ASSERT_EQUAL(4ULL, prefetched.hits());
+    CPPUNIT_ASSERT_EQUAL(0ULL, prefetched.misses());
+
+    // Only the gap between the windows reaches the other stream.
+
+    CPPUNIT_ASSERT_EQUAL(data.mid(8, 84), prefetched.readBlockAt(8, 84));
+    CPPUNIT_ASSERT_EQUAL(2U, counting.requests);
+    CPPUNIT_ASSERT_EQUAL(1ULL, prefetched.misses());
+    CPPUNIT_ASSERT_EQUAL(data, prefetched.readBlockAt(0, 200));
+    CPPUNIT_ASSERT_EQUAL(3U, counting.requests);
+  }
+
+  void testRegions()
+  {
+    const ByteVector data = testData(100);
+    ByteVectorStream stream(data);
+    RequestCountingStream counting(&stream);
+
+    // The first two regions are merged, the last one is clamped to the end.
+
+    PrefetchIOStream prefetched(&counting, { { 20, 10 }, { 25, 15 }, { -10, 20 } });
+    CPPUNIT_ASSERT_EQUAL(1U, counting.requests);
+    CPPUNIT_ASSERT_EQUAL(data.mid(20, 20), prefetched.readBlockAt(20, 20));
+    CPPUNIT_ASSERT_EQUAL(data.mid(90), prefetched.readBlockAt(90, 20));
+    CPPUNIT_ASSERT_EQUAL(ByteVector(), prefetched.readBlockAt(100, 4));
+    CPPUNIT_ASSERT_EQUAL(1U, counting.requests);
+    CPPUNIT_ASSERT_EQUAL(3ULL, prefetched.hits());
+
+    CPPUNIT_ASSERT_EQUAL(data.mid(10, 20), prefetched.readBlockAt(10, 20));
+    CPPUNIT_ASSERT_EQUAL(2U, counting.requests);
+
+    // The stream starts at the position of the other stream.
+
+    stream.seek(42);
+    PrefetchIOStream positioned(&stream, List<IOStream::Region>());
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(42), positioned.tell());
+    CPPUNIT_ASSERT_EQUAL(data.mid(42, 2), positioned.readBlock(2));
+  }
+
+  void testWrite()
+  {
+    ByteVectorStream stream(testData(100));
+    PrefetchIOStream prefetched(&stream, 16, 16);
+
+    prefetched.seek(10);
+    prefetched.writeBlock("abcd");
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(14), prefetched.tell());
+    CPPUNIT_ASSERT_EQUAL(*stream.data(), prefetched.readBlockAt(0, 100));
+
+    prefetched.seek(0, IOStream::End);
+    prefetched.writeBlock("efgh");
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(104), prefetched.length());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("efgh"), prefetched.readBlockAt(100, 8));
+
+    prefetched.insert("ijkl", 5, 2);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(106), prefetched.length());
+    CPPUNIT_ASSERT_EQUAL(*stream.data(), prefetched.readBlockAt(0, 106));
+
+    prefetched.removeBlock(5, 30);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(76), prefetched.length());
+    CPPUNIT_ASSERT_EQUAL(*stream.data(), prefetched.readBlockAt(0, 100));
+
+    prefetched.truncate(50);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(50), prefetched.length());
+    CPPUNIT_ASSERT_EQUAL(*stream.data(), prefetched.readBlockAt(0, 100));
+  }
+
+  void testFileRef()
+  {
+    for(const auto &name : { "xing.mp3", "no-tags.flac", "empty.ogg", "empty.wav",
+                             "empty.aiff", "has-tags.m4a", "click.mpc" }) {
+      FileStream fileStream(TEST_FILE_PATH_C(name), true);
+      RequestCountingStream direct(&fileStream);
+      const FileRef directFile(&direct);
+      CPPUNIT_ASSERT(!directFile.isNull());
+
+      fileStream.seek(0);
+      RequestCountingStream counting(&fileStream);
+      PrefetchIOStream prefetched(&counting);
+      const FileRef file(&prefetched);
+
+      CPPUNIT_ASSERT(!file.isNull());
+      CPPUNIT_ASSERT(file.file()->properties() == directFile.file()->properties());
+      CPPUNIT_ASSERT_EQUAL(directFile.audioProperties()->lengthInMilliseconds(),
+                           file.audioProperties()->lengthInMilliseconds());
+      CPPUNIT_ASSERT_EQUAL(directFile.audioProperties()->bitrate(),
+                           file.audioProperties()->bitrate());
+      CPPUNIT_ASSERT_EQUAL(1U, counting.batches);
+      CPPUNIT_ASSERT(counting.requests < direct.requests);
+    }
+  }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestPrefetchIOStream);
@@ -55,6 +55,7 @@ class TestPropertyMap : public CppUnit::TestFixture
   CPPUNIT_TEST(testGetSetId3v1);
   CPPUNIT_TEST(testGetSetId3v2);
   CPPUNIT_TEST(testGetSet);
+  CPPUNIT_TEST(testSerialize);
 #ifdef TAGLIB_WITH_APE
   CPPUNIT_TEST(testGetSetApe);
 #endif
@@ -94,6 +95,36 @@ public:
 
   }
 
+  void testSerialize()
+  {
+    PropertyMap map;
+    map["ARTIST"] = StringList {"Artist 1", L"\x00c4\x00d6\x00dc"};
+    map["TITLE"] = String("Title");
+    map["COMMENT:"] = StringList {""};
+    map["EMPTY"] = StringList();
+    map.addUnsupportedData("APIC");
+    map.addUnsupportedData("UNKNOWN/1");
+
+    bool ok = false;
+    const PropertyMap copy = PropertyMap::deserialize(map.serialize(), &ok);
+    CPPUNIT_ASSERT(ok);
+    CPPUNIT_ASSERT(map == copy);
+    CPPUNIT_ASSERT_EQUAL(map.toString(), copy.toString());
+
+    CPPUNIT_ASSERT(PropertyMap::deserialize(PropertyMap().serialize(), &ok).isEmpty());
+    CPPUNIT_ASSERT(ok);
+
+    const ByteVector data = map.serialize();
+    CPPUNIT_ASSERT(PropertyMap::deserialize(data.mid(0, data.size() - 1), &ok).isEmpty());
+    CPPUNIT_ASSERT(!ok);
+
+    const StringList list {"first", "", L"\x20ac"};
+    CPPUNIT_ASSERT_EQUAL(list, StringList::deserialize(list.serialize(), &ok));
+    CPPUNIT_ASSERT(ok);
+    CPPUNIT_ASSERT(StringList::deserialize(ByteVector("\0\0\0\x01", 4), &ok).isEmpty());
+    CPPUNIT_ASSERT(!ok);
+  }
+
   template <typename T>
   void tagGetSet()
   {
@@ -0,0 +1,149 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#include <thread>
+#include <vector>
+
+#include "tsharedreadstream.h"
+#include "tbytevectorstream.h"
+#include "tfilestream.h"
+#include "tpropertymap.h"
+#include "fileref.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include "utils.h"
+
+using namespace std;
+using namespace TagLib;
+
+class TestSharedReadStream : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestSharedReadStream);
+  CPPUNIT_TEST(testReadBlock);
+  CPPUNIT_TEST(testReadOnly);
+  CPPUNIT_TEST(testSupportsConcurrentReads);
+  CPPUNIT_TEST(testConcurrentReaders);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void testReadBlock()
+  {
+    ByteVectorStream stream(ByteVector("abcdefgh"));
+    SharedReadStream first(&stream);
+    SharedReadStream second(&stream);
+
+    CPPUNIT_ASSERT(first.isOpen());
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(8), first.length());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abc"), first.readBlock(3));
+    CPPUNIT_ASSERT_EQUAL(ByteVector("ab"), second.readBlock(2));
+    CPPUNIT_ASSERT_EQUAL(ByteVector("def"), first.readBlock(3));
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(6), first.tell());
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(2), second.tell());
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(0), stream.tell());
+
+    first.seek(-3, IOStream::End);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("fgh"), first.readBlock(10));
+    first.seek(-6, IOStream::Current);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("cd"), first.readBlock(2));
+    CPPUNIT_ASSERT_EQUAL(ByteVector("gh"), first.readBlockAt(6, 2));
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(4), first.tell());
+    first.seek(20);
+    CPPUNIT_ASSERT_EQUAL(ByteVector(), first.readBlock(1));
+  }
+
+  void testReadOnly()
+  {
+    ByteVectorStream stream(ByteVector("abcd"));
+    SharedReadStream reader(&stream);
+
+    CPPUNIT_ASSERT(reader.readOnly());
+    reader.writeBlock(ByteVector("xx"));
+    reader.insert(ByteVector("yy"), 1);
+    reader.removeBlock(0, 2);
+    reader.truncate(1);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abcd"), *stream.data());
+  }
+
+  void testSupportsConcurrentReads()
+  {
+    ScopedFileCopy copy("xing", ".mp3");
+
+    {
+      FileStream stream(copy.fileName().c_str(), true);
+      CPPUNIT_ASSERT(stream.supportsConcurrentReads());
+      CPPUNIT_ASSERT(SharedReadStream(&stream).supportsConcurrentReads());
+    }
+    {
+      FileStream stream(copy.fileName().c_str());
+      CPPUNIT_ASSERT(!stream.readOnly());
+      CPPUNIT_ASSERT(!stream.supportsConcurrentReads());
+    }
+
+    ByteVectorStream stream(ByteVector("abcd"));
+    CPPUNIT_ASSERT(stream.supportsConcurrentReads());
+  }
+
+  void testConcurrentReaders()
+  {
+    const string fileNames[] = {
+      TEST_FILE_PATH_C("xing.mp3"),
+      TEST_FILE_PATH_C("has-tags.m4a"),
+      TEST_FILE_PATH_C("lowercase-fields.ogg"),
+      TEST_FILE_PATH_C("sinewave.flac")
+    };
+
+    for(const auto &fileName : fileNames) {
+      FileRef expected(fileName.c_str());
+      CPPUNIT_ASSERT(!expected.isNull());
+      const int length = expected.audioProperties()->lengthInMilliseconds();
+      const PropertyMap properties = expected.properties();
+
+      FileStream stream(fileName.c_str(), true);
+
+      vector<int> matches(4, 0);
+      vector<thread> threads;
+      for(auto &count : matches) {
+        threads.emplace_back([&stream, &count, length, &properties] {
+          for(int i = 0; i < 20; ++i) {
+            SharedReadStream reader(&stream);
+            const FileRef file(&reader);
+            if(!file.isNull() &&
+               file.audioProperties()->lengthInMilliseconds() == length &&
+               file.properties() == properties)
+              ++count;
+          }
+        });
+      }
+      for(auto &t : threads)
+        t.join();
+
+      for(int count : matches)
+        CPPUNIT_ASSERT_EQUAL(20, count);
+    }
+  }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestSharedReadStream);
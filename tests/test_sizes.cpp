@@ -41,6 +41,7 @@
 #include "tstringlist.h"
 #include "fileref.h"
 #include "mpegfile.h"
+#include "mpegframeindex.h"
 #include "mpegheader.h"
 #include "mpegproperties.h"
 #include "xingheader.h"
@@ -208,6 +209,7 @@ public:
         CPPUNIT_ASSERT_EQUAL(classSize(0, true), sizeof(TagLib::IOStream));
         CPPUNIT_ASSERT_EQUAL(classSize(1, false), sizeof(TagLib::List<int>));
         CPPUNIT_ASSERT_EQUAL(classSize(1, true), sizeof(TagLib::MPEG::File));
+        CPPUNIT_ASSERT_EQUAL(classSize(1, false), sizeof(TagLib::MPEG::FrameIndex));
         CPPUNIT_ASSERT_EQUAL(classSize(1, false), sizeof(TagLib::MPEG::Header));
         CPPUNIT_ASSERT_EQUAL(classSize(1, true), sizeof(TagLib::MPEG::Properties));
         CPPUNIT_ASSERT_EQUAL(classSize(0, false), sizeof(TagLib::MPEG::XingHeader));
@@ -39,6 +39,8 @@ class TestVariant : public CppUnit::TestFixture
   CPPUNIT_TEST_SUITE(TestVariant);
   CPPUNIT_TEST(testVariantTypes);
   CPPUNIT_TEST(testVariantToOStream);
+  CPPUNIT_TEST(testSerialize);
+  CPPUNIT_TEST(testDeserializeInvalid);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -199,6 +201,72 @@ public:
       R"( "varlist": [null, 1, -10, 4.32, false]})"s,
     ss.str());
   }
+
+  void testSerialize()
+  {
+    const VariantMap vm {
+      {"void", Variant()},
+      {"bool", true},
+      {"int", -4},
+      {"uint", 0xfffffff0U},
+      {"longlong", -6LL},
+      {"ulonglong", 0xfffffffffffffff0ULL},
+      {"double", -1.23e300},
+      {"string", String(L"\x00c4\x00d6\x00dc \x20ac")},
+      {"strlist", StringList {"first", "", "third"}},
+      {"data", ByteVector("\0\xa9\x01\x7f", 4)},
+      {"datalist", ByteVectorList {"first", ByteVector()}},
+      {"varlist", VariantList {Variant(), 1U, -10LL, 4.32, false,
+                               VariantMap {{"nested", StringList()}}}},
+      {"varmap", VariantMap()}
+    };
+
+    bool ok = false;
+    CPPUNIT_ASSERT(Variant(vm) == Variant::deserialize(Variant(vm).serialize(), &ok));
+    CPPUNIT_ASSERT(ok);
+
+    for(const auto &[key, value] : vm) {
+      const Variant v = Variant::deserialize(value.serialize(), &ok);
+      CPPUNIT_ASSERT(ok);
+      CPPUNIT_ASSERT_EQUAL(value.type(), v.type());
+      CPPUNIT_ASSERT(value == v);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(ByteVector("\x09\0\0\0\x03" "abc", 8),
+                         Variant(ByteVector("abc")).serialize());
+
+    // Byte vectors refer to the serialized data instead of copying it.
+    const ByteVector data = Variant(ByteVector("abc")).serialize();
+    const ByteVector raw = ByteVector::fromRawData(data.data(), data.size());
+    const ByteVector abc = Variant::deserialize(raw).toByteVector();
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abc"), abc);
+    CPPUNIT_ASSERT(abc.data() == data.data() + 5);
+  }
+
+  void testDeserializeInvalid()
+  {
+    const ByteVector data = Variant(VariantList {"1st", 2, ByteVector("3rd")}).serialize();
+    bool ok = true;
+    for(unsigned int size = 0; size < data.size(); ++size) {
+      CPPUNIT_ASSERT(Variant::deserialize(data.mid(0, size), &ok).isEmpty());
+      CPPUNIT_ASSERT(!ok);
+    }
+    CPPUNIT_ASSERT(Variant::deserialize(data + ByteVector(1, '\0'), &ok).isEmpty());
+    CPPUNIT_ASSERT(!ok);
+    CPPUNIT_ASSERT(Variant::deserialize(ByteVector(1, '\x7f'), &ok).isEmpty());
+    CPPUNIT_ASSERT(!ok);
+
+    // A huge count does not allocate anything before reading past the end.
+    CPPUNIT_ASSERT(Variant::deserialize(ByteVector("\x0b\xff\xff\xff\xff", 5), &ok).isEmpty());
+    CPPUNIT_ASSERT(!ok);
+
+    // Deeply nested lists are rejected.
+    Variant nested;
+    for(int i = 0; i < 100; ++i)
+      nested = VariantList {nested};
+    CPPUNIT_ASSERT(Variant::deserialize(nested.serialize(), &ok).isEmpty());
+    CPPUNIT_ASSERT(!ok);
+  }
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestVariant);
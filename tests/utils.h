@@ -50,25 +50,32 @@ inline string testFilePath(const string &filename)
 
 #define TEST_FILE_PATH_C(f) testFilePath(f).c_str()
 
-inline string copyFile(const string &filename, const string &ext)
+inline string tempFilePath(const string &name)
 {
-  char testFileName[1024];
+  char tempFileName[1024];
 
 #ifdef TESTS_TMPDIR
-  snprintf(testFileName, sizeof(testFileName), "%s/taglib-test%s", TESTS_TMPDIR, ext.c_str());
+  snprintf(tempFileName, sizeof(tempFileName), "%s/%s", TESTS_TMPDIR, name.c_str());
 #elif defined _WIN32
   char tempDir[MAX_PATH + 1];
   GetTempPathA(sizeof(tempDir), tempDir);
-  wsprintfA(testFileName, "%s\\taglib-test%s", tempDir, ext.c_str());
+  wsprintfA(tempFileName, "%s\\%s", tempDir, name.c_str());
 #else
-  snprintf(testFileName, sizeof(testFileName), "%s/taglib-test%s", P_tmpdir, ext.c_str());
+  snprintf(tempFileName, sizeof(tempFileName), "%s/%s", P_tmpdir, name.c_str());
 #endif
 
+  return string(tempFileName);
+}
+
+inline string copyFile(const string &filename, const string &ext)
+{
+  const string testFileName = tempFilePath("taglib-test" + ext);
+
   string sourceFileName = testFilePath(filename) + ext;
   ifstream source(sourceFileName.c_str(), std::ios::binary);
-  ofstream destination(testFileName, std::ios::binary);
+  ofstream destination(testFileName.c_str(), std::ios::binary);
   destination << source.rdbuf();
-  return string(testFileName);
+  return testFileName;
 }
 
 inline void deleteFile(const string &filename)
@@ -153,3 +160,31 @@ private:
   const bool m_deleteFile;
   const string m_filename;
 };
+
+// An empty file in the temporary directory, which is removed afterwards.
+
+class ScopedTempFile
+{
+public:
+  explicit ScopedTempFile(const string &name) :
+    m_filename(tempFilePath("taglib-test-" + name))
+  {
+    ofstream(m_filename.c_str(), std::ios::binary | std::ios::trunc);
+  }
+
+  ~ScopedTempFile()
+  {
+    deleteFile(m_filename);
+  }
+
+  ScopedTempFile(const ScopedTempFile &) = delete;
+  ScopedTempFile &operator=(const ScopedTempFile &) = delete;
+
+  string fileName() const
+  {
+    return m_filename;
+  }
+
+private:
+  const string m_filename;
+};